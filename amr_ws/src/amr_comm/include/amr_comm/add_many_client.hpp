@@ -0,0 +1,59 @@
+#ifndef AMR_COMM__ADD_MANY_CLIENT_HPP_
+#define AMR_COMM__ADD_MANY_CLIENT_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "custom_interfaces/srv/add_many.hpp"
+
+namespace amr_comm
+{
+
+// Pipelined client for the AddMany service. Batches are sent as soon as they
+// are queued, up to `max_in_flight` outstanding requests; the rest wait in a
+// FIFO and go out as responses arrive. Responses are delivered through the
+// node's executor, so the node has to be spinning.
+class AddManyClient
+{
+public:
+  using AddMany = custom_interfaces::srv::AddMany;
+  using Callback = std::function<void (const std::vector<int64_t> & sum)>;
+
+  AddManyClient(
+    rclcpp::Node * node, const std::string & service_name, size_t max_in_flight);
+
+  bool wait_for_service(std::chrono::nanoseconds timeout);
+
+  // Queues one batch; `callback` runs with the sums once the response arrives.
+  void add_many(std::vector<int64_t> a, std::vector<int64_t> b, Callback callback);
+
+  size_t in_flight() const;
+  size_t pending() const;
+
+private:
+  struct Batch
+  {
+    std::shared_ptr<AddMany::Request> request;
+    Callback callback;
+  };
+
+  void send_pending_locked();
+  void on_response(const Callback & callback, rclcpp::Client<AddMany>::SharedFuture future);
+
+  rclcpp::Client<AddMany>::SharedPtr client_;
+  const size_t max_in_flight_;
+  mutable std::mutex mutex_;
+  std::deque<Batch> pending_;
+  size_t in_flight_;
+};
+
+}  // namespace amr_comm
+
+#endif  // AMR_COMM__ADD_MANY_CLIENT_HPP_
@@ -0,0 +1,31 @@
+#ifndef AMR_COMM__ADD_MANY_SERVER_HPP_
+#define AMR_COMM__ADD_MANY_SERVER_HPP_
+
+#include <memory>
+
+#include "rclcpp/rclcpp.hpp"
+#include "custom_interfaces/srv/add_many.hpp"
+
+namespace amr_comm
+{
+
+// Batched counterpart of aula8/srv_server.py: every request carries whole
+// operand arrays and is answered in a single pass over them.
+class AddManyServer : public rclcpp::Node
+{
+public:
+  using AddMany = custom_interfaces::srv::AddMany;
+
+  explicit AddManyServer(const rclcpp::NodeOptions & options = rclcpp::NodeOptions());
+
+private:
+  void srv_callback(
+    const std::shared_ptr<AddMany::Request> request,
+    std::shared_ptr<AddMany::Response> response);
+
+  rclcpp::Service<AddMany>::SharedPtr srv_;
+};
+
+}  // namespace amr_comm
+
+#endif  // AMR_COMM__ADD_MANY_SERVER_HPP_
@@ -0,0 +1,32 @@
+#ifndef AMR_COMM__ALLOCATION_COUNTER_HPP_
+#define AMR_COMM__ALLOCATION_COUNTER_HPP_
+
+#include <cstddef>
+
+namespace amr_comm
+{
+
+// Process-wide count of global operator new calls, every overload (plain,
+// array, nothrow and align_val_t). Only available to executables that link
+// amr_comm_allocation_counter, which replaces the global allocation
+// functions. Direct malloc/calloc/realloc calls, as made by C libraries such
+// as rcl, rmw and the DDS implementation, are not seen, so a zero count
+// proves the C++ side of a callback allocation-free, not the middleware.
+size_t heap_allocations();
+
+// Heap allocations made during the lifetime of the object.
+class ScopedAllocationCount
+{
+public:
+  ScopedAllocationCount()
+  : start_(heap_allocations()) {}
+
+  size_t count() const {return heap_allocations() - start_;}
+
+private:
+  size_t start_;
+};
+
+}  // namespace amr_comm
+
+#endif  // AMR_COMM__ALLOCATION_COUNTER_HPP_
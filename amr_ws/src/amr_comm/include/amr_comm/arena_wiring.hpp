@@ -0,0 +1,148 @@
+#ifndef AMR_COMM__ARENA_WIRING_HPP_
+#define AMR_COMM__ARENA_WIRING_HPP_
+
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <utility>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/serialized_message.hpp"
+#include "custom_interfaces/message_cdr.hpp"
+#include "amr_comm/cycle_arena.hpp"
+
+// The generated typesupport only handles messages instantiated with
+// std::allocator, so arena messages (Msg_<ArenaAllocator<void>>, whose strings
+// and sequences live in the arena too) cross rmw in serialized form: the
+// publisher writes the CDR bytes into a buffer reused across cycles and the
+// subscription reads them back into the arena, both through
+// custom_interfaces/message_cdr.hpp. Serialized publishing does not go
+// through intra-process communication, which must stay disabled on the node.
+namespace amr_comm
+{
+
+// Msg_<A> -> Msg_<AllocatorT> for a generated message template.
+template<typename MessageT, typename AllocatorT>
+struct rebind_message;
+
+template<template<typename> class MessageTemplate, typename FromT, typename AllocatorT>
+struct rebind_message<MessageTemplate<FromT>, AllocatorT>
+{
+  using type = MessageTemplate<AllocatorT>;
+};
+
+// MessageT with every string and sequence allocated through ArenaAllocator.
+template<typename MessageT>
+using ArenaMessage = typename rebind_message<MessageT, ArenaAllocator<void>>::type;
+
+// Starts a new arena cycle for the next message, or falls back to the heap
+// when something from the previous cycle is still alive: the arena is
+// monotonic, so allocating on without a rewind would only grow it.
+inline std::pmr::memory_resource * begin_arena_cycle(CycleArena & arena)
+{
+  return arena.reset() ? static_cast<std::pmr::memory_resource *>(&arena) :
+         std::pmr::new_delete_resource();
+}
+
+// Hands the executor the same serialized buffer on every take, once the
+// previous message has been returned, so steady-state takes do not allocate.
+class ReusedSerializedMessageStrategy
+  : public rclcpp::message_memory_strategy::MessageMemoryStrategy<rclcpp::SerializedMessage>
+{
+public:
+  std::shared_ptr<rclcpp::SerializedMessage> borrow_serialized_message(size_t capacity) override
+  {
+    if (!buffer_ || buffer_.use_count() != 1) {
+      buffer_ = std::make_shared<rclcpp::SerializedMessage>(capacity);
+    }
+    return buffer_;
+  }
+
+private:
+  std::shared_ptr<rclcpp::SerializedMessage> buffer_;
+};
+
+// Subscription to MessageT whose messages are read into `arena`, one cycle
+// per message; `callback` takes a const ArenaMessage<MessageT> &, valid for
+// the duration of the call. Anything it keeps must be copied into containers
+// of its own, or the arena cannot rewind. `arena` is not thread-safe: give the
+// subscriptions that share it one mutually exclusive callback group through
+// `options`.
+template<typename MessageT, typename CallbackT>
+rclcpp::Subscription<rclcpp::SerializedMessage>::SharedPtr
+create_arena_subscription(
+  rclcpp::Node & node, const std::string & topic, const rclcpp::QoS & qos,
+  CallbackT && callback, CycleArena & arena,
+  const rclcpp::SubscriptionOptions & options = rclcpp::SubscriptionOptions())
+{
+  auto on_message =
+    [callback = std::forward<CallbackT>(callback), &arena, logger = node.get_logger()](
+    std::shared_ptr<rclcpp::SerializedMessage> serialized) mutable
+    {
+      std::pmr::memory_resource * resource = begin_arena_cycle(arena);
+      const auto msg = make_arena_unique<ArenaMessage<MessageT>>(
+        *resource, ArenaAllocator<void>(resource));
+      const rcl_serialized_message_t & data = serialized->get_rcl_serialized_message();
+      if (!custom_interfaces::format::read_cdr(data.buffer, data.buffer_length, *msg)) {
+        RCLCPP_WARN(logger, "dropped a malformed message of %zu bytes", data.buffer_length);
+        return;
+      }
+      const ArenaMessage<MessageT> & received = *msg;
+      callback(received);
+    };
+  return node.create_subscription<MessageT>(
+    topic, qos, std::move(on_message), options,
+    std::make_shared<ReusedSerializedMessageStrategy>());
+}
+
+// Publisher that builds every message in a fresh cycle of `arena` and
+// serializes it into a buffer kept across calls.
+template<typename MessageT>
+class ArenaPublisher
+{
+public:
+  ArenaPublisher(
+    rclcpp::Node & node, const std::string & topic, const rclcpp::QoS & qos, CycleArena & arena)
+  : publisher_(node.create_publisher<MessageT>(topic, qos)), arena_(arena) {}
+
+  // Lets `fill` populate an ArenaMessage<MessageT> and publishes it. Returns
+  // false when the message had to be built on the heap because the arena
+  // could not rewind (see begin_arena_cycle); it is published either way.
+  template<typename FillT>
+  bool publish(FillT && fill)
+  {
+    std::pmr::memory_resource * resource = begin_arena_cycle(arena_);
+    const bool in_arena = resource == &arena_;
+    {
+      auto msg = make_arena_unique<ArenaMessage<MessageT>>(
+        *resource, ArenaAllocator<void>(resource));
+      fill(*msg);
+      serialize(*msg);
+    }
+    publisher_->publish(serialized_);
+    return in_arena;
+  }
+
+  const typename rclcpp::Publisher<MessageT>::SharedPtr & publisher() const {return publisher_;}
+
+private:
+  // Grows the buffer only for a message larger than any before it.
+  void serialize(const ArenaMessage<MessageT> & msg)
+  {
+    rcl_serialized_message_t & data = serialized_.get_rcl_serialized_message();
+    size_t length = custom_interfaces::format::write_cdr(msg, data.buffer, data.buffer_capacity);
+    while (length == 0) {
+      serialized_.reserve(data.buffer_capacity == 0 ? 256 : 2 * data.buffer_capacity);
+      length = custom_interfaces::format::write_cdr(msg, data.buffer, data.buffer_capacity);
+    }
+    data.buffer_length = length;
+  }
+
+  typename rclcpp::Publisher<MessageT>::SharedPtr publisher_;
+  CycleArena & arena_;
+  rclcpp::SerializedMessage serialized_;
+};
+
+}  // namespace amr_comm
+
+#endif  // AMR_COMM__ARENA_WIRING_HPP_
@@ -0,0 +1,40 @@
+#ifndef AMR_COMM__AULA7_FIXED_PUBLISHER_HPP_
+#define AMR_COMM__AULA7_FIXED_PUBLISHER_HPP_
+
+#include <cstdint>
+
+#include "rclcpp/rclcpp.hpp"
+#include "custom_interfaces/msg/aula7_fixed.hpp"
+
+namespace amr_comm
+{
+
+// C++ counterpart of aula7/publisher.py on the fixed-capacity Aula7 message.
+// When the middleware supports loaned messages the sample is written straight
+// into middleware memory; otherwise a message owned by the node is reused, so
+// the steady-state publish path never touches the heap.
+class Aula7FixedPublisher : public rclcpp::Node
+{
+public:
+  using Aula7Fixed = custom_interfaces::msg::Aula7Fixed;
+
+  explicit Aula7FixedPublisher(const rclcpp::NodeOptions & options = rclcpp::NodeOptions());
+
+  // Publishes the next count and returns it.
+  int32_t publish_once();
+
+  bool uses_loaned_messages() const;
+
+private:
+  void timer_callback();
+  void fill(Aula7Fixed & msg) const;
+
+  rclcpp::Publisher<Aula7Fixed>::SharedPtr publisher_;
+  rclcpp::TimerBase::SharedPtr timer_;
+  Aula7Fixed message_;
+  int32_t contador_;
+};
+
+}  // namespace amr_comm
+
+#endif  // AMR_COMM__AULA7_FIXED_PUBLISHER_HPP_
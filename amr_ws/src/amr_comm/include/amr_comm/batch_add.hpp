@@ -0,0 +1,25 @@
+#ifndef AMR_COMM__BATCH_ADD_HPP_
+#define AMR_COMM__BATCH_ADD_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace amr_comm
+{
+
+// out[i] = a[i] + b[i], wrapping around on overflow: the operands come from
+// clients, and signed overflow would be undefined, so the sum is taken in
+// uint64_t. Written as a plain loop over non-aliasing pointers so the
+// compiler vectorizes it (-O3, as in Release builds).
+inline void add_arrays(
+  const int64_t * __restrict a, const int64_t * __restrict b,
+  int64_t * __restrict out, size_t count)
+{
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = static_cast<int64_t>(static_cast<uint64_t>(a[i]) + static_cast<uint64_t>(b[i]));
+  }
+}
+
+}  // namespace amr_comm
+
+#endif  // AMR_COMM__BATCH_ADD_HPP_
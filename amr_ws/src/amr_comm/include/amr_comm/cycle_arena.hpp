@@ -0,0 +1,190 @@
+#ifndef AMR_COMM__CYCLE_ARENA_HPP_
+#define AMR_COMM__CYCLE_ARENA_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace amr_comm
+{
+
+// Forwards to another resource and counts what goes through it.
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+  explicit CountingResource(std::pmr::memory_resource * upstream = std::pmr::new_delete_resource())
+  : upstream_(upstream), allocations_(0), bytes_(0) {}
+
+  size_t allocations() const {return allocations_;}
+  size_t bytes() const {return bytes_;}
+
+private:
+  void * do_allocate(size_t bytes, size_t alignment) override
+  {
+    ++allocations_;
+    bytes_ += bytes;
+    return upstream_->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void * p, size_t bytes, size_t alignment) override
+  {
+    upstream_->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override
+  {
+    return this == &other;
+  }
+
+  std::pmr::memory_resource * upstream_;
+  size_t allocations_;
+  size_t bytes_;
+};
+
+// Monotonic arena over a buffer allocated once up front. Allocation is a
+// pointer bump and deallocation only drops a live-block count; reset()
+// rewinds the whole buffer at a cycle boundary once nothing allocated in the
+// previous cycle is still alive. Requests that do not fit spill to the heap
+// and are counted as overflows, so a correctly sized arena reports zero.
+// Not thread-safe: use one arena per callback group.
+class CycleArena : public std::pmr::memory_resource
+{
+public:
+  explicit CycleArena(size_t capacity)
+  : buffer_(capacity),
+    monotonic_(buffer_.data(), buffer_.size(), &overflow_),
+    live_blocks_(0), used_bytes_(0), high_water_bytes_(0), cycles_(0), skipped_resets_(0) {}
+
+  CycleArena(const CycleArena &) = delete;
+  CycleArena & operator=(const CycleArena &) = delete;
+
+  // Starts a new cycle. Returns false, leaving the arena untouched, while
+  // blocks from the current cycle are still alive.
+  bool reset()
+  {
+    if (live_blocks_ != 0) {
+      ++skipped_resets_;
+      return false;
+    }
+    monotonic_.release();
+    used_bytes_ = 0;
+    ++cycles_;
+    return true;
+  }
+
+  size_t capacity() const {return buffer_.size();}
+  size_t live_blocks() const {return live_blocks_;}
+  size_t high_water_bytes() const {return high_water_bytes_;}
+  size_t cycles() const {return cycles_;}
+  size_t skipped_resets() const {return skipped_resets_;}
+  size_t overflow_allocations() const {return overflow_.allocations();}
+
+private:
+  void * do_allocate(size_t bytes, size_t alignment) override
+  {
+    void * p = monotonic_.allocate(bytes, alignment);
+    ++live_blocks_;
+    used_bytes_ += bytes;
+    if (used_bytes_ > high_water_bytes_) {
+      high_water_bytes_ = used_bytes_;
+    }
+    return p;
+  }
+
+  void do_deallocate(void *, size_t, size_t) override
+  {
+    --live_blocks_;
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override
+  {
+    return this == &other;
+  }
+
+  std::vector<std::byte> buffer_;
+  CountingResource overflow_;
+  std::pmr::monotonic_buffer_resource monotonic_;
+  size_t live_blocks_;
+  size_t used_bytes_;
+  size_t high_water_bytes_;
+  size_t cycles_;
+  size_t skipped_resets_;
+};
+
+// Standard allocator over a memory_resource. Unlike
+// std::pmr::polymorphic_allocator it provides the nested `rebind` that the
+// generated message templates (Msg_<ContainerAllocator>) and rclcpp expect.
+template<typename T>
+class ArenaAllocator
+{
+public:
+  using value_type = T;
+
+  template<typename U>
+  struct rebind
+  {
+    using other = ArenaAllocator<U>;
+  };
+
+  explicit ArenaAllocator(std::pmr::memory_resource * resource) noexcept
+  : resource_(resource) {}
+
+  template<typename U>
+  ArenaAllocator(const ArenaAllocator<U> & other) noexcept  // NOLINT(runtime/explicit)
+  : resource_(other.resource()) {}
+
+  T * allocate(size_t n)
+  {
+    return static_cast<T *>(resource_->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T * p, size_t n)
+  {
+    resource_->deallocate(p, n * sizeof(T), alignof(T));
+  }
+
+  std::pmr::memory_resource * resource() const noexcept {return resource_;}
+
+private:
+  std::pmr::memory_resource * resource_;
+};
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T> & a, const ArenaAllocator<U> & b) noexcept
+{
+  return a.resource() == b.resource();
+}
+
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T> & a, const ArenaAllocator<U> & b) noexcept
+{
+  return !(a == b);
+}
+
+// unique_ptr for objects constructed in an arena.
+template<typename T>
+struct ArenaDeleter
+{
+  std::pmr::memory_resource * resource;
+
+  void operator()(T * p) const
+  {
+    p->~T();
+    resource->deallocate(p, sizeof(T), alignof(T));
+  }
+};
+
+template<typename T>
+using ArenaUniquePtr = std::unique_ptr<T, ArenaDeleter<T>>;
+
+template<typename T, typename ... Args>
+ArenaUniquePtr<T> make_arena_unique(std::pmr::memory_resource & resource, Args && ... args)
+{
+  void * p = resource.allocate(sizeof(T), alignof(T));
+  return ArenaUniquePtr<T>(new (p) T(std::forward<Args>(args)...), ArenaDeleter<T>{&resource});
+}
+
+}  // namespace amr_comm
+
+#endif  // AMR_COMM__CYCLE_ARENA_HPP_
@@ -0,0 +1,40 @@
+#ifndef AMR_COMM__FIXED_TEXT_HPP_
+#define AMR_COMM__FIXED_TEXT_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace amr_comm
+{
+
+// Helpers for messages that carry text as a `uint8[N] message` array plus a
+// `uint8 message_length` field, such as custom_interfaces/msg/Aula7Fixed.
+// Text longer than the array is truncated.
+
+template<typename MessageT>
+inline void set_text(MessageT & msg, const char * text, std::size_t length)
+{
+  const std::size_t n = std::min(length, msg.message.size());
+  std::memcpy(msg.message.data(), text, n);
+  msg.message_length = static_cast<uint8_t>(n);
+}
+
+template<typename MessageT>
+inline void set_text(MessageT & msg, const char * text)
+{
+  set_text(msg, text, std::strlen(text));
+}
+
+template<typename MessageT>
+inline std::string get_text(const MessageT & msg)
+{
+  const std::size_t n = std::min<std::size_t>(msg.message_length, msg.message.size());
+  return std::string(reinterpret_cast<const char *>(msg.message.data()), n);
+}
+
+}  // namespace amr_comm
+
+#endif  // AMR_COMM__FIXED_TEXT_HPP_
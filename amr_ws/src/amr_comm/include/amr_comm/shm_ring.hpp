@@ -0,0 +1,62 @@
+#ifndef AMR_COMM__SHM_RING_HPP_
+#define AMR_COMM__SHM_RING_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace amr_comm
+{
+
+// Single-producer, single-consumer ring of fixed-size slots in POSIX shared
+// memory (/dev/shm). Works between processes, and between containers that
+// share the host IPC namespace (`ipc: host` in docker-compose.yaml).
+// Writers fill a slot in place and commit it; readers get a pointer into the
+// slot and release it, so payloads are never copied by the transport.
+class ShmRing
+{
+public:
+  // Creates (or replaces) the segment; it is unlinked again on destruction.
+  static std::unique_ptr<ShmRing> create(
+    const std::string & name, size_t slot_size, size_t slot_count);
+  // Maps an existing segment; returns nullptr when it does not exist yet.
+  // Throws std::runtime_error when its header describes slots that do not
+  // fit in the segment.
+  static std::unique_ptr<ShmRing> open(const std::string & name);
+
+  ~ShmRing();
+  ShmRing(const ShmRing &) = delete;
+  ShmRing & operator=(const ShmRing &) = delete;
+
+  // Returns the next free slot, or nullptr when the ring is full.
+  void * try_begin_write();
+  // Publishes the slot returned by try_begin_write().
+  void commit_write(size_t size, uint64_t stamp_ns);
+
+  // Returns the oldest unread slot, or nullptr when the ring is empty.
+  const void * try_begin_read(size_t & size, uint64_t & stamp_ns);
+  // Hands the slot returned by try_begin_read() back to the writer.
+  void end_read();
+
+  size_t slot_size() const;
+  size_t slot_count() const;
+
+private:
+  struct Header;
+  struct Slot;
+
+  ShmRing(const std::string & name, void * base, size_t mapped_size, bool owner);
+  Slot * slot(uint64_t index) const;
+
+  std::string name_;
+  void * base_;
+  size_t mapped_size_;
+  bool owner_;
+  Header * header_;
+  size_t stride_;
+};
+
+}  // namespace amr_comm
+
+#endif  // AMR_COMM__SHM_RING_HPP_
@@ -0,0 +1,70 @@
+#include "amr_comm/add_many_client.hpp"
+
+#include <utility>
+
+namespace amr_comm
+{
+
+AddManyClient::AddManyClient(
+  rclcpp::Node * node, const std::string & service_name, size_t max_in_flight)
+: client_(node->create_client<AddMany>(service_name)),
+  max_in_flight_(max_in_flight == 0 ? 1 : max_in_flight),
+  in_flight_(0)
+{
+}
+
+bool AddManyClient::wait_for_service(std::chrono::nanoseconds timeout)
+{
+  return client_->wait_for_service(timeout);
+}
+
+void AddManyClient::add_many(
+  std::vector<int64_t> a, std::vector<int64_t> b, Callback callback)
+{
+  auto request = std::make_shared<AddMany::Request>();
+  request->a = std::move(a);
+  request->b = std::move(b);
+  std::lock_guard<std::mutex> lock(mutex_);
+  pending_.push_back(Batch{request, std::move(callback)});
+  send_pending_locked();
+}
+
+size_t AddManyClient::in_flight() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return in_flight_;
+}
+
+size_t AddManyClient::pending() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pending_.size();
+}
+
+void AddManyClient::send_pending_locked()
+{
+  while (in_flight_ < max_in_flight_ && !pending_.empty()) {
+    Batch batch = std::move(pending_.front());
+    pending_.pop_front();
+    ++in_flight_;
+    Callback callback = std::move(batch.callback);
+    client_->async_send_request(
+      batch.request,
+      [this, callback](rclcpp::Client<AddMany>::SharedFuture future) {
+        on_response(callback, future);
+      });
+  }
+}
+
+void AddManyClient::on_response(
+  const Callback & callback, rclcpp::Client<AddMany>::SharedFuture future)
+{
+  if (callback) {
+    callback(future.get()->sum);
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  --in_flight_;
+  send_pending_locked();
+}
+
+}  // namespace amr_comm
@@ -0,0 +1,70 @@
+// Throughput check for the AddMany service:
+//   ros2 run amr_comm add_many_client <total_ops> <batch_size> <max_in_flight>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "amr_comm/add_many_client.hpp"
+
+int main(int argc, char ** argv)
+{
+  const size_t total_ops = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+  const size_t batch_size = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000;
+  const size_t max_in_flight = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 8;
+  if (batch_size == 0 || max_in_flight == 0) {
+    std::fprintf(
+      stderr, "usage: %s <total_ops> <batch_size> <max_in_flight>\n"
+      "batch_size and max_in_flight must be positive\n", argv[0]);
+    return 2;
+  }
+
+  rclcpp::init(argc, argv);
+  auto node = std::make_shared<rclcpp::Node>("add_many_srv_client");
+
+  amr_comm::AddManyClient client(node.get(), "add_many_srv", max_in_flight);
+  while (!client.wait_for_service(std::chrono::seconds(1))) {
+    if (!rclcpp::ok()) {
+      return 1;
+    }
+    RCLCPP_INFO(node->get_logger(), "Service not available, waiting...");
+  }
+
+  size_t completed = 0;
+  size_t wrong = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t first = 0; first < total_ops; first += batch_size) {
+    const size_t count = std::min(batch_size, total_ops - first);
+    std::vector<int64_t> a(count);
+    std::vector<int64_t> b(count);
+    for (size_t i = 0; i < count; ++i) {
+      a[i] = static_cast<int64_t>(first + i);
+      b[i] = 1;
+    }
+    client.add_many(
+      std::move(a), std::move(b),
+      [&completed, &wrong, first](const std::vector<int64_t> & sum) {
+        for (size_t i = 0; i < sum.size(); ++i) {
+          if (sum[i] != static_cast<int64_t>(first + i + 1)) {
+            ++wrong;
+          }
+        }
+        completed += sum.size();
+      });
+  }
+  while (rclcpp::ok() && completed < total_ops) {
+    rclcpp::spin_some(node);
+  }
+  const double seconds = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count();
+
+  RCLCPP_INFO(
+    node->get_logger(), "%zu additions in %.3f s (%.0f ops/s), %zu wrong results",
+    completed, seconds, completed / seconds, wrong);
+  rclcpp::shutdown();
+  return wrong == 0 ? 0 : 1;
+}
@@ -0,0 +1,34 @@
+#include "amr_comm/add_many_server.hpp"
+
+#include <algorithm>
+
+#include "amr_comm/batch_add.hpp"
+
+namespace amr_comm
+{
+
+AddManyServer::AddManyServer(const rclcpp::NodeOptions & options)
+: Node("add_many_srv_server", options)
+{
+  srv_ = create_service<AddMany>(
+    "add_many_srv",
+    std::bind(
+      &AddManyServer::srv_callback, this,
+      std::placeholders::_1, std::placeholders::_2));
+}
+
+void AddManyServer::srv_callback(
+  const std::shared_ptr<AddMany::Request> request,
+  std::shared_ptr<AddMany::Response> response)
+{
+  if (request->a.size() != request->b.size()) {
+    RCLCPP_WARN(
+      get_logger(), "Operand arrays differ in length (%zu, %zu), adding the common prefix",
+      request->a.size(), request->b.size());
+  }
+  const size_t count = std::min(request->a.size(), request->b.size());
+  response->sum.resize(count);
+  add_arrays(request->a.data(), request->b.data(), response->sum.data(), count);
+}
+
+}  // namespace amr_comm
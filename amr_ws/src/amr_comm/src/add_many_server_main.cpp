@@ -0,0 +1,12 @@
+#include <memory>
+
+#include "rclcpp/rclcpp.hpp"
+#include "amr_comm/add_many_server.hpp"
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  rclcpp::spin(std::make_shared<amr_comm::AddManyServer>());
+  rclcpp::shutdown();
+  return 0;
+}
@@ -0,0 +1,150 @@
+#include "amr_comm/allocation_counter.hpp"
+
+#include <stdlib.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<size_t> g_allocations{0};
+
+void * counted_malloc(std::size_t size) noexcept
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void * counted_aligned_malloc(std::size_t size, std::align_val_t alignment) noexcept
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  // posix_memalign wants a multiple of sizeof(void *); its memory goes back
+  // through free() like the rest.
+  std::size_t align = static_cast<std::size_t>(alignment);
+  if (align < sizeof(void *)) {
+    align = sizeof(void *);
+  }
+  void * ptr = nullptr;
+  return posix_memalign(&ptr, align, size == 0 ? 1 : size) == 0 ? ptr : nullptr;
+}
+
+void * checked(void * ptr)
+{
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+}  // namespace
+
+namespace amr_comm
+{
+
+size_t heap_allocations()
+{
+  return g_allocations.load(std::memory_order_relaxed);
+}
+
+}  // namespace amr_comm
+
+void * operator new(std::size_t size)
+{
+  return checked(counted_malloc(size));
+}
+
+void * operator new[](std::size_t size)
+{
+  return checked(counted_malloc(size));
+}
+
+void * operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+  return counted_malloc(size);
+}
+
+void * operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+  return counted_malloc(size);
+}
+
+void * operator new(std::size_t size, std::align_val_t alignment)
+{
+  return checked(counted_aligned_malloc(size, alignment));
+}
+
+void * operator new[](std::size_t size, std::align_val_t alignment)
+{
+  return checked(counted_aligned_malloc(size, alignment));
+}
+
+void * operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+  return counted_aligned_malloc(size, alignment);
+}
+
+void * operator new[](
+  std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+  return counted_aligned_malloc(size, alignment);
+}
+
+void operator delete(void * ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void * ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void * ptr, const std::nothrow_t &) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void * ptr, const std::nothrow_t &) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void * ptr, std::align_val_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::align_val_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t, std::align_val_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::size_t, std::align_val_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void * ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+  std::free(ptr);
+}
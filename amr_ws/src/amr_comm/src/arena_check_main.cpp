@@ -0,0 +1,128 @@
+// Publishes and receives ScanSectors (a frame_id string and four sequences)
+// through CycleArena-backed wiring and reports the heap allocations seen
+// inside the callbacks once warmed up:
+//   ros2 run amr_comm arena_check [cycles]
+
+#include <cstdlib>
+#include <memory>
+
+#include "rclcpp/rclcpp.hpp"
+#include "custom_interfaces/msg/scan_sectors.hpp"
+#include "amr_comm/allocation_counter.hpp"
+#include "amr_comm/arena_wiring.hpp"
+
+namespace
+{
+
+using ScanSectors = custom_interfaces::msg::ScanSectors;
+using ArenaScanSectors = amr_comm::ArenaMessage<ScanSectors>;
+
+constexpr size_t kWarmupCycles = 100;
+// 10 degree sectors over a full turn.
+constexpr size_t kSectors = 36;
+
+class ArenaCheck : public rclcpp::Node
+{
+public:
+  explicit ArenaCheck(size_t cycles)
+  : Node("arena_check"),
+    publish_arena_(4096), receive_arena_(4096),
+    publisher_(*this, "arena_scan_sectors", 10, publish_arena_),
+    cycles_(cycles), published_(0), received_(0), heap_publishes_(0),
+    publish_allocations_(0), receive_allocations_(0), last_forward_clearance_(0.0f)
+  {
+    subscription_ = amr_comm::create_arena_subscription<ScanSectors>(
+      *this, "arena_scan_sectors", 10,
+      [this](const ArenaScanSectors & msg) {receive_callback(msg);},
+      receive_arena_);
+    timer_ = create_wall_timer(
+      std::chrono::milliseconds(10), [this]() {publish_callback();});
+  }
+
+  bool done() const {return received_ >= cycles_;}
+
+  bool report() const
+  {
+    RCLCPP_INFO(
+      get_logger(),
+      "published %zu (%zu on the heap), received %zu; steady-state heap allocations: "
+      "publish %zu, receive %zu; arena overflows: publish %zu, receive %zu; arena high water: "
+      "publish %zu B, receive %zu B; skipped resets: publish %zu, receive %zu",
+      published_, heap_publishes_, received_, publish_allocations_, receive_allocations_,
+      publish_arena_.overflow_allocations(), receive_arena_.overflow_allocations(),
+      publish_arena_.high_water_bytes(), receive_arena_.high_water_bytes(),
+      publish_arena_.skipped_resets(), receive_arena_.skipped_resets());
+    return publish_allocations_ == 0 && receive_allocations_ == 0;
+  }
+
+private:
+  void publish_callback()
+  {
+    amr_comm::ScopedAllocationCount allocations;
+    const bool in_arena = publisher_.publish(
+      [this](ArenaScanSectors & msg) {
+        const builtin_interfaces::msg::Time stamp = now();
+        msg.header.stamp.sec = stamp.sec;
+        msg.header.stamp.nanosec = stamp.nanosec;
+        msg.header.frame_id = "base_laser_link";
+        msg.angle_min = -3.14159274f;
+        msg.sector_width = 0.174532925f;
+        msg.min_range.reserve(kSectors);
+        msg.mean_range.reserve(kSectors);
+        msg.argmin.reserve(kSectors);
+        msg.valid_count.reserve(kSectors);
+        for (size_t i = 0; i < kSectors; ++i) {
+          msg.min_range.push_back(0.5f + 0.01f * static_cast<float>((published_ + i) % 100));
+          msg.mean_range.push_back(1.5f);
+          msg.argmin.push_back(static_cast<uint32_t>(i * 10));
+          msg.valid_count.push_back(10);
+        }
+        msg.forward_clearance = msg.min_range[kSectors / 2];
+      });
+    ++published_;
+    if (!in_arena) {
+      ++heap_publishes_;
+    }
+    if (published_ > kWarmupCycles) {
+      publish_allocations_ += allocations.count();
+    }
+  }
+
+  void receive_callback(const ArenaScanSectors & msg)
+  {
+    amr_comm::ScopedAllocationCount allocations;
+    last_forward_clearance_ = msg.forward_clearance;
+    ++received_;
+    if (received_ > kWarmupCycles) {
+      receive_allocations_ += allocations.count();
+    }
+  }
+
+  amr_comm::CycleArena publish_arena_;
+  amr_comm::CycleArena receive_arena_;
+  amr_comm::ArenaPublisher<ScanSectors> publisher_;
+  rclcpp::Subscription<rclcpp::SerializedMessage>::SharedPtr subscription_;
+  rclcpp::TimerBase::SharedPtr timer_;
+  const size_t cycles_;
+  size_t published_;
+  size_t received_;
+  size_t heap_publishes_;
+  size_t publish_allocations_;
+  size_t receive_allocations_;
+  float last_forward_clearance_;
+};
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  const size_t cycles = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+  auto node = std::make_shared<ArenaCheck>(cycles + kWarmupCycles);
+  while (rclcpp::ok() && !node->done()) {
+    rclcpp::spin_some(node);
+  }
+  const bool clean = node->report();
+  rclcpp::shutdown();
+  return clean ? 0 : 1;
+}
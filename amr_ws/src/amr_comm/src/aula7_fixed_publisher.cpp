@@ -0,0 +1,65 @@
+#include "amr_comm/aula7_fixed_publisher.hpp"
+
+#include <chrono>
+#include <type_traits>
+
+#include "amr_comm/fixed_text.hpp"
+
+namespace amr_comm
+{
+
+static_assert(
+  std::is_trivially_copyable<custom_interfaces::msg::Aula7Fixed>::value,
+  "Aula7Fixed must stay plain-old-data to be loanable");
+
+namespace
+{
+constexpr char kText[] = "The count is: ";
+}  // namespace
+
+Aula7FixedPublisher::Aula7FixedPublisher(const rclcpp::NodeOptions & options)
+: Node("aula7_fixed_publisher", options),
+  contador_(0)
+{
+  const double period = declare_parameter("period", 1.0);
+  publisher_ = create_publisher<Aula7Fixed>("aula7_fixed_topic", 10);
+  timer_ = create_wall_timer(
+    std::chrono::duration<double>(period),
+    std::bind(&Aula7FixedPublisher::timer_callback, this));
+  RCLCPP_INFO(
+    get_logger(), "Publishing Aula7Fixed with %s",
+    uses_loaned_messages() ? "loaned messages" : "a reused message");
+}
+
+bool Aula7FixedPublisher::uses_loaned_messages() const
+{
+  return publisher_->can_loan_messages();
+}
+
+void Aula7FixedPublisher::fill(Aula7Fixed & msg) const
+{
+  msg.count = contador_;
+  set_text(msg, kText, sizeof(kText) - 1);
+}
+
+int32_t Aula7FixedPublisher::publish_once()
+{
+  contador_ += 1;
+  if (uses_loaned_messages()) {
+    auto loaned = publisher_->borrow_loaned_message();
+    fill(loaned.get());
+    publisher_->publish(std::move(loaned));
+  } else {
+    fill(message_);
+    publisher_->publish(message_);
+  }
+  return contador_;
+}
+
+void Aula7FixedPublisher::timer_callback()
+{
+  const int32_t count = publish_once();
+  RCLCPP_INFO(get_logger(), "Publishing: \"%s%i\"", kText, count);
+}
+
+}  // namespace amr_comm
@@ -0,0 +1,12 @@
+#include <memory>
+
+#include "rclcpp/rclcpp.hpp"
+#include "amr_comm/aula7_fixed_publisher.hpp"
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  rclcpp::spin(std::make_shared<amr_comm::Aula7FixedPublisher>());
+  rclcpp::shutdown();
+  return 0;
+}
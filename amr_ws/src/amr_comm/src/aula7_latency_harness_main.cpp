@@ -0,0 +1,230 @@
+// Latency and throughput sweep over Aula7 publish/subscribe, the message
+// type of aula7/publisher.py. Every combination of executor, reliability,
+// history depth, payload size and publish rate runs for `duration` seconds
+// with a fresh publisher and subscription, both in this process but with
+// intra-process communication off, so every sample goes through the RMW.
+//
+//   ros2 run amr_comm aula7_latency_harness --ros-args \
+//     -p rates:="[100.0, 1000.0, 0.0]" -p payload_sizes:="[16, 1024]"
+//
+// A rate of 0 publishes as fast as possible. Results are printed as CSV: one
+// row per run, then the highest sustained rate of every configuration
+// (loss <= max_loss and achieved rate >= 95 % of the requested one).
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "custom_interfaces/msg/aula7.hpp"
+
+namespace
+{
+
+using custom_interfaces::msg::Aula7;
+
+struct RunConfig
+{
+  std::string executor;
+  std::string reliability;
+  int64_t depth;  // 0 means keep all
+  int64_t payload;
+  double rate_hz;
+};
+
+struct RunResult
+{
+  size_t sent = 0;
+  size_t received = 0;
+  double p50_us = 0.0;
+  double p99_us = 0.0;
+  double p999_us = 0.0;
+  double achieved_hz = 0.0;
+};
+
+int64_t now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double percentile_us(const std::vector<int64_t> & sorted_ns, double p)
+{
+  if (sorted_ns.empty()) {
+    return 0.0;
+  }
+  const size_t index = std::min(
+    sorted_ns.size() - 1, static_cast<size_t>(p * (sorted_ns.size() - 1) + 0.5));
+  return sorted_ns[index] / 1e3;
+}
+
+std::shared_ptr<rclcpp::Executor> make_executor(const std::string & type)
+{
+  if (type == "multi") {
+    return std::make_shared<rclcpp::executors::MultiThreadedExecutor>();
+  }
+  if (type == "static") {
+    return std::make_shared<rclcpp::executors::StaticSingleThreadedExecutor>();
+  }
+  return std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+}
+
+rclcpp::QoS make_qos(const RunConfig & config)
+{
+  rclcpp::QoS qos = config.depth > 0 ?
+    rclcpp::QoS(rclcpp::KeepLast(config.depth)) : rclcpp::QoS(rclcpp::KeepAll());
+  if (config.reliability == "best_effort") {
+    qos.best_effort();
+  } else {
+    qos.reliable();
+  }
+  return qos;
+}
+
+RunResult run_once(
+  const std::string & topic, const RunConfig & config, double duration_s, size_t max_messages)
+{
+  // Send stamps and latencies are indexed by Aula7.count, so callbacks running
+  // concurrently on the multi-threaded executor never share a slot.
+  std::vector<int64_t> sent_ns(max_messages, 0);
+  std::vector<int64_t> latency_ns(max_messages, -1);
+  std::atomic<size_t> received{0};
+
+  auto sub_node = std::make_shared<rclcpp::Node>("aula7_harness_subscriber");
+  auto pub_node = std::make_shared<rclcpp::Node>("aula7_harness_publisher");
+  const rclcpp::QoS qos = make_qos(config);
+  auto subscription = sub_node->create_subscription<Aula7>(
+    topic, qos,
+    [&](const Aula7::SharedPtr msg) {
+      const int64_t now = now_ns();
+      const size_t seq = static_cast<size_t>(msg->count);
+      if (seq < max_messages && sent_ns[seq] != 0) {
+        latency_ns[seq] = now - sent_ns[seq];
+        received.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  auto publisher = pub_node->create_publisher<Aula7>(topic, qos);
+
+  auto executor = make_executor(config.executor);
+  executor->add_node(sub_node);
+  std::thread spinner([&executor]() {executor->spin();});
+
+  // Give discovery a moment so the first samples are not lost to matching.
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+  Aula7 msg;
+  msg.message.assign(static_cast<size_t>(config.payload), 'x');
+  const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+    std::chrono::duration<double>(config.rate_hz > 0.0 ? 1.0 / config.rate_hz : 0.0));
+  const auto start = std::chrono::steady_clock::now();
+  const auto end = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+    std::chrono::duration<double>(duration_s));
+  auto next = start;
+  size_t sent = 0;
+  while (sent < max_messages && std::chrono::steady_clock::now() < end) {
+    if (config.rate_hz > 0.0) {
+      std::this_thread::sleep_until(next);
+      next += period;
+    }
+    msg.count = static_cast<int32_t>(sent);
+    sent_ns[sent] = now_ns();
+    publisher->publish(msg);
+    ++sent;
+  }
+  const double elapsed_s = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count();
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  executor->cancel();
+  spinner.join();
+
+  RunResult result;
+  result.sent = sent;
+  result.received = received.load();
+  result.achieved_hz = elapsed_s > 0.0 ? result.received / elapsed_s : 0.0;
+  std::vector<int64_t> samples;
+  samples.reserve(result.received);
+  for (size_t i = 0; i < sent; ++i) {
+    if (latency_ns[i] >= 0) {
+      samples.push_back(latency_ns[i]);
+    }
+  }
+  std::sort(samples.begin(), samples.end());
+  result.p50_us = percentile_us(samples, 0.5);
+  result.p99_us = percentile_us(samples, 0.99);
+  result.p999_us = percentile_us(samples, 0.999);
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  auto params = std::make_shared<rclcpp::Node>("aula7_latency_harness");
+  const std::string topic = params->declare_parameter("topic", std::string("aula7_bench_topic"));
+  const double duration = params->declare_parameter("duration", 2.0);
+  const double max_loss = params->declare_parameter("max_loss", 0.01);
+  const int64_t max_messages = params->declare_parameter("max_messages", 1000000);
+  const auto executors = params->declare_parameter(
+    "executors", std::vector<std::string>{"single", "multi", "static"});
+  const auto reliabilities = params->declare_parameter(
+    "reliabilities", std::vector<std::string>{"reliable", "best_effort"});
+  const auto depths = params->declare_parameter(
+    "depths", std::vector<int64_t>{1, 10, 100});
+  const auto payload_sizes = params->declare_parameter(
+    "payload_sizes", std::vector<int64_t>{16, 1024, 65536});
+  const auto rates = params->declare_parameter(
+    "rates", std::vector<double>{10.0, 100.0, 1000.0, 10000.0, 0.0});
+
+  std::vector<std::string> summary;
+  std::printf(
+    "executor,reliability,depth,payload_bytes,rate_hz,sent,received,loss,"
+    "p50_us,p99_us,p999_us,achieved_hz\n");
+  for (const auto & executor : executors) {
+    for (const auto & reliability : reliabilities) {
+      for (int64_t depth : depths) {
+        for (int64_t payload : payload_sizes) {
+          double sustained_hz = 0.0;
+          for (double rate : rates) {
+            if (!rclcpp::ok()) {
+              break;
+            }
+            const RunConfig config{executor, reliability, depth, payload, rate};
+            const RunResult r = run_once(
+              topic, config, duration, static_cast<size_t>(max_messages));
+            const double loss = r.sent > 0 ? 1.0 - static_cast<double>(r.received) / r.sent : 1.0;
+            std::printf(
+              "%s,%s,%ld,%ld,%.0f,%zu,%zu,%.4f,%.1f,%.1f,%.1f,%.0f\n",
+              executor.c_str(), reliability.c_str(), static_cast<long>(depth),  // NOLINT
+              static_cast<long>(payload), rate, r.sent, r.received, loss,  // NOLINT
+              r.p50_us, r.p99_us, r.p999_us, r.achieved_hz);
+            std::fflush(stdout);
+            const bool kept_up = rate <= 0.0 || r.achieved_hz >= 0.95 * rate;
+            if (loss <= max_loss && kept_up) {
+              sustained_hz = std::max(sustained_hz, r.achieved_hz);
+            }
+          }
+          char line[256];
+          std::snprintf(
+            line, sizeof(line), "%s,%s,%ld,%ld,%.0f",
+            executor.c_str(), reliability.c_str(), static_cast<long>(depth),  // NOLINT
+            static_cast<long>(payload), sustained_hz);  // NOLINT
+          summary.push_back(line);
+        }
+      }
+    }
+  }
+
+  std::printf("\nexecutor,reliability,depth,payload_bytes,max_sustained_hz\n");
+  for (const auto & line : summary) {
+    std::printf("%s\n", line.c_str());
+  }
+  rclcpp::shutdown();
+  return 0;
+}
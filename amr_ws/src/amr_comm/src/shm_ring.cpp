@@ -0,0 +1,209 @@
+#include "amr_comm/shm_ring.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+namespace amr_comm
+{
+
+namespace
+{
+constexpr uint64_t kMagic = 0x474e4952524d41ull;  // "AMRRING"
+constexpr uint32_t kVersion = 1;
+constexpr size_t kCacheLine = 64;
+
+size_t round_up(size_t value, size_t multiple)
+{
+  return (value + multiple - 1) / multiple * multiple;
+}
+}  // namespace
+
+struct ShmRing::Header
+{
+  std::atomic<uint64_t> magic;
+  uint32_t version;
+  uint32_t reserved;
+  uint64_t slot_size;
+  uint64_t slot_count;
+  alignas(kCacheLine) std::atomic<uint64_t> write_index;
+  alignas(kCacheLine) std::atomic<uint64_t> read_index;
+};
+
+struct ShmRing::Slot
+{
+  uint64_t size;
+  uint64_t stamp_ns;
+  alignas(kCacheLine) unsigned char payload[1];
+};
+
+static_assert(
+  std::atomic<uint64_t>::is_always_lock_free,
+  "the ring needs address-free atomics to be shared between processes");
+
+std::unique_ptr<ShmRing> ShmRing::create(
+  const std::string & name, size_t slot_size, size_t slot_count)
+{
+  if (slot_count == 0) {
+    throw std::invalid_argument("ShmRing needs at least one slot");
+  }
+  const size_t stride = round_up(offsetof(Slot, payload) + slot_size, kCacheLine);
+  const size_t total = round_up(sizeof(Header), kCacheLine) + stride * slot_count;
+
+  shm_unlink(name.c_str());
+  const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0666);
+  if (fd < 0) {
+    throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+  }
+  if (ftruncate(fd, static_cast<off_t>(total)) != 0) {
+    const int error = errno;
+    close(fd);
+    shm_unlink(name.c_str());
+    throw std::system_error(error, std::generic_category(), "ftruncate " + name);
+  }
+  void * base = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  const int error = errno;
+  close(fd);
+  if (base == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    throw std::system_error(error, std::generic_category(), "mmap " + name);
+  }
+
+  Header * header = new (base) Header;
+  header->version = kVersion;
+  header->reserved = 0;
+  header->slot_size = slot_size;
+  header->slot_count = slot_count;
+  header->write_index.store(0, std::memory_order_relaxed);
+  header->read_index.store(0, std::memory_order_relaxed);
+  // The magic is published last; a reader that sees it sees the rest.
+  header->magic.store(kMagic, std::memory_order_release);
+  return std::unique_ptr<ShmRing>(new ShmRing(name, base, total, true));
+}
+
+std::unique_ptr<ShmRing> ShmRing::open(const std::string & name)
+{
+  const int fd = shm_open(name.c_str(), O_RDWR, 0666);
+  if (fd < 0) {
+    if (errno == ENOENT) {
+      return nullptr;
+    }
+    throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+    close(fd);
+    return nullptr;
+  }
+  const size_t total = static_cast<size_t>(info.st_size);
+  void * base = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  const int error = errno;
+  close(fd);
+  if (base == MAP_FAILED) {
+    throw std::system_error(error, std::generic_category(), "mmap " + name);
+  }
+  const Header * header = static_cast<const Header *>(base);
+  if (header->magic.load(std::memory_order_acquire) != kMagic ||
+    header->version != kVersion)
+  {
+    munmap(base, total);
+    return nullptr;
+  }
+  // The header comes from another process: every slot it describes must lie
+  // inside the mapping before any index is turned into an address.
+  const size_t slots_offset = round_up(sizeof(Header), kCacheLine);
+  const uint64_t slot_size = header->slot_size;
+  const uint64_t slot_count = header->slot_count;
+  const bool fits = slot_count != 0 && slots_offset <= total &&
+    slot_size <= total - offsetof(Slot, payload) &&
+    slot_count <= (total - slots_offset) /
+    round_up(offsetof(Slot, payload) + slot_size, kCacheLine);
+  if (!fits) {
+    munmap(base, total);
+    throw std::runtime_error(
+      "shm segment " + name + " is too small for its " + std::to_string(slot_count) +
+      " slots of " + std::to_string(slot_size) + " B");
+  }
+  return std::unique_ptr<ShmRing>(new ShmRing(name, base, total, false));
+}
+
+ShmRing::ShmRing(const std::string & name, void * base, size_t mapped_size, bool owner)
+: name_(name), base_(base), mapped_size_(mapped_size), owner_(owner),
+  header_(static_cast<Header *>(base))
+{
+  stride_ = round_up(offsetof(Slot, payload) + header_->slot_size, kCacheLine);
+}
+
+ShmRing::~ShmRing()
+{
+  munmap(base_, mapped_size_);
+  if (owner_) {
+    shm_unlink(name_.c_str());
+  }
+}
+
+ShmRing::Slot * ShmRing::slot(uint64_t index) const
+{
+  unsigned char * slots =
+    static_cast<unsigned char *>(base_) + round_up(sizeof(Header), kCacheLine);
+  return reinterpret_cast<Slot *>(slots + (index % header_->slot_count) * stride_);
+}
+
+void * ShmRing::try_begin_write()
+{
+  const uint64_t write = header_->write_index.load(std::memory_order_relaxed);
+  const uint64_t read = header_->read_index.load(std::memory_order_acquire);
+  if (write - read >= header_->slot_count) {
+    return nullptr;
+  }
+  return slot(write)->payload;
+}
+
+void ShmRing::commit_write(size_t size, uint64_t stamp_ns)
+{
+  const uint64_t write = header_->write_index.load(std::memory_order_relaxed);
+  Slot * s = slot(write);
+  s->size = size < header_->slot_size ? size : header_->slot_size;
+  s->stamp_ns = stamp_ns;
+  header_->write_index.store(write + 1, std::memory_order_release);
+}
+
+const void * ShmRing::try_begin_read(size_t & size, uint64_t & stamp_ns)
+{
+  const uint64_t read = header_->read_index.load(std::memory_order_relaxed);
+  const uint64_t write = header_->write_index.load(std::memory_order_acquire);
+  if (read == write) {
+    return nullptr;
+  }
+  const Slot * s = slot(read);
+  size = s->size;
+  stamp_ns = s->stamp_ns;
+  return s->payload;
+}
+
+void ShmRing::end_read()
+{
+  const uint64_t read = header_->read_index.load(std::memory_order_relaxed);
+  header_->read_index.store(read + 1, std::memory_order_release);
+}
+
+size_t ShmRing::slot_size() const
+{
+  return header_->slot_size;
+}
+
+size_t ShmRing::slot_count() const
+{
+  return header_->slot_count;
+}
+
+}  // namespace amr_comm
@@ -0,0 +1,105 @@
+// Reader half of the shared-memory ring benchmark. Creates the segment,
+// then prints one CSV row per run sent by shm_ring_talker:
+//   shm_ring_listener [runs] [slot_count] [segment]
+// Latency is measured from the talker's commit to the listener seeing the
+// slot, using CLOCK_MONOTONIC, which all containers on a host share.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "amr_comm/shm_ring.hpp"
+
+namespace
+{
+
+constexpr size_t kMaxPayload = 1920 * 1080 * 3;
+
+uint64_t now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double percentile_us(std::vector<uint64_t> & sorted_ns, double p)
+{
+  if (sorted_ns.empty()) {
+    return 0.0;
+  }
+  const size_t index = std::min(
+    sorted_ns.size() - 1, static_cast<size_t>(p * (sorted_ns.size() - 1) + 0.5));
+  return sorted_ns[index] / 1e3;
+}
+
+// Sum of the first and last byte, 0 for an empty payload.
+unsigned touch(const unsigned char * bytes, size_t size)
+{
+  return size == 0 ? 0 : bytes[0] + bytes[size - 1];
+}
+
+// Keeps the payload reads from being optimized away.
+volatile unsigned checksum_sink;
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  const size_t runs = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 7;
+  const size_t slot_count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4;
+  const std::string segment = argc > 3 ? argv[3] : "/amr_comm_ring";
+
+  auto ring = amr_comm::ShmRing::create(segment, kMaxPayload, slot_count);
+  std::printf("payload_bytes,messages,p50_us,p99_us,p999_us,max_us,msgs_per_s,mbytes_per_s\n");
+  std::fflush(stdout);
+
+  std::vector<uint64_t> latencies;
+  size_t payload = 0;
+  uint64_t first_ns = 0;
+  uint64_t last_ns = 0;
+  unsigned checksum = 0;
+  for (size_t run = 0; run < runs; ) {
+    size_t size = 0;
+    uint64_t stamp_ns = 0;
+    const void * data = ring->try_begin_read(size, stamp_ns);
+    if (data == nullptr) {
+      std::this_thread::yield();
+      continue;
+    }
+    const uint64_t received_ns = now_ns();
+    if (size == 0) {
+      ring->end_read();
+      const size_t messages = latencies.size();
+      std::sort(latencies.begin(), latencies.end());
+      const double seconds = messages > 1 ? (last_ns - first_ns) / 1e9 : 0.0;
+      const double rate = seconds > 0.0 ? (messages - 1) / seconds : 0.0;
+      std::printf(
+        "%zu,%zu,%.2f,%.2f,%.2f,%.2f,%.0f,%.1f\n",
+        payload, messages,
+        percentile_us(latencies, 0.5), percentile_us(latencies, 0.99),
+        percentile_us(latencies, 0.999), percentile_us(latencies, 1.0),
+        rate, rate * payload / 1e6);
+      std::fflush(stdout);
+      latencies.clear();
+      ++run;
+      continue;
+    }
+    // Touch both ends of the payload, as a consumer reading it would.
+    const unsigned char * bytes = static_cast<const unsigned char *>(data);
+    checksum += touch(bytes, size);
+    ring->end_read();
+
+    if (latencies.empty()) {
+      first_ns = received_ns;
+      latencies.reserve(100000);
+    }
+    latencies.push_back(received_ns - stamp_ns);
+    last_ns = received_ns;
+    payload = size;
+  }
+  checksum_sink = checksum;
+  return 0;
+}
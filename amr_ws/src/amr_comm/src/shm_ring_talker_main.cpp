@@ -0,0 +1,85 @@
+// Writer half of the shared-memory ring benchmark. For every payload size,
+// from 4 B up to a 1920x1080 RGB frame, it sends `count` messages (paced at
+// `rate_hz`, or as fast as the ring allows when 0) followed by an empty
+// end-of-run marker:
+//   shm_ring_talker [count] [rate_hz] [segment]
+// Start shm_ring_listener first; it owns the segment.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "amr_comm/shm_ring.hpp"
+
+namespace
+{
+
+constexpr size_t kPayloadSizes[] = {4, 64, 1024, 16384, 262144, 1048576, 1920 * 1080 * 3};
+
+uint64_t now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void * wait_for_slot(amr_comm::ShmRing & ring)
+{
+  void * slot = nullptr;
+  while ((slot = ring.try_begin_write()) == nullptr) {
+    std::this_thread::yield();
+  }
+  return slot;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  const size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+  const double rate_hz = argc > 2 ? std::strtod(argv[2], nullptr) : 0.0;
+  const std::string segment = argc > 3 ? argv[3] : "/amr_comm_ring";
+
+  std::unique_ptr<amr_comm::ShmRing> ring;
+  try {
+    while (!(ring = amr_comm::ShmRing::open(segment))) {
+      std::printf("Waiting for %s, start shm_ring_listener first\n", segment.c_str());
+      std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+  } catch (const std::exception & e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+
+  std::vector<unsigned char> source(ring->slot_size());
+  for (size_t i = 0; i < source.size(); ++i) {
+    source[i] = static_cast<unsigned char>(i);
+  }
+  const auto period = std::chrono::duration<double>(rate_hz > 0.0 ? 1.0 / rate_hz : 0.0);
+
+  for (size_t size : kPayloadSizes) {
+    if (size > ring->slot_size()) {
+      std::printf(
+        "Skipping %zu B payloads, larger than the %zu B slots\n", size, ring->slot_size());
+      continue;
+    }
+    auto next = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+      if (rate_hz > 0.0) {
+        std::this_thread::sleep_until(next);
+        next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(period);
+      }
+      void * slot = wait_for_slot(*ring);
+      std::memcpy(slot, source.data(), size);
+      ring->commit_write(size, now_ns());
+    }
+    wait_for_slot(*ring);
+    ring->commit_write(0, now_ns());
+  }
+  return 0;
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include "rclcpp/rclcpp.hpp"
+#include "amr_comm/allocation_counter.hpp"
+#include "amr_comm/aula7_fixed_publisher.hpp"
+#include "amr_comm/fixed_text.hpp"
+
+using custom_interfaces::msg::Aula7Fixed;
+
+TEST(Aula7Fixed, is_plain_old_data)
+{
+  EXPECT_TRUE(std::is_trivially_copyable<Aula7Fixed>::value);
+  EXPECT_EQ(sizeof(Aula7Fixed), 64u);
+}
+
+TEST(Aula7Fixed, text_round_trip_and_truncation)
+{
+  Aula7Fixed msg;
+  amr_comm::set_text(msg, "The count is: ");
+  EXPECT_EQ(amr_comm::get_text(msg), "The count is: ");
+
+  const std::string long_text(100, 'x');
+  amr_comm::set_text(msg, long_text.c_str());
+  EXPECT_EQ(msg.message_length, msg.message.size());
+  EXPECT_EQ(amr_comm::get_text(msg), std::string(msg.message.size(), 'x'));
+}
+
+class Aula7FixedPublisherTest : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase() {rclcpp::init(0, nullptr);}
+  static void TearDownTestCase() {rclcpp::shutdown();}
+};
+
+TEST_F(Aula7FixedPublisherTest, steady_state_publish_does_not_allocate)
+{
+  auto node = std::make_shared<amr_comm::Aula7FixedPublisher>();
+  // Warm up so lazily created middleware resources are in place.
+  for (int i = 0; i < 10; ++i) {
+    node->publish_once();
+  }
+
+  amr_comm::ScopedAllocationCount allocations;
+  for (int i = 0; i < 1000; ++i) {
+    node->publish_once();
+  }
+  EXPECT_EQ(allocations.count(), 0u);
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "amr_comm/add_many_client.hpp"
+#include "amr_comm/add_many_server.hpp"
+#include "amr_comm/batch_add.hpp"
+
+namespace
+{
+
+constexpr int64_t kMax = std::numeric_limits<int64_t>::max();
+constexpr int64_t kMin = std::numeric_limits<int64_t>::min();
+
+}  // namespace
+
+TEST(BatchAdd, wraps_around_on_overflow)
+{
+  const std::vector<int64_t> a = {kMax, kMin, kMax, -1, 5};
+  const std::vector<int64_t> b = {1, -1, kMax, kMin, -7};
+  std::vector<int64_t> sum(a.size());
+  amr_comm::add_arrays(a.data(), b.data(), sum.data(), a.size());
+  EXPECT_EQ(sum, std::vector<int64_t>({kMin, kMax, -2, kMax, -2}));
+}
+
+// Lengths on both sides of the vector widths the compiler may pick, so the
+// remainder loop is covered too.
+TEST(BatchAdd, matches_element_wise_sum_at_every_length)
+{
+  for (size_t count = 0; count <= 37; ++count) {
+    std::vector<int64_t> a(count);
+    std::vector<int64_t> b(count);
+    for (size_t i = 0; i < count; ++i) {
+      a[i] = static_cast<int64_t>(i * 0x9e3779b97f4a7c15ULL);
+      b[i] = kMax - static_cast<int64_t>(i);
+    }
+    std::vector<int64_t> sum(count, 42);
+    amr_comm::add_arrays(a.data(), b.data(), sum.data(), count);
+    for (size_t i = 0; i < count; ++i) {
+      ASSERT_EQ(
+        static_cast<uint64_t>(sum[i]),
+        static_cast<uint64_t>(a[i]) + static_cast<uint64_t>(b[i])) << i << " of " << count;
+    }
+  }
+}
+
+class AddManyServerTest : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase() {rclcpp::init(0, nullptr);}
+  static void TearDownTestCase() {rclcpp::shutdown();}
+};
+
+// Through the service: wrapped sums come back as they are, and arrays of
+// different lengths are added over their common prefix.
+TEST_F(AddManyServerTest, answers_with_wrapped_sums)
+{
+  auto server = std::make_shared<amr_comm::AddManyServer>();
+  auto node = std::make_shared<rclcpp::Node>("add_many_test_client");
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(server);
+  executor.add_node(node);
+
+  amr_comm::AddManyClient client(node.get(), "add_many_srv", 1);
+  ASSERT_TRUE(client.wait_for_service(std::chrono::seconds(5)));
+  std::vector<std::vector<int64_t>> results;
+  const auto store = [&results](const std::vector<int64_t> & sum) {results.push_back(sum);};
+  client.add_many({kMax, kMin, 2}, {1, -1, 3}, store);
+  client.add_many({1, 2, 3}, {10}, store);
+  client.add_many({}, {}, store);
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (results.size() < 3 && std::chrono::steady_clock::now() < deadline) {
+    executor.spin_some(std::chrono::milliseconds(10));
+  }
+  ASSERT_EQ(results.size(), 3u);
+  EXPECT_EQ(results[0], std::vector<int64_t>({kMin, kMax, 5}));
+  EXPECT_EQ(results[1], std::vector<int64_t>({11}));
+  EXPECT_TRUE(results[2].empty());
+}
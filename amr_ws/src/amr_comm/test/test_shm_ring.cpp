@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "amr_comm/shm_ring.hpp"
+
+namespace
+{
+
+// Unique per process, so parallel test runs do not share segments.
+std::string segment_name(const char * test)
+{
+  return "/amr_comm_test_" + std::string(test) + "_" + std::to_string(getpid());
+}
+
+// Overwrites `size` bytes of the segment at `offset`, as another process could.
+void poke(const std::string & name, size_t offset, const void * bytes, size_t size)
+{
+  const int fd = shm_open(name.c_str(), O_RDWR, 0);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(pwrite(fd, bytes, size, static_cast<off_t>(offset)), static_cast<ssize_t>(size));
+  close(fd);
+}
+
+void resize(const std::string & name, size_t size)
+{
+  const int fd = shm_open(name.c_str(), O_RDWR, 0);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(ftruncate(fd, static_cast<off_t>(size)), 0);
+  close(fd);
+}
+
+// Header layout: u64 magic, u32 version, u32 reserved, u64 slot_size,
+// u64 slot_count.
+constexpr size_t kSlotSizeOffset = 16;
+constexpr size_t kSlotCountOffset = 24;
+
+}  // namespace
+
+TEST(ShmRing, passes_slots_in_order)
+{
+  const std::string name = segment_name("order");
+  auto writer = amr_comm::ShmRing::create(name, 16, 2);
+  auto reader = amr_comm::ShmRing::open(name);
+  ASSERT_TRUE(reader);
+  EXPECT_EQ(reader->slot_size(), 16u);
+  EXPECT_EQ(reader->slot_count(), 2u);
+
+  for (uint64_t i = 0; i < 2; ++i) {
+    void * slot = writer->try_begin_write();
+    ASSERT_NE(slot, nullptr);
+    std::memset(slot, static_cast<int>('a' + i), 16);
+    writer->commit_write(i == 0 ? 3 : 40, 100 + i);
+  }
+  EXPECT_EQ(writer->try_begin_write(), nullptr);
+
+  size_t size = 0;
+  uint64_t stamp_ns = 0;
+  const void * data = reader->try_begin_read(size, stamp_ns);
+  ASSERT_NE(data, nullptr);
+  EXPECT_EQ(size, 3u);
+  EXPECT_EQ(stamp_ns, 100u);
+  EXPECT_EQ(static_cast<const char *>(data)[0], 'a');
+  reader->end_read();
+  data = reader->try_begin_read(size, stamp_ns);
+  ASSERT_NE(data, nullptr);
+  // Sizes are clamped to the slot.
+  EXPECT_EQ(size, 16u);
+  EXPECT_EQ(static_cast<const char *>(data)[15], 'b');
+  reader->end_read();
+  EXPECT_EQ(reader->try_begin_read(size, stamp_ns), nullptr);
+}
+
+TEST(ShmRing, open_returns_null_without_a_segment)
+{
+  EXPECT_EQ(amr_comm::ShmRing::open(segment_name("missing")), nullptr);
+}
+
+TEST(ShmRing, open_rejects_a_header_without_slots)
+{
+  const std::string name = segment_name("no_slots");
+  auto writer = amr_comm::ShmRing::create(name, 64, 4);
+  const uint64_t zero = 0;
+  poke(name, kSlotCountOffset, &zero, sizeof(zero));
+  EXPECT_THROW(amr_comm::ShmRing::open(name), std::runtime_error);
+}
+
+TEST(ShmRing, open_rejects_slots_past_the_end_of_the_segment)
+{
+  const std::string name = segment_name("too_small");
+  auto writer = amr_comm::ShmRing::create(name, 64, 4);
+  ASSERT_TRUE(amr_comm::ShmRing::open(name));
+
+  const uint64_t count = 5;
+  poke(name, kSlotCountOffset, &count, sizeof(count));
+  EXPECT_THROW(amr_comm::ShmRing::open(name), std::runtime_error);
+
+  const uint64_t four = 4;
+  poke(name, kSlotCountOffset, &four, sizeof(four));
+  const uint64_t huge = UINT64_MAX - 8;
+  poke(name, kSlotSizeOffset, &huge, sizeof(huge));
+  EXPECT_THROW(amr_comm::ShmRing::open(name), std::runtime_error);
+
+  const uint64_t size = 64;
+  poke(name, kSlotSizeOffset, &size, sizeof(size));
+  ASSERT_TRUE(amr_comm::ShmRing::open(name));
+  // A segment cut short after the header was written.
+  resize(name, 512);
+  EXPECT_THROW(amr_comm::ShmRing::open(name), std::runtime_error);
+}
@@ -1,10 +1,10 @@
 import rclpy
 from rclpy.node import Node
 from rclpy.action import ActionClient
-from sensor_msgs.msg import LaserScan
 from geometry_msgs.msg import Twist
 from std_srvs.srv import Empty
 from custom_interfaces.action import Rotate
+from custom_interfaces.msg import ScanSectors
 
 class MainNavigationNode(Node):
     def __init__(self):
@@ -16,7 +16,11 @@ class MainNavigationNode(Node):
         self.forward_speed = self.get_parameter('forward_speed').value
         self.rotation_angle = self.get_parameter('rotation_angle').value
         self.vel_pub = self.create_publisher(Twist, 'cmd_vel', 10)
-        self.scan_sub = self.create_subscription(LaserScan, 'scan', self.laser_callback, 10)
+        # scan_reducer (basic_navigation_cpp) reduces each scan in C++. The
+        # middle sector is the front wedge of the scan and forward_clearance
+        # the closest return in the robot's path; a wall is the nearer of both.
+        self.scan_sub = self.create_subscription(
+            ScanSectors, 'scan_sectors', self.laser_callback, 10)
         self.srv = self.create_service(Empty, 'start_navigation', self.start_navigation_callback)
         self.action_client = ActionClient(self, Rotate, 'rotate')
         self.is_navigating = False
@@ -26,15 +30,13 @@ class MainNavigationNode(Node):
     def laser_callback(self, msg):
         if not self.is_navigating:
             return
-        front_angles = len(msg.ranges) // 3
-        middle_start = len(msg.ranges) // 3
-        middle_end = 2 * len(msg.ranges) // 3
-        front_readings = msg.ranges[middle_start:middle_end]
-        min_distance = min(front_readings)
+        min_distance = msg.forward_clearance
+        if msg.min_range:
+            min_distance = min(msg.min_range[len(msg.min_range) // 2], min_distance)
         if not self.is_rotating and min_distance < self.wall_threshold:
             self.get_logger().info(f'Wall detected at {min_distance}m. Starting rotation.')
             self.stop_robot()
-            self.send_rotation_goal()
+            self.send_rotation_goal(msg.header.stamp)
         elif not self.is_rotating:
             self.move_forward()
 
@@ -47,10 +49,12 @@ class MainNavigationNode(Node):
         msg = Twist()
         self.vel_pub.publish(msg)
         
-    def send_rotation_goal(self):
+    def send_rotation_goal(self, scan_stamp):
         self.is_rotating = True
         goal_msg = Rotate.Goal()
         goal_msg.angle = self.rotation_angle
+        goal_msg.scan_stamp_sec = scan_stamp.sec
+        goal_msg.scan_stamp_nanosec = scan_stamp.nanosec
         self.action_client.wait_for_server()
         self.send_goal_future = self.action_client.send_goal_async(
             goal_msg, 
@@ -78,7 +82,8 @@ class MainNavigationNode(Node):
         
     def feedback_callback(self, feedback_msg):
         feedback = feedback_msg.feedback
-        self.get_logger().info(f'Remaining degrees: {feedback.remaining_degrees}')
+        self.get_logger().info(
+            f'Remaining degrees: {feedback.remaining_degrees}', throttle_duration_sec=1.0)
         
     def start_navigation_callback(self, request, response):
         if not self.is_navigating:
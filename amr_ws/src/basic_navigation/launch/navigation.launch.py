@@ -8,11 +8,15 @@ def generate_launch_description():
     forward_speed = LaunchConfiguration('forward_speed', default='0.2')
     rotation_angle = LaunchConfiguration('rotation_angle', default='90.0')
     rotation_speed = LaunchConfiguration('rotation_speed', default='0.5')
+    goal_policy = LaunchConfiguration('goal_policy', default='preempt_latest')
     ld = LaunchDescription()
     ld.add_action(DeclareLaunchArgument('wall_distance_threshold', default_value='0.5'))   
     ld.add_action(DeclareLaunchArgument('forward_speed', default_value='0.2')) 
     ld.add_action(DeclareLaunchArgument('rotation_angle',default_value='90.0'))
     ld.add_action(DeclareLaunchArgument('rotation_speed', default_value='0.5'))
+    # How the rotation server handles a goal that arrives while another is
+    # running: reject_if_busy, preempt_latest, queue or merge_angles.
+    ld.add_action(DeclareLaunchArgument('goal_policy', default_value='preempt_latest'))
     main_node = Node(
     package='basic_navigation',
     executable='main_node',  # este é o nome do entry point, não do .py
@@ -22,19 +26,61 @@ def generate_launch_description():
         'forward_speed': forward_speed,
         'rotation_angle': rotation_angle
     }],
+    remappings=[('cmd_vel', 'cmd_vel/navigation')],
     output='screen'
 )
 
+    # Closed-loop rotation on the IMU yaw, with goal arbitration.
     rotation_server = Node(
-        package='basic_navigation',
-        executable='rotation_action_server',  # idem
+        package='basic_navigation_cpp',
+        executable='rotation_server',
         name='rotation_action_server',
         parameters=[{
-            'rotation_speed': rotation_speed
+            'rotation_speed': rotation_speed,
+            'goal_policy': goal_policy
         }],
+        remappings=[('cmd_vel', 'cmd_vel/rotation')],
         output='screen'
     )
 
+    # Only twist_mux publishes cmd_vel; rotation commands win over driving.
+    twist_mux = Node(
+        package='basic_navigation_cpp',
+        executable='twist_mux',
+        name='twist_mux',
+        parameters=[{
+            'inputs': ['rotation', 'navigation'],
+            'rotation.priority': 100,
+            'rotation.timeout': 0.5,
+            'navigation.priority': 10,
+            'navigation.timeout': 0.5
+        }],
+        output='screen'
+    )
+
+    # Filters /scan once; the reducer and the localization/costmap stacks read
+    # its output.
+    scan_preprocessor = Node(
+        package='basic_navigation_cpp',
+        executable='scan_preprocessor',
+        name='scan_preprocessor',
+        output='screen'
+    )
+
+    scan_reducer = Node(
+        package='basic_navigation_cpp',
+        executable='scan_reducer',
+        name='scan_reducer',
+        parameters=[{
+            'sectors': 3
+        }],
+        remappings=[('scan', 'scan/filtered')],
+        output='screen'
+    )
+
+    ld.add_action(scan_preprocessor)
+    ld.add_action(scan_reducer)
     ld.add_action(main_node)
     ld.add_action(rotation_server)
+    ld.add_action(twist_mux)
     return ld
\ No newline at end of file
@@ -0,0 +1,166 @@
+// Runs N concurrent Aula9 counting goals on one ActionEngine and a
+// single-threaded executor, then cancels all of them. Prints one CSV row per
+// goal count: mean and worst engine tick while every goal is active, and the
+// latency from cancel request to canceled result as seen by the client.
+//
+//   ros2 run basic_navigation_cpp action_engine_benchmark [period_ms]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_action/rclcpp_action.hpp"
+#include "custom_interfaces/action/aula9.hpp"
+#include "basic_navigation_cpp/action_engine.hpp"
+
+namespace
+{
+
+using Aula9 = custom_interfaces::action::Aula9;
+using basic_navigation_cpp::GoalContext;
+using basic_navigation_cpp::GoalStatus;
+
+// aula9/action_server.py as a state machine: one number per tick instead of
+// one per time.sleep(1).
+class CountTask : public basic_navigation_cpp::GoalTask<Aula9>
+{
+public:
+  GoalStatus step(GoalContext<Aula9> & context) override
+  {
+    auto feedback = std::make_shared<Aula9::Feedback>();
+    feedback->current_number = current_;
+    context.publish_feedback(feedback);
+    if (++current_ < context.goal->count_up_to) {
+      return GoalStatus::kRunning;
+    }
+    context.result->final_count = current_;
+    return GoalStatus::kSucceeded;
+  }
+
+  GoalStatus cancel(GoalContext<Aula9> & context) override
+  {
+    context.result->final_count = current_;
+    return GoalStatus::kCanceled;
+  }
+
+private:
+  int32_t current_ = 0;
+};
+
+// `values` must be sorted.
+double percentile_ms(const std::vector<double> & values, double p)
+{
+  if (values.empty()) {
+    return 0.0;
+  }
+  return values[std::min(values.size() - 1, static_cast<size_t>(p * (values.size() - 1) + 0.5))];
+}
+
+void run(size_t goals, std::chrono::milliseconds period)
+{
+  using Clock = std::chrono::steady_clock;
+  using GoalHandle = rclcpp_action::ClientGoalHandle<Aula9>;
+
+  auto server_node = std::make_shared<rclcpp::Node>("engine_benchmark_server");
+  auto client_node = std::make_shared<rclcpp::Node>("engine_benchmark_client");
+  basic_navigation_cpp::ActionEngine<Aula9>::Options options;
+  options.period = period;
+  options.feedback_rate_hz = 1.0;
+  basic_navigation_cpp::ActionEngine<Aula9> engine(
+    server_node.get(), "engine_benchmark",
+    [](const std::shared_ptr<const Aula9::Goal> &) {return std::make_unique<CountTask>();},
+    options);
+  auto client = rclcpp_action::create_client<Aula9>(client_node, "engine_benchmark");
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(server_node);
+  executor.add_node(client_node);
+  const auto spin_until = [&executor](const std::function<bool()> & done, Clock::duration limit) {
+      const auto deadline = Clock::now() + limit;
+      while (!done() && Clock::now() < deadline && rclcpp::ok()) {
+        executor.spin_some(std::chrono::milliseconds(1));
+      }
+      return done();
+    };
+  if (!spin_until(
+      [&client]() {return client->action_server_is_ready();}, std::chrono::seconds(5)))
+  {
+    std::fprintf(stderr, "action server not discovered\n");
+    return;
+  }
+
+  std::vector<GoalHandle::SharedPtr> handles;
+  std::map<rclcpp_action::GoalUUID, Clock::time_point> cancel_sent;
+  std::vector<double> cancel_ms;
+  size_t finished = 0;
+  Aula9::Goal goal;
+  goal.count_up_to = 1 << 30;
+  for (size_t i = 0; i < goals; ++i) {
+    rclcpp_action::Client<Aula9>::SendGoalOptions send_options;
+    send_options.goal_response_callback =
+      [&handles](std::shared_future<GoalHandle::SharedPtr> future) {
+        handles.push_back(future.get());
+      };
+    send_options.result_callback =
+      [&](const GoalHandle::WrappedResult & result) {
+        ++finished;
+        const auto sent = cancel_sent.find(result.goal_id);
+        if (result.code == rclcpp_action::ResultCode::CANCELED && sent != cancel_sent.end()) {
+          cancel_ms.push_back(
+            std::chrono::duration<double, std::milli>(Clock::now() - sent->second).count());
+        }
+      };
+    client->async_send_goal(goal, send_options);
+  }
+  spin_until(
+    [&]() {return engine.stats().active == goals;}, std::chrono::seconds(30));
+
+  // Let every goal run for a while before sampling the tick cost.
+  spin_until([]() {return false;}, std::chrono::milliseconds(500));
+  const auto before = engine.stats();
+  spin_until([]() {return false;}, std::chrono::seconds(2));
+  const auto after = engine.stats();
+  const uint64_t ticks = after.ticks - before.ticks;
+  const double mean_tick_us = ticks > 0 ?
+    (after.total_tick_ns - before.total_tick_ns) / 1e3 / ticks : 0.0;
+
+  for (const auto & handle : handles) {
+    cancel_sent[handle->get_goal_id()] = Clock::now();
+    client->async_cancel_goal(handle);
+  }
+  spin_until([&]() {return finished == goals;}, std::chrono::seconds(30));
+
+  std::sort(cancel_ms.begin(), cancel_ms.end());
+  const double cancel_p50_ms = percentile_ms(cancel_ms, 0.5);
+  const double cancel_p99_ms = percentile_ms(cancel_ms, 0.99);
+  const double cancel_max_ms = cancel_ms.empty() ? 0.0 : cancel_ms.back();
+  std::printf(
+    "%zu,%lld,%zu,%.1f,%.1f,%.2f,%.2f,%.2f\n", goals, static_cast<long long>(period.count()),
+    handles.size(), mean_tick_us, after.max_tick_ns / 1e3, cancel_p50_ms, cancel_p99_ms,
+    cancel_max_ms);
+  std::fflush(stdout);
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  const std::chrono::milliseconds period(argc > 1 ? std::atoi(argv[1]) : 20);
+  std::printf(
+    "goals,period_ms,accepted,mean_tick_us,max_tick_us,cancel_p50_ms,cancel_p99_ms,"
+    "cancel_max_ms\n");
+  for (size_t goals : {10u, 100u, 1000u, 5000u}) {
+    if (!rclcpp::ok()) {
+      break;
+    }
+    run(goals, period);
+  }
+  rclcpp::shutdown();
+  return 0;
+}
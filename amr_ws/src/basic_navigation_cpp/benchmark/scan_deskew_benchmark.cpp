@@ -0,0 +1,154 @@
+// Deskews a synthetic 720-beam, 10 Hz sweep taken while the robot drives at
+// the nav2 limits (0.26 m/s, 1 rad/s) inside a 6 x 4 m room, with odometry at
+// 10 Hz like the simulated diff drive. Every range is ray cast from the pose
+// at its own beam time. Reports the time per scan, the share of one core it
+// takes at 10 Hz, and the range error against a scan taken entirely from
+// the stamp pose, before and after deskewing.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <vector>
+
+#include "basic_navigation_cpp/scan_deskew.hpp"
+
+namespace
+{
+
+using basic_navigation_cpp::Pose2D;
+
+constexpr double kHalfWidth = 3.0;
+constexpr double kHalfHeight = 2.0;
+
+template<typename T>
+inline void do_not_optimize(T const & value)
+{
+  asm volatile ("" : : "r,m" (value) : "memory");
+}
+
+// Pose at time t of a robot that is at `start` at t = 0.
+Pose2D robot_at(const Pose2D & start, double linear, double angular, double t)
+{
+  Pose2D pose;
+  pose.yaw = start.yaw + angular * t;
+  const double radius = linear / angular;
+  pose.x = start.x + radius * (std::sin(pose.yaw) - std::sin(start.yaw));
+  pose.y = start.y - radius * (std::cos(pose.yaw) - std::cos(start.yaw));
+  return pose;
+}
+
+// Distance from (x, y) along `angle` to the walls of the room.
+float ray_cast(double x, double y, double angle)
+{
+  const double dx = std::cos(angle);
+  const double dy = std::sin(angle);
+  double t = std::numeric_limits<double>::infinity();
+  if (dx > 1e-12) {t = std::min(t, (kHalfWidth - x) / dx);}
+  if (dx < -1e-12) {t = std::min(t, (-kHalfWidth - x) / dx);}
+  if (dy > 1e-12) {t = std::min(t, (kHalfHeight - y) / dy);}
+  if (dy < -1e-12) {t = std::min(t, (-kHalfHeight - y) / dy);}
+  return static_cast<float>(t);
+}
+
+// Lidar at `extrinsic` on a robot at `pose`, beam at `angle` in the lidar.
+float measure(
+  const Pose2D & pose, const basic_navigation_cpp::Extrinsic2D & extrinsic, double angle)
+{
+  const double c = std::cos(pose.yaw);
+  const double s = std::sin(pose.yaw);
+  return ray_cast(
+    pose.x + c * extrinsic.x - s * extrinsic.y, pose.y + s * extrinsic.x + c * extrinsic.y,
+    pose.yaw + extrinsic.yaw + angle);
+}
+
+struct Error
+{
+  double rms;
+  double max;
+};
+
+Error range_error(const std::vector<float> & ranges, const std::vector<float> & truth)
+{
+  double sum = 0.0;
+  double max = 0.0;
+  size_t n = 0;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    if (std::isnan(ranges[i])) {
+      continue;
+    }
+    const double e = std::abs(ranges[i] - truth[i]);
+    sum += e * e;
+    max = std::max(max, e);
+    ++n;
+  }
+  return Error{n > 0 ? std::sqrt(sum / n) : 0.0, max};
+}
+
+}  // namespace
+
+int main()
+{
+  constexpr uint32_t beams = 720;
+  constexpr double scan_period = 0.1;
+  constexpr double linear = 0.26;
+  constexpr double angular = 1.0;
+  constexpr size_t iterations = 20000;
+  const basic_navigation_cpp::BeamLayout layout{
+    static_cast<float>(-M_PI), static_cast<float>(2.0 * M_PI / beams), beams};
+  const basic_navigation_cpp::Extrinsic2D extrinsic{0.1f, 0.0f, 0.0f};
+  const double time_increment = scan_period / beams;
+  const Pose2D start{0.4, -0.3, 0.2};
+  const int64_t stamp_ns = 1000000000;
+
+  // Odometry every 100 ms, the last sample 70 ms before the end of the
+  // sweep, so the end of every scan is extrapolated.
+  basic_navigation_cpp::OdomHistory odom(1000000000);
+  for (int k = -5; k <= 0; ++k) {
+    const double t = 0.1 * k + 0.03;
+    odom.add(
+      stamp_ns + static_cast<int64_t>(t * 1e9), robot_at(start, linear, angular, t),
+      linear, angular);
+  }
+
+  std::vector<float> skewed(beams);
+  std::vector<float> truth(beams);
+  for (uint32_t i = 0; i < beams; ++i) {
+    const double angle = layout.angle_min + i * static_cast<double>(layout.angle_increment);
+    skewed[i] = measure(robot_at(start, linear, angular, i * time_increment), extrinsic, angle);
+    truth[i] = measure(start, extrinsic, angle);
+  }
+
+  basic_navigation_cpp::SweepDeskewer deskewer(extrinsic);
+  std::vector<float> deskewed(beams);
+  const int64_t max_extrapolation_ns = 150000000;
+  if (!deskewer.deskew(
+      skewed.data(), nullptr, layout, 0.1f, 10.0f, stamp_ns, time_increment, odom,
+      max_extrapolation_ns, deskewed.data(), nullptr))
+  {
+    std::printf("odometry does not cover the sweep\n");
+    return 1;
+  }
+
+  const auto begin = std::chrono::steady_clock::now();
+  for (size_t n = 0; n < iterations; ++n) {
+    deskewer.deskew(
+      skewed.data(), nullptr, layout, 0.1f, 10.0f, stamp_ns, time_increment, odom,
+      max_extrapolation_ns, deskewed.data(), nullptr);
+    do_not_optimize(deskewed[0]);
+  }
+  const double ns = std::chrono::duration<double, std::nano>(
+    std::chrono::steady_clock::now() - begin).count() / iterations;
+
+  const Error before = range_error(skewed, truth);
+  const Error after = range_error(deskewed, truth);
+  const size_t holes = static_cast<size_t>(
+    std::count_if(deskewed.begin(), deskewed.end(), [](float r) {return std::isnan(r);}));
+  std::printf("beams,us_per_scan,core_percent_at_10hz,rms_before_m,max_before_m,"
+    "rms_after_m,max_after_m,empty_beams\n");
+  std::printf(
+    "%u,%.1f,%.3f,%.4f,%.4f,%.4f,%.4f,%zu\n", beams, ns / 1e3,
+    100.0 * ns / (scan_period * 1e9), before.rms, before.max, after.rms, after.max, holes);
+  return 0;
+}
@@ -0,0 +1,136 @@
+// Compares three ways of turning a scan into base_link points: cos/sin per
+// beam on every scan, the cached beam table in plain C++, and the dispatched
+// project_scan kernel. Scans are synthetic, with a mix of NaN, inf and
+// out-of-range returns, and the lidar sits at a non-trivial extrinsic. The
+// match column checks the table-based results against per-beam math.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "basic_navigation_cpp/scan_geometry.hpp"
+
+namespace
+{
+
+template<typename T>
+inline void do_not_optimize(T const & value)
+{
+  asm volatile ("" : : "r,m" (value) : "memory");
+}
+
+template<typename Op>
+double ns_per_op(Op && op, size_t iterations)
+{
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    op();
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+// What every consumer did before the tables: trigonometry per beam and scan.
+void project_naive(
+  const basic_navigation_cpp::BeamLayout & layout, const float * ranges, float range_min,
+  float range_max, const basic_navigation_cpp::Extrinsic2D & extrinsic,
+  basic_navigation_cpp::ScanPoints & out)
+{
+  out.x.resize(layout.count);
+  out.y.resize(layout.count);
+  out.valid = 0;
+  for (uint32_t i = 0; i < layout.count; ++i) {
+    const float r = ranges[i];
+    if (!(r >= range_min && r <= range_max)) {
+      out.x[i] = out.y[i] = std::numeric_limits<float>::quiet_NaN();
+      continue;
+    }
+    const float angle = layout.angle_min + i * layout.angle_increment + extrinsic.yaw;
+    out.x[i] = extrinsic.x + r * std::cos(angle);
+    out.y[i] = extrinsic.y + r * std::sin(angle);
+    ++out.valid;
+  }
+}
+
+// Largest coordinate difference, or +inf when validity differs.
+float max_error(
+  const basic_navigation_cpp::ScanPoints & a, const basic_navigation_cpp::ScanPoints & b)
+{
+  float error = 0.0f;
+  for (size_t i = 0; i < a.x.size(); ++i) {
+    if (std::isnan(a.x[i]) != std::isnan(b.x[i])) {
+      return std::numeric_limits<float>::infinity();
+    }
+    if (!std::isnan(a.x[i])) {
+      error = std::fmax(error, std::fabs(a.x[i] - b.x[i]));
+      error = std::fmax(error, std::fabs(a.y[i] - b.y[i]));
+    }
+  }
+  return a.valid == b.valid ? error : std::numeric_limits<float>::infinity();
+}
+
+}  // namespace
+
+int main()
+{
+  using basic_navigation_cpp::BeamLayout;
+  using basic_navigation_cpp::ScanPoints;
+  constexpr float range_min = 0.1f;
+  constexpr float range_max = 10.0f;
+  constexpr size_t iterations = 50000;
+  const basic_navigation_cpp::Extrinsic2D extrinsic{0.11f, -0.02f, 0.35f};
+
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<float> distance(0.0f, 11.0f);
+  std::uniform_int_distribution<int> pick(0, 19);
+
+  std::printf("kernel: %s\n", basic_navigation_cpp::project_scan_kernel());
+  std::printf("beams,naive_ns,table_scalar_ns,table_vector_ns,speedup,max_error_m,match\n");
+  for (uint32_t beams : {360u, 720u, 1440u}) {
+    // +-pi like the simulated lidar in robot_description/urdf/sensors.xacro.
+    const BeamLayout layout{
+      -3.14159f, 2.0f * 3.14159f / static_cast<float>(beams - 1), beams};
+    std::vector<float> ranges(beams);
+    for (float & r : ranges) {
+      const int p = pick(rng);
+      r = p == 0 ? std::numeric_limits<float>::quiet_NaN() :
+        p == 1 ? std::numeric_limits<float>::infinity() : distance(rng);
+    }
+    const auto table = basic_navigation_cpp::beam_table(layout);
+
+    ScanPoints naive;
+    ScanPoints scalar;
+    ScanPoints vector;
+    project_naive(layout, ranges.data(), range_min, range_max, extrinsic, naive);
+    basic_navigation_cpp::project_scan_scalar(
+      *table, ranges.data(), range_min, range_max, extrinsic, scalar);
+    basic_navigation_cpp::project_scan(
+      *table, ranges.data(), range_min, range_max, extrinsic, vector);
+    const float error = std::fmax(max_error(naive, scalar), max_error(naive, vector));
+
+    const double naive_ns = ns_per_op(
+      [&]() {
+        project_naive(layout, ranges.data(), range_min, range_max, extrinsic, naive);
+        do_not_optimize(naive.x[0]);
+      }, iterations);
+    const double scalar_ns = ns_per_op(
+      [&]() {
+        basic_navigation_cpp::project_scan_scalar(
+          *table, ranges.data(), range_min, range_max, extrinsic, scalar);
+        do_not_optimize(scalar.x[0]);
+      }, iterations);
+    const double vector_ns = ns_per_op(
+      [&]() {
+        basic_navigation_cpp::project_scan(
+          *table, ranges.data(), range_min, range_max, extrinsic, vector);
+        do_not_optimize(vector.x[0]);
+      }, iterations);
+    std::printf(
+      "%u,%.1f,%.1f,%.1f,%.2f,%.2g,%s\n", beams, naive_ns, scalar_ns, vector_ns,
+      naive_ns / vector_ns, error, error < 1e-5f * range_max ? "yes" : "no");
+  }
+  return 0;
+}
@@ -0,0 +1,88 @@
+// Compares the dispatched reduce_sectors kernel against the scalar reference
+// on synthetic 720-beam scans with a mix of NaN, inf and out-of-range returns,
+// and checks that both agree on min, argmin and valid count.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "basic_navigation_cpp/scan_reduction.hpp"
+
+namespace
+{
+
+template<typename T>
+inline void do_not_optimize(T const & value)
+{
+  asm volatile ("" : : "r,m" (value) : "memory");
+}
+
+template<typename Op>
+double ns_per_op(Op && op, size_t iterations)
+{
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    op();
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+}  // namespace
+
+int main()
+{
+  using basic_navigation_cpp::SectorStats;
+  constexpr float range_min = 0.12f;
+  constexpr float range_max = 3.5f;
+  constexpr size_t iterations = 200000;
+
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<float> distance(0.0f, 4.0f);
+  std::uniform_int_distribution<int> pick(0, 19);
+
+  std::printf("kernel: %s\n", basic_navigation_cpp::reduce_sectors_kernel());
+  std::printf("beams,sectors,scalar_ns,vector_ns,speedup,match\n");
+  for (size_t beams : {360u, 720u, 1440u}) {
+    std::vector<float> ranges(beams);
+    for (float & r : ranges) {
+      const int p = pick(rng);
+      r = p == 0 ? std::numeric_limits<float>::quiet_NaN() :
+        p == 1 ? std::numeric_limits<float>::infinity() : distance(rng);
+    }
+    for (size_t sectors : {1u, 3u, 8u, 36u}) {
+      std::vector<SectorStats> a(sectors);
+      std::vector<SectorStats> b(sectors);
+      basic_navigation_cpp::reduce_sectors_scalar(
+        ranges.data(), beams, range_min, range_max, sectors, a.data());
+      basic_navigation_cpp::reduce_sectors(
+        ranges.data(), beams, range_min, range_max, sectors, b.data());
+      bool match = true;
+      for (size_t s = 0; s < sectors; ++s) {
+        match = match && a[s].min_range == b[s].min_range && a[s].argmin == b[s].argmin &&
+          a[s].valid_count == b[s].valid_count &&
+          std::fabs(a[s].mean_range - b[s].mean_range) <= 1e-5f * a[s].mean_range;
+      }
+
+      const double scalar_ns = ns_per_op(
+        [&]() {
+          basic_navigation_cpp::reduce_sectors_scalar(
+            ranges.data(), beams, range_min, range_max, sectors, a.data());
+          do_not_optimize(a[0]);
+        }, iterations);
+      const double vector_ns = ns_per_op(
+        [&]() {
+          basic_navigation_cpp::reduce_sectors(
+            ranges.data(), beams, range_min, range_max, sectors, b.data());
+          do_not_optimize(b[0]);
+        }, iterations);
+      std::printf(
+        "%zu,%zu,%.1f,%.1f,%.2f,%s\n", beams, sectors, scalar_ns, vector_ns,
+        scalar_ns / vector_ns, match ? "yes" : "no");
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,352 @@
+#ifndef BASIC_NAVIGATION_CPP__ACTION_ENGINE_HPP_
+#define BASIC_NAVIGATION_CPP__ACTION_ENGINE_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_action/rclcpp_action.hpp"
+#include "basic_navigation_cpp/feedback_rate_limiter.hpp"
+#include "basic_navigation_cpp/goal_policy.hpp"
+
+namespace basic_navigation_cpp
+{
+
+enum class GoalStatus
+{
+  kRunning,
+  kSucceeded,
+  kAborted,
+  kCanceled,
+};
+
+// What a goal sees while it is stepped: the tick time, its request, the
+// result to fill in before finishing and a feedback slot. Feedback published
+// faster than the engine's feedback rate is coalesced, latest value wins (see
+// FeedbackRateLimiter).
+template<typename ActionT>
+class GoalContext
+{
+public:
+  using Goal = typename ActionT::Goal;
+  using Result = typename ActionT::Result;
+  using Feedback = typename ActionT::Feedback;
+
+  rclcpp::Time now;
+  int64_t period_ns = 0;
+  std::shared_ptr<const Goal> goal;
+  std::shared_ptr<Result> result;
+
+  void publish_feedback(std::shared_ptr<Feedback> feedback)
+  {
+    pending_feedback_ = std::move(feedback);
+  }
+
+private:
+  template<typename>
+  friend class ActionEngine;
+
+  std::shared_ptr<Feedback> pending_feedback_;
+};
+
+// One goal as a state machine. step() is called once per engine tick and must
+// not block; it returns kRunning until the goal is finished.
+template<typename ActionT>
+class GoalTask
+{
+public:
+  virtual ~GoalTask() = default;
+
+  virtual GoalStatus step(GoalContext<ActionT> & context) = 0;
+
+  // Called on the first tick after a cancel request instead of step(). Return
+  // kCanceled to finish now, or kRunning to wind down over further ticks; the
+  // engine then keeps calling cancel() until it returns a terminal status.
+  virtual GoalStatus cancel(GoalContext<ActionT> &) {return GoalStatus::kCanceled;}
+
+  // Called once when the goal is aborted because a newer goal took over
+  // (preempt_latest).
+  virtual void preempted(GoalContext<ActionT> &) {}
+
+  // merge_angles: called on the newest goal, before its first step, with
+  // every goal it replaces, oldest first. The older goal is aborted afterwards.
+  virtual void absorb(GoalTask<ActionT> &, GoalContext<ActionT> &) {}
+};
+
+struct ActionEngineStats
+{
+  uint64_t ticks = 0;
+  size_t active = 0;
+  int64_t last_tick_ns = 0;  // wall time spent in the last tick
+  int64_t max_tick_ns = 0;
+  int64_t total_tick_ns = 0;
+  uint64_t succeeded = 0;
+  uint64_t aborted = 0;      // includes preempted and merged goals
+  uint64_t canceled = 0;
+  GoalPolicyMetrics policy;
+};
+
+// Action server whose goals are GoalTask state machines stepped by a single
+// timer, so no goal ever holds an executor thread and any number of goals
+// runs on the executor's fixed thread count. Goal callbacks only queue work
+// under a short lock; the timer admits new goals, steps every running goal
+// and finishes those that are done. Cancel requests and preemptions take
+// effect on the next tick, which bounds their latency by the period plus the
+// time of one tick.
+//
+// With any policy but kParallel a GoalArbiter lets one goal run at a time:
+// admission is decided in the goal callback, the rest on the tick. Waiting
+// goals can be canceled before they start.
+template<typename ActionT>
+class ActionEngine
+{
+public:
+  using Goal = typename ActionT::Goal;
+  using Feedback = typename ActionT::Feedback;
+  using Result = typename ActionT::Result;
+  using GoalHandle = rclcpp_action::ServerGoalHandle<ActionT>;
+  using TaskFactory =
+    std::function<std::unique_ptr<GoalTask<ActionT>>(const std::shared_ptr<const Goal> &)>;
+  using GoalFilter = std::function<rclcpp_action::GoalResponse(
+        const rclcpp_action::GoalUUID &, std::shared_ptr<const Goal>)>;
+
+  struct Options
+  {
+    std::chrono::nanoseconds period{std::chrono::milliseconds(20)};
+    double feedback_rate_hz = 10.0;  // per goal, 0 for no limit
+    GoalPolicy policy = GoalPolicy::kParallel;
+    size_t max_queue = 0;            // waiting goals allowed by kQueue
+    // Optional accept/reject decision, asked before the policy; every goal
+    // passes without it.
+    GoalFilter filter;
+  };
+
+  ActionEngine(
+    rclcpp::Node * node, const std::string & name, TaskFactory factory, Options options)
+  : node_(node), factory_(std::move(factory)), options_(std::move(options)),
+    period_ns_(options_.period.count()),
+    feedback_(node->get_clock(), options_.feedback_rate_hz, 0.0),
+    arbiter_(options_.policy, options_.max_queue),
+    next_id_(0)
+  {
+    server_ = rclcpp_action::create_server<ActionT>(
+      node, name,
+      [this](const rclcpp_action::GoalUUID & uuid, std::shared_ptr<const Goal> goal) {
+        if (options_.filter &&
+        options_.filter(uuid, goal) == rclcpp_action::GoalResponse::REJECT)
+        {
+          return rclcpp_action::GoalResponse::REJECT;
+        }
+        return arbiter_.try_admit() ?
+        rclcpp_action::GoalResponse::ACCEPT_AND_EXECUTE : rclcpp_action::GoalResponse::REJECT;
+      },
+      [](const std::shared_ptr<GoalHandle>) {return rclcpp_action::CancelResponse::ACCEPT;},
+      [this](const std::shared_ptr<GoalHandle> handle) {accept(handle);});
+    timer_ = node->create_wall_timer(options_.period, [this]() {tick();});
+  }
+
+  ActionEngineStats stats() const
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    ActionEngineStats stats = stats_;
+    stats.policy = arbiter_.metrics();
+    return stats;
+  }
+
+private:
+  struct Entry
+  {
+    uint64_t id;
+    std::shared_ptr<GoalHandle> handle;
+    std::unique_ptr<GoalTask<ActionT>> task;
+    GoalContext<ActionT> context;
+    bool canceling;
+  };
+  using EntryPtr = std::unique_ptr<Entry>;
+
+  void accept(const std::shared_ptr<GoalHandle> & handle)
+  {
+    auto task = factory_(handle->get_goal());
+    std::lock_guard<std::mutex> lock(inbox_mutex_);
+    inbox_.push_back(
+      EntryPtr(
+        new Entry{next_id_++, handle, std::move(task), GoalContext<ActionT>(), false}));
+  }
+
+  void tick()
+  {
+    const auto started = std::chrono::steady_clock::now();
+    const rclcpp::Time now = node_->now();
+    ActionEngineStats counts;
+
+    {
+      std::lock_guard<std::mutex> lock(inbox_mutex_);
+      incoming_.swap(inbox_);
+    }
+    if (options_.policy == GoalPolicy::kParallel) {
+      for (auto & entry : incoming_) {
+        active_.push_back(std::move(entry));
+      }
+    } else {
+      arbitrate(now, counts);
+    }
+    incoming_.clear();
+
+    auto done = std::remove_if(
+      active_.begin(), active_.end(),
+      [&](EntryPtr & pointer) {
+        Entry & entry = *pointer;
+        const GoalStatus status = step(entry, now);
+        if (status == GoalStatus::kRunning) {
+          return false;
+        }
+        finish(entry, status, counts);
+        if (options_.policy != GoalPolicy::kParallel) {
+          arbiter_.finish(entry.id);
+        }
+        return true;
+      });
+    active_.erase(done, active_.end());
+    // Feedback parked by goals that did not publish this tick.
+    feedback_.flush();
+
+    const int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - started).count();
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    ++stats_.ticks;
+    stats_.active = active_.size();
+    stats_.last_tick_ns = elapsed;
+    stats_.max_tick_ns = std::max(stats_.max_tick_ns, elapsed);
+    stats_.total_tick_ns += elapsed;
+    stats_.succeeded += counts.succeeded;
+    stats_.aborted += counts.aborted;
+    stats_.canceled += counts.canceled;
+  }
+
+  // Hands new goals to the arbiter and carries out its plan.
+  void arbitrate(const rclcpp::Time & now, ActionEngineStats & counts)
+  {
+    const int64_t now_ns = now.nanoseconds();
+    for (auto & entry : incoming_) {
+      arbiter_.arrive(entry->id, now_ns);
+      waiting_.push_back(std::move(entry));
+    }
+    for (auto it = waiting_.begin(); it != waiting_.end(); ) {
+      if ((*it)->handle->is_canceling() && arbiter_.cancel_waiting((*it)->id)) {
+        prepare(**it, now);
+        finish(**it, GoalStatus::kCanceled, counts);
+        it = waiting_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    const GoalArbiter::Plan plan = arbiter_.plan(now_ns);
+    for (uint64_t id : plan.preempted) {
+      EntryPtr entry = take(id);
+      prepare(*entry, now);
+      entry->task->preempted(entry->context);
+      finish(*entry, GoalStatus::kAborted, counts);
+    }
+    if (!plan.start) {
+      return;
+    }
+    EntryPtr next = take(plan.start_id);
+    prepare(*next, now);
+    for (uint64_t id : plan.merged) {
+      EntryPtr older = take(id);
+      prepare(*older, now);
+      next->task->absorb(*older->task, next->context);
+      finish(*older, GoalStatus::kAborted, counts);
+    }
+    active_.push_back(std::move(next));
+  }
+
+  // Removes goal `id` from the running or waiting goals.
+  EntryPtr take(uint64_t id)
+  {
+    for (auto * list : {&active_, &waiting_}) {
+      for (auto it = list->begin(); it != list->end(); ++it) {
+        if ((*it)->id == id) {
+          EntryPtr entry = std::move(*it);
+          list->erase(it);
+          return entry;
+        }
+      }
+    }
+    return nullptr;
+  }
+
+  GoalStatus step(Entry & entry, const rclcpp::Time & now)
+  {
+    prepare(entry, now);
+    entry.canceling = entry.canceling || entry.handle->is_canceling();
+    const GoalStatus status = entry.canceling ?
+      entry.task->cancel(entry.context) : entry.task->step(entry.context);
+    if (entry.context.pending_feedback_) {
+      feedback_.publish(entry.handle, std::move(entry.context.pending_feedback_));
+      entry.context.pending_feedback_.reset();
+    }
+    return status;
+  }
+
+  void prepare(Entry & entry, const rclcpp::Time & now)
+  {
+    GoalContext<ActionT> & context = entry.context;
+    context.now = now;
+    context.period_ns = period_ns_;
+    if (!context.goal) {
+      context.goal = entry.handle->get_goal();
+      context.result = std::make_shared<Result>();
+    }
+  }
+
+  void finish(Entry & entry, GoalStatus status, ActionEngineStats & counts)
+  {
+    feedback_.finish(entry.handle);
+    auto & result = entry.context.result;
+    // A goal that was asked to cancel may still report success or abort, but
+    // the action protocol only allows canceled() while canceling.
+    if (status == GoalStatus::kCanceled && entry.handle->is_canceling()) {
+      entry.handle->canceled(result);
+      ++counts.canceled;
+    } else if (status == GoalStatus::kSucceeded) {
+      entry.handle->succeed(result);
+      ++counts.succeeded;
+    } else {
+      entry.handle->abort(result);
+      ++counts.aborted;
+    }
+  }
+
+  rclcpp::Node * node_;
+  TaskFactory factory_;
+  Options options_;
+  const int64_t period_ns_;
+  FeedbackRateLimiter<ActionT> feedback_;
+  GoalArbiter arbiter_;
+  typename rclcpp_action::Server<ActionT>::SharedPtr server_;
+  rclcpp::TimerBase::SharedPtr timer_;
+
+  std::mutex inbox_mutex_;
+  uint64_t next_id_;
+  std::vector<EntryPtr> inbox_;
+  // Only touched by tick().
+  std::vector<EntryPtr> incoming_;
+  std::vector<EntryPtr> waiting_;
+  std::vector<EntryPtr> active_;
+
+  mutable std::mutex stats_mutex_;
+  ActionEngineStats stats_;
+};
+
+}  // namespace basic_navigation_cpp
+
+#endif  // BASIC_NAVIGATION_CPP__ACTION_ENGINE_HPP_
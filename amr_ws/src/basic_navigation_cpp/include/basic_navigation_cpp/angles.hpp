@@ -0,0 +1,21 @@
+#ifndef BASIC_NAVIGATION_CPP__ANGLES_HPP_
+#define BASIC_NAVIGATION_CPP__ANGLES_HPP_
+
+#include <cmath>
+
+namespace basic_navigation_cpp
+{
+
+// Wraps an angle into [-pi, pi).
+inline double normalize_angle(double angle)
+{
+  angle = std::fmod(angle + M_PI, 2.0 * M_PI);
+  if (angle < 0.0) {
+    angle += 2.0 * M_PI;
+  }
+  return angle - M_PI;
+}
+
+}  // namespace basic_navigation_cpp
+
+#endif  // BASIC_NAVIGATION_CPP__ANGLES_HPP_
@@ -0,0 +1,129 @@
+#ifndef BASIC_NAVIGATION_CPP__FEEDBACK_RATE_LIMITER_HPP_
+#define BASIC_NAVIGATION_CPP__FEEDBACK_RATE_LIMITER_HPP_
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_action/rclcpp_action.hpp"
+#include "basic_navigation_cpp/feedback_throttle.hpp"
+
+namespace basic_navigation_cpp
+{
+
+// Action-server helper that publishes feedback at no more than `max_rate_hz`
+// per goal (no limit when 0). Execution code calls publish() as often as it
+// likes; newer feedback replaces unsent feedback, and feedback parked for
+// longer than `max_age_s` is dropped (never when 0). flush() sends parked
+// feedback that has become due, for all goals, and drops goals that ended
+// without finish(), keeping their counters in unfinished().
+template<typename ActionT>
+class FeedbackRateLimiter
+{
+public:
+  using GoalHandle = rclcpp_action::ServerGoalHandle<ActionT>;
+  using Feedback = typename ActionT::Feedback;
+
+  // Flushes from its own wall timer, once per minimum period.
+  FeedbackRateLimiter(rclcpp::Node * node, double max_rate_hz, double max_age_s)
+  : FeedbackRateLimiter(node->get_clock(), max_rate_hz, max_age_s)
+  {
+    if (min_period_ns_ > 0) {
+      timer_ = node->create_wall_timer(
+        std::chrono::nanoseconds(min_period_ns_), [this]() {flush();});
+    }
+  }
+
+  // Without a timer: the owner calls flush() from its own loop, as
+  // ActionEngine does on every tick.
+  FeedbackRateLimiter(rclcpp::Clock::SharedPtr clock, double max_rate_hz, double max_age_s)
+  : clock_(std::move(clock)),
+    min_period_ns_(max_rate_hz > 0.0 ? static_cast<int64_t>(1e9 / max_rate_hz) : 0),
+    max_age_ns_(static_cast<int64_t>(max_age_s * 1e9)) {}
+
+  void publish(const std::shared_ptr<GoalHandle> & goal, std::shared_ptr<Feedback> feedback)
+  {
+    const int64_t now = clock_->now().nanoseconds();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = goals_.find(goal->get_goal_id());
+    if (it == goals_.end()) {
+      it = goals_.emplace(
+        goal->get_goal_id(),
+        Entry{goal, Throttle(min_period_ns_, max_age_ns_)}).first;
+    }
+    it->second.throttle.offer(std::move(feedback), now, Sender{goal.get()});
+  }
+
+  // Forgets the goal, discarding unsent feedback, and returns its counters.
+  // Call it before succeeding, aborting or canceling the goal.
+  FeedbackCounters finish(const std::shared_ptr<GoalHandle> & goal)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = goals_.find(goal->get_goal_id());
+    if (it == goals_.end()) {
+      return FeedbackCounters();
+    }
+    it->second.throttle.discard_pending();
+    FeedbackCounters counters = it->second.throttle.counters();
+    goals_.erase(it);
+    return counters;
+  }
+
+  void flush()
+  {
+    const int64_t now = clock_->now().nanoseconds();
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = goals_.begin(); it != goals_.end(); ) {
+      auto goal = it->second.goal.lock();
+      if (!goal || !goal->is_active()) {
+        it->second.throttle.discard_pending();
+        unfinished_ += it->second.throttle.counters();
+        it = goals_.erase(it);
+        continue;
+      }
+      it->second.throttle.poll(now, Sender{goal.get()});
+      ++it;
+    }
+  }
+
+  // Summed counters of the goals flush() dropped because they ended without
+  // finish(); their parked feedback counts as discarded.
+  FeedbackCounters unfinished() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return unfinished_;
+  }
+
+private:
+  using Throttle = FeedbackThrottle<std::shared_ptr<Feedback>>;
+
+  struct Entry
+  {
+    std::weak_ptr<GoalHandle> goal;
+    Throttle throttle;
+  };
+
+  struct Sender
+  {
+    GoalHandle * goal;
+    void operator()(std::shared_ptr<Feedback> feedback) const
+    {
+      goal->publish_feedback(feedback);
+    }
+  };
+
+  rclcpp::Clock::SharedPtr clock_;
+  const int64_t min_period_ns_;
+  const int64_t max_age_ns_;
+  rclcpp::TimerBase::SharedPtr timer_;
+  mutable std::mutex mutex_;
+  std::map<rclcpp_action::GoalUUID, Entry> goals_;
+  FeedbackCounters unfinished_;
+};
+
+}  // namespace basic_navigation_cpp
+
+#endif  // BASIC_NAVIGATION_CPP__FEEDBACK_RATE_LIMITER_HPP_
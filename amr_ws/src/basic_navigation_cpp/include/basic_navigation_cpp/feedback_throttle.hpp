@@ -0,0 +1,118 @@
+#ifndef BASIC_NAVIGATION_CPP__FEEDBACK_THROTTLE_HPP_
+#define BASIC_NAVIGATION_CPP__FEEDBACK_THROTTLE_HPP_
+
+#include <cstdint>
+#include <utility>
+
+namespace basic_navigation_cpp
+{
+
+struct FeedbackCounters
+{
+  uint64_t offered = 0;    // feedback handed to the throttle
+  uint64_t sent = 0;       // feedback actually published
+  uint64_t coalesced = 0;  // replaced by newer feedback before it was sent
+  uint64_t stale = 0;      // dropped because it waited longer than max_age
+  uint64_t discarded = 0;  // still parked when the goal finished
+
+  FeedbackCounters & operator+=(const FeedbackCounters & other)
+  {
+    offered += other.offered;
+    sent += other.sent;
+    coalesced += other.coalesced;
+    stale += other.stale;
+    discarded += other.discarded;
+    return *this;
+  }
+};
+
+// Rate limiter with latest-value-wins coalescing for a single goal.
+// offer() sends right away when the minimum period has elapsed since the last
+// send and otherwise parks the value, replacing any parked one. poll() sends
+// the parked value once the period allows, unless it has become older than
+// max_age, in which case it is dropped. Times are in nanoseconds.
+template<typename FeedbackT>
+class FeedbackThrottle
+{
+public:
+  FeedbackThrottle(int64_t min_period_ns, int64_t max_age_ns)
+  : min_period_ns_(min_period_ns), max_age_ns_(max_age_ns),
+    last_sent_ns_(0), has_sent_(false), has_pending_(false), pending_ns_(0) {}
+
+  template<typename SendT>
+  void offer(FeedbackT feedback, int64_t now_ns, SendT && send)
+  {
+    ++counters_.offered;
+    if (!has_pending_ && due(now_ns)) {
+      emit(std::move(feedback), now_ns, send);
+      return;
+    }
+    if (has_pending_) {
+      ++counters_.coalesced;
+    }
+    pending_ = std::move(feedback);
+    pending_ns_ = now_ns;
+    has_pending_ = true;
+    poll(now_ns, send);
+  }
+
+  template<typename SendT>
+  void poll(int64_t now_ns, SendT && send)
+  {
+    if (!has_pending_) {
+      return;
+    }
+    if (max_age_ns_ > 0 && now_ns - pending_ns_ > max_age_ns_) {
+      ++counters_.stale;
+      has_pending_ = false;
+      pending_ = FeedbackT();
+      return;
+    }
+    if (due(now_ns)) {
+      has_pending_ = false;
+      emit(std::move(pending_), now_ns, send);
+      pending_ = FeedbackT();
+    }
+  }
+
+  // Drops whatever is parked, e.g. when the goal terminates.
+  void discard_pending()
+  {
+    if (has_pending_) {
+      ++counters_.discarded;
+    }
+    has_pending_ = false;
+    pending_ = FeedbackT();
+  }
+
+  bool has_pending() const {return has_pending_;}
+  const FeedbackCounters & counters() const {return counters_;}
+
+private:
+  bool due(int64_t now_ns) const
+  {
+    return !has_sent_ || now_ns - last_sent_ns_ >= min_period_ns_;
+  }
+
+  template<typename SendT>
+  void emit(FeedbackT feedback, int64_t now_ns, SendT & send)
+  {
+    send(std::move(feedback));
+    ++counters_.sent;
+    last_sent_ns_ = now_ns;
+    has_sent_ = true;
+  }
+
+  const int64_t min_period_ns_;
+  const int64_t max_age_ns_;
+  int64_t last_sent_ns_;
+  bool has_sent_;
+  bool has_pending_;
+  FeedbackT pending_;
+  int64_t pending_ns_;
+  FeedbackCounters counters_;
+};
+
+}  // namespace basic_navigation_cpp
+
+#endif  // BASIC_NAVIGATION_CPP__FEEDBACK_THROTTLE_HPP_
@@ -0,0 +1,100 @@
+#ifndef BASIC_NAVIGATION_CPP__GOAL_POLICY_HPP_
+#define BASIC_NAVIGATION_CPP__GOAL_POLICY_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace basic_navigation_cpp
+{
+
+// How an action server with one actuator treats overlapping goals.
+enum class GoalPolicy
+{
+  kParallel,       // no arbitration, every goal runs at once
+  kRejectIfBusy,   // refuse new goals while one is running
+  kPreemptLatest,  // the newest goal replaces the running one
+  kQueue,          // run goals one after another, at most max_queue waiting
+  kMergeAngles,    // fold the running goal into the newest one
+};
+
+// Parses "parallel", "reject_if_busy", "preempt_latest", "queue" or
+// "merge_angles"; false for anything else.
+bool parse_goal_policy(const std::string & name, GoalPolicy & policy);
+const char * goal_policy_name(GoalPolicy policy);
+
+struct GoalPolicyMetrics
+{
+  uint64_t accepted = 0;
+  uint64_t rejected = 0;        // by the policy: busy, or queue full
+  uint64_t preempted = 0;       // ended because a newer goal took over
+  uint64_t merged = 0;          // ended because a newer goal absorbed them
+  uint64_t started = 0;
+  uint64_t queue_waits = 0;     // goals that started after waiting in the queue
+  int64_t queue_wait_total_ns = 0;
+  int64_t queue_wait_max_ns = 0;
+  size_t queue_depth = 0;       // goals waiting right now
+};
+
+// Single-runner goal arbitration, independent of ROS so every policy can be
+// tested deterministically. Goals are plain ids:
+//  - try_admit() decides at request time, from any thread, and reserves a slot;
+//  - arrive() hands over an admitted goal, plan() applies the policy and says
+//    which goals to end and which one to run, finish()/cancel_waiting() report
+//    goals that ended on their own.
+// All calls but try_admit() and metrics() come from one thread. kParallel has
+// nothing to arbitrate: every goal is admitted and plan() starts none of them.
+class GoalArbiter
+{
+public:
+  struct Plan
+  {
+    std::vector<uint64_t> preempted;  // end these as aborted
+    std::vector<uint64_t> merged;     // fold these into `start`, then end them
+    bool start = false;               // run `start_id` from now on
+    uint64_t start_id = 0;
+  };
+
+  GoalArbiter(GoalPolicy policy, size_t max_queue);
+
+  bool try_admit();
+  void arrive(uint64_t id, int64_t now_ns);
+  Plan plan(int64_t now_ns);
+  // The running goal ended (succeeded, aborted or canceled).
+  void finish(uint64_t id);
+  // A waiting goal was canceled; false if `id` was not waiting.
+  bool cancel_waiting(uint64_t id);
+
+  bool running(uint64_t & id) const;
+  GoalPolicy policy() const {return policy_;}
+  GoalPolicyMetrics metrics() const;
+
+private:
+  struct Waiting
+  {
+    uint64_t id;
+    int64_t since_ns;
+  };
+
+  void release();
+
+  const GoalPolicy policy_;
+  const size_t max_queue_;
+  // Goals admitted and not yet ended, reserved in try_admit().
+  std::atomic<size_t> outstanding_;
+  std::vector<Waiting> arrivals_;
+  std::deque<Waiting> queue_;
+  bool has_running_;
+  uint64_t running_id_;
+
+  mutable std::mutex metrics_mutex_;
+  GoalPolicyMetrics metrics_;
+};
+
+}  // namespace basic_navigation_cpp
+
+#endif  // BASIC_NAVIGATION_CPP__GOAL_POLICY_HPP_
@@ -0,0 +1,54 @@
+#ifndef BASIC_NAVIGATION_CPP__LATENCY_HISTOGRAM_HPP_
+#define BASIC_NAVIGATION_CPP__LATENCY_HISTOGRAM_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace basic_navigation_cpp
+{
+
+// Log-linear latency histogram that any thread can record into without locks:
+// a sample costs one relaxed fetch_add plus a compare-exchange only when it
+// raises the maximum. Values below 8 ns get exact buckets; above that every
+// power of two is split into 8 buckets, so a bucket is at most 12.5 % wide.
+// Samples of 2^38 ns (about 4.5 minutes) and more share one overflow bucket.
+class LatencyHistogram
+{
+public:
+  static constexpr size_t kSubBuckets = 8;
+  static constexpr size_t kMaxExponent = 38;
+  static constexpr size_t kBuckets = kSubBuckets * (kMaxExponent - 2) + 1;
+
+  struct Snapshot
+  {
+    uint64_t count = 0;
+    int64_t max_ns = 0;
+    std::array<uint64_t, kBuckets> buckets{};
+  };
+
+  LatencyHistogram();
+
+  // Negative samples (clock skew between hosts) are recorded as zero.
+  void record(int64_t ns) noexcept;
+
+  // Moves the samples recorded so far into `out` and starts a new window.
+  // Samples racing with the drain end up in either window, never in both.
+  void drain(Snapshot & out) noexcept;
+
+  static size_t bucket_index(uint64_t ns) noexcept;
+  // Exclusive upper bound of bucket `index`; UINT64_MAX for the overflow bucket.
+  static uint64_t bucket_upper_ns(size_t index) noexcept;
+  // Upper bound of the bucket holding the p-quantile (0 <= p <= 1), capped
+  // at the window maximum; 0 for an empty snapshot.
+  static int64_t percentile_ns(const Snapshot & snapshot, double p) noexcept;
+
+private:
+  std::array<std::atomic<uint64_t>, kBuckets> buckets_;
+  std::atomic<int64_t> max_ns_;
+};
+
+}  // namespace basic_navigation_cpp
+
+#endif  // BASIC_NAVIGATION_CPP__LATENCY_HISTOGRAM_HPP_
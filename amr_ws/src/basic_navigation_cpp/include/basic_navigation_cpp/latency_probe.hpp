@@ -0,0 +1,52 @@
+#ifndef BASIC_NAVIGATION_CPP__LATENCY_PROBE_HPP_
+#define BASIC_NAVIGATION_CPP__LATENCY_PROBE_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "geometry_msgs/msg/twist.hpp"
+#include "sensor_msgs/msg/laser_scan.hpp"
+#include "std_srvs/srv/empty.hpp"
+
+namespace basic_navigation_cpp
+{
+
+// Measures scan -> cmd_vel latency of the wall follower without a simulator.
+// It starts navigation through start_navigation, publishes synthetic scans
+// with no obstacle in range at rate_hz and pairs each scan with the next
+// cmd_vel, which the wall follower answers with one move_forward per scan.
+// After `samples` pairs it prints one CSV row labelled with `mode`.
+class LatencyProbe : public rclcpp::Node
+{
+public:
+  explicit LatencyProbe(const rclcpp::NodeOptions & options = rclcpp::NodeOptions());
+
+private:
+  void tick();
+  void cmd_vel_callback(const geometry_msgs::msg::Twist::SharedPtr msg);
+  void report();
+
+  std::string mode_;
+  size_t samples_;
+  bool started_;
+  std::atomic<bool> done_;
+  sensor_msgs::msg::LaserScan scan_;
+
+  rclcpp::Publisher<sensor_msgs::msg::LaserScan>::SharedPtr scan_pub_;
+  rclcpp::Subscription<geometry_msgs::msg::Twist>::SharedPtr cmd_vel_sub_;
+  rclcpp::Client<std_srvs::srv::Empty>::SharedPtr start_client_;
+  rclcpp::TimerBase::SharedPtr timer_;
+
+  std::mutex mutex_;
+  std::deque<int64_t> in_flight_ns_;
+  std::vector<int64_t> latency_ns_;
+};
+
+}  // namespace basic_navigation_cpp
+
+#endif  // BASIC_NAVIGATION_CPP__LATENCY_PROBE_HPP_
@@ -0,0 +1,54 @@
+#ifndef BASIC_NAVIGATION_CPP__LATENCY_TRACER_HPP_
+#define BASIC_NAVIGATION_CPP__LATENCY_TRACER_HPP_
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "builtin_interfaces/msg/time.hpp"
+#include "custom_interfaces/msg/latency_histogram.hpp"
+#include "basic_navigation_cpp/latency_histogram.hpp"
+
+namespace basic_navigation_cpp
+{
+
+// Scan-stamp latency tracepoints for one node. record() measures the node
+// clock against the stamp of the scan that triggered the work and adds it to
+// the stage's histogram; a timer publishes every stage on latency_histogram
+// once per latency_report_period seconds and starts a new window.
+// Tracing is on unless the latency_tracing parameter is false. With
+// use_sim_time, latencies are quantised to the /clock publishing period.
+class LatencyTracer
+{
+public:
+  LatencyTracer(rclcpp::Node * node, const std::vector<std::string> & stages);
+
+  // Zero stamps (origin unknown) are ignored.
+  void record(size_t stage, const builtin_interfaces::msg::Time & origin)
+  {
+    if (!enabled_ || (origin.sec == 0 && origin.nanosec == 0)) {
+      return;
+    }
+    const int64_t origin_ns = static_cast<int64_t>(origin.sec) * 1000000000LL + origin.nanosec;
+    histograms_[stage].record(clock_->now().nanoseconds() - origin_ns);
+  }
+
+private:
+  void publish();
+
+  bool enabled_;
+  std::string node_name_;
+  rclcpp::Clock::SharedPtr clock_;
+  // deque, because LatencyHistogram holds atomics and cannot be moved.
+  std::deque<LatencyHistogram> histograms_;
+  LatencyHistogram::Snapshot snapshot_;
+  custom_interfaces::msg::LatencyHistogram msg_;
+  rclcpp::Time window_start_;
+  rclcpp::Publisher<custom_interfaces::msg::LatencyHistogram>::SharedPtr publisher_;
+  rclcpp::TimerBase::SharedPtr timer_;
+};
+
+}  // namespace basic_navigation_cpp
+
+#endif  // BASIC_NAVIGATION_CPP__LATENCY_TRACER_HPP_
@@ -0,0 +1,53 @@
+#ifndef BASIC_NAVIGATION_CPP__ROTATION_CONTROLLER_HPP_
+#define BASIC_NAVIGATION_CPP__ROTATION_CONTROLLER_HPP_
+
+namespace basic_navigation_cpp
+{
+
+struct RotationLimits
+{
+  double max_speed;         // cruise angular speed [rad/s]
+  double max_acceleration;  // [rad/s^2], used for both speeding up and braking
+  double min_speed;         // floor outside the tolerance, to beat static friction [rad/s]
+  double tolerance;         // |remaining| accepted as on target [rad]
+};
+
+// Closed-loop in-place rotation by a relative angle. Every update() takes the
+// yaw travelled since start() and returns the angular velocity to command:
+// a trapezoidal profile whose cruise speed is capped by the braking distance
+// sqrt(2 a |remaining|), rate-limited to max_acceleration. Because the speed
+// follows the measured remaining angle, an overshoot is driven back. Inside
+// the tolerance the command is zero, and the rotation is done once the
+// measured yaw rate has also dropped below min_speed, so the robot does not
+// coast out of the tolerance after the goal succeeded. The yaw rate comes
+// from the sensor (IMU or odometry twist) rather than from differencing yaw
+// between updates: the yaw is sampled slower than the control rate, and an
+// update without a new sample would otherwise see a rate of zero.
+class RotationController
+{
+public:
+  explicit RotationController(const RotationLimits & limits);
+
+  // `target` is the signed relative angle [rad]; `velocity` the current
+  // angular speed, so a rotation can start from motion.
+  void start(double target, double velocity = 0.0);
+
+  // `travelled` is the signed yaw change since start() [rad], `rate` the
+  // measured yaw rate [rad/s], `dt` the time since the previous update [s].
+  // Returns the command [rad/s], zero once done.
+  double update(double travelled, double rate, double dt);
+
+  double remaining() const {return remaining_;}
+  bool done() const {return done_;}
+
+private:
+  RotationLimits limits_;
+  double target_;
+  double remaining_;
+  double velocity_;
+  bool done_;
+};
+
+}  // namespace basic_navigation_cpp
+
+#endif  // BASIC_NAVIGATION_CPP__ROTATION_CONTROLLER_HPP_
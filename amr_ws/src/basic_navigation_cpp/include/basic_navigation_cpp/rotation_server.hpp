@@ -0,0 +1,89 @@
+#ifndef BASIC_NAVIGATION_CPP__ROTATION_SERVER_HPP_
+#define BASIC_NAVIGATION_CPP__ROTATION_SERVER_HPP_
+
+#include <memory>
+#include <mutex>
+
+#include "rclcpp/rclcpp.hpp"
+#include "geometry_msgs/msg/quaternion.hpp"
+#include "geometry_msgs/msg/twist.hpp"
+#include "nav_msgs/msg/odometry.hpp"
+#include "sensor_msgs/msg/imu.hpp"
+#include "custom_interfaces/action/rotate.hpp"
+#include "custom_interfaces/msg/goal_policy_metrics.hpp"
+#include "basic_navigation_cpp/action_engine.hpp"
+#include "basic_navigation_cpp/latency_tracer.hpp"
+#include "basic_navigation_cpp/rotation_controller.hpp"
+
+namespace basic_navigation_cpp
+{
+
+// Rotate action server closing the loop on measured yaw. yaw_source selects
+// sensor_msgs/Imu on imu_topic ("imu") or nav_msgs/Odometry on odom_topic
+// ("odometry"). Goals run on an ActionEngine ticking at control_rate Hz: each
+// one drives a RotationController with a trapezoidal profile
+// (rotation_speed, max_angular_acceleration) until the yaw is within
+// tolerance_deg of the target and the yaw rate reported by the same message
+// has settled, and feedback reports the measured remaining_degrees at up to
+// feedback_rate Hz. Goals are rejected while rotation_speed is not positive;
+// the other limits and control_rate are checked at startup.
+//
+// One rotation runs at a time; goal_policy decides what happens to goals that
+// overlap it:
+//  - preempt_latest (default): the newest goal replaces the running one and
+//    starts from the current speed;
+//  - reject_if_busy: goals are refused while one is running;
+//  - queue: goals run in order, at most max_queue of them waiting;
+//  - merge_angles: the newest goal also turns whatever the goals it replaces
+//    had left, so consecutive requests add up.
+// parallel is refused with a warning, since concurrent rotations would fight
+// over cmd_vel, and preempt_latest is used instead.
+// Arbitration counters are published on rotate/policy_metrics every
+// metrics_period seconds. A goal is aborted when no yaw arrives for
+// yaw_timeout seconds. When a goal carries a scan stamp, latency is traced on
+// goal receipt and on the first velocity command of the rotation.
+class RotationServer : public rclcpp::Node
+{
+public:
+  using Rotate = custom_interfaces::action::Rotate;
+
+  explicit RotationServer(const rclcpp::NodeOptions & options = rclcpp::NodeOptions());
+
+private:
+  class RotationTask;
+
+  enum Stage : size_t {kGoalReceived, kRotationStart};
+
+  void yaw_callback(const geometry_msgs::msg::Quaternion & orientation, double yaw_rate);
+  // Latest unwrapped yaw and yaw rate; false when none arrived within
+  // yaw_timeout.
+  bool current_yaw(const rclcpp::Time & now, double & yaw, double & yaw_rate);
+  void publish_velocity(double angular_z);
+  void publish_metrics();
+
+  RotationLimits limits_;
+  double yaw_timeout_;
+  // Last commanded speed, handed from a preempted rotation to the next one.
+  double command_;
+
+  std::mutex yaw_mutex_;
+  // Yaw unwrapped across +-pi, so rotations beyond half a turn work.
+  bool has_yaw_;
+  double last_raw_yaw_;
+  double yaw_;
+  double yaw_rate_;
+  rclcpp::Time yaw_stamp_;
+
+  rclcpp::Publisher<geometry_msgs::msg::Twist>::SharedPtr vel_pub_;
+  rclcpp::Subscription<sensor_msgs::msg::Imu>::SharedPtr imu_sub_;
+  rclcpp::Subscription<nav_msgs::msg::Odometry>::SharedPtr odom_sub_;
+  rclcpp::Publisher<custom_interfaces::msg::GoalPolicyMetrics>::SharedPtr metrics_pub_;
+  rclcpp::TimerBase::SharedPtr metrics_timer_;
+  GoalPolicy policy_;
+  LatencyTracer tracer_;
+  std::unique_ptr<ActionEngine<Rotate>> engine_;
+};
+
+}  // namespace basic_navigation_cpp
+
+#endif  // BASIC_NAVIGATION_CPP__ROTATION_SERVER_HPP_
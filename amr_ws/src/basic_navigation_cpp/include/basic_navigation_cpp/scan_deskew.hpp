@@ -0,0 +1,87 @@
+#ifndef BASIC_NAVIGATION_CPP__SCAN_DESKEW_HPP_
+#define BASIC_NAVIGATION_CPP__SCAN_DESKEW_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+#include "basic_navigation_cpp/scan_geometry.hpp"
+
+namespace basic_navigation_cpp
+{
+
+struct Pose2D
+{
+  double x = 0.0;
+  double y = 0.0;
+  double yaw = 0.0;
+};
+
+// Odometry of the last `horizon_ns`, in time order, with yaw unwrapped so
+// interpolation never takes the long way around +-pi.
+class OdomHistory
+{
+public:
+  explicit OdomHistory(int64_t horizon_ns)
+  : horizon_ns_(horizon_ns) {}
+
+  // Samples older than the newest one are dropped. `linear` and `angular`
+  // are the body-frame velocities, used to extrapolate past either end.
+  void add(int64_t stamp_ns, const Pose2D & pose, double linear, double angular);
+
+  // Pose at `stamp_ns`, interpolated between the samples around it, or
+  // extrapolated at constant velocity from the nearest one when `stamp_ns` is
+  // at most `max_extrapolation_ns` outside the history. False otherwise.
+  bool pose_at(int64_t stamp_ns, int64_t max_extrapolation_ns, Pose2D & pose) const;
+
+  bool empty() const {return samples_.empty();}
+  size_t size() const {return samples_.size();}
+
+private:
+  struct Sample
+  {
+    int64_t stamp_ns;
+    Pose2D pose;
+    double linear;
+    double angular;
+  };
+
+  const int64_t horizon_ns_;
+  std::deque<Sample> samples_;
+};
+
+// Removes the motion of the robot during one lidar sweep. Beam i is measured
+// at stamp + i * time_increment; each return is moved, through the lidar
+// extrinsic and the odometry pose at its own time, to where it lies relative
+// to the robot at the scan stamp, then binned back into the scan's beam
+// layout. Beams that receive several returns keep the nearest one, beams
+// that receive none are NaN. A layout covering a full turn wraps around,
+// whether its beams are 2 pi / count apart or, as Gazebo publishes them,
+// 2 pi / (count - 1) apart with the last beam copying the first.
+class SweepDeskewer
+{
+public:
+  explicit SweepDeskewer(const Extrinsic2D & lidar)
+  : lidar_(lidar) {}
+
+  // Writes layout.count ranges to `out` (and intensities to `out_intensities`
+  // when both intensity pointers are given). Returns false, leaving `out`
+  // untouched, when the odometry does not cover the whole sweep.
+  bool deskew(
+    const float * ranges, const float * intensities, const BeamLayout & layout,
+    float range_min, float range_max, int64_t stamp_ns, double time_increment,
+    const OdomHistory & odom, int64_t max_extrapolation_ns,
+    float * out, float * out_intensities);
+
+  const Extrinsic2D & lidar() const {return lidar_;}
+
+private:
+  Extrinsic2D lidar_;
+  // Beam angles of the last layout seen, shared through the table cache.
+  std::shared_ptr<const BeamTable> table_;
+};
+
+}  // namespace basic_navigation_cpp
+
+#endif  // BASIC_NAVIGATION_CPP__SCAN_DESKEW_HPP_
@@ -0,0 +1,51 @@
+#ifndef BASIC_NAVIGATION_CPP__SCAN_DESKEWER_HPP_
+#define BASIC_NAVIGATION_CPP__SCAN_DESKEWER_HPP_
+
+#include <memory>
+#include <mutex>
+
+#include "rclcpp/rclcpp.hpp"
+#include "nav_msgs/msg/odometry.hpp"
+#include "sensor_msgs/msg/laser_scan.hpp"
+#include "basic_navigation_cpp/latency_tracer.hpp"
+#include "basic_navigation_cpp/scan_deskew.hpp"
+
+namespace basic_navigation_cpp
+{
+
+// Publishes every /scan on scan/deskewed with the robot's motion during the
+// sweep removed, using the odometry on `odom` interpolated to each beam's
+// time (see SweepDeskewer). lidar_x, lidar_y and lidar_yaw place lidar_link in
+// the odometry's base frame. Beam times come from the scan's time_increment,
+// or from sweep_period when that is positive. Scans whose sweep the
+// odometry does not cover, within max_extrapolation seconds, are forwarded
+// unchanged.
+class ScanDeskewer : public rclcpp::Node
+{
+public:
+  explicit ScanDeskewer(const rclcpp::NodeOptions & options = rclcpp::NodeOptions());
+
+private:
+  enum Stage : size_t {kReceive, kDeskew, kPublish};
+
+  void odom_callback(const nav_msgs::msg::Odometry::SharedPtr msg);
+  void laser_callback(const sensor_msgs::msg::LaserScan::SharedPtr msg);
+
+  double sweep_period_;
+  int64_t max_extrapolation_ns_;
+  std::unique_ptr<SweepDeskewer> deskewer_;
+
+  std::mutex odom_mutex_;
+  OdomHistory odom_;
+
+  rclcpp::Subscription<nav_msgs::msg::Odometry>::SharedPtr odom_sub_;
+  rclcpp::Subscription<sensor_msgs::msg::LaserScan>::SharedPtr scan_sub_;
+  rclcpp::Publisher<sensor_msgs::msg::LaserScan>::SharedPtr scan_pub_;
+  sensor_msgs::msg::LaserScan deskewed_msg_;
+  uint64_t forwarded_;
+  LatencyTracer tracer_;
+};
+
+}  // namespace basic_navigation_cpp
+
+#endif  // BASIC_NAVIGATION_CPP__SCAN_DESKEWER_HPP_
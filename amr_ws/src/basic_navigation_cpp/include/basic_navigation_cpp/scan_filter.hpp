@@ -0,0 +1,75 @@
+#ifndef BASIC_NAVIGATION_CPP__SCAN_FILTER_HPP_
+#define BASIC_NAVIGATION_CPP__SCAN_FILTER_HPP_
+
+#include <cstddef>
+#include <vector>
+
+namespace basic_navigation_cpp
+{
+
+struct ScanFilterConfig
+{
+  // Returns outside [range_min, range_max], NaN and -inf become NaN. +inf,
+  // a beam that saw nothing within range (REP 117), stays +inf so consumers
+  // can still clear along it; it takes part in the median but not in shadow
+  // removal.
+  float range_min = 0.0f;
+  float range_max = 0.0f;
+  // Shadow/veil removal: for two valid beams up to shadow_window apart, the
+  // angle at the nearer point between its ray and the segment to the farther
+  // point is computed; below shadow_min_angle or above shadow_max_angle
+  // (radians) the pair straddles a depth edge and the farther point, a mixed
+  // pixel, is dropped. shadow_window 0 disables it.
+  float shadow_min_angle = 0.0f;
+  float shadow_max_angle = 0.0f;
+  size_t shadow_window = 0;
+  // Odd number of beams the median is taken over; 1 disables it. Only valid
+  // returns take part, and invalid beams stay invalid.
+  size_t median_window = 1;
+};
+
+// Range clipping, shadow/veil removal and median filtering of one scan, in
+// that order, with buffers reused from scan to scan. Invalid beams are NaN on
+// output so beam indices and angles stay those of the input.
+class ScanFilter
+{
+public:
+  static constexpr size_t kMaxMedianWindow = 15;
+
+  explicit ScanFilter(const ScanFilterConfig & config);
+
+  // `out` may not alias `ranges`. Returns the number of beams that are not
+  // NaN, +inf included.
+  size_t filter(const float * ranges, size_t count, float angle_increment, float * out);
+
+  const ScanFilterConfig & config() const {return config_;}
+
+private:
+  void clip(const float * ranges, size_t count, float * out) const;
+  void remove_shadows(const float * ranges, size_t count, float angle_increment, float * out);
+  void median(const float * ranges, size_t count, float * out) const;
+
+  ScanFilterConfig config_;
+  float cos_min_;
+  float sin_min_;
+  float cos_max_;
+  float sin_max_;
+  // cos and sin of k * angle_increment for k = 1..shadow_window.
+  float table_increment_;
+  std::vector<float> cos_offset_;
+  std::vector<float> sin_offset_;
+  std::vector<float> clipped_;
+  std::vector<float> unshadowed_;
+};
+
+// Angular decimation by `factor`: every group of `factor` consecutive beams
+// becomes one beam holding the group's nearest return, +inf when it only has
+// +inf and NaN when it has neither, so no obstacle is lost. The last group may be shorter. Writes
+// ceil(count / factor) beams and returns that count. The decimated scan
+// starts at angle_min + (factor - 1) / 2 * angle_increment, the centre of the
+// first group, with factor * angle_increment between beams.
+size_t decimate_scan(const float * ranges, size_t count, size_t factor, float * out);
+
+}  // namespace basic_navigation_cpp
+
+#endif  // BASIC_NAVIGATION_CPP__SCAN_FILTER_HPP_
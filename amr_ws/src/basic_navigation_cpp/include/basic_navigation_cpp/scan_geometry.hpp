@@ -0,0 +1,104 @@
+#ifndef BASIC_NAVIGATION_CPP__SCAN_GEOMETRY_HPP_
+#define BASIC_NAVIGATION_CPP__SCAN_GEOMETRY_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace basic_navigation_cpp
+{
+
+// Angular layout of a scan, as in sensor_msgs/LaserScan.
+struct BeamLayout
+{
+  float angle_min;
+  float angle_increment;
+  uint32_t count;
+
+  bool operator==(const BeamLayout & other) const
+  {
+    return angle_min == other.angle_min && angle_increment == other.angle_increment &&
+           count == other.count;
+  }
+  bool operator!=(const BeamLayout & other) const {return !(*this == other);}
+};
+
+// cos and sin of every beam angle, angle_min + i * angle_increment, evaluated
+// in double and stored as float.
+struct BeamTable
+{
+  BeamLayout layout;
+  std::vector<float> cos;
+  std::vector<float> sin;
+};
+
+// Shared table for `layout`. Tables live in one process-wide cache, so every
+// consumer of the same lidar, including components in one container, uses the
+// same pair of arrays. The call takes a lock; keep the pointer rather than
+// asking per scan (ScanProjector does this).
+std::shared_ptr<const BeamTable> beam_table(const BeamLayout & layout);
+
+// Planar pose of the lidar in the target frame, e.g. lidar_link in base_link.
+struct Extrinsic2D
+{
+  float x = 0.0f;
+  float y = 0.0f;
+  float yaw = 0.0f;
+};
+
+// Scan points as separate x and y arrays, one entry per beam so index i is
+// still beam i. Returns that are NaN, inf or outside [range_min, range_max]
+// are NaN in both arrays.
+struct ScanPoints
+{
+  std::vector<float> x;
+  std::vector<float> y;
+  size_t valid = 0;
+};
+
+// Converts `ranges` (table.layout.count entries) to points in the extrinsic's
+// frame, resizing `out`. Rotation and translation are applied in the same
+// pass as the polar conversion. Uses AVX2 when the CPU has it or NEON on ARM,
+// and plain C++ otherwise.
+void project_scan(
+  const BeamTable & table, const float * ranges, float range_min, float range_max,
+  const Extrinsic2D & extrinsic, ScanPoints & out);
+
+// Same conversion without vector instructions; the reference for benchmarks.
+void project_scan_scalar(
+  const BeamTable & table, const float * ranges, float range_min, float range_max,
+  const Extrinsic2D & extrinsic, ScanPoints & out);
+
+// Name of the kernel project_scan dispatches to: "avx2", "neon" or "scalar".
+const char * project_scan_kernel();
+
+// Distance along +x to the closest point ahead with |y| <= half_width, that
+// is the first return a body of that half width driving straight would hit;
+// inf when there is none. NaN points are skipped.
+float closest_ahead(const ScanPoints & points, float half_width);
+
+// Per-consumer front end: holds the table of the last layout it saw and only
+// goes back to the cache when the layout changes, then reuses its buffers.
+class ScanProjector
+{
+public:
+  explicit ScanProjector(const Extrinsic2D & extrinsic = Extrinsic2D())
+  : extrinsic_(extrinsic) {}
+
+  const ScanPoints & project(
+    const float * ranges, const BeamLayout & layout, float range_min, float range_max);
+
+  void set_extrinsic(const Extrinsic2D & extrinsic) {extrinsic_ = extrinsic;}
+  const Extrinsic2D & extrinsic() const {return extrinsic_;}
+  const ScanPoints & points() const {return points_;}
+
+private:
+  Extrinsic2D extrinsic_;
+  std::shared_ptr<const BeamTable> table_;
+  ScanPoints points_;
+};
+
+}  // namespace basic_navigation_cpp
+
+#endif  // BASIC_NAVIGATION_CPP__SCAN_GEOMETRY_HPP_
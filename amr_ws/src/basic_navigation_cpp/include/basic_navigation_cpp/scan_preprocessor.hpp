@@ -0,0 +1,44 @@
+#ifndef BASIC_NAVIGATION_CPP__SCAN_PREPROCESSOR_HPP_
+#define BASIC_NAVIGATION_CPP__SCAN_PREPROCESSOR_HPP_
+
+#include <memory>
+
+#include "rclcpp/rclcpp.hpp"
+#include "sensor_msgs/msg/laser_scan.hpp"
+#include "basic_navigation_cpp/latency_tracer.hpp"
+#include "basic_navigation_cpp/scan_filter.hpp"
+
+namespace basic_navigation_cpp
+{
+
+// Filters /scan once for every consumer. Publishes scan/filtered, the full
+// resolution scan after range clipping (range_min, range_max), shadow/veil
+// removal (shadow_min_angle_deg, shadow_max_angle_deg, shadow_window) and a
+// median over median_window beams, and scan/decimated, the filtered scan
+// reduced by `decimation` keeping the nearest return of each group, for AMCL
+// and the costmaps. Removed beams are NaN. Traces receive, filter and publish
+// latency against the scan stamp.
+class ScanPreprocessor : public rclcpp::Node
+{
+public:
+  explicit ScanPreprocessor(const rclcpp::NodeOptions & options = rclcpp::NodeOptions());
+
+private:
+  enum Stage : size_t {kReceive, kFilter, kPublish};
+
+  void laser_callback(const sensor_msgs::msg::LaserScan::SharedPtr msg);
+
+  std::unique_ptr<ScanFilter> filter_;
+  size_t decimation_;
+
+  rclcpp::Subscription<sensor_msgs::msg::LaserScan>::SharedPtr scan_sub_;
+  rclcpp::Publisher<sensor_msgs::msg::LaserScan>::SharedPtr filtered_pub_;
+  rclcpp::Publisher<sensor_msgs::msg::LaserScan>::SharedPtr decimated_pub_;
+  sensor_msgs::msg::LaserScan filtered_msg_;
+  sensor_msgs::msg::LaserScan decimated_msg_;
+  LatencyTracer tracer_;
+};
+
+}  // namespace basic_navigation_cpp
+
+#endif  // BASIC_NAVIGATION_CPP__SCAN_PREPROCESSOR_HPP_
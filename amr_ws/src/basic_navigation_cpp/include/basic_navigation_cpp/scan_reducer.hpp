@@ -0,0 +1,43 @@
+#ifndef BASIC_NAVIGATION_CPP__SCAN_REDUCER_HPP_
+#define BASIC_NAVIGATION_CPP__SCAN_REDUCER_HPP_
+
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "sensor_msgs/msg/laser_scan.hpp"
+#include "custom_interfaces/msg/scan_sectors.hpp"
+#include "basic_navigation_cpp/latency_tracer.hpp"
+#include "basic_navigation_cpp/scan_geometry.hpp"
+#include "basic_navigation_cpp/scan_reduction.hpp"
+
+namespace basic_navigation_cpp
+{
+
+// Reduces every /scan into a ScanSectors message (per-sector min, mean and
+// argmin), so reactive consumers subscribe to a few dozen bytes instead of
+// the full range array. The scan is also projected into base_link through the
+// shared beam table to report forward_clearance, the closest return in the
+// corridor_width wide path straight ahead. Traces receive, reduce and publish latency against
+// the scan stamp, which it forwards in the ScanSectors header.
+class ScanReducer : public rclcpp::Node
+{
+public:
+  explicit ScanReducer(const rclcpp::NodeOptions & options = rclcpp::NodeOptions());
+
+private:
+  enum Stage : size_t {kReceive, kReduce, kPublish};
+
+  void laser_callback(const sensor_msgs::msg::LaserScan::SharedPtr msg);
+
+  rclcpp::Subscription<sensor_msgs::msg::LaserScan>::SharedPtr scan_sub_;
+  rclcpp::Publisher<custom_interfaces::msg::ScanSectors>::SharedPtr sectors_pub_;
+  custom_interfaces::msg::ScanSectors sectors_msg_;
+  std::vector<SectorStats> stats_;
+  ScanProjector projector_;
+  float half_width_;
+  LatencyTracer tracer_;
+};
+
+}  // namespace basic_navigation_cpp
+
+#endif  // BASIC_NAVIGATION_CPP__SCAN_REDUCER_HPP_
@@ -0,0 +1,40 @@
+#ifndef BASIC_NAVIGATION_CPP__SCAN_REDUCTION_HPP_
+#define BASIC_NAVIGATION_CPP__SCAN_REDUCTION_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace basic_navigation_cpp
+{
+
+// Reduction of the returns of one angular sector of a scan.
+struct SectorStats
+{
+  float min_range;       // closest valid return, +inf when there is none
+  float mean_range;      // mean of the valid returns, NaN when there is none
+  uint32_t argmin;       // index of min_range in the full ranges array
+  uint32_t valid_count;  // returns that are finite and inside [range_min, range_max]
+};
+
+// Splits `ranges` into `sectors` consecutive, equally sized index blocks and
+// reduces each one in a single pass, ignoring NaN, inf and anything outside
+// [range_min, range_max]. `out` must hold `sectors` entries. Uses AVX2 when the
+// CPU has it (checked once at runtime) or NEON on ARM, and plain C++ otherwise.
+// On ties argmin is the lowest index, whichever kernel runs.
+void reduce_sectors(
+  const float * ranges, size_t count, float range_min, float range_max,
+  size_t sectors, SectorStats * out);
+
+// Same reduction without vector instructions; the reference for benchmarks.
+// mean_range may differ from reduce_sectors in the last bits, since the vector
+// kernels accumulate per lane in float.
+void reduce_sectors_scalar(
+  const float * ranges, size_t count, float range_min, float range_max,
+  size_t sectors, SectorStats * out);
+
+// Name of the kernel reduce_sectors dispatches to: "avx2", "neon" or "scalar".
+const char * reduce_sectors_kernel();
+
+}  // namespace basic_navigation_cpp
+
+#endif  // BASIC_NAVIGATION_CPP__SCAN_REDUCTION_HPP_
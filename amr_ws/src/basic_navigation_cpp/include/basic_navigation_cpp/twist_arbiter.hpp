@@ -0,0 +1,73 @@
+#ifndef BASIC_NAVIGATION_CPP__TWIST_ARBITER_HPP_
+#define BASIC_NAVIGATION_CPP__TWIST_ARBITER_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+#include "basic_navigation_cpp/twist_slot.hpp"
+
+namespace basic_navigation_cpp
+{
+
+struct TwistInputCounters
+{
+  uint64_t received = 0;     // commands written to the slot
+  uint64_t overwritten = 0;  // replaced before an output tick looked at them
+  uint64_t stale = 0;        // times the input timed out while it was active
+  uint64_t selected = 0;     // output ticks that forwarded this input
+  uint64_t preempted = 0;    // output ticks on which a higher priority input won
+  uint64_t locked_out = 0;   // output ticks skipped because of the lock-out flag
+};
+
+// Priority arbitration over velocity inputs. Inputs write into their own
+// TwistSlot from any thread; select() runs on the fixed-rate output tick and
+// picks the highest priority input whose latest command is younger than its
+// timeout and that is not locked out. Ties go to the input added first.
+class TwistArbiter
+{
+public:
+  // Returns the index used by write(), set_locked_out() and counters().
+  size_t add_input(const std::string & name, int priority, int64_t timeout_ns);
+
+  void write(size_t input, const Velocity & velocity, int64_t now_ns) noexcept;
+  void set_locked_out(size_t input, bool locked_out) noexcept;
+
+  // Index of the winning input with its command in `velocity`, or -1 when no
+  // input is eligible.
+  int select(int64_t now_ns, Velocity & velocity) noexcept;
+
+  size_t size() const {return inputs_.size();}
+  const std::string & name(size_t input) const {return inputs_[input].name;}
+  TwistInputCounters counters(size_t input) const;
+
+private:
+  struct Input
+  {
+    Input(const std::string & name, int priority, int64_t timeout_ns)
+    : name(name), priority(priority), timeout_ns(timeout_ns), locked_out(false),
+      active(false), received(0), overwritten(0), stale(0), selected(0), preempted(0),
+      locked_out_ticks(0) {}
+
+    std::string name;
+    int priority;
+    int64_t timeout_ns;
+    TwistSlot slot;
+    std::atomic<bool> locked_out;
+    bool active;  // only touched by select()
+    std::atomic<uint64_t> received;
+    std::atomic<uint64_t> overwritten;
+    std::atomic<uint64_t> stale;
+    std::atomic<uint64_t> selected;
+    std::atomic<uint64_t> preempted;
+    std::atomic<uint64_t> locked_out_ticks;
+  };
+
+  // deque, because Input holds atomics and cannot be moved.
+  std::deque<Input> inputs_;
+};
+
+}  // namespace basic_navigation_cpp
+
+#endif  // BASIC_NAVIGATION_CPP__TWIST_ARBITER_HPP_
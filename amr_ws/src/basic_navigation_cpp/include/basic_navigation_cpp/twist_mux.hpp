@@ -0,0 +1,54 @@
+#ifndef BASIC_NAVIGATION_CPP__TWIST_MUX_HPP_
+#define BASIC_NAVIGATION_CPP__TWIST_MUX_HPP_
+
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "amr_comm/cycle_arena.hpp"
+#include "geometry_msgs/msg/twist.hpp"
+#include "std_msgs/msg/bool.hpp"
+#include "custom_interfaces/msg/twist_mux_status.hpp"
+#include "basic_navigation_cpp/twist_arbiter.hpp"
+
+namespace basic_navigation_cpp
+{
+
+// Single owner of cmd_vel. Every producer publishes on its own input topic;
+// the node keeps the latest command of each input in a lock-free slot and, at
+// a fixed `rate`, forwards the highest priority input that is neither timed
+// out nor locked out. When the last input goes idle one zero command is sent,
+// since the diff-drive plugin would otherwise keep the last velocity.
+//
+// Parameters: `inputs` lists the input names; for each name, `<name>.topic`
+// (default cmd_vel/<name>), `<name>.priority` (higher wins),
+// `<name>.timeout` [s] and `<name>.lockout_topic`, a std_msgs/Bool that locks
+// the input out while true (empty for none). Counters are published on
+// cmd_vel_mux/status every `status_period` seconds. Incoming commands are
+// read into a per-message arena cycle (amr_comm::create_arena_subscription)
+// rather than the heap; the inputs share the arena and one mutually
+// exclusive callback group.
+class TwistMux : public rclcpp::Node
+{
+public:
+  explicit TwistMux(const rclcpp::NodeOptions & options = rclcpp::NodeOptions());
+
+private:
+  void tick();
+  void publish_status();
+
+  TwistArbiter arbiter_;
+  int active_;
+  // Declared before the subscriptions so it outlives them.
+  amr_comm::CycleArena input_arena_;
+  rclcpp::Publisher<geometry_msgs::msg::Twist>::SharedPtr cmd_vel_pub_;
+  rclcpp::Publisher<custom_interfaces::msg::TwistMuxStatus>::SharedPtr status_pub_;
+  std::vector<rclcpp::Subscription<rclcpp::SerializedMessage>::SharedPtr> input_subs_;
+  std::vector<rclcpp::Subscription<std_msgs::msg::Bool>::SharedPtr> lockout_subs_;
+  rclcpp::TimerBase::SharedPtr output_timer_;
+  rclcpp::TimerBase::SharedPtr status_timer_;
+  custom_interfaces::msg::TwistMuxStatus status_msg_;
+};
+
+}  // namespace basic_navigation_cpp
+
+#endif  // BASIC_NAVIGATION_CPP__TWIST_MUX_HPP_
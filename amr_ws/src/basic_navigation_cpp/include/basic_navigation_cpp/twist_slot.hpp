@@ -0,0 +1,92 @@
+#ifndef BASIC_NAVIGATION_CPP__TWIST_SLOT_HPP_
+#define BASIC_NAVIGATION_CPP__TWIST_SLOT_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace basic_navigation_cpp
+{
+
+// Plain velocity command: linear x, y, z then angular x, y, z.
+using Velocity = std::array<double, 6>;
+
+// Latest-value mailbox for one velocity input. One writer (the input's
+// subscription) and any number of readers, without locks: a sequence lock
+// whose payload is held in relaxed atomics, so a reader that overlaps a write
+// retries instead of seeing a torn value. The writer never waits.
+//
+// consume() is read() for the one consumer that accounts for lost commands:
+// it swaps the sequence number of the value it copied into consumed_, so
+// every write between two consumes is counted exactly once, even when a
+// write lands between the copy and the swap.
+class TwistSlot
+{
+public:
+  TwistSlot()
+  : sequence_(0), stamp_ns_(0), consumed_(0)
+  {
+    for (auto & value : values_) {
+      value.store(0.0, std::memory_order_relaxed);
+    }
+  }
+
+  void write(const Velocity & velocity, int64_t stamp_ns) noexcept
+  {
+    const uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < values_.size(); ++i) {
+      values_[i].store(velocity[i], std::memory_order_relaxed);
+    }
+    stamp_ns_.store(stamp_ns, std::memory_order_relaxed);
+    sequence_.store(sequence + 2, std::memory_order_release);
+  }
+
+  // Copies the latest value; false if nothing was ever written.
+  bool read(Velocity & velocity, int64_t & stamp_ns) const noexcept
+  {
+    return copy(velocity, stamp_ns) != 0;
+  }
+
+  // Copies the latest value and marks it consumed. `overwritten` is the
+  // number of values written since the previous consume() that nobody
+  // consumed. False if nothing was ever written.
+  bool consume(Velocity & velocity, int64_t & stamp_ns, uint64_t & overwritten) noexcept
+  {
+    const uint32_t sequence = copy(velocity, stamp_ns);
+    const uint32_t previous = consumed_.exchange(sequence, std::memory_order_relaxed);
+    // Sequence numbers advance by two per write; unsigned arithmetic keeps
+    // the difference right across wraparound.
+    const uint32_t writes = (sequence - previous) / 2;
+    overwritten = writes > 1 ? writes - 1 : 0;
+    return sequence != 0;
+  }
+
+private:
+  // Returns the (even) sequence number of the copied value, 0 if none.
+  uint32_t copy(Velocity & velocity, int64_t & stamp_ns) const noexcept
+  {
+    uint32_t before;
+    uint32_t after;
+    do {
+      before = sequence_.load(std::memory_order_acquire);
+      for (size_t i = 0; i < values_.size(); ++i) {
+        velocity[i] = values_[i].load(std::memory_order_relaxed);
+      }
+      stamp_ns = stamp_ns_.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = sequence_.load(std::memory_order_relaxed);
+    } while ((before & 1u) != 0 || before != after);
+    return before;
+  }
+
+  std::atomic<uint32_t> sequence_;
+  std::array<std::atomic<double>, 6> values_;
+  std::atomic<int64_t> stamp_ns_;
+  std::atomic<uint32_t> consumed_;  // sequence of the last consumed value
+};
+
+}  // namespace basic_navigation_cpp
+
+#endif  // BASIC_NAVIGATION_CPP__TWIST_SLOT_HPP_
@@ -0,0 +1,59 @@
+#ifndef BASIC_NAVIGATION_CPP__WALL_FOLLOWER_HPP_
+#define BASIC_NAVIGATION_CPP__WALL_FOLLOWER_HPP_
+
+#include <memory>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_action/rclcpp_action.hpp"
+#include "geometry_msgs/msg/twist.hpp"
+#include "std_srvs/srv/empty.hpp"
+#include "custom_interfaces/action/rotate.hpp"
+#include "custom_interfaces/msg/scan_sectors.hpp"
+#include "basic_navigation_cpp/latency_tracer.hpp"
+
+namespace basic_navigation_cpp
+{
+
+// Component port of basic_navigation/main_node.py. Once start_navigation is
+// called it drives forward until the middle sector of scan_sectors or its
+// forward_clearance reports a wall closer than wall_distance_threshold: the
+// sector catches walls at an angle beside the path, the clearance anything in
+// the path the wedge misses. It then stops and asks the rotate action server
+// to turn by rotation_angle degrees. Latency from the scan stamp is traced on
+// receive, after the decision and after the resulting cmd_vel or goal has been
+// sent; the stamp also travels in the goal as scan_stamp_sec/scan_stamp_nanosec.
+class WallFollower : public rclcpp::Node
+{
+public:
+  using Rotate = custom_interfaces::action::Rotate;
+  using GoalHandle = rclcpp_action::ClientGoalHandle<Rotate>;
+
+  explicit WallFollower(const rclcpp::NodeOptions & options = rclcpp::NodeOptions());
+
+private:
+  enum Stage : size_t {kReceive, kDecide, kPublish};
+
+  void sectors_callback(const custom_interfaces::msg::ScanSectors::SharedPtr msg);
+  void start_navigation_callback(
+    const std::shared_ptr<std_srvs::srv::Empty::Request> request,
+    std::shared_ptr<std_srvs::srv::Empty::Response> response);
+  void move_forward();
+  void stop_robot();
+  void send_rotation_goal(const builtin_interfaces::msg::Time & scan_stamp);
+
+  double wall_threshold_;
+  double forward_speed_;
+  double rotation_angle_;
+  bool is_navigating_;
+  bool is_rotating_;
+
+  rclcpp::Publisher<geometry_msgs::msg::Twist>::SharedPtr vel_pub_;
+  rclcpp::Subscription<custom_interfaces::msg::ScanSectors>::SharedPtr sectors_sub_;
+  rclcpp::Service<std_srvs::srv::Empty>::SharedPtr srv_;
+  rclcpp_action::Client<Rotate>::SharedPtr action_client_;
+  LatencyTracer tracer_;
+};
+
+}  // namespace basic_navigation_cpp
+
+#endif  // BASIC_NAVIGATION_CPP__WALL_FOLLOWER_HPP_
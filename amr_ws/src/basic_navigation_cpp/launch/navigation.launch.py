@@ -0,0 +1,128 @@
+from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument, OpaqueFunction
+from launch.substitutions import LaunchConfiguration
+from launch_ros.actions import ComposableNodeContainer, Node
+from launch_ros.descriptions import ComposableNode
+
+# (executable, plugin, node name, remappings) of every component in the stack.
+# Velocity producers publish on their own input of twist_mux, which alone
+# owns cmd_vel.
+COMPONENTS = [
+    ('scan_preprocessor', 'basic_navigation_cpp::ScanPreprocessor', 'scan_preprocessor', []),
+    ('scan_reducer', 'basic_navigation_cpp::ScanReducer', 'scan_reducer',
+     [('scan', 'scan/filtered')]),
+    ('wall_follower', 'basic_navigation_cpp::WallFollower', 'main_navigation_node',
+     [('cmd_vel', 'cmd_vel/navigation')]),
+    ('rotation_server', 'basic_navigation_cpp::RotationServer', 'rotation_action_server',
+     [('cmd_vel', 'cmd_vel/rotation')]),
+    ('twist_mux', 'basic_navigation_cpp::TwistMux', 'twist_mux', []),
+]
+# Optional first stage; the preprocessor then reads its output.
+DESKEW = ('scan_deskewer', 'basic_navigation_cpp::ScanDeskewer', 'scan_deskewer', [])
+# The probe pairs every scan with the wall follower's own command, so it
+# listens ahead of the multiplexer.
+PROBE = ('latency_probe', 'basic_navigation_cpp::LatencyProbe', 'latency_probe',
+         [('cmd_vel', 'cmd_vel/navigation')])
+
+
+def launch_stack(context):
+    container = LaunchConfiguration('container').perform(context).lower() == 'true'
+    probe = LaunchConfiguration('latency_probe').perform(context).lower() == 'true'
+    parameters = {
+        'scan_deskewer': [{}],
+        'scan_preprocessor': [{}],
+        'scan_reducer': [{'sectors': 3}],
+        'main_navigation_node': [{
+            'wall_distance_threshold': float(
+                LaunchConfiguration('wall_distance_threshold').perform(context)),
+            'forward_speed': float(LaunchConfiguration('forward_speed').perform(context)),
+            'rotation_angle': float(LaunchConfiguration('rotation_angle').perform(context)),
+        }],
+        'rotation_action_server': [{
+            'rotation_speed': float(LaunchConfiguration('rotation_speed').perform(context)),
+            'yaw_source': LaunchConfiguration('yaw_source').perform(context),
+            'tolerance_deg': float(LaunchConfiguration('tolerance_deg').perform(context)),
+            'goal_policy': LaunchConfiguration('goal_policy').perform(context),
+        }],
+        'twist_mux': [{
+            'inputs': ['rotation', 'navigation'],
+            'rotation.priority': 100,
+            'rotation.timeout': 0.5,
+            'navigation.priority': 10,
+            'navigation.timeout': 0.5,
+        }],
+        'latency_probe': [{'mode': 'container' if container else 'process'}],
+    }
+    components = COMPONENTS + ([PROBE] if probe else [])
+    if LaunchConfiguration('deskew').perform(context).lower() == 'true':
+        executable, plugin, name, _ = components[0]
+        components = [DESKEW, (executable, plugin, name, [('scan', 'scan/deskewed')])] + \
+            components[1:]
+
+    if not container:
+        return [
+            Node(
+                package='basic_navigation_cpp',
+                executable=executable,
+                name=name,
+                parameters=parameters[name],
+                remappings=remappings,
+                output='screen')
+            for executable, _, name, remappings in components
+        ]
+
+    # One process, one executor: scans, sector reductions and cmd_vel move
+    # between the nodes as intra-process pointers instead of DDS samples.
+    return [
+        ComposableNodeContainer(
+            name='navigation_container',
+            namespace='',
+            package='rclcpp_components',
+            executable='component_container',
+            composable_node_descriptions=[
+                ComposableNode(
+                    package='basic_navigation_cpp',
+                    plugin=plugin,
+                    name=name,
+                    parameters=parameters[name],
+                    remappings=remappings,
+                    extra_arguments=[{'use_intra_process_comms': True}])
+                for _, plugin, name, remappings in components
+            ],
+            output='screen')
+    ]
+
+
+def generate_launch_description():
+    ld = LaunchDescription()
+    ld.add_action(DeclareLaunchArgument(
+        'container', default_value='false',
+        description='Load every node into one component container with intra-process '
+                    'comms instead of running one process per node'))
+    ld.add_action(DeclareLaunchArgument(
+        'latency_probe', default_value='false',
+        description='Also run latency_probe, which drives the stack with synthetic '
+                    'scans and prints scan -> cmd_vel latency'))
+    ld.add_action(DeclareLaunchArgument(
+        'deskew', default_value='false',
+        description='Remove the robot motion during each sweep from /scan, using /odom, '
+                    'before preprocessing'))
+    ld.add_action(DeclareLaunchArgument('wall_distance_threshold', default_value='0.5'))
+    ld.add_action(DeclareLaunchArgument('forward_speed', default_value='0.2'))
+    ld.add_action(DeclareLaunchArgument('rotation_angle', default_value='90.0'))
+    ld.add_action(DeclareLaunchArgument(
+        'rotation_speed', default_value='1.0',
+        description='Cruise speed of the closed-loop rotation [rad/s]'))
+    ld.add_action(DeclareLaunchArgument(
+        'yaw_source', default_value='imu',
+        description='Yaw feedback of the rotation: imu (/imu/data) or odometry '
+                    '(/odometry/filtered)'))
+    ld.add_action(DeclareLaunchArgument(
+        'tolerance_deg', default_value='1.0',
+        description='Accepted final rotation error [deg]'))
+    ld.add_action(DeclareLaunchArgument(
+        'goal_policy', default_value='preempt_latest',
+        description='Overlapping rotation goals: preempt_latest, reject_if_busy, queue '
+                    'or merge_angles'))
+    ld.add_action(OpaqueFunction(function=launch_stack))
+    return ld
@@ -0,0 +1,30 @@
+from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument
+from launch.substitutions import LaunchConfiguration
+from launch_ros.actions import Node
+
+
+# Runs scan_preprocessor alone. rm_localization's amcl.launch.py and
+# rm_slam's slam.launch.py include it with preprocess_scan:=true and then read
+# scan/decimated and scan/filtered instead of /scan; they read /scan by
+# default. navigation.launch.py starts its own.
+def generate_launch_description():
+    ld = LaunchDescription()
+    ld.add_action(DeclareLaunchArgument('use_sim_time', default_value='true'))
+    ld.add_action(DeclareLaunchArgument(
+        'decimation', default_value='4',
+        description='Beams of scan/filtered folded into one beam of scan/decimated'))
+    ld.add_action(DeclareLaunchArgument(
+        'median_window', default_value='3',
+        description='Beams the median filter spans, 1 to disable it'))
+    ld.add_action(Node(
+        package='basic_navigation_cpp',
+        executable='scan_preprocessor',
+        name='scan_preprocessor',
+        parameters=[{
+            'use_sim_time': LaunchConfiguration('use_sim_time'),
+            'decimation': LaunchConfiguration('decimation'),
+            'median_window': LaunchConfiguration('median_window'),
+        }],
+        output='screen'))
+    return ld
@@ -0,0 +1,163 @@
+#include "basic_navigation_cpp/goal_policy.hpp"
+
+#include <algorithm>
+
+namespace basic_navigation_cpp
+{
+
+bool parse_goal_policy(const std::string & name, GoalPolicy & policy)
+{
+  for (GoalPolicy candidate : {GoalPolicy::kParallel, GoalPolicy::kRejectIfBusy,
+      GoalPolicy::kPreemptLatest, GoalPolicy::kQueue, GoalPolicy::kMergeAngles})
+  {
+    if (name == goal_policy_name(candidate)) {
+      policy = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+const char * goal_policy_name(GoalPolicy policy)
+{
+  switch (policy) {
+    case GoalPolicy::kParallel: return "parallel";
+    case GoalPolicy::kRejectIfBusy: return "reject_if_busy";
+    case GoalPolicy::kPreemptLatest: return "preempt_latest";
+    case GoalPolicy::kQueue: return "queue";
+    case GoalPolicy::kMergeAngles: return "merge_angles";
+  }
+  return "unknown";
+}
+
+GoalArbiter::GoalArbiter(GoalPolicy policy, size_t max_queue)
+: policy_(policy), max_queue_(max_queue), outstanding_(0), has_running_(false),
+  running_id_(0)
+{
+}
+
+bool GoalArbiter::try_admit()
+{
+  // Only reject_if_busy and queue have a capacity: one running goal, plus
+  // max_queue waiting ones for queue.
+  size_t capacity = 0;
+  if (policy_ == GoalPolicy::kRejectIfBusy) {
+    capacity = 1;
+  } else if (policy_ == GoalPolicy::kQueue) {
+    capacity = 1 + max_queue_;
+  }
+  size_t outstanding = outstanding_.load();
+  do {
+    if (capacity > 0 && outstanding >= capacity) {
+      std::lock_guard<std::mutex> lock(metrics_mutex_);
+      ++metrics_.rejected;
+      return false;
+    }
+  } while (!outstanding_.compare_exchange_weak(outstanding, outstanding + 1));
+  std::lock_guard<std::mutex> lock(metrics_mutex_);
+  ++metrics_.accepted;
+  return true;
+}
+
+void GoalArbiter::arrive(uint64_t id, int64_t now_ns)
+{
+  arrivals_.push_back(Waiting{id, now_ns});
+}
+
+GoalArbiter::Plan GoalArbiter::plan(int64_t now_ns)
+{
+  Plan plan;
+  std::lock_guard<std::mutex> lock(metrics_mutex_);
+
+  if (policy_ == GoalPolicy::kParallel) {
+    // Nothing to arbitrate: every goal runs as soon as it arrives.
+    arrivals_.clear();
+  } else if (policy_ == GoalPolicy::kQueue || policy_ == GoalPolicy::kRejectIfBusy) {
+    // Admission already bounded the count, so arrivals only need to wait.
+    queue_.insert(queue_.end(), arrivals_.begin(), arrivals_.end());
+    arrivals_.clear();
+    if (!has_running_ && !queue_.empty()) {
+      const Waiting next = queue_.front();
+      queue_.pop_front();
+      plan.start = true;
+      plan.start_id = next.id;
+      const int64_t waited = now_ns - next.since_ns;
+      if (waited > 0 && policy_ == GoalPolicy::kQueue) {
+        ++metrics_.queue_waits;
+        metrics_.queue_wait_total_ns += waited;
+        metrics_.queue_wait_max_ns = std::max(metrics_.queue_wait_max_ns, waited);
+      }
+    }
+  } else if (!arrivals_.empty()) {
+    // preempt_latest and merge_angles: the newest arrival wins and every
+    // older goal, running or just arrived, ends in its favour.
+    std::vector<uint64_t> & ended =
+      policy_ == GoalPolicy::kPreemptLatest ? plan.preempted : plan.merged;
+    if (has_running_) {
+      ended.push_back(running_id_);
+    }
+    for (size_t i = 0; i + 1 < arrivals_.size(); ++i) {
+      ended.push_back(arrivals_[i].id);
+    }
+    plan.start = true;
+    plan.start_id = arrivals_.back().id;
+    arrivals_.clear();
+    (policy_ == GoalPolicy::kPreemptLatest ? metrics_.preempted : metrics_.merged) +=
+      ended.size();
+    outstanding_ -= ended.size();
+  }
+
+  if (plan.start) {
+    has_running_ = true;
+    running_id_ = plan.start_id;
+    ++metrics_.started;
+  }
+  metrics_.queue_depth = queue_.size();
+  return plan;
+}
+
+void GoalArbiter::finish(uint64_t id)
+{
+  if (has_running_ && running_id_ == id) {
+    has_running_ = false;
+    release();
+  }
+}
+
+bool GoalArbiter::cancel_waiting(uint64_t id)
+{
+  const auto match = [id](const Waiting & waiting) {return waiting.id == id;};
+  auto it = std::find_if(queue_.begin(), queue_.end(), match);
+  if (it != queue_.end()) {
+    queue_.erase(it);
+  } else {
+    auto arrival = std::find_if(arrivals_.begin(), arrivals_.end(), match);
+    if (arrival == arrivals_.end()) {
+      return false;
+    }
+    arrivals_.erase(arrival);
+  }
+  release();
+  std::lock_guard<std::mutex> lock(metrics_mutex_);
+  metrics_.queue_depth = queue_.size();
+  return true;
+}
+
+bool GoalArbiter::running(uint64_t & id) const
+{
+  id = running_id_;
+  return has_running_;
+}
+
+GoalPolicyMetrics GoalArbiter::metrics() const
+{
+  std::lock_guard<std::mutex> lock(metrics_mutex_);
+  return metrics_;
+}
+
+void GoalArbiter::release()
+{
+  outstanding_.fetch_sub(1);
+}
+
+}  // namespace basic_navigation_cpp
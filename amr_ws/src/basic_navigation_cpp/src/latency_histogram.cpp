@@ -0,0 +1,94 @@
+#include "basic_navigation_cpp/latency_histogram.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace basic_navigation_cpp
+{
+
+namespace
+{
+
+size_t log2_floor(uint64_t value)
+{
+  return 63 - static_cast<size_t>(__builtin_clzll(value));
+}
+
+}  // namespace
+
+LatencyHistogram::LatencyHistogram()
+: max_ns_(0)
+{
+  for (auto & bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+}
+
+void LatencyHistogram::record(int64_t ns) noexcept
+{
+  const int64_t value = ns > 0 ? ns : 0;
+  buckets_[bucket_index(static_cast<uint64_t>(value))].fetch_add(1, std::memory_order_relaxed);
+  int64_t max = max_ns_.load(std::memory_order_relaxed);
+  while (value > max &&
+    !max_ns_.compare_exchange_weak(max, value, std::memory_order_relaxed))
+  {
+  }
+}
+
+void LatencyHistogram::drain(Snapshot & out) noexcept
+{
+  out.count = 0;
+  for (size_t i = 0; i < kBuckets; ++i) {
+    out.buckets[i] = buckets_[i].exchange(0, std::memory_order_relaxed);
+    out.count += out.buckets[i];
+  }
+  out.max_ns = max_ns_.exchange(0, std::memory_order_relaxed);
+}
+
+size_t LatencyHistogram::bucket_index(uint64_t ns) noexcept
+{
+  if (ns < kSubBuckets) {
+    return static_cast<size_t>(ns);
+  }
+  const size_t exponent = log2_floor(ns);
+  if (exponent >= kMaxExponent) {
+    return kBuckets - 1;
+  }
+  // exponent >= 3 here; the three bits below the leading one pick the bucket.
+  const size_t mantissa = static_cast<size_t>(ns >> (exponent - 3)) & (kSubBuckets - 1);
+  return kSubBuckets * (exponent - 2) + mantissa;
+}
+
+uint64_t LatencyHistogram::bucket_upper_ns(size_t index) noexcept
+{
+  if (index < kSubBuckets) {
+    return index + 1;
+  }
+  if (index == kBuckets - 1) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  const size_t exponent = index / kSubBuckets + 2;
+  const uint64_t mantissa = index % kSubBuckets;
+  return (kSubBuckets + mantissa + 1) << (exponent - 3);
+}
+
+int64_t LatencyHistogram::percentile_ns(const Snapshot & snapshot, double p) noexcept
+{
+  if (snapshot.count == 0) {
+    return 0;
+  }
+  const uint64_t rank = std::max<uint64_t>(
+    1, static_cast<uint64_t>(p * static_cast<double>(snapshot.count) + 0.5));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBuckets; ++i) {
+    seen += snapshot.buckets[i];
+    if (seen >= rank) {
+      const uint64_t upper = bucket_upper_ns(i);
+      return upper < static_cast<uint64_t>(snapshot.max_ns) ?
+        static_cast<int64_t>(upper) : snapshot.max_ns;
+    }
+  }
+  return snapshot.max_ns;
+}
+
+}  // namespace basic_navigation_cpp
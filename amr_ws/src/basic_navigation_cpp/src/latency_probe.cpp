@@ -0,0 +1,127 @@
+#include "basic_navigation_cpp/latency_probe.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <memory>
+
+#include "rclcpp_components/register_node_macro.hpp"
+
+namespace basic_navigation_cpp
+{
+
+namespace
+{
+
+int64_t steady_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double percentile_us(const std::vector<int64_t> & sorted_ns, double p)
+{
+  if (sorted_ns.empty()) {
+    return 0.0;
+  }
+  const size_t index = std::min(
+    sorted_ns.size() - 1, static_cast<size_t>(p * (sorted_ns.size() - 1) + 0.5));
+  return sorted_ns[index] / 1e3;
+}
+
+// A scan that is still unanswered after this long is counted as lost.
+constexpr int64_t kMaxPendingNs = 1000000000;
+
+}  // namespace
+
+LatencyProbe::LatencyProbe(const rclcpp::NodeOptions & options)
+: Node("latency_probe", options),
+  started_(false),
+  done_(false)
+{
+  mode_ = declare_parameter("mode", std::string("process"));
+  samples_ = static_cast<size_t>(declare_parameter("samples", 2000));
+  const double rate_hz = declare_parameter("rate_hz", 20.0);
+  const int beams = declare_parameter("beams", 720);
+
+  scan_.header.frame_id = "base_scan";
+  scan_.angle_min = static_cast<float>(-M_PI);
+  scan_.angle_max = static_cast<float>(M_PI);
+  scan_.angle_increment = static_cast<float>(2.0 * M_PI / beams);
+  scan_.range_min = 0.12f;
+  scan_.range_max = 3.5f;
+  scan_.ranges.assign(static_cast<size_t>(beams), scan_.range_max);
+  latency_ns_.reserve(samples_);
+
+  scan_pub_ = create_publisher<sensor_msgs::msg::LaserScan>("scan", rclcpp::SensorDataQoS());
+  cmd_vel_sub_ = create_subscription<geometry_msgs::msg::Twist>(
+    "cmd_vel", 10,
+    std::bind(&LatencyProbe::cmd_vel_callback, this, std::placeholders::_1));
+  start_client_ = create_client<std_srvs::srv::Empty>("start_navigation");
+  timer_ = create_wall_timer(
+    std::chrono::duration<double>(1.0 / rate_hz), [this]() {tick();});
+}
+
+void LatencyProbe::tick()
+{
+  if (done_) {
+    return;
+  }
+  if (!started_) {
+    if (start_client_->service_is_ready()) {
+      start_client_->async_send_request(std::make_shared<std_srvs::srv::Empty::Request>());
+      started_ = true;
+    }
+    return;
+  }
+
+  // Publishing a unique_ptr lets intra-process subscribers take the scan
+  // without a copy when the probe shares a container with the stack.
+  auto scan = std::make_unique<sensor_msgs::msg::LaserScan>(scan_);
+  scan->header.stamp = now();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const int64_t sent = steady_ns();
+    while (!in_flight_ns_.empty() && sent - in_flight_ns_.front() > kMaxPendingNs) {
+      in_flight_ns_.pop_front();
+    }
+    in_flight_ns_.push_back(sent);
+  }
+  scan_pub_->publish(std::move(scan));
+}
+
+void LatencyProbe::cmd_vel_callback(const geometry_msgs::msg::Twist::SharedPtr)
+{
+  const int64_t received = steady_ns();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (done_ || in_flight_ns_.empty()) {
+    return;
+  }
+  latency_ns_.push_back(received - in_flight_ns_.front());
+  in_flight_ns_.pop_front();
+  if (latency_ns_.size() >= samples_) {
+    done_ = true;
+    report();
+  }
+}
+
+void LatencyProbe::report()
+{
+  std::sort(latency_ns_.begin(), latency_ns_.end());
+  std::printf("mode,samples,p50_us,p99_us,p999_us,max_us\n");
+  std::printf(
+    "%s,%zu,%.1f,%.1f,%.1f,%.1f\n", mode_.c_str(), latency_ns_.size(),
+    percentile_us(latency_ns_, 0.5), percentile_us(latency_ns_, 0.99),
+    percentile_us(latency_ns_, 0.999), latency_ns_.back() / 1e3);
+  std::fflush(stdout);
+  RCLCPP_INFO(
+    get_logger(), "%s mode: scan -> cmd_vel p50 %.1f us, p99 %.1f us over %zu samples",
+    mode_.c_str(), percentile_us(latency_ns_, 0.5), percentile_us(latency_ns_, 0.99),
+    latency_ns_.size());
+}
+
+}  // namespace basic_navigation_cpp
+
+RCLCPP_COMPONENTS_REGISTER_NODE(basic_navigation_cpp::LatencyProbe)
@@ -0,0 +1,67 @@
+#include "basic_navigation_cpp/latency_tracer.hpp"
+
+#include <chrono>
+#include <limits>
+
+namespace basic_navigation_cpp
+{
+
+LatencyTracer::LatencyTracer(rclcpp::Node * node, const std::vector<std::string> & stages)
+: node_name_(node->get_name()),
+  clock_(node->get_clock()),
+  histograms_(stages.size())
+{
+  enabled_ = node->declare_parameter("latency_tracing", true);
+  const double period = node->declare_parameter("latency_report_period", 1.0);
+  msg_.node = node_name_;
+  msg_.stages.resize(stages.size());
+  for (size_t i = 0; i < stages.size(); ++i) {
+    msg_.stages[i].name = stages[i];
+  }
+  if (!enabled_) {
+    return;
+  }
+  window_start_ = clock_->now();
+  publisher_ = node->create_publisher<custom_interfaces::msg::LatencyHistogram>(
+    "latency_histogram", 10);
+  timer_ = node->create_wall_timer(
+    std::chrono::duration<double>(period), [this]() {publish();});
+}
+
+void LatencyTracer::publish()
+{
+  bool any = false;
+  for (size_t i = 0; i < histograms_.size(); ++i) {
+    histograms_[i].drain(snapshot_);
+    auto & stage = msg_.stages[i];
+    stage.count = snapshot_.count;
+    stage.p50_us = LatencyHistogram::percentile_ns(snapshot_, 0.5) / 1e3;
+    stage.p99_us = LatencyHistogram::percentile_ns(snapshot_, 0.99) / 1e3;
+    stage.max_us = snapshot_.max_ns / 1e3;
+    stage.bucket_upper_us.clear();
+    stage.bucket_count.clear();
+    for (size_t b = 0; b < LatencyHistogram::kBuckets; ++b) {
+      if (snapshot_.buckets[b] == 0) {
+        continue;
+      }
+      const uint64_t upper = LatencyHistogram::bucket_upper_ns(b);
+      stage.bucket_upper_us.push_back(
+        upper == std::numeric_limits<uint64_t>::max() ?
+        std::numeric_limits<double>::infinity() : upper / 1e3);
+      stage.bucket_count.push_back(snapshot_.buckets[b]);
+    }
+    any = any || snapshot_.count > 0;
+  }
+
+  const rclcpp::Time now = clock_->now();
+  msg_.window_s = (now - window_start_).seconds();
+  window_start_ = now;
+  // Idle nodes stay quiet instead of publishing empty windows.
+  if (!any) {
+    return;
+  }
+  msg_.header.stamp = now;
+  publisher_->publish(msg_);
+}
+
+}  // namespace basic_navigation_cpp
@@ -0,0 +1,44 @@
+#include "basic_navigation_cpp/rotation_controller.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace basic_navigation_cpp
+{
+
+RotationController::RotationController(const RotationLimits & limits)
+: limits_(limits), target_(0.0), remaining_(0.0), velocity_(0.0), done_(true)
+{
+}
+
+void RotationController::start(double target, double velocity)
+{
+  target_ = target;
+  remaining_ = target;
+  velocity_ = velocity;
+  done_ = false;
+}
+
+double RotationController::update(double travelled, double rate, double dt)
+{
+  if (done_) {
+    return 0.0;
+  }
+  remaining_ = target_ - travelled;
+  const double distance = std::abs(remaining_);
+  if (distance <= limits_.tolerance) {
+    velocity_ = 0.0;
+    done_ = std::abs(rate) <= limits_.min_speed;
+    return 0.0;
+  }
+
+  const double braking_speed = std::sqrt(2.0 * limits_.max_acceleration * distance);
+  const double speed = std::max(
+    limits_.min_speed, std::min(limits_.max_speed, braking_speed));
+  const double desired = std::copysign(speed, remaining_);
+  const double max_step = limits_.max_acceleration * dt;
+  velocity_ += std::max(-max_step, std::min(max_step, desired - velocity_));
+  return velocity_;
+}
+
+}  // namespace basic_navigation_cpp
@@ -0,0 +1,279 @@
+#include "basic_navigation_cpp/rotation_server.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "rclcpp_components/register_node_macro.hpp"
+#include "basic_navigation_cpp/angles.hpp"
+
+namespace basic_navigation_cpp
+{
+
+namespace
+{
+
+double deg_to_rad(double degrees)
+{
+  return degrees * M_PI / 180.0;
+}
+
+double yaw_of(const geometry_msgs::msg::Quaternion & q)
+{
+  return std::atan2(2.0 * (q.w * q.z + q.x * q.y), 1.0 - 2.0 * (q.y * q.y + q.z * q.z));
+}
+
+builtin_interfaces::msg::Time scan_stamp_of(const RotationServer::Rotate::Goal & goal)
+{
+  builtin_interfaces::msg::Time stamp;
+  stamp.sec = goal.scan_stamp_sec;
+  stamp.nanosec = goal.scan_stamp_nanosec;
+  return stamp;
+}
+
+}  // namespace
+
+// State machine of one rotation: waits for yaw, then follows the controller
+// until it reports done.
+class RotationServer::RotationTask : public GoalTask<Rotate>
+{
+public:
+  RotationTask(RotationServer & server, double target)
+  : server_(server), controller_(server.limits_), target_(target), waiting_(false),
+    started_(false), start_yaw_(0.0) {}
+
+  GoalStatus step(GoalContext<Rotate> & context) override
+  {
+    if (!waiting_) {
+      waiting_since_ = context.now;
+      waiting_ = true;
+    }
+    double yaw;
+    double yaw_rate;
+    if (!server_.current_yaw(context.now, yaw, yaw_rate)) {
+      // The first yaw may still be on its way when the goal arrives.
+      if (started_ || (context.now - waiting_since_).seconds() > server_.yaw_timeout_) {
+        RCLCPP_WARN(server_.get_logger(), "No yaw measurement, aborting rotation");
+        return stop(context, GoalStatus::kAborted);
+      }
+      return GoalStatus::kRunning;
+    }
+    if (!started_) {
+      start_yaw_ = yaw;
+      controller_.start(target_, server_.command_);
+    }
+
+    server_.command_ =
+      controller_.update(yaw - start_yaw_, yaw_rate, context.period_ns / 1e9);
+    if (controller_.done()) {
+      RCLCPP_INFO(
+        server_.get_logger(), "Rotation completed successfully, %.2f degrees off target",
+        controller_.remaining() * 180.0 / M_PI);
+      context.result->success = true;
+      return stop(context, GoalStatus::kSucceeded);
+    }
+    server_.publish_velocity(server_.command_);
+    if (!started_) {
+      server_.tracer_.record(kRotationStart, scan_stamp_of(*context.goal));
+      started_ = true;
+    }
+    auto feedback = std::make_shared<Rotate::Feedback>();
+    feedback->remaining_degrees =
+      static_cast<float>(std::abs(controller_.remaining()) * 180.0 / M_PI);
+    context.publish_feedback(feedback);
+    return GoalStatus::kRunning;
+  }
+
+  GoalStatus cancel(GoalContext<Rotate> & context) override
+  {
+    RCLCPP_INFO(server_.get_logger(), "Goal canceled");
+    return stop(context, GoalStatus::kCanceled);
+  }
+
+  void preempted(GoalContext<Rotate> &) override
+  {
+    // Keep turning; the next goal takes over from server_.command_.
+    RCLCPP_INFO(server_.get_logger(), "Goal preempted by a newer goal");
+  }
+
+  void absorb(GoalTask<Rotate> & older, GoalContext<Rotate> &) override
+  {
+    // What the older goal still had to turn: all of it if it never started.
+    const auto & task = static_cast<RotationTask &>(older);
+    const double pending = task.started_ ? task.controller_.remaining() : task.target_;
+    target_ += pending;
+    RCLCPP_INFO(
+      server_.get_logger(), "Merged %.1f pending degrees into the new goal, %.1f in total",
+      pending * 180.0 / M_PI, target_ * 180.0 / M_PI);
+  }
+
+private:
+  GoalStatus stop(GoalContext<Rotate> & context, GoalStatus status)
+  {
+    server_.command_ = 0.0;
+    server_.publish_velocity(0.0);
+    context.result->success = status == GoalStatus::kSucceeded;
+    return status;
+  }
+
+  RotationServer & server_;
+  RotationController controller_;
+  double target_;
+  bool waiting_;
+  bool started_;
+  double start_yaw_;
+  rclcpp::Time waiting_since_;
+};
+
+RotationServer::RotationServer(const rclcpp::NodeOptions & options)
+: Node("rotation_action_server", options),
+  command_(0.0),
+  has_yaw_(false),
+  last_raw_yaw_(0.0),
+  yaw_(0.0),
+  yaw_rate_(0.0),
+  tracer_(this, {"goal_received", "rotation_start"})
+{
+  limits_.max_speed = declare_parameter("rotation_speed", 1.0);
+  limits_.max_acceleration = declare_parameter("max_angular_acceleration", 1.5);
+  limits_.min_speed = declare_parameter("min_rotation_speed", 0.05);
+  limits_.tolerance = deg_to_rad(declare_parameter("tolerance_deg", 1.0));
+  yaw_timeout_ = declare_parameter("yaw_timeout", 0.5);
+  const double control_rate = declare_parameter("control_rate", 50.0);
+  const double feedback_rate = declare_parameter("feedback_rate", 10.0);
+  if (!(control_rate > 0.0)) {
+    throw std::invalid_argument("control_rate must be positive");
+  }
+  if (!(limits_.max_acceleration > 0.0)) {
+    throw std::invalid_argument("max_angular_acceleration must be positive");
+  }
+  if (!(limits_.min_speed >= 0.0) || !(limits_.tolerance >= 0.0) || !(yaw_timeout_ > 0.0)) {
+    throw std::invalid_argument(
+            "min_rotation_speed and tolerance_deg must not be negative, yaw_timeout must be "
+            "positive");
+  }
+  if (!(limits_.max_speed > 0.0)) {
+    RCLCPP_ERROR(get_logger(), "rotation_speed must be positive, goals will be rejected");
+  }
+  const std::string policy =
+    declare_parameter("goal_policy", std::string("preempt_latest"));
+  if (!parse_goal_policy(policy, policy_)) {
+    RCLCPP_WARN(
+      get_logger(), "Unknown goal_policy '%s', using preempt_latest", policy.c_str());
+    policy_ = GoalPolicy::kPreemptLatest;
+  } else if (policy_ == GoalPolicy::kParallel) {
+    RCLCPP_WARN(
+      get_logger(),
+      "goal_policy 'parallel' would let rotations fight over cmd_vel, using preempt_latest");
+    policy_ = GoalPolicy::kPreemptLatest;
+  }
+  const int64_t max_queue = declare_parameter("max_queue", 5);
+  const double metrics_period = declare_parameter("metrics_period", 1.0);
+
+  const std::string yaw_source = declare_parameter("yaw_source", std::string("imu"));
+  if (yaw_source == "odometry") {
+    odom_sub_ = create_subscription<nav_msgs::msg::Odometry>(
+      declare_parameter("odom_topic", std::string("odometry/filtered")), 10,
+      [this](const nav_msgs::msg::Odometry::SharedPtr msg) {
+        yaw_callback(msg->pose.pose.orientation, msg->twist.twist.angular.z);
+      });
+  } else {
+    imu_sub_ = create_subscription<sensor_msgs::msg::Imu>(
+      declare_parameter("imu_topic", std::string("imu/data")), rclcpp::SensorDataQoS(),
+      [this](const sensor_msgs::msg::Imu::SharedPtr msg) {
+        yaw_callback(msg->orientation, msg->angular_velocity.z);
+      });
+  }
+  vel_pub_ = create_publisher<geometry_msgs::msg::Twist>("cmd_vel", 10);
+
+  ActionEngine<Rotate>::Options engine_options;
+  engine_options.period = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::duration<double>(1.0 / control_rate));
+  engine_options.feedback_rate_hz = feedback_rate;
+  engine_options.policy = policy_;
+  engine_options.max_queue = static_cast<size_t>(std::max<int64_t>(max_queue, 0));
+  engine_options.filter =
+    [this](const rclcpp_action::GoalUUID &, std::shared_ptr<const Rotate::Goal> goal) {
+      tracer_.record(kGoalReceived, scan_stamp_of(*goal));
+      RCLCPP_INFO(get_logger(), "Received goal request to rotate %.1f degrees", goal->angle);
+      if (!(limits_.max_speed > 0.0)) {
+        RCLCPP_ERROR(get_logger(), "rotation_speed must be positive");
+        return rclcpp_action::GoalResponse::REJECT;
+      }
+      return rclcpp_action::GoalResponse::ACCEPT_AND_EXECUTE;
+    };
+  engine_ = std::make_unique<ActionEngine<Rotate>>(
+    this, "rotate",
+    [this](const std::shared_ptr<const Rotate::Goal> & goal) {
+      return std::make_unique<RotationTask>(*this, deg_to_rad(goal->angle));
+    },
+    engine_options);
+
+  metrics_pub_ = create_publisher<custom_interfaces::msg::GoalPolicyMetrics>(
+    "rotate/policy_metrics", 10);
+  if (metrics_period > 0.0) {
+    metrics_timer_ = create_wall_timer(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double>(metrics_period)),
+      [this]() {publish_metrics();});
+  }
+  RCLCPP_INFO(
+    get_logger(), "Rotation action server initialized (yaw from %s, %.0f Hz, %s)",
+    yaw_source.c_str(), control_rate, goal_policy_name(policy_));
+}
+
+void RotationServer::yaw_callback(
+  const geometry_msgs::msg::Quaternion & orientation, double yaw_rate)
+{
+  const double raw = yaw_of(orientation);
+  std::lock_guard<std::mutex> lock(yaw_mutex_);
+  yaw_ = has_yaw_ ? yaw_ + normalize_angle(raw - last_raw_yaw_) : raw;
+  last_raw_yaw_ = raw;
+  yaw_rate_ = yaw_rate;
+  has_yaw_ = true;
+  yaw_stamp_ = now();
+}
+
+bool RotationServer::current_yaw(const rclcpp::Time & now, double & yaw, double & yaw_rate)
+{
+  std::lock_guard<std::mutex> lock(yaw_mutex_);
+  if (!has_yaw_ || (now - yaw_stamp_).seconds() > yaw_timeout_) {
+    return false;
+  }
+  yaw = yaw_;
+  yaw_rate = yaw_rate_;
+  return true;
+}
+
+void RotationServer::publish_velocity(double angular_z)
+{
+  geometry_msgs::msg::Twist vel;
+  vel.angular.z = angular_z;
+  vel_pub_->publish(vel);
+}
+
+void RotationServer::publish_metrics()
+{
+  const GoalPolicyMetrics metrics = engine_->stats().policy;
+  custom_interfaces::msg::GoalPolicyMetrics msg;
+  msg.header.stamp = now();
+  msg.action = "rotate";
+  msg.policy = goal_policy_name(policy_);
+  msg.accepted = metrics.accepted;
+  msg.rejected = metrics.rejected;
+  msg.preempted = metrics.preempted;
+  msg.merged = metrics.merged;
+  msg.started = metrics.started;
+  msg.queue_depth = static_cast<uint32_t>(metrics.queue_depth);
+  msg.queue_waits = metrics.queue_waits;
+  msg.queue_wait_mean_s = metrics.queue_waits > 0 ?
+    metrics.queue_wait_total_ns / 1e9 / static_cast<double>(metrics.queue_waits) : 0.0;
+  msg.queue_wait_max_s = metrics.queue_wait_max_ns / 1e9;
+  metrics_pub_->publish(msg);
+}
+
+}  // namespace basic_navigation_cpp
+
+RCLCPP_COMPONENTS_REGISTER_NODE(basic_navigation_cpp::RotationServer)
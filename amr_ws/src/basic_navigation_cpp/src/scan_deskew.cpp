@@ -0,0 +1,193 @@
+#include "basic_navigation_cpp/scan_deskew.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "basic_navigation_cpp/angles.hpp"
+
+namespace basic_navigation_cpp
+{
+
+namespace
+{
+
+// Pose after moving for `dt` seconds at constant body velocities.
+Pose2D integrate(const Pose2D & pose, double linear, double angular, double dt)
+{
+  Pose2D moved;
+  moved.yaw = pose.yaw + angular * dt;
+  // Exact arc for a unicycle; a straight line when the rate is negligible.
+  if (std::abs(angular) > 1e-9) {
+    const double radius = linear / angular;
+    moved.x = pose.x + radius * (std::sin(moved.yaw) - std::sin(pose.yaw));
+    moved.y = pose.y - radius * (std::cos(moved.yaw) - std::cos(pose.yaw));
+  } else {
+    moved.x = pose.x + linear * dt * std::cos(pose.yaw);
+    moved.y = pose.y + linear * dt * std::sin(pose.yaw);
+  }
+  return moved;
+}
+
+// Beams per turn of a layout that covers a full turn, 0 otherwise. Drivers
+// space `count` beams either 2 pi / count apart, or, like Gazebo from -pi to
+// pi, 2 pi / (count - 1) apart so that the last beam repeats the first.
+int64_t beams_per_turn(const BeamLayout & layout)
+{
+  const double increment = std::abs(static_cast<double>(layout.angle_increment));
+  // Far above the float rounding of the increment and of a -3.14159 to
+  // 3.14159 configuration, far below a beam.
+  const double tolerance = 0.01 * increment;
+  const int64_t count = layout.count;
+  for (int64_t beams : {count, count - 1}) {
+    if (beams > 1 && std::abs(beams * increment - 2.0 * M_PI) < tolerance) {
+      return beams;
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
+void OdomHistory::add(int64_t stamp_ns, const Pose2D & pose, double linear, double angular)
+{
+  Sample sample{stamp_ns, pose, linear, angular};
+  if (!samples_.empty()) {
+    const Sample & last = samples_.back();
+    if (stamp_ns <= last.stamp_ns) {
+      return;
+    }
+    sample.pose.yaw = last.pose.yaw + normalize_angle(pose.yaw - last.pose.yaw);
+  }
+  samples_.push_back(sample);
+  while (samples_.size() > 2 && samples_.front().stamp_ns < stamp_ns - horizon_ns_) {
+    samples_.pop_front();
+  }
+}
+
+bool OdomHistory::pose_at(
+  int64_t stamp_ns, int64_t max_extrapolation_ns, Pose2D & pose) const
+{
+  if (samples_.empty()) {
+    return false;
+  }
+  const Sample & first = samples_.front();
+  const Sample & last = samples_.back();
+  if (stamp_ns <= first.stamp_ns || stamp_ns >= last.stamp_ns) {
+    const Sample & nearest = stamp_ns <= first.stamp_ns ? first : last;
+    const int64_t gap = stamp_ns - nearest.stamp_ns;
+    if (std::abs(gap) > max_extrapolation_ns) {
+      return false;
+    }
+    pose = integrate(nearest.pose, nearest.linear, nearest.angular, gap * 1e-9);
+    return true;
+  }
+  const auto after = std::upper_bound(
+    samples_.begin(), samples_.end(), stamp_ns,
+    [](int64_t stamp, const Sample & sample) {return stamp < sample.stamp_ns;});
+  const Sample & b = *after;
+  const Sample & a = *(after - 1);
+  const double s = static_cast<double>(stamp_ns - a.stamp_ns) /
+    static_cast<double>(b.stamp_ns - a.stamp_ns);
+  pose.x = a.pose.x + s * (b.pose.x - a.pose.x);
+  pose.y = a.pose.y + s * (b.pose.y - a.pose.y);
+  pose.yaw = a.pose.yaw + s * (b.pose.yaw - a.pose.yaw);
+  return true;
+}
+
+bool SweepDeskewer::deskew(
+  const float * ranges, const float * intensities, const BeamLayout & layout,
+  float range_min, float range_max, int64_t stamp_ns, double time_increment,
+  const OdomHistory & odom, int64_t max_extrapolation_ns,
+  float * out, float * out_intensities)
+{
+  const size_t count = layout.count;
+  if (count == 0) {
+    return true;
+  }
+  const int64_t sweep_ns = static_cast<int64_t>(time_increment * 1e9 * (count - 1));
+  Pose2D reference;
+  Pose2D end;
+  if (!odom.pose_at(stamp_ns, max_extrapolation_ns, reference) ||
+    !odom.pose_at(stamp_ns + sweep_ns, max_extrapolation_ns, end))
+  {
+    return false;
+  }
+  if (!table_ || table_->layout != layout) {
+    table_ = beam_table(layout);
+  }
+
+  const double ref_cos = std::cos(reference.yaw);
+  const double ref_sin = std::sin(reference.yaw);
+  const double lidar_cos = std::cos(lidar_.yaw);
+  const double lidar_sin = std::sin(lidar_.yaw);
+  const double increment = layout.angle_increment;
+  // Bins wrap around a full turn, where the first and last beams are
+  // neighbours or the same direction.
+  const int64_t turn = beams_per_turn(layout);
+  const bool with_intensities = intensities && out_intensities;
+  std::fill(out, out + count, std::numeric_limits<float>::quiet_NaN());
+  if (with_intensities) {
+    std::fill(out_intensities, out_intensities + count, 0.0f);
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    const float r = ranges[i];
+    // Comparisons with NaN are false, so NaN is rejected here as well.
+    if (!(r >= range_min && r <= range_max)) {
+      continue;
+    }
+    Pose2D pose;
+    // Inside [stamp, stamp + sweep], which was checked above.
+    odom.pose_at(
+      stamp_ns + static_cast<int64_t>(time_increment * 1e9 * i), max_extrapolation_ns, pose);
+    // Beam i's base pose relative to the base at the scan stamp.
+    const double dx = pose.x - reference.x;
+    const double dy = pose.y - reference.y;
+    const double rel_x = ref_cos * dx + ref_sin * dy;
+    const double rel_y = -ref_sin * dx + ref_cos * dy;
+    const double rel_yaw = pose.yaw - reference.yaw;
+
+    // lidar -> base at the beam's time -> base at the stamp -> lidar.
+    const double lx = r * table_->cos[i];
+    const double ly = r * table_->sin[i];
+    const double bx = lidar_.x + lidar_cos * lx - lidar_sin * ly;
+    const double by = lidar_.y + lidar_sin * lx + lidar_cos * ly;
+    const double c = std::cos(rel_yaw);
+    const double s = std::sin(rel_yaw);
+    const double px = rel_x + c * bx - s * by - lidar_.x;
+    const double py = rel_y + s * bx + c * by - lidar_.y;
+    const double qx = lidar_cos * px + lidar_sin * py;
+    const double qy = -lidar_sin * px + lidar_cos * py;
+
+    const double position = (std::atan2(qy, qx) - layout.angle_min) / increment;
+    int64_t bin = std::llround(position);
+    if (turn > 0) {
+      bin %= turn;
+      bin += bin < 0 ? turn : 0;
+    } else if (position < 0.0) {
+      // atan2 is in [-pi, pi] but the layout may reach past pi.
+      bin = std::llround(position + 2.0 * M_PI / increment);
+    }
+    if (bin < 0 || bin >= static_cast<int64_t>(count)) {
+      continue;
+    }
+    const float range = static_cast<float>(std::hypot(qx, qy));
+    // fmin-style: a NaN bin is empty.
+    if (!(out[bin] <= range)) {
+      out[bin] = range;
+      if (with_intensities) {
+        out_intensities[bin] = intensities[i];
+      }
+    }
+  }
+  if (turn == static_cast<int64_t>(count) - 1) {
+    out[count - 1] = out[0];
+    if (with_intensities) {
+      out_intensities[count - 1] = out_intensities[0];
+    }
+  }
+  return true;
+}
+
+}  // namespace basic_navigation_cpp
@@ -0,0 +1,112 @@
+#include "basic_navigation_cpp/scan_deskewer.hpp"
+
+#include <cmath>
+
+#include "rclcpp_components/register_node_macro.hpp"
+
+namespace basic_navigation_cpp
+{
+
+namespace
+{
+
+int64_t to_ns(const builtin_interfaces::msg::Time & stamp)
+{
+  return static_cast<int64_t>(stamp.sec) * 1000000000LL + stamp.nanosec;
+}
+
+}  // namespace
+
+ScanDeskewer::ScanDeskewer(const rclcpp::NodeOptions & options)
+: Node("scan_deskewer", options),
+  odom_(static_cast<int64_t>(1e9 * declare_parameter("odom_history", 1.0))),
+  forwarded_(0),
+  tracer_(this, {"receive", "deskew", "publish"})
+{
+  // lidar_joint in robot_description/urdf/robot_base.xacro has no planar
+  // offset from base_link.
+  Extrinsic2D lidar;
+  lidar.x = static_cast<float>(declare_parameter("lidar_x", 0.0));
+  lidar.y = static_cast<float>(declare_parameter("lidar_y", 0.0));
+  lidar.yaw = static_cast<float>(declare_parameter("lidar_yaw", 0.0));
+  deskewer_ = std::make_unique<SweepDeskewer>(lidar);
+  sweep_period_ = declare_parameter("sweep_period", 0.0);
+  // The simulated diff drive publishes odometry at 10 Hz, as slow as the
+  // scans, so the end of a sweep is usually past the newest sample.
+  max_extrapolation_ns_ = static_cast<int64_t>(1e9 * declare_parameter("max_extrapolation", 0.15));
+
+  scan_pub_ = create_publisher<sensor_msgs::msg::LaserScan>(
+    "scan/deskewed", rclcpp::SensorDataQoS());
+  odom_sub_ = create_subscription<nav_msgs::msg::Odometry>(
+    "odom", 50, std::bind(&ScanDeskewer::odom_callback, this, std::placeholders::_1));
+  scan_sub_ = create_subscription<sensor_msgs::msg::LaserScan>(
+    "scan", rclcpp::SensorDataQoS(),
+    std::bind(&ScanDeskewer::laser_callback, this, std::placeholders::_1));
+  RCLCPP_INFO(get_logger(), "Scan deskewer initialized");
+}
+
+void ScanDeskewer::odom_callback(const nav_msgs::msg::Odometry::SharedPtr msg)
+{
+  const auto & q = msg->pose.pose.orientation;
+  Pose2D pose;
+  pose.x = msg->pose.pose.position.x;
+  pose.y = msg->pose.pose.position.y;
+  pose.yaw = std::atan2(2.0 * (q.w * q.z + q.x * q.y), 1.0 - 2.0 * (q.y * q.y + q.z * q.z));
+  std::lock_guard<std::mutex> lock(odom_mutex_);
+  odom_.add(
+    to_ns(msg->header.stamp), pose, msg->twist.twist.linear.x, msg->twist.twist.angular.z);
+}
+
+void ScanDeskewer::laser_callback(const sensor_msgs::msg::LaserScan::SharedPtr msg)
+{
+  tracer_.record(kReceive, msg->header.stamp);
+  const size_t count = msg->ranges.size();
+  const double time_increment = sweep_period_ > 0.0 && count > 1 ?
+    sweep_period_ / static_cast<double>(count) : msg->time_increment;
+  if (time_increment == 0.0) {
+    // Every beam was taken at the stamp (e.g. Gazebo's ray sensor): nothing
+    // to correct.
+    scan_pub_->publish(*msg);
+    return;
+  }
+
+  deskewed_msg_.header = msg->header;
+  deskewed_msg_.angle_min = msg->angle_min;
+  deskewed_msg_.angle_max = msg->angle_max;
+  deskewed_msg_.angle_increment = msg->angle_increment;
+  // The beams now describe one instant.
+  deskewed_msg_.time_increment = 0.0f;
+  deskewed_msg_.scan_time = msg->scan_time;
+  deskewed_msg_.range_min = msg->range_min;
+  deskewed_msg_.range_max = msg->range_max;
+  deskewed_msg_.ranges.resize(count);
+  const bool with_intensities = msg->intensities.size() == count;
+  deskewed_msg_.intensities.resize(with_intensities ? count : 0);
+
+  const BeamLayout layout{msg->angle_min, msg->angle_increment, static_cast<uint32_t>(count)};
+  bool covered;
+  {
+    std::lock_guard<std::mutex> lock(odom_mutex_);
+    covered = deskewer_->deskew(
+      msg->ranges.data(), with_intensities ? msg->intensities.data() : nullptr, layout,
+      msg->range_min, msg->range_max, to_ns(msg->header.stamp), time_increment, odom_,
+      max_extrapolation_ns_, deskewed_msg_.ranges.data(),
+      with_intensities ? deskewed_msg_.intensities.data() : nullptr);
+  }
+  tracer_.record(kDeskew, msg->header.stamp);
+  if (!covered) {
+    ++forwarded_;
+    RCLCPP_WARN_THROTTLE(
+      get_logger(), *get_clock(), 5000,
+      "No odometry around the sweep, forwarding scans unchanged (%lu so far)",
+      static_cast<unsigned long>(forwarded_));
+    scan_pub_->publish(*msg);
+    return;
+  }
+  scan_pub_->publish(deskewed_msg_);
+  tracer_.record(kPublish, msg->header.stamp);
+}
+
+}  // namespace basic_navigation_cpp
+
+RCLCPP_COMPONENTS_REGISTER_NODE(basic_navigation_cpp::ScanDeskewer)
@@ -0,0 +1,144 @@
+#include "basic_navigation_cpp/scan_filter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace basic_navigation_cpp
+{
+
+namespace
+{
+
+constexpr float kNaN = std::numeric_limits<float>::quiet_NaN();
+constexpr float kInf = std::numeric_limits<float>::infinity();
+
+}  // namespace
+
+ScanFilter::ScanFilter(const ScanFilterConfig & config)
+: config_(config),
+  cos_min_(std::cos(config.shadow_min_angle)),
+  sin_min_(std::sin(config.shadow_min_angle)),
+  cos_max_(std::cos(config.shadow_max_angle)),
+  sin_max_(std::sin(config.shadow_max_angle)),
+  table_increment_(kNaN)
+{
+  // An even window has no middle; widen it by one.
+  config_.median_window = std::min(config_.median_window | 1, kMaxMedianWindow);
+}
+
+size_t ScanFilter::filter(
+  const float * ranges, size_t count, float angle_increment, float * out)
+{
+  clipped_.resize(count);
+  unshadowed_.resize(count);
+  clip(ranges, count, clipped_.data());
+  const float * stage = clipped_.data();
+  if (config_.shadow_window > 0) {
+    remove_shadows(stage, count, angle_increment, unshadowed_.data());
+    stage = unshadowed_.data();
+  }
+  if (config_.median_window > 1) {
+    median(stage, count, out);
+  } else {
+    std::copy(stage, stage + count, out);
+  }
+  size_t valid = 0;
+  for (size_t i = 0; i < count; ++i) {
+    valid += std::isnan(out[i]) ? 0 : 1;
+  }
+  return valid;
+}
+
+void ScanFilter::clip(const float * ranges, size_t count, float * out) const
+{
+  for (size_t i = 0; i < count; ++i) {
+    const float r = ranges[i];
+    // Comparisons with NaN are false, so NaN is rejected here as well.
+    out[i] = (r >= config_.range_min && r <= config_.range_max) || r == kInf ? r : kNaN;
+  }
+}
+
+void ScanFilter::remove_shadows(
+  const float * ranges, size_t count, float angle_increment, float * out)
+{
+  const size_t window = config_.shadow_window;
+  if (angle_increment != table_increment_) {
+    cos_offset_.resize(window + 1);
+    sin_offset_.resize(window + 1);
+    for (size_t k = 1; k <= window; ++k) {
+      cos_offset_[k] = static_cast<float>(std::cos(k * static_cast<double>(angle_increment)));
+      sin_offset_[k] = std::fabs(
+        static_cast<float>(std::sin(k * static_cast<double>(angle_increment))));
+    }
+    table_increment_ = angle_increment;
+  }
+
+  std::copy(ranges, ranges + count, out);
+  for (size_t i = 0; i < count; ++i) {
+    const float a = ranges[i];
+    // No point to form a segment with for NaN or +inf.
+    if (!std::isfinite(a)) {
+      continue;
+    }
+    for (size_t k = 1; k <= window && i + k < count; ++k) {
+      const float b = ranges[i + k];
+      if (!std::isfinite(b)) {
+        continue;
+      }
+      // Segment from the nearer point to the farther one, in the frame of
+      // the nearer ray: (along the ray back to the sensor, across it). Its
+      // angle is compared through cross products with the unit vectors at
+      // the limits, so no atan2 per pair.
+      const float near = std::min(a, b);
+      const float far = std::max(a, b);
+      const float along = near - far * cos_offset_[k];
+      const float across = far * sin_offset_[k];
+      const bool too_shallow = along * sin_min_ - across * cos_min_ > 0.0f;
+      const bool too_steep = across * cos_max_ - along * sin_max_ > 0.0f;
+      if (too_shallow || too_steep) {
+        out[a > b ? i : i + k] = kNaN;
+      }
+    }
+  }
+}
+
+void ScanFilter::median(const float * ranges, size_t count, float * out) const
+{
+  const size_t half = config_.median_window / 2;
+  float window[kMaxMedianWindow];
+  for (size_t i = 0; i < count; ++i) {
+    if (std::isnan(ranges[i])) {
+      out[i] = kNaN;
+      continue;
+    }
+    const size_t begin = i >= half ? i - half : 0;
+    const size_t end = std::min(count, i + half + 1);
+    size_t n = 0;
+    for (size_t j = begin; j < end; ++j) {
+      if (!std::isnan(ranges[j])) {
+        window[n++] = ranges[j];
+      }
+    }
+    std::nth_element(window, window + n / 2, window + n);
+    out[i] = window[n / 2];
+  }
+}
+
+size_t decimate_scan(const float * ranges, size_t count, size_t factor, float * out)
+{
+  factor = std::max<size_t>(factor, 1);
+  size_t beams = 0;
+  for (size_t begin = 0; begin < count; begin += factor) {
+    const size_t end = std::min(count, begin + factor);
+    float nearest = kNaN;
+    for (size_t i = begin; i < end; ++i) {
+      // fmin ignores a NaN operand and prefers any return to +inf.
+      nearest = std::fmin(nearest, ranges[i]);
+    }
+    out[beams++] = nearest;
+  }
+  return beams;
+}
+
+}  // namespace basic_navigation_cpp
@@ -0,0 +1,253 @@
+#include "basic_navigation_cpp/scan_geometry.hpp"
+
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define BASIC_NAVIGATION_CPP_HAVE_AVX2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define BASIC_NAVIGATION_CPP_HAVE_NEON 1
+#endif
+
+namespace basic_navigation_cpp
+{
+
+namespace
+{
+
+constexpr float kNaN = std::numeric_limits<float>::quiet_NaN();
+// Distinct layouts kept alive by the cache; a robot has one or two lidars.
+constexpr size_t kMaxTables = 8;
+
+// Extrinsic rotation and translation, shared by every kernel.
+struct Transform
+{
+  float cos_yaw;
+  float sin_yaw;
+  float x;
+  float y;
+};
+
+// Converts beams [begin, end) and returns how many of them were valid.
+size_t project_block_scalar(
+  const BeamTable & table, const float * ranges, size_t begin, size_t end, float range_min,
+  float range_max, const Transform & t, float * x, float * y)
+{
+  size_t valid = 0;
+  for (size_t i = begin; i < end; ++i) {
+    const float r = ranges[i];
+    // Comparisons with NaN are false, so NaN is rejected here as well.
+    if (!(r >= range_min && r <= range_max)) {
+      x[i] = kNaN;
+      y[i] = kNaN;
+      continue;
+    }
+    const float lx = r * table.cos[i];
+    const float ly = r * table.sin[i];
+    x[i] = t.x + t.cos_yaw * lx - t.sin_yaw * ly;
+    y[i] = t.y + t.sin_yaw * lx + t.cos_yaw * ly;
+    ++valid;
+  }
+  return valid;
+}
+
+#if defined(BASIC_NAVIGATION_CPP_HAVE_AVX2)
+
+// Converts whole blocks of 8 beams from `begin`; returns the first beam left
+// for the scalar tail.
+__attribute__((target("avx2")))
+size_t project_block_avx2(
+  const BeamTable & table, const float * ranges, size_t begin, size_t end, float range_min,
+  float range_max, const Transform & t, float * x, float * y, size_t & valid)
+{
+  const __m256 lo = _mm256_set1_ps(range_min);
+  const __m256 hi = _mm256_set1_ps(range_max);
+  const __m256 nan = _mm256_set1_ps(kNaN);
+  const __m256 cy = _mm256_set1_ps(t.cos_yaw);
+  const __m256 sy = _mm256_set1_ps(t.sin_yaw);
+  const __m256 tx = _mm256_set1_ps(t.x);
+  const __m256 ty = _mm256_set1_ps(t.y);
+  const float * c = table.cos.data();
+  const float * s = table.sin.data();
+
+  size_t i = begin;
+  for (; i + 8 <= end; i += 8) {
+    const __m256 r = _mm256_loadu_ps(ranges + i);
+    // Ordered predicates are false for NaN, which drops it with the out of
+    // range returns.
+    const __m256 ok = _mm256_and_ps(
+      _mm256_cmp_ps(r, lo, _CMP_GE_OQ), _mm256_cmp_ps(r, hi, _CMP_LE_OQ));
+    const __m256 lx = _mm256_mul_ps(r, _mm256_loadu_ps(c + i));
+    const __m256 ly = _mm256_mul_ps(r, _mm256_loadu_ps(s + i));
+    const __m256 px = _mm256_add_ps(
+      tx, _mm256_sub_ps(_mm256_mul_ps(cy, lx), _mm256_mul_ps(sy, ly)));
+    const __m256 py = _mm256_add_ps(
+      ty, _mm256_add_ps(_mm256_mul_ps(sy, lx), _mm256_mul_ps(cy, ly)));
+    _mm256_storeu_ps(x + i, _mm256_blendv_ps(nan, px, ok));
+    _mm256_storeu_ps(y + i, _mm256_blendv_ps(nan, py, ok));
+    valid += static_cast<size_t>(__builtin_popcount(_mm256_movemask_ps(ok)));
+  }
+  return i;
+}
+
+bool cpu_has_avx2()
+{
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+}
+
+#elif defined(BASIC_NAVIGATION_CPP_HAVE_NEON)
+
+size_t project_block_neon(
+  const BeamTable & table, const float * ranges, size_t begin, size_t end, float range_min,
+  float range_max, const Transform & t, float * x, float * y, size_t & valid)
+{
+  const float32x4_t lo = vdupq_n_f32(range_min);
+  const float32x4_t hi = vdupq_n_f32(range_max);
+  const float32x4_t nan = vdupq_n_f32(kNaN);
+  const float32x4_t tx = vdupq_n_f32(t.x);
+  const float32x4_t ty = vdupq_n_f32(t.y);
+  const float * c = table.cos.data();
+  const float * s = table.sin.data();
+  uint32x4_t count = vdupq_n_u32(0);
+
+  size_t i = begin;
+  for (; i + 4 <= end; i += 4) {
+    const float32x4_t r = vld1q_f32(ranges + i);
+    const uint32x4_t ok = vandq_u32(vcgeq_f32(r, lo), vcleq_f32(r, hi));
+    const float32x4_t lx = vmulq_f32(r, vld1q_f32(c + i));
+    const float32x4_t ly = vmulq_f32(r, vld1q_f32(s + i));
+    const float32x4_t px = vmlsq_n_f32(vmlaq_n_f32(tx, lx, t.cos_yaw), ly, t.sin_yaw);
+    const float32x4_t py = vmlaq_n_f32(vmlaq_n_f32(ty, lx, t.sin_yaw), ly, t.cos_yaw);
+    vst1q_f32(x + i, vbslq_f32(ok, px, nan));
+    vst1q_f32(y + i, vbslq_f32(ok, py, nan));
+    count = vsubq_u32(count, ok);
+  }
+  uint32_t lanes[4];
+  vst1q_u32(lanes, count);
+  valid += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+  return i;
+}
+
+#endif
+
+using BlockKernel = size_t (*)(
+  const BeamTable &, const float *, size_t, size_t, float, float, const Transform &,
+  float *, float *, size_t &);
+
+BlockKernel vector_kernel()
+{
+#if defined(BASIC_NAVIGATION_CPP_HAVE_AVX2)
+  return cpu_has_avx2() ? &project_block_avx2 : nullptr;
+#elif defined(BASIC_NAVIGATION_CPP_HAVE_NEON)
+  return &project_block_neon;
+#else
+  return nullptr;
+#endif
+}
+
+void project_scan_with(
+  BlockKernel kernel, const BeamTable & table, const float * ranges, float range_min,
+  float range_max, const Extrinsic2D & extrinsic, ScanPoints & out)
+{
+  const size_t count = table.layout.count;
+  out.x.resize(count);
+  out.y.resize(count);
+  const Transform t{std::cos(extrinsic.yaw), std::sin(extrinsic.yaw), extrinsic.x, extrinsic.y};
+  size_t valid = 0;
+  const size_t tail = kernel ?
+    kernel(table, ranges, 0, count, range_min, range_max, t, out.x.data(), out.y.data(), valid) :
+    0;
+  valid += project_block_scalar(
+    table, ranges, tail, count, range_min, range_max, t, out.x.data(), out.y.data());
+  out.valid = valid;
+}
+
+}  // namespace
+
+std::shared_ptr<const BeamTable> beam_table(const BeamLayout & layout)
+{
+  static std::mutex mutex;
+  // Most recently used last.
+  static std::vector<std::shared_ptr<const BeamTable>> tables;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  for (auto it = tables.begin(); it != tables.end(); ++it) {
+    if ((*it)->layout == layout) {
+      auto table = *it;
+      tables.erase(it);
+      tables.push_back(table);
+      return table;
+    }
+  }
+
+  auto table = std::make_shared<BeamTable>();
+  table->layout = layout;
+  table->cos.resize(layout.count);
+  table->sin.resize(layout.count);
+  for (uint32_t i = 0; i < layout.count; ++i) {
+    const double angle = static_cast<double>(layout.angle_min) +
+      static_cast<double>(i) * static_cast<double>(layout.angle_increment);
+    table->cos[i] = static_cast<float>(std::cos(angle));
+    table->sin[i] = static_cast<float>(std::sin(angle));
+  }
+  // Consumers still holding an evicted table keep it alive.
+  if (tables.size() == kMaxTables) {
+    tables.erase(tables.begin());
+  }
+  tables.push_back(table);
+  return table;
+}
+
+void project_scan(
+  const BeamTable & table, const float * ranges, float range_min, float range_max,
+  const Extrinsic2D & extrinsic, ScanPoints & out)
+{
+  static const BlockKernel kernel = vector_kernel();
+  project_scan_with(kernel, table, ranges, range_min, range_max, extrinsic, out);
+}
+
+void project_scan_scalar(
+  const BeamTable & table, const float * ranges, float range_min, float range_max,
+  const Extrinsic2D & extrinsic, ScanPoints & out)
+{
+  project_scan_with(nullptr, table, ranges, range_min, range_max, extrinsic, out);
+}
+
+const char * project_scan_kernel()
+{
+#if defined(BASIC_NAVIGATION_CPP_HAVE_AVX2)
+  return cpu_has_avx2() ? "avx2" : "scalar";
+#elif defined(BASIC_NAVIGATION_CPP_HAVE_NEON)
+  return "neon";
+#else
+  return "scalar";
+#endif
+}
+
+float closest_ahead(const ScanPoints & points, float half_width)
+{
+  float closest = std::numeric_limits<float>::infinity();
+  for (size_t i = 0; i < points.x.size(); ++i) {
+    // NaN fails every comparison and is skipped.
+    if (points.x[i] > 0.0f && std::abs(points.y[i]) <= half_width && points.x[i] < closest) {
+      closest = points.x[i];
+    }
+  }
+  return closest;
+}
+
+const ScanPoints & ScanProjector::project(
+  const float * ranges, const BeamLayout & layout, float range_min, float range_max)
+{
+  if (!table_ || table_->layout != layout) {
+    table_ = beam_table(layout);
+  }
+  project_scan(*table_, ranges, range_min, range_max, extrinsic_, points_);
+  return points_;
+}
+
+}  // namespace basic_navigation_cpp
@@ -0,0 +1,94 @@
+#include "basic_navigation_cpp/scan_preprocessor.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "rclcpp_components/register_node_macro.hpp"
+
+namespace basic_navigation_cpp
+{
+
+namespace
+{
+
+float deg_to_rad(double degrees)
+{
+  return static_cast<float>(degrees * M_PI / 180.0);
+}
+
+}  // namespace
+
+ScanPreprocessor::ScanPreprocessor(const rclcpp::NodeOptions & options)
+: Node("scan_preprocessor", options),
+  tracer_(this, {"receive", "filter", "publish"})
+{
+  // Defaults follow the simulated lidar in robot_description/urdf/sensors.xacro.
+  ScanFilterConfig config;
+  config.range_min = static_cast<float>(declare_parameter("range_min", 0.12));
+  config.range_max = static_cast<float>(declare_parameter("range_max", 10.0));
+  config.shadow_min_angle = deg_to_rad(declare_parameter("shadow_min_angle_deg", 10.0));
+  config.shadow_max_angle = deg_to_rad(declare_parameter("shadow_max_angle_deg", 170.0));
+  config.shadow_window = static_cast<size_t>(
+    std::max<int64_t>(declare_parameter("shadow_window", 1), 0));
+  config.median_window = static_cast<size_t>(
+    std::max<int64_t>(declare_parameter("median_window", 3), 1));
+  filter_ = std::make_unique<ScanFilter>(config);
+  decimation_ = static_cast<size_t>(std::max<int64_t>(declare_parameter("decimation", 4), 1));
+
+  filtered_pub_ = create_publisher<sensor_msgs::msg::LaserScan>(
+    "scan/filtered", rclcpp::SensorDataQoS());
+  decimated_pub_ = create_publisher<sensor_msgs::msg::LaserScan>(
+    "scan/decimated", rclcpp::SensorDataQoS());
+  scan_sub_ = create_subscription<sensor_msgs::msg::LaserScan>(
+    "scan", rclcpp::SensorDataQoS(),
+    std::bind(&ScanPreprocessor::laser_callback, this, std::placeholders::_1));
+  RCLCPP_INFO(
+    get_logger(), "Scan preprocessor initialized (median %zu, shadow window %zu, "
+    "decimation %zu)", filter_->config().median_window, config.shadow_window, decimation_);
+}
+
+void ScanPreprocessor::laser_callback(const sensor_msgs::msg::LaserScan::SharedPtr msg)
+{
+  tracer_.record(kReceive, msg->header.stamp);
+  const size_t count = msg->ranges.size();
+  const ScanFilterConfig & config = filter_->config();
+
+  filtered_msg_.header = msg->header;
+  filtered_msg_.angle_min = msg->angle_min;
+  filtered_msg_.angle_max = msg->angle_max;
+  filtered_msg_.angle_increment = msg->angle_increment;
+  filtered_msg_.time_increment = msg->time_increment;
+  filtered_msg_.scan_time = msg->scan_time;
+  filtered_msg_.range_min = std::max(msg->range_min, config.range_min);
+  filtered_msg_.range_max = std::min(msg->range_max, config.range_max);
+  filtered_msg_.ranges.resize(count);
+  filter_->filter(
+    msg->ranges.data(), count, msg->angle_increment, filtered_msg_.ranges.data());
+  // Intensities of removed beams are meaningless but harmless; keep them so
+  // consumers that read them still see one per beam.
+  filtered_msg_.intensities = msg->intensities;
+
+  const float factor = static_cast<float>(decimation_);
+  decimated_msg_.header = msg->header;
+  decimated_msg_.angle_min =
+    msg->angle_min + 0.5f * (factor - 1.0f) * msg->angle_increment;
+  decimated_msg_.angle_increment = factor * msg->angle_increment;
+  decimated_msg_.time_increment = factor * msg->time_increment;
+  decimated_msg_.scan_time = msg->scan_time;
+  decimated_msg_.range_min = filtered_msg_.range_min;
+  decimated_msg_.range_max = filtered_msg_.range_max;
+  decimated_msg_.ranges.resize((count + decimation_ - 1) / decimation_);
+  const size_t beams = decimate_scan(
+    filtered_msg_.ranges.data(), count, decimation_, decimated_msg_.ranges.data());
+  decimated_msg_.angle_max = decimated_msg_.angle_min +
+    static_cast<float>(beams > 0 ? beams - 1 : 0) * decimated_msg_.angle_increment;
+  tracer_.record(kFilter, msg->header.stamp);
+
+  filtered_pub_->publish(filtered_msg_);
+  decimated_pub_->publish(decimated_msg_);
+  tracer_.record(kPublish, msg->header.stamp);
+}
+
+}  // namespace basic_navigation_cpp
+
+RCLCPP_COMPONENTS_REGISTER_NODE(basic_navigation_cpp::ScanPreprocessor)
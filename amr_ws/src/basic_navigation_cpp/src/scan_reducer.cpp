@@ -0,0 +1,71 @@
+#include "basic_navigation_cpp/scan_reducer.hpp"
+
+#include <stdexcept>
+
+#include "rclcpp_components/register_node_macro.hpp"
+
+namespace basic_navigation_cpp
+{
+
+ScanReducer::ScanReducer(const rclcpp::NodeOptions & options)
+: Node("scan_reducer", options),
+  tracer_(this, {"receive", "reduce", "publish"})
+{
+  const int sectors = declare_parameter("sectors", 3);
+  stats_.resize(sectors > 0 ? sectors : 1);
+  sectors_msg_.min_range.resize(stats_.size());
+  sectors_msg_.mean_range.resize(stats_.size());
+  sectors_msg_.argmin.resize(stats_.size());
+  sectors_msg_.valid_count.resize(stats_.size());
+
+  // lidar_joint in robot_description/urdf/robot_base.xacro has no planar
+  // offset from base_link, and the chassis is 0.3 m wide.
+  Extrinsic2D lidar;
+  lidar.x = static_cast<float>(declare_parameter("lidar_x", 0.0));
+  lidar.y = static_cast<float>(declare_parameter("lidar_y", 0.0));
+  lidar.yaw = static_cast<float>(declare_parameter("lidar_yaw", 0.0));
+  projector_.set_extrinsic(lidar);
+  const double corridor_width = declare_parameter("corridor_width", 0.3);
+  if (corridor_width <= 0.0) {
+    throw std::invalid_argument("corridor_width must be positive");
+  }
+  half_width_ = static_cast<float>(0.5 * corridor_width);
+
+  sectors_pub_ = create_publisher<custom_interfaces::msg::ScanSectors>("scan_sectors", 10);
+  scan_sub_ = create_subscription<sensor_msgs::msg::LaserScan>(
+    "scan", rclcpp::SensorDataQoS(),
+    std::bind(&ScanReducer::laser_callback, this, std::placeholders::_1));
+  RCLCPP_INFO(get_logger(), "Scan reducer initialized with %zu sectors", stats_.size());
+}
+
+void ScanReducer::laser_callback(const sensor_msgs::msg::LaserScan::SharedPtr msg)
+{
+  tracer_.record(kReceive, msg->header.stamp);
+  const size_t sectors = stats_.size();
+  reduce_sectors(
+    msg->ranges.data(), msg->ranges.size(), msg->range_min, msg->range_max,
+    sectors, stats_.data());
+
+  sectors_msg_.header = msg->header;
+  sectors_msg_.angle_min = msg->angle_min;
+  sectors_msg_.sector_width =
+    msg->angle_increment * static_cast<float>(msg->ranges.size()) / sectors;
+  for (size_t s = 0; s < sectors; ++s) {
+    sectors_msg_.min_range[s] = stats_[s].min_range;
+    sectors_msg_.mean_range[s] = stats_[s].mean_range;
+    sectors_msg_.argmin[s] = stats_[s].argmin;
+    sectors_msg_.valid_count[s] = stats_[s].valid_count;
+  }
+  const BeamLayout layout{
+    msg->angle_min, msg->angle_increment, static_cast<uint32_t>(msg->ranges.size())};
+  sectors_msg_.forward_clearance = closest_ahead(
+    projector_.project(msg->ranges.data(), layout, msg->range_min, msg->range_max),
+    half_width_);
+  tracer_.record(kReduce, msg->header.stamp);
+  sectors_pub_->publish(sectors_msg_);
+  tracer_.record(kPublish, msg->header.stamp);
+}
+
+}  // namespace basic_navigation_cpp
+
+RCLCPP_COMPONENTS_REGISTER_NODE(basic_navigation_cpp::ScanReducer)
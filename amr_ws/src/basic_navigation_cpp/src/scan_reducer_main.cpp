@@ -0,0 +1,12 @@
+#include <memory>
+
+#include "rclcpp/rclcpp.hpp"
+#include "basic_navigation_cpp/scan_reducer.hpp"
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  rclcpp::spin(std::make_shared<basic_navigation_cpp::ScanReducer>());
+  rclcpp::shutdown();
+  return 0;
+}
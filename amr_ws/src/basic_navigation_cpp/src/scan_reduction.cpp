@@ -0,0 +1,225 @@
+#include "basic_navigation_cpp/scan_reduction.hpp"
+
+#include <limits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define BASIC_NAVIGATION_CPP_HAVE_AVX2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define BASIC_NAVIGATION_CPP_HAVE_NEON 1
+#endif
+
+namespace basic_navigation_cpp
+{
+
+namespace
+{
+
+constexpr float kInf = std::numeric_limits<float>::infinity();
+
+// Scalar reduction of ranges[begin, end) folded into `stats` and `sum`. Only a
+// strictly smaller return replaces the minimum, so argmin is the first index
+// holding it, which is what the vector kernels reproduce across lanes.
+void reduce_block_scalar(
+  const float * ranges, size_t begin, size_t end, float range_min, float range_max,
+  SectorStats & stats, double & sum)
+{
+  for (size_t i = begin; i < end; ++i) {
+    const float r = ranges[i];
+    // Comparisons with NaN are false, so NaN is rejected here as well.
+    if (!(r >= range_min && r <= range_max)) {
+      continue;
+    }
+    sum += r;
+    ++stats.valid_count;
+    if (r < stats.min_range) {
+      stats.min_range = r;
+      stats.argmin = static_cast<uint32_t>(i);
+    }
+  }
+}
+
+// Folds per-lane minima into `stats`, keeping the lowest index on ties.
+template<size_t Lanes>
+void merge_lanes(const float (& min)[Lanes], const uint32_t (& index)[Lanes], SectorStats & stats)
+{
+  for (size_t l = 0; l < Lanes; ++l) {
+    if (min[l] < stats.min_range || (min[l] == stats.min_range && min[l] < kInf &&
+      index[l] < stats.argmin))
+    {
+      stats.min_range = min[l];
+      stats.argmin = index[l];
+    }
+  }
+}
+
+#if defined(BASIC_NAVIGATION_CPP_HAVE_AVX2)
+
+__attribute__((target("avx2")))
+size_t reduce_block_avx2(
+  const float * ranges, size_t begin, size_t end, float range_min, float range_max,
+  SectorStats & stats, double & sum)
+{
+  const __m256 lo = _mm256_set1_ps(range_min);
+  const __m256 hi = _mm256_set1_ps(range_max);
+  const __m256 inf = _mm256_set1_ps(kInf);
+  const __m256i step = _mm256_set1_epi32(8);
+  __m256i index = _mm256_add_epi32(
+    _mm256_set1_epi32(static_cast<int>(begin)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+  __m256i best_index = index;
+  __m256i count = _mm256_setzero_si256();
+  __m256 best = inf;
+  __m256 total = _mm256_setzero_ps();
+
+  size_t i = begin;
+  for (; i + 8 <= end; i += 8) {
+    const __m256 r = _mm256_loadu_ps(ranges + i);
+    // Ordered predicates are false for NaN, which drops it with the out of
+    // range returns.
+    const __m256 valid = _mm256_and_ps(
+      _mm256_cmp_ps(r, lo, _CMP_GE_OQ), _mm256_cmp_ps(r, hi, _CMP_LE_OQ));
+    total = _mm256_add_ps(total, _mm256_and_ps(r, valid));
+    count = _mm256_sub_epi32(count, _mm256_castps_si256(valid));
+    const __m256 candidate = _mm256_blendv_ps(inf, r, valid);
+    const __m256 smaller = _mm256_cmp_ps(candidate, best, _CMP_LT_OQ);
+    best = _mm256_blendv_ps(best, candidate, smaller);
+    best_index = _mm256_castps_si256(
+      _mm256_blendv_ps(
+        _mm256_castsi256_ps(best_index), _mm256_castsi256_ps(index), smaller));
+    index = _mm256_add_epi32(index, step);
+  }
+
+  alignas(32) float lane_min[8];
+  alignas(32) uint32_t lane_index[8];
+  alignas(32) float lane_sum[8];
+  alignas(32) uint32_t lane_count[8];
+  _mm256_store_ps(lane_min, best);
+  _mm256_store_si256(reinterpret_cast<__m256i *>(lane_index), best_index);
+  _mm256_store_ps(lane_sum, total);
+  _mm256_store_si256(reinterpret_cast<__m256i *>(lane_count), count);
+  for (size_t l = 0; l < 8; ++l) {
+    sum += lane_sum[l];
+    stats.valid_count += lane_count[l];
+  }
+  merge_lanes(lane_min, lane_index, stats);
+  return i;
+}
+
+bool cpu_has_avx2()
+{
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+}
+
+#elif defined(BASIC_NAVIGATION_CPP_HAVE_NEON)
+
+size_t reduce_block_neon(
+  const float * ranges, size_t begin, size_t end, float range_min, float range_max,
+  SectorStats & stats, double & sum)
+{
+  const float32x4_t lo = vdupq_n_f32(range_min);
+  const float32x4_t hi = vdupq_n_f32(range_max);
+  const float32x4_t inf = vdupq_n_f32(kInf);
+  const uint32x4_t step = vdupq_n_u32(4);
+  const uint32_t first[4] = {0, 1, 2, 3};
+  uint32x4_t index = vaddq_u32(vdupq_n_u32(static_cast<uint32_t>(begin)), vld1q_u32(first));
+  uint32x4_t best_index = index;
+  uint32x4_t count = vdupq_n_u32(0);
+  float32x4_t best = inf;
+  float32x4_t total = vdupq_n_f32(0.0f);
+
+  size_t i = begin;
+  for (; i + 4 <= end; i += 4) {
+    const float32x4_t r = vld1q_f32(ranges + i);
+    const uint32x4_t valid = vandq_u32(vcgeq_f32(r, lo), vcleq_f32(r, hi));
+    total = vaddq_f32(
+      total, vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(r), valid)));
+    count = vsubq_u32(count, valid);
+    const float32x4_t candidate = vbslq_f32(valid, r, inf);
+    const uint32x4_t smaller = vcltq_f32(candidate, best);
+    best = vbslq_f32(smaller, candidate, best);
+    best_index = vbslq_u32(smaller, index, best_index);
+    index = vaddq_u32(index, step);
+  }
+
+  float lane_min[4];
+  uint32_t lane_index[4];
+  float lane_sum[4];
+  uint32_t lane_count[4];
+  vst1q_f32(lane_min, best);
+  vst1q_u32(lane_index, best_index);
+  vst1q_f32(lane_sum, total);
+  vst1q_u32(lane_count, count);
+  for (size_t l = 0; l < 4; ++l) {
+    sum += lane_sum[l];
+    stats.valid_count += lane_count[l];
+  }
+  merge_lanes(lane_min, lane_index, stats);
+  return i;
+}
+
+#endif
+
+using BlockKernel = size_t (*)(
+  const float *, size_t, size_t, float, float, SectorStats &, double &);
+
+BlockKernel vector_kernel()
+{
+#if defined(BASIC_NAVIGATION_CPP_HAVE_AVX2)
+  return cpu_has_avx2() ? &reduce_block_avx2 : nullptr;
+#elif defined(BASIC_NAVIGATION_CPP_HAVE_NEON)
+  return &reduce_block_neon;
+#else
+  return nullptr;
+#endif
+}
+
+void reduce_sectors_with(
+  BlockKernel kernel, const float * ranges, size_t count, float range_min, float range_max,
+  size_t sectors, SectorStats * out)
+{
+  for (size_t s = 0; s < sectors; ++s) {
+    const size_t begin = s * count / sectors;
+    const size_t end = (s + 1) * count / sectors;
+    SectorStats stats{kInf, 0.0f, static_cast<uint32_t>(begin), 0};
+    double sum = 0.0;
+    const size_t tail = kernel ?
+      kernel(ranges, begin, end, range_min, range_max, stats, sum) : begin;
+    reduce_block_scalar(ranges, tail, end, range_min, range_max, stats, sum);
+    stats.mean_range = stats.valid_count > 0 ?
+      static_cast<float>(sum / stats.valid_count) :
+      std::numeric_limits<float>::quiet_NaN();
+    out[s] = stats;
+  }
+}
+
+}  // namespace
+
+void reduce_sectors(
+  const float * ranges, size_t count, float range_min, float range_max,
+  size_t sectors, SectorStats * out)
+{
+  static const BlockKernel kernel = vector_kernel();
+  reduce_sectors_with(kernel, ranges, count, range_min, range_max, sectors, out);
+}
+
+void reduce_sectors_scalar(
+  const float * ranges, size_t count, float range_min, float range_max,
+  size_t sectors, SectorStats * out)
+{
+  reduce_sectors_with(nullptr, ranges, count, range_min, range_max, sectors, out);
+}
+
+const char * reduce_sectors_kernel()
+{
+#if defined(BASIC_NAVIGATION_CPP_HAVE_AVX2)
+  return cpu_has_avx2() ? "avx2" : "scalar";
+#elif defined(BASIC_NAVIGATION_CPP_HAVE_NEON)
+  return "neon";
+#else
+  return "scalar";
+#endif
+}
+
+}  // namespace basic_navigation_cpp
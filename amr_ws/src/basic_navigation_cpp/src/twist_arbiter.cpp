@@ -0,0 +1,79 @@
+#include "basic_navigation_cpp/twist_arbiter.hpp"
+
+namespace basic_navigation_cpp
+{
+
+size_t TwistArbiter::add_input(const std::string & name, int priority, int64_t timeout_ns)
+{
+  inputs_.emplace_back(name, priority, timeout_ns);
+  return inputs_.size() - 1;
+}
+
+void TwistArbiter::write(size_t input, const Velocity & velocity, int64_t now_ns) noexcept
+{
+  Input & in = inputs_[input];
+  in.received.fetch_add(1, std::memory_order_relaxed);
+  in.slot.write(velocity, now_ns);
+}
+
+void TwistArbiter::set_locked_out(size_t input, bool locked_out) noexcept
+{
+  inputs_[input].locked_out.store(locked_out, std::memory_order_relaxed);
+}
+
+int TwistArbiter::select(int64_t now_ns, Velocity & velocity) noexcept
+{
+  int winner = -1;
+  Velocity command;
+  for (size_t i = 0; i < inputs_.size(); ++i) {
+    Input & in = inputs_[i];
+    int64_t stamp_ns;
+    uint64_t overwritten;
+    if (!in.slot.consume(command, stamp_ns, overwritten)) {
+      continue;
+    }
+    if (overwritten > 0) {
+      in.overwritten.fetch_add(overwritten, std::memory_order_relaxed);
+    }
+    const bool fresh = now_ns - stamp_ns <= in.timeout_ns;
+    if (in.active && !fresh) {
+      in.stale.fetch_add(1, std::memory_order_relaxed);
+    }
+    in.active = fresh;
+    if (!fresh) {
+      continue;
+    }
+    if (in.locked_out.load(std::memory_order_relaxed)) {
+      in.locked_out_ticks.fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
+    if (winner >= 0 && inputs_[winner].priority >= in.priority) {
+      in.preempted.fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
+    if (winner >= 0) {
+      inputs_[winner].preempted.fetch_add(1, std::memory_order_relaxed);
+    }
+    winner = static_cast<int>(i);
+    velocity = command;
+  }
+  if (winner >= 0) {
+    inputs_[winner].selected.fetch_add(1, std::memory_order_relaxed);
+  }
+  return winner;
+}
+
+TwistInputCounters TwistArbiter::counters(size_t input) const
+{
+  const Input & in = inputs_[input];
+  TwistInputCounters counters;
+  counters.received = in.received.load(std::memory_order_relaxed);
+  counters.overwritten = in.overwritten.load(std::memory_order_relaxed);
+  counters.stale = in.stale.load(std::memory_order_relaxed);
+  counters.selected = in.selected.load(std::memory_order_relaxed);
+  counters.preempted = in.preempted.load(std::memory_order_relaxed);
+  counters.locked_out = in.locked_out_ticks.load(std::memory_order_relaxed);
+  return counters;
+}
+
+}  // namespace basic_navigation_cpp
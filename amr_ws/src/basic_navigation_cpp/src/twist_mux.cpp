@@ -0,0 +1,139 @@
+#include "basic_navigation_cpp/twist_mux.hpp"
+
+#include <chrono>
+#include <string>
+
+#include "amr_comm/arena_wiring.hpp"
+#include "rclcpp_components/register_node_macro.hpp"
+
+namespace basic_navigation_cpp
+{
+
+namespace
+{
+
+// Timeouts are judged on the steady clock, so a paused or jumping /clock
+// cannot keep an old command alive.
+int64_t steady_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace
+
+TwistMux::TwistMux(const rclcpp::NodeOptions & options)
+: Node("twist_mux", options),
+  active_(-1),
+  input_arena_(1024)
+{
+  const auto inputs = declare_parameter(
+    "inputs", std::vector<std::string>{"rotation", "navigation"});
+  const double rate = declare_parameter("rate", 20.0);
+  const double status_period = declare_parameter("status_period", 1.0);
+
+  // The inputs share one arena, which is only safe while their callbacks
+  // never overlap: pin them to one mutually exclusive group, whatever
+  // executor the node is added to.
+  rclcpp::SubscriptionOptions input_options;
+  input_options.callback_group = create_callback_group(
+    rclcpp::CallbackGroupType::MutuallyExclusive);
+
+  for (const auto & name : inputs) {
+    const std::string topic = declare_parameter(name + ".topic", "cmd_vel/" + name);
+    const int priority = declare_parameter(name + ".priority", 0);
+    const double timeout = declare_parameter(name + ".timeout", 0.5);
+    const std::string lockout_topic = declare_parameter(name + ".lockout_topic", std::string());
+
+    const size_t input = arbiter_.add_input(
+      name, priority, static_cast<int64_t>(timeout * 1e9));
+    input_subs_.push_back(
+      amr_comm::create_arena_subscription<geometry_msgs::msg::Twist>(
+        *this, topic, 10,
+        [this, input](const amr_comm::ArenaMessage<geometry_msgs::msg::Twist> & msg) {
+          arbiter_.write(
+            input,
+            Velocity{msg.linear.x, msg.linear.y, msg.linear.z,
+              msg.angular.x, msg.angular.y, msg.angular.z},
+            steady_ns());
+        },
+        input_arena_, input_options));
+    if (!lockout_topic.empty()) {
+      lockout_subs_.push_back(
+        create_subscription<std_msgs::msg::Bool>(
+          lockout_topic, rclcpp::QoS(1).transient_local(),
+          [this, input](const std_msgs::msg::Bool::SharedPtr msg) {
+            arbiter_.set_locked_out(input, msg->data);
+          }));
+    }
+    status_msg_.input.push_back(name);
+    RCLCPP_INFO(
+      get_logger(), "Input '%s' on %s: priority %d, timeout %.2fs%s%s", name.c_str(),
+      topic.c_str(), priority, timeout, lockout_topic.empty() ? "" : ", lock-out on ",
+      lockout_topic.c_str());
+  }
+
+  const size_t count = arbiter_.size();
+  status_msg_.received.resize(count);
+  status_msg_.overwritten.resize(count);
+  status_msg_.stale.resize(count);
+  status_msg_.selected.resize(count);
+  status_msg_.preempted.resize(count);
+  status_msg_.locked_out.resize(count);
+
+  cmd_vel_pub_ = create_publisher<geometry_msgs::msg::Twist>("cmd_vel", 10);
+  status_pub_ = create_publisher<custom_interfaces::msg::TwistMuxStatus>(
+    "cmd_vel_mux/status", 10);
+  output_timer_ = create_wall_timer(
+    std::chrono::duration<double>(1.0 / rate), [this]() {tick();});
+  status_timer_ = create_wall_timer(
+    std::chrono::duration<double>(status_period), [this]() {publish_status();});
+}
+
+void TwistMux::tick()
+{
+  Velocity velocity;
+  const int winner = arbiter_.select(steady_ns(), velocity);
+  if (winner != active_) {
+    RCLCPP_INFO(
+      get_logger(), "cmd_vel source: %s",
+      winner >= 0 ? arbiter_.name(winner).c_str() : "none");
+  }
+  if (winner < 0) {
+    if (active_ >= 0) {
+      cmd_vel_pub_->publish(geometry_msgs::msg::Twist());
+    }
+    active_ = winner;
+    return;
+  }
+  active_ = winner;
+
+  geometry_msgs::msg::Twist msg;
+  msg.linear.x = velocity[0];
+  msg.linear.y = velocity[1];
+  msg.linear.z = velocity[2];
+  msg.angular.x = velocity[3];
+  msg.angular.y = velocity[4];
+  msg.angular.z = velocity[5];
+  cmd_vel_pub_->publish(msg);
+}
+
+void TwistMux::publish_status()
+{
+  status_msg_.header.stamp = now();
+  status_msg_.active_input = active_ >= 0 ? arbiter_.name(active_) : std::string();
+  for (size_t i = 0; i < arbiter_.size(); ++i) {
+    const TwistInputCounters counters = arbiter_.counters(i);
+    status_msg_.received[i] = counters.received;
+    status_msg_.overwritten[i] = counters.overwritten;
+    status_msg_.stale[i] = counters.stale;
+    status_msg_.selected[i] = counters.selected;
+    status_msg_.preempted[i] = counters.preempted;
+    status_msg_.locked_out[i] = counters.locked_out;
+  }
+  status_pub_->publish(status_msg_);
+}
+
+}  // namespace basic_navigation_cpp
+
+RCLCPP_COMPONENTS_REGISTER_NODE(basic_navigation_cpp::TwistMux)
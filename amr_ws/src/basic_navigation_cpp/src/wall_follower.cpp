@@ -0,0 +1,126 @@
+#include "basic_navigation_cpp/wall_follower.hpp"
+
+#include <algorithm>
+#include <functional>
+
+#include "rclcpp_components/register_node_macro.hpp"
+
+namespace basic_navigation_cpp
+{
+
+WallFollower::WallFollower(const rclcpp::NodeOptions & options)
+: Node("main_navigation_node", options),
+  is_navigating_(false),
+  is_rotating_(false),
+  tracer_(this, {"receive", "decide", "publish"})
+{
+  wall_threshold_ = declare_parameter("wall_distance_threshold", 0.5);
+  forward_speed_ = declare_parameter("forward_speed", 0.2);
+  rotation_angle_ = declare_parameter("rotation_angle", 90.0);
+
+  vel_pub_ = create_publisher<geometry_msgs::msg::Twist>("cmd_vel", 10);
+  sectors_sub_ = create_subscription<custom_interfaces::msg::ScanSectors>(
+    "scan_sectors", 10,
+    std::bind(&WallFollower::sectors_callback, this, std::placeholders::_1));
+  srv_ = create_service<std_srvs::srv::Empty>(
+    "start_navigation",
+    std::bind(
+      &WallFollower::start_navigation_callback, this,
+      std::placeholders::_1, std::placeholders::_2));
+  action_client_ = rclcpp_action::create_client<Rotate>(this, "rotate");
+  RCLCPP_INFO(get_logger(), "Main navigation node initialized");
+}
+
+void WallFollower::sectors_callback(const custom_interfaces::msg::ScanSectors::SharedPtr msg)
+{
+  tracer_.record(kReceive, msg->header.stamp);
+  if (!is_navigating_ || is_rotating_) {
+    return;
+  }
+  float min_distance = msg->forward_clearance;
+  if (!msg->min_range.empty()) {
+    min_distance = std::min(msg->min_range[msg->min_range.size() / 2], min_distance);
+  }
+  const bool wall_ahead = min_distance < wall_threshold_;
+  tracer_.record(kDecide, msg->header.stamp);
+  if (wall_ahead) {
+    RCLCPP_INFO(get_logger(), "Wall detected at %.3fm. Starting rotation.", min_distance);
+    stop_robot();
+    send_rotation_goal(msg->header.stamp);
+  } else {
+    move_forward();
+  }
+  tracer_.record(kPublish, msg->header.stamp);
+}
+
+void WallFollower::start_navigation_callback(
+  const std::shared_ptr<std_srvs::srv::Empty::Request>,
+  std::shared_ptr<std_srvs::srv::Empty::Response>)
+{
+  if (!is_navigating_) {
+    RCLCPP_INFO(get_logger(), "Starting navigation");
+    is_navigating_ = true;
+  } else {
+    RCLCPP_INFO(get_logger(), "Navigation already in progress");
+  }
+}
+
+void WallFollower::move_forward()
+{
+  geometry_msgs::msg::Twist msg;
+  msg.linear.x = forward_speed_;
+  vel_pub_->publish(msg);
+}
+
+void WallFollower::stop_robot()
+{
+  vel_pub_->publish(geometry_msgs::msg::Twist());
+}
+
+void WallFollower::send_rotation_goal(const builtin_interfaces::msg::Time & scan_stamp)
+{
+  // main_node.py blocks in wait_for_server(); a component must not stall the
+  // container's executor, so the goal is retried on the next scan instead.
+  if (!action_client_->action_server_is_ready()) {
+    RCLCPP_WARN_THROTTLE(
+      get_logger(), *get_clock(), 1000, "Rotation action server not available");
+    return;
+  }
+  is_rotating_ = true;
+  Rotate::Goal goal;
+  goal.angle = static_cast<float>(rotation_angle_);
+  goal.scan_stamp_sec = scan_stamp.sec;
+  goal.scan_stamp_nanosec = scan_stamp.nanosec;
+
+  auto options = rclcpp_action::Client<Rotate>::SendGoalOptions();
+  options.goal_response_callback =
+    [this](std::shared_future<GoalHandle::SharedPtr> future) {
+      if (!future.get()) {
+        RCLCPP_ERROR(get_logger(), "Rotation goal rejected");
+        is_rotating_ = false;
+        return;
+      }
+      RCLCPP_INFO(get_logger(), "Rotation goal accepted");
+    };
+  options.feedback_callback =
+    [this](GoalHandle::SharedPtr, const std::shared_ptr<const Rotate::Feedback> feedback) {
+      RCLCPP_INFO_THROTTLE(
+        get_logger(), *get_clock(), 1000, "Remaining degrees: %.1f",
+        feedback->remaining_degrees);
+    };
+  options.result_callback =
+    [this](const GoalHandle::WrappedResult & result) {
+      if (result.code == rclcpp_action::ResultCode::SUCCEEDED) {
+        RCLCPP_INFO(get_logger(), "Rotation completed successfully");
+      } else {
+        RCLCPP_ERROR(
+          get_logger(), "Rotation failed with status: %d", static_cast<int>(result.code));
+      }
+      is_rotating_ = false;
+    };
+  action_client_->async_send_goal(goal, options);
+}
+
+}  // namespace basic_navigation_cpp
+
+RCLCPP_COMPONENTS_REGISTER_NODE(basic_navigation_cpp::WallFollower)
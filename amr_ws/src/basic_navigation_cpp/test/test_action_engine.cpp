@@ -0,0 +1,278 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_action/rclcpp_action.hpp"
+#include "custom_interfaces/action/aula9.hpp"
+#include "basic_navigation_cpp/action_engine.hpp"
+
+using Aula9 = custom_interfaces::action::Aula9;
+using basic_navigation_cpp::ActionEngine;
+using basic_navigation_cpp::GoalContext;
+using basic_navigation_cpp::GoalPolicy;
+using basic_navigation_cpp::GoalStatus;
+using basic_navigation_cpp::GoalTask;
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+using ClientGoalHandle = rclcpp_action::ClientGoalHandle<Aula9>;
+
+// How a scripted goal behaves; goals are told apart by count_up_to.
+struct Script
+{
+  int steps = -1;  // steps before finishing with `status`, -1 for never
+  GoalStatus status = GoalStatus::kSucceeded;
+  int cancel_ticks = 1;  // cancel() calls until it returns kCanceled
+};
+
+// Appends "<goal> <event>" to a shared log on every engine callback.
+class ScriptedTask : public GoalTask<Aula9>
+{
+public:
+  ScriptedTask(int label, Script script, std::vector<std::string> & log)
+  : label_(label), script_(script), log_(log) {}
+
+  GoalStatus step(GoalContext<Aula9> & context) override
+  {
+    record("step");
+    auto feedback = std::make_shared<Aula9::Feedback>();
+    feedback->current_number = ++steps_;
+    context.publish_feedback(feedback);
+    if (script_.steps >= 0 && steps_ >= script_.steps) {
+      context.result->final_count = steps_;
+      record("finish");
+      return script_.status;
+    }
+    return GoalStatus::kRunning;
+  }
+
+  GoalStatus cancel(GoalContext<Aula9> & context) override
+  {
+    record("cancel");
+    context.result->final_count = steps_;
+    return ++cancels_ >= script_.cancel_ticks ? GoalStatus::kCanceled : GoalStatus::kRunning;
+  }
+
+  void preempted(GoalContext<Aula9> &) override
+  {
+    record("preempted");
+  }
+
+private:
+  void record(const char * event)
+  {
+    log_.push_back(std::to_string(label_) + " " + event);
+  }
+
+  int label_;
+  Script script_;
+  std::vector<std::string> & log_;
+  int steps_ = 0;
+  int cancels_ = 0;
+};
+
+class ActionEngineTest : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase() {rclcpp::init(0, nullptr);}
+  static void TearDownTestCase() {rclcpp::shutdown();}
+
+  void start(GoalPolicy policy, double feedback_rate_hz = 0.0)
+  {
+    server_node_ = std::make_shared<rclcpp::Node>("action_engine_test_server");
+    client_node_ = std::make_shared<rclcpp::Node>("action_engine_test_client");
+    ActionEngine<Aula9>::Options options;
+    options.period = std::chrono::milliseconds(5);
+    options.feedback_rate_hz = feedback_rate_hz;
+    options.policy = policy;
+    engine_ = std::make_unique<ActionEngine<Aula9>>(
+      server_node_.get(), "action_engine_test",
+      [this](const std::shared_ptr<const Aula9::Goal> & goal) {
+        return std::make_unique<ScriptedTask>(
+          goal->count_up_to, scripts_[goal->count_up_to], log_);
+      },
+      options);
+    client_ = rclcpp_action::create_client<Aula9>(client_node_, "action_engine_test");
+    executor_.add_node(server_node_);
+    executor_.add_node(client_node_);
+    ASSERT_TRUE(
+      spin_until([this]() {return client_->action_server_is_ready();}, std::chrono::seconds(5)));
+  }
+
+  void TearDown() override
+  {
+    if (server_node_) {
+      executor_.remove_node(server_node_);
+      executor_.remove_node(client_node_);
+    }
+  }
+
+  bool spin_until(const std::function<bool()> & done, Clock::duration limit)
+  {
+    const auto deadline = Clock::now() + limit;
+    while (!done() && Clock::now() < deadline) {
+      executor_.spin_some(std::chrono::milliseconds(1));
+    }
+    return done();
+  }
+
+  // Sends goal `label` and waits until the server has answered it.
+  ClientGoalHandle::SharedPtr send(int label)
+  {
+    Aula9::Goal goal;
+    goal.count_up_to = label;
+    rclcpp_action::Client<Aula9>::SendGoalOptions options;
+    options.feedback_callback =
+      [this, label](ClientGoalHandle::SharedPtr, const std::shared_ptr<const Aula9::Feedback>) {
+        ++feedback_[label];
+      };
+    options.result_callback = [this, label](const ClientGoalHandle::WrappedResult & result) {
+        results_[label] = result.code;
+      };
+    auto future = client_->async_send_goal(goal, options);
+    if (!spin_until(
+        [&future]() {
+          return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }, std::chrono::seconds(5)))
+    {
+      return nullptr;
+    }
+    return future.get();
+  }
+
+  bool wait_result(int label)
+  {
+    return spin_until(
+      [this, label]() {return results_.count(label) != 0;}, std::chrono::seconds(5));
+  }
+
+  // Position of `entry` in the log, or -1.
+  int position(const std::string & entry) const
+  {
+    const auto it = std::find(log_.begin(), log_.end(), entry);
+    return it == log_.end() ? -1 : static_cast<int>(it - log_.begin());
+  }
+
+  int count(const std::string & entry) const
+  {
+    return static_cast<int>(std::count(log_.begin(), log_.end(), entry));
+  }
+
+  std::map<int, Script> scripts_;
+  std::vector<std::string> log_;
+  std::map<int, rclcpp_action::ResultCode> results_;
+  std::map<int, int> feedback_;
+  rclcpp::Node::SharedPtr server_node_;
+  rclcpp::Node::SharedPtr client_node_;
+  std::unique_ptr<ActionEngine<Aula9>> engine_;
+  rclcpp_action::Client<Aula9>::SharedPtr client_;
+  rclcpp::executors::SingleThreadedExecutor executor_;
+};
+
+}  // namespace
+
+TEST_F(ActionEngineTest, StepsUntilSucceeded)
+{
+  scripts_[1] = Script{3, GoalStatus::kSucceeded, 1};
+  start(GoalPolicy::kParallel);
+  ASSERT_TRUE(send(1));
+  ASSERT_TRUE(wait_result(1));
+
+  EXPECT_EQ(results_[1], rclcpp_action::ResultCode::SUCCEEDED);
+  EXPECT_EQ(log_, std::vector<std::string>({"1 step", "1 step", "1 step", "1 finish"}));
+  const auto stats = engine_->stats();
+  EXPECT_EQ(stats.succeeded, 1u);
+  EXPECT_EQ(stats.aborted, 0u);
+  EXPECT_EQ(stats.active, 0u);
+}
+
+TEST_F(ActionEngineTest, AbortedStatusAbortsTheGoal)
+{
+  scripts_[1] = Script{2, GoalStatus::kAborted, 1};
+  start(GoalPolicy::kParallel);
+  ASSERT_TRUE(send(1));
+  ASSERT_TRUE(wait_result(1));
+
+  EXPECT_EQ(results_[1], rclcpp_action::ResultCode::ABORTED);
+  EXPECT_EQ(count("1 step"), 2);
+  EXPECT_EQ(engine_->stats().aborted, 1u);
+}
+
+TEST_F(ActionEngineTest, CancelReplacesStepUntilTerminal)
+{
+  scripts_[1] = Script{-1, GoalStatus::kSucceeded, 3};
+  start(GoalPolicy::kParallel);
+  auto handle = send(1);
+  ASSERT_TRUE(handle);
+  ASSERT_TRUE(spin_until([this]() {return count("1 step") >= 2;}, std::chrono::seconds(5)));
+
+  client_->async_cancel_goal(handle);
+  ASSERT_TRUE(wait_result(1));
+  EXPECT_EQ(results_[1], rclcpp_action::ResultCode::CANCELED);
+  // Once canceling, the goal is never stepped again and cancel() runs until
+  // it reports a terminal status.
+  const int first_cancel = position("1 cancel");
+  ASSERT_GE(first_cancel, 0);
+  EXPECT_EQ(count("1 cancel"), 3);
+  EXPECT_EQ(
+    std::find(log_.begin() + first_cancel, log_.end(), "1 step"), log_.end());
+  EXPECT_EQ(engine_->stats().canceled, 1u);
+}
+
+TEST_F(ActionEngineTest, PreemptAbortsOldGoalBeforeNewOneSteps)
+{
+  scripts_[1] = Script{-1, GoalStatus::kSucceeded, 1};
+  scripts_[2] = Script{2, GoalStatus::kSucceeded, 1};
+  start(GoalPolicy::kPreemptLatest);
+  ASSERT_TRUE(send(1));
+  ASSERT_TRUE(spin_until([this]() {return count("1 step") >= 1;}, std::chrono::seconds(5)));
+  ASSERT_TRUE(send(2));
+  ASSERT_TRUE(wait_result(1));
+  ASSERT_TRUE(wait_result(2));
+
+  EXPECT_EQ(results_[1], rclcpp_action::ResultCode::ABORTED);
+  EXPECT_EQ(results_[2], rclcpp_action::ResultCode::SUCCEEDED);
+  const int preempted = position("1 preempted");
+  ASSERT_GE(preempted, 0);
+  EXPECT_LT(preempted, position("2 step"));
+  EXPECT_EQ(std::find(log_.begin() + preempted, log_.end(), "1 step"), log_.end());
+  const auto stats = engine_->stats();
+  EXPECT_EQ(stats.policy.preempted, 1u);
+  EXPECT_EQ(stats.aborted, 1u);
+  EXPECT_EQ(stats.succeeded, 1u);
+}
+
+TEST_F(ActionEngineTest, RejectIfBusyRefusesSecondGoal)
+{
+  scripts_[1] = Script{-1, GoalStatus::kSucceeded, 1};
+  start(GoalPolicy::kRejectIfBusy);
+  auto first = send(1);
+  ASSERT_TRUE(first);
+  EXPECT_FALSE(send(2));
+  EXPECT_EQ(count("2 step"), 0);
+  client_->async_cancel_goal(first);
+  ASSERT_TRUE(wait_result(1));
+  EXPECT_EQ(results_[1], rclcpp_action::ResultCode::CANCELED);
+}
+
+TEST_F(ActionEngineTest, FeedbackIsRateLimited)
+{
+  // 5 ms ticks, feedback at 20 Hz: about one message per ten steps.
+  scripts_[1] = Script{100, GoalStatus::kSucceeded, 1};
+  start(GoalPolicy::kParallel, 20.0);
+  ASSERT_TRUE(send(1));
+  ASSERT_TRUE(wait_result(1));
+
+  EXPECT_EQ(count("1 step"), 100);
+  EXPECT_GT(feedback_[1], 0);
+  EXPECT_LT(feedback_[1], 40);
+}
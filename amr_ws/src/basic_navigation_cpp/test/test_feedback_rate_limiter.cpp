@@ -0,0 +1,293 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_action/rclcpp_action.hpp"
+#include "custom_interfaces/action/aula9.hpp"
+#include "basic_navigation_cpp/feedback_rate_limiter.hpp"
+#include "basic_navigation_cpp/feedback_throttle.hpp"
+
+using Aula9 = custom_interfaces::action::Aula9;
+using basic_navigation_cpp::FeedbackCounters;
+using basic_navigation_cpp::FeedbackRateLimiter;
+using basic_navigation_cpp::FeedbackThrottle;
+
+namespace
+{
+
+constexpr int64_t kMs = 1000000;
+
+// Collects what the throttle sends.
+struct Recorder
+{
+  std::vector<int> sent;
+  void operator()(int value) {sent.push_back(value);}
+};
+
+using Clock = std::chrono::steady_clock;
+using ServerGoalHandle = rclcpp_action::ServerGoalHandle<Aula9>;
+using ClientGoalHandle = rclcpp_action::ClientGoalHandle<Aula9>;
+
+std::shared_ptr<Aula9::Feedback> feedback(int number)
+{
+  auto msg = std::make_shared<Aula9::Feedback>();
+  msg->current_number = number;
+  return msg;
+}
+
+void expect_counters(const FeedbackCounters & counters, const FeedbackCounters & expected)
+{
+  EXPECT_EQ(counters.offered, expected.offered);
+  EXPECT_EQ(counters.sent, expected.sent);
+  EXPECT_EQ(counters.coalesced, expected.coalesced);
+  EXPECT_EQ(counters.stale, expected.stale);
+  EXPECT_EQ(counters.discarded, expected.discarded);
+}
+
+FeedbackCounters counters(
+  uint64_t offered, uint64_t sent, uint64_t coalesced, uint64_t stale, uint64_t discarded)
+{
+  FeedbackCounters counters;
+  counters.offered = offered;
+  counters.sent = sent;
+  counters.coalesced = coalesced;
+  counters.stale = stale;
+  counters.discarded = discarded;
+  return counters;
+}
+
+// A bare action server that keeps the handles of the goals it accepts, and a
+// client that records the feedback it receives, so the limiter can be driven
+// with real goal handles.
+class FeedbackRateLimiterTest : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase() {rclcpp::init(0, nullptr);}
+  static void TearDownTestCase() {rclcpp::shutdown();}
+
+  void SetUp() override
+  {
+    server_node_ = std::make_shared<rclcpp::Node>("feedback_rate_limiter_test_server");
+    client_node_ = std::make_shared<rclcpp::Node>("feedback_rate_limiter_test_client");
+    server_ = rclcpp_action::create_server<Aula9>(
+      server_node_, "feedback_rate_limiter_test",
+      [](const rclcpp_action::GoalUUID &, std::shared_ptr<const Aula9::Goal>) {
+        return rclcpp_action::GoalResponse::ACCEPT_AND_EXECUTE;
+      },
+      [](std::shared_ptr<ServerGoalHandle>) {return rclcpp_action::CancelResponse::ACCEPT;},
+      [this](std::shared_ptr<ServerGoalHandle> handle) {accepted_.push_back(handle);});
+    client_ = rclcpp_action::create_client<Aula9>(client_node_, "feedback_rate_limiter_test");
+    executor_.add_node(server_node_);
+    executor_.add_node(client_node_);
+    ASSERT_TRUE(
+      spin_until([this]() {return client_->action_server_is_ready();}, std::chrono::seconds(5)));
+  }
+
+  void TearDown() override
+  {
+    for (const auto & handle : accepted_) {
+      if (handle->is_active()) {
+        handle->abort(std::make_shared<Aula9::Result>());
+      }
+    }
+    executor_.remove_node(server_node_);
+    executor_.remove_node(client_node_);
+  }
+
+  bool spin_until(const std::function<bool()> & done, Clock::duration limit)
+  {
+    const auto deadline = Clock::now() + limit;
+    while (!done() && Clock::now() < deadline) {
+      executor_.spin_some(std::chrono::milliseconds(1));
+    }
+    return done();
+  }
+
+  // Sends a goal and returns its server-side handle once accepted.
+  std::shared_ptr<ServerGoalHandle> start_goal()
+  {
+    rclcpp_action::Client<Aula9>::SendGoalOptions options;
+    options.feedback_callback =
+      [this](ClientGoalHandle::SharedPtr, const std::shared_ptr<const Aula9::Feedback> msg) {
+        received_.push_back(msg->current_number);
+      };
+    const size_t before = accepted_.size();
+    auto future = client_->async_send_goal(Aula9::Goal(), options);
+    const bool answered = spin_until(
+      [&future, this, before]() {
+        return accepted_.size() > before &&
+               future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+      }, std::chrono::seconds(5));
+    return answered ? accepted_.back() : nullptr;
+  }
+
+  rclcpp::Node::SharedPtr server_node_;
+  rclcpp::Node::SharedPtr client_node_;
+  rclcpp_action::Server<Aula9>::SharedPtr server_;
+  rclcpp_action::Client<Aula9>::SharedPtr client_;
+  rclcpp::executors::SingleThreadedExecutor executor_;
+  std::vector<std::shared_ptr<ServerGoalHandle>> accepted_;
+  std::vector<int> received_;
+};
+
+}  // namespace
+
+TEST(FeedbackRateLimiter, FirstFeedbackGoesOutImmediately)
+{
+  FeedbackThrottle<int> throttle(100 * kMs, 0);
+  Recorder recorder;
+  throttle.offer(1, 0, recorder);
+  EXPECT_EQ(recorder.sent, std::vector<int>({1}));
+  EXPECT_FALSE(throttle.has_pending());
+}
+
+TEST(FeedbackRateLimiter, CoalescesWithinThePeriod)
+{
+  FeedbackThrottle<int> throttle(100 * kMs, 0);
+  Recorder recorder;
+  throttle.offer(1, 0, recorder);
+  throttle.offer(2, 10 * kMs, recorder);
+  throttle.offer(3, 20 * kMs, recorder);
+  throttle.offer(4, 30 * kMs, recorder);
+  EXPECT_EQ(recorder.sent, std::vector<int>({1}));
+  EXPECT_TRUE(throttle.has_pending());
+
+  // Not yet due.
+  throttle.poll(99 * kMs, recorder);
+  EXPECT_EQ(recorder.sent, std::vector<int>({1}));
+  // Latest value wins once the period has elapsed.
+  throttle.poll(100 * kMs, recorder);
+  EXPECT_EQ(recorder.sent, std::vector<int>({1, 4}));
+  EXPECT_FALSE(throttle.has_pending());
+
+  const auto & counters = throttle.counters();
+  EXPECT_EQ(counters.offered, 4u);
+  EXPECT_EQ(counters.sent, 2u);
+  EXPECT_EQ(counters.coalesced, 2u);
+  EXPECT_EQ(counters.stale, 0u);
+}
+
+TEST(FeedbackRateLimiter, PeriodRestartsAtEverySend)
+{
+  FeedbackThrottle<int> throttle(100 * kMs, 0);
+  Recorder recorder;
+  throttle.offer(1, 0, recorder);
+  throttle.offer(2, 150 * kMs, recorder);
+  // 150 ms after the last send, but only 90 ms after the second one.
+  throttle.offer(3, 240 * kMs, recorder);
+  EXPECT_EQ(recorder.sent, std::vector<int>({1, 2}));
+  throttle.offer(4, 250 * kMs, recorder);
+  EXPECT_EQ(recorder.sent, std::vector<int>({1, 2, 4}));
+}
+
+TEST(FeedbackRateLimiter, OfferFlushesDuePendingValue)
+{
+  FeedbackThrottle<int> throttle(100 * kMs, 0);
+  Recorder recorder;
+  throttle.offer(1, 0, recorder);
+  throttle.offer(2, 50 * kMs, recorder);
+  // No poll in between: the next offer replaces 2 and sends right away.
+  throttle.offer(3, 120 * kMs, recorder);
+  EXPECT_EQ(recorder.sent, std::vector<int>({1, 3}));
+  EXPECT_EQ(throttle.counters().coalesced, 1u);
+}
+
+TEST(FeedbackRateLimiter, DropsStaleFeedback)
+{
+  FeedbackThrottle<int> throttle(100 * kMs, 30 * kMs);
+  Recorder recorder;
+  throttle.offer(1, 0, recorder);
+  throttle.offer(2, 60 * kMs, recorder);
+  throttle.poll(100 * kMs, recorder);
+  EXPECT_EQ(recorder.sent, std::vector<int>({1}));
+  EXPECT_FALSE(throttle.has_pending());
+  EXPECT_EQ(throttle.counters().stale, 1u);
+}
+
+TEST(FeedbackRateLimiter, DiscardsPendingWhenTheGoalFinishes)
+{
+  FeedbackThrottle<int> throttle(100 * kMs, 0);
+  Recorder recorder;
+  throttle.offer(1, 0, recorder);
+  throttle.offer(2, 10 * kMs, recorder);
+  throttle.discard_pending();
+  throttle.poll(200 * kMs, recorder);
+  EXPECT_EQ(recorder.sent, std::vector<int>({1}));
+  EXPECT_EQ(throttle.counters().discarded, 1u);
+}
+
+TEST(FeedbackRateLimiter, ZeroPeriodSendsEverything)
+{
+  FeedbackThrottle<int> throttle(0, 0);
+  Recorder recorder;
+  for (int i = 0; i < 5; ++i) {
+    throttle.offer(i, 0, recorder);
+  }
+  EXPECT_EQ(recorder.sent, std::vector<int>({0, 1, 2, 3, 4}));
+  EXPECT_EQ(throttle.counters().coalesced, 0u);
+}
+
+// With a node, the limiter flushes from its own timer: parked feedback goes
+// out without another publish() or flush() call.
+TEST_F(FeedbackRateLimiterTest, TimerSendsParkedFeedback)
+{
+  FeedbackRateLimiter<Aula9> limiter(server_node_.get(), 20.0, 0.0);
+  auto goal = start_goal();
+  ASSERT_TRUE(goal);
+  limiter.publish(goal, feedback(1));
+  limiter.publish(goal, feedback(2));
+  limiter.publish(goal, feedback(3));
+  ASSERT_TRUE(spin_until([this]() {return received_.size() >= 2;}, std::chrono::seconds(5)));
+  EXPECT_EQ(received_, std::vector<int>({1, 3}));
+  expect_counters(limiter.finish(goal), counters(3, 2, 1, 0, 0));
+}
+
+TEST_F(FeedbackRateLimiterTest, FinishReturnsTheCountersAndForgetsTheGoal)
+{
+  // One feedback per 1000 s: everything after the first one stays parked.
+  FeedbackRateLimiter<Aula9> limiter(server_node_->get_clock(), 0.001, 0.0);
+  auto first = start_goal();
+  auto second = start_goal();
+  ASSERT_TRUE(first);
+  ASSERT_TRUE(second);
+  limiter.publish(first, feedback(1));
+  limiter.publish(first, feedback(2));
+  limiter.publish(first, feedback(3));
+  limiter.publish(second, feedback(10));
+
+  expect_counters(limiter.finish(first), counters(3, 1, 1, 0, 1));
+  expect_counters(limiter.finish(first), FeedbackCounters());
+  // Other goals keep their own throttle.
+  expect_counters(limiter.finish(second), counters(1, 1, 0, 0, 0));
+  expect_counters(limiter.unfinished(), FeedbackCounters());
+}
+
+// A goal that ends without finish() is dropped by the next flush(), which
+// keeps its counters and does not send its parked feedback.
+TEST_F(FeedbackRateLimiterTest, FlushDropsEndedGoalsButKeepsTheirCounters)
+{
+  FeedbackRateLimiter<Aula9> limiter(server_node_->get_clock(), 0.001, 0.0);
+  auto ended = start_goal();
+  auto running = start_goal();
+  ASSERT_TRUE(ended);
+  ASSERT_TRUE(running);
+  limiter.publish(ended, feedback(1));
+  limiter.publish(ended, feedback(2));
+  limiter.publish(running, feedback(10));
+  ended->succeed(std::make_shared<Aula9::Result>());
+
+  limiter.flush();
+  expect_counters(limiter.unfinished(), counters(2, 1, 0, 0, 1));
+  expect_counters(limiter.finish(ended), FeedbackCounters());
+  // Counted once, however often flush() runs.
+  limiter.flush();
+  expect_counters(limiter.unfinished(), counters(2, 1, 0, 0, 1));
+  // The running goal is untouched.
+  limiter.publish(running, feedback(11));
+  expect_counters(limiter.finish(running), counters(2, 1, 0, 0, 1));
+}
@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "basic_navigation_cpp/goal_policy.hpp"
+
+using basic_navigation_cpp::GoalArbiter;
+using basic_navigation_cpp::GoalPolicy;
+
+namespace
+{
+
+constexpr int64_t kMs = 1000000;
+
+// Admits and hands over goal `id`, as the action engine does.
+bool submit(GoalArbiter & arbiter, uint64_t id, int64_t now_ns)
+{
+  if (!arbiter.try_admit()) {
+    return false;
+  }
+  arbiter.arrive(id, now_ns);
+  return true;
+}
+
+}  // namespace
+
+TEST(GoalPolicy, NamesRoundTrip)
+{
+  for (GoalPolicy policy : {GoalPolicy::kParallel, GoalPolicy::kRejectIfBusy,
+      GoalPolicy::kPreemptLatest, GoalPolicy::kQueue, GoalPolicy::kMergeAngles})
+  {
+    GoalPolicy parsed = GoalPolicy::kParallel;
+    ASSERT_TRUE(basic_navigation_cpp::parse_goal_policy(
+        basic_navigation_cpp::goal_policy_name(policy), parsed));
+    EXPECT_EQ(parsed, policy);
+  }
+  GoalPolicy parsed;
+  EXPECT_FALSE(basic_navigation_cpp::parse_goal_policy("fifo", parsed));
+}
+
+TEST(GoalPolicy, ParallelStartsNothing)
+{
+  GoalArbiter arbiter(GoalPolicy::kParallel, 0);
+  for (uint64_t id = 0; id < 10; ++id) {
+    EXPECT_TRUE(submit(arbiter, id, 0));
+  }
+  const GoalArbiter::Plan plan = arbiter.plan(0);
+  EXPECT_FALSE(plan.start);
+  EXPECT_TRUE(plan.preempted.empty());
+  EXPECT_TRUE(plan.merged.empty());
+  uint64_t running;
+  EXPECT_FALSE(arbiter.running(running));
+
+  const auto metrics = arbiter.metrics();
+  EXPECT_EQ(metrics.accepted, 10u);
+  EXPECT_EQ(metrics.rejected, 0u);
+  EXPECT_EQ(metrics.started, 0u);
+  EXPECT_EQ(metrics.preempted, 0u);
+  EXPECT_EQ(metrics.merged, 0u);
+  EXPECT_EQ(metrics.queue_depth, 0u);
+}
+
+TEST(GoalPolicy, RejectIfBusy)
+{
+  GoalArbiter arbiter(GoalPolicy::kRejectIfBusy, 0);
+  ASSERT_TRUE(submit(arbiter, 1, 0));
+  // Still rejected before the tick that starts goal 1.
+  EXPECT_FALSE(arbiter.try_admit());
+
+  GoalArbiter::Plan plan = arbiter.plan(0);
+  ASSERT_TRUE(plan.start);
+  EXPECT_EQ(plan.start_id, 1u);
+  EXPECT_TRUE(plan.preempted.empty());
+  EXPECT_FALSE(arbiter.try_admit());
+  EXPECT_FALSE(arbiter.try_admit());
+
+  arbiter.finish(1);
+  ASSERT_TRUE(submit(arbiter, 2, 5 * kMs));
+  plan = arbiter.plan(5 * kMs);
+  ASSERT_TRUE(plan.start);
+  EXPECT_EQ(plan.start_id, 2u);
+
+  const auto metrics = arbiter.metrics();
+  EXPECT_EQ(metrics.accepted, 2u);
+  EXPECT_EQ(metrics.rejected, 3u);
+  EXPECT_EQ(metrics.started, 2u);
+  EXPECT_EQ(metrics.preempted, 0u);
+}
+
+TEST(GoalPolicy, PreemptLatestReplacesRunningGoal)
+{
+  GoalArbiter arbiter(GoalPolicy::kPreemptLatest, 0);
+  ASSERT_TRUE(submit(arbiter, 1, 0));
+  GoalArbiter::Plan plan = arbiter.plan(0);
+  ASSERT_TRUE(plan.start);
+  EXPECT_EQ(plan.start_id, 1u);
+
+  // Nothing new: the running goal keeps going.
+  plan = arbiter.plan(1 * kMs);
+  EXPECT_FALSE(plan.start);
+  EXPECT_TRUE(plan.preempted.empty());
+
+  ASSERT_TRUE(submit(arbiter, 2, 2 * kMs));
+  plan = arbiter.plan(2 * kMs);
+  ASSERT_TRUE(plan.start);
+  EXPECT_EQ(plan.start_id, 2u);
+  EXPECT_EQ(plan.preempted, std::vector<uint64_t>({1}));
+  EXPECT_TRUE(plan.merged.empty());
+
+  uint64_t running = 0;
+  ASSERT_TRUE(arbiter.running(running));
+  EXPECT_EQ(running, 2u);
+}
+
+TEST(GoalPolicy, PreemptLatestKeepsNewestOfOneTick)
+{
+  GoalArbiter arbiter(GoalPolicy::kPreemptLatest, 0);
+  ASSERT_TRUE(submit(arbiter, 1, 0));
+  arbiter.plan(0);
+  ASSERT_TRUE(submit(arbiter, 2, 1 * kMs));
+  ASSERT_TRUE(submit(arbiter, 3, 1 * kMs));
+  ASSERT_TRUE(submit(arbiter, 4, 1 * kMs));
+
+  const GoalArbiter::Plan plan = arbiter.plan(2 * kMs);
+  ASSERT_TRUE(plan.start);
+  EXPECT_EQ(plan.start_id, 4u);
+  EXPECT_EQ(plan.preempted, std::vector<uint64_t>({1, 2, 3}));
+
+  const auto metrics = arbiter.metrics();
+  EXPECT_EQ(metrics.accepted, 4u);
+  EXPECT_EQ(metrics.rejected, 0u);
+  EXPECT_EQ(metrics.preempted, 3u);
+  EXPECT_EQ(metrics.started, 2u);
+}
+
+TEST(GoalPolicy, QueueRunsInOrderWithBoundedDepth)
+{
+  GoalArbiter arbiter(GoalPolicy::kQueue, 2);
+  ASSERT_TRUE(submit(arbiter, 1, 0));
+  ASSERT_TRUE(submit(arbiter, 2, 0));
+  ASSERT_TRUE(submit(arbiter, 3, 0));
+  // One running and two waiting fill the capacity.
+  EXPECT_FALSE(arbiter.try_admit());
+
+  GoalArbiter::Plan plan = arbiter.plan(0);
+  ASSERT_TRUE(plan.start);
+  EXPECT_EQ(plan.start_id, 1u);
+  EXPECT_EQ(arbiter.metrics().queue_depth, 2u);
+
+  plan = arbiter.plan(10 * kMs);
+  EXPECT_FALSE(plan.start);
+
+  arbiter.finish(1);
+  plan = arbiter.plan(40 * kMs);
+  ASSERT_TRUE(plan.start);
+  EXPECT_EQ(plan.start_id, 2u);
+  // A freed slot admits one more goal, which queues behind goal 3.
+  ASSERT_TRUE(submit(arbiter, 4, 40 * kMs));
+  EXPECT_FALSE(arbiter.try_admit());
+
+  arbiter.finish(2);
+  plan = arbiter.plan(100 * kMs);
+  ASSERT_TRUE(plan.start);
+  EXPECT_EQ(plan.start_id, 3u);
+
+  arbiter.finish(3);
+  plan = arbiter.plan(110 * kMs);
+  ASSERT_TRUE(plan.start);
+  EXPECT_EQ(plan.start_id, 4u);
+  arbiter.finish(4);
+
+  const auto metrics = arbiter.metrics();
+  EXPECT_EQ(metrics.accepted, 4u);
+  EXPECT_EQ(metrics.rejected, 2u);
+  EXPECT_EQ(metrics.started, 4u);
+  EXPECT_EQ(metrics.preempted, 0u);
+  EXPECT_EQ(metrics.queue_depth, 0u);
+  // Goal 1 never waited; 2, 3 and 4 waited 40, 100 and 70 ms.
+  EXPECT_EQ(metrics.queue_waits, 3u);
+  EXPECT_EQ(metrics.queue_wait_total_ns, 210 * kMs);
+  EXPECT_EQ(metrics.queue_wait_max_ns, 100 * kMs);
+}
+
+TEST(GoalPolicy, QueueCancelWaiting)
+{
+  GoalArbiter arbiter(GoalPolicy::kQueue, 1);
+  ASSERT_TRUE(submit(arbiter, 1, 0));
+  ASSERT_TRUE(submit(arbiter, 2, 0));
+  arbiter.plan(0);
+  EXPECT_FALSE(arbiter.try_admit());
+
+  // The running goal is not waiting, goal 2 is.
+  EXPECT_FALSE(arbiter.cancel_waiting(1));
+  EXPECT_TRUE(arbiter.cancel_waiting(2));
+  EXPECT_FALSE(arbiter.cancel_waiting(2));
+  EXPECT_EQ(arbiter.metrics().queue_depth, 0u);
+
+  // Its slot is free again.
+  ASSERT_TRUE(submit(arbiter, 3, 5 * kMs));
+  arbiter.finish(1);
+  const GoalArbiter::Plan plan = arbiter.plan(5 * kMs);
+  ASSERT_TRUE(plan.start);
+  EXPECT_EQ(plan.start_id, 3u);
+}
+
+TEST(GoalPolicy, MergeAnglesFoldsOlderGoals)
+{
+  GoalArbiter arbiter(GoalPolicy::kMergeAngles, 0);
+  ASSERT_TRUE(submit(arbiter, 1, 0));
+  arbiter.plan(0);
+  ASSERT_TRUE(submit(arbiter, 2, 1 * kMs));
+  ASSERT_TRUE(submit(arbiter, 3, 1 * kMs));
+
+  GoalArbiter::Plan plan = arbiter.plan(2 * kMs);
+  ASSERT_TRUE(plan.start);
+  EXPECT_EQ(plan.start_id, 3u);
+  // Oldest first, so pending rotations add up in request order.
+  EXPECT_EQ(plan.merged, std::vector<uint64_t>({1, 2}));
+  EXPECT_TRUE(plan.preempted.empty());
+
+  arbiter.finish(3);
+  ASSERT_TRUE(submit(arbiter, 4, 3 * kMs));
+  plan = arbiter.plan(3 * kMs);
+  ASSERT_TRUE(plan.start);
+  EXPECT_EQ(plan.start_id, 4u);
+  EXPECT_TRUE(plan.merged.empty());
+
+  const auto metrics = arbiter.metrics();
+  EXPECT_EQ(metrics.merged, 2u);
+  EXPECT_EQ(metrics.preempted, 0u);
+  EXPECT_EQ(metrics.started, 3u);
+}
+
+TEST(GoalPolicy, FinishIgnoresGoalsThatAreNotRunning)
+{
+  GoalArbiter arbiter(GoalPolicy::kRejectIfBusy, 0);
+  ASSERT_TRUE(submit(arbiter, 1, 0));
+  arbiter.plan(0);
+  arbiter.finish(7);
+  EXPECT_FALSE(arbiter.try_admit());
+  arbiter.finish(1);
+  arbiter.finish(1);
+  EXPECT_TRUE(arbiter.try_admit());
+  EXPECT_FALSE(arbiter.try_admit());
+}
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "basic_navigation_cpp/latency_histogram.hpp"
+
+using basic_navigation_cpp::LatencyHistogram;
+
+namespace
+{
+
+constexpr size_t kOverflow = LatencyHistogram::kBuckets - 1;
+
+LatencyHistogram::Snapshot drained(LatencyHistogram & histogram)
+{
+  LatencyHistogram::Snapshot snapshot;
+  histogram.drain(snapshot);
+  return snapshot;
+}
+
+}  // namespace
+
+TEST(LatencyHistogram, SmallValuesHaveExactBuckets)
+{
+  for (uint64_t ns = 0; ns < LatencyHistogram::kSubBuckets; ++ns) {
+    EXPECT_EQ(LatencyHistogram::bucket_index(ns), ns);
+    EXPECT_EQ(LatencyHistogram::bucket_upper_ns(ns), ns + 1);
+  }
+}
+
+// Every power of two from 8 ns up starts a new group of 8 buckets, and the
+// value just below it closes the previous group.
+TEST(LatencyHistogram, PowersOfTwoStartABucketGroup)
+{
+  for (size_t exponent = 3; exponent < LatencyHistogram::kMaxExponent; ++exponent) {
+    SCOPED_TRACE(exponent);
+    const uint64_t power = uint64_t{1} << exponent;
+    const size_t first = LatencyHistogram::kSubBuckets * (exponent - 2);
+    EXPECT_EQ(LatencyHistogram::bucket_index(power), first);
+    EXPECT_EQ(LatencyHistogram::bucket_index(power - 1), first - 1);
+    EXPECT_EQ(LatencyHistogram::bucket_upper_ns(first - 1), power);
+    EXPECT_EQ(LatencyHistogram::bucket_index(2 * power - 1), first + 7);
+    EXPECT_EQ(LatencyHistogram::bucket_upper_ns(first + 7), 2 * power);
+  }
+}
+
+// Every value falls in the bucket whose bounds enclose it, and a bucket is at
+// most 1/8 of its lower bound wide.
+TEST(LatencyHistogram, BucketsEncloseTheirValues)
+{
+  for (uint64_t ns = 1; ns < (uint64_t{1} << 20); ns = ns * 9 / 8 + 1) {
+    SCOPED_TRACE(ns);
+    const size_t index = LatencyHistogram::bucket_index(ns);
+    ASSERT_LT(index, kOverflow);
+    const uint64_t lower = index == 0 ? 0 : LatencyHistogram::bucket_upper_ns(index - 1);
+    const uint64_t upper = LatencyHistogram::bucket_upper_ns(index);
+    EXPECT_LE(lower, ns);
+    EXPECT_LT(ns, upper);
+    EXPECT_LE(upper - lower, lower < 8 ? 1 : lower / 8);
+  }
+}
+
+TEST(LatencyHistogram, LargeSamplesGoToTheOverflowBucket)
+{
+  const uint64_t limit = uint64_t{1} << LatencyHistogram::kMaxExponent;
+  EXPECT_EQ(LatencyHistogram::bucket_index(limit - 1), kOverflow - 1);
+  EXPECT_EQ(LatencyHistogram::bucket_upper_ns(kOverflow - 1), limit);
+  EXPECT_EQ(LatencyHistogram::bucket_index(limit), kOverflow);
+  EXPECT_EQ(
+    LatencyHistogram::bucket_index(std::numeric_limits<uint64_t>::max()), kOverflow);
+  EXPECT_EQ(
+    LatencyHistogram::bucket_upper_ns(kOverflow), std::numeric_limits<uint64_t>::max());
+
+  LatencyHistogram histogram;
+  histogram.record(std::numeric_limits<int64_t>::max());
+  histogram.record(static_cast<int64_t>(limit));
+  const auto snapshot = drained(histogram);
+  EXPECT_EQ(snapshot.buckets[kOverflow], 2u);
+  EXPECT_EQ(snapshot.max_ns, std::numeric_limits<int64_t>::max());
+  // The overflow bucket has no bound; the percentile falls back to the max.
+  EXPECT_EQ(
+    LatencyHistogram::percentile_ns(snapshot, 0.5), std::numeric_limits<int64_t>::max());
+}
+
+TEST(LatencyHistogram, NegativeSamplesCountAsZero)
+{
+  LatencyHistogram histogram;
+  histogram.record(-5);
+  const auto snapshot = drained(histogram);
+  EXPECT_EQ(snapshot.count, 1u);
+  EXPECT_EQ(snapshot.buckets[0], 1u);
+  EXPECT_EQ(snapshot.max_ns, 0);
+}
+
+// Percentiles are the upper bound of the bucket holding the rank
+// round(p * count) (at least 1), capped at the window maximum.
+TEST(LatencyHistogram, PercentilesFollowTheRank)
+{
+  LatencyHistogram histogram;
+  // 90 samples in [1000, 1024) and 10 in [4096, 4608).
+  for (int i = 0; i < 90; ++i) {
+    histogram.record(1000 + i % 20);
+  }
+  for (int i = 0; i < 10; ++i) {
+    histogram.record(4100 + i);
+  }
+  const auto snapshot = drained(histogram);
+  ASSERT_EQ(snapshot.count, 100u);
+  EXPECT_EQ(snapshot.max_ns, 4109);
+
+  EXPECT_EQ(LatencyHistogram::percentile_ns(snapshot, 0.0), 1024);
+  EXPECT_EQ(LatencyHistogram::percentile_ns(snapshot, 0.5), 1024);
+  EXPECT_EQ(LatencyHistogram::percentile_ns(snapshot, 0.9), 1024);
+  // Rank 91 is the first sample of the upper group; its bucket ends at 4608
+  // but no sample went past 4109.
+  EXPECT_EQ(LatencyHistogram::percentile_ns(snapshot, 0.91), 4109);
+  EXPECT_EQ(LatencyHistogram::percentile_ns(snapshot, 0.904), 1024);
+  EXPECT_EQ(LatencyHistogram::percentile_ns(snapshot, 1.0), 4109);
+
+  EXPECT_EQ(LatencyHistogram::percentile_ns(LatencyHistogram::Snapshot(), 0.5), 0);
+}
+
+// drain() hands over the window and resets the histogram; samples from
+// several threads all land in it.
+TEST(LatencyHistogram, DrainCollectsEveryThreadAndResets)
+{
+  LatencyHistogram histogram;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back(
+      [&histogram, t]() {
+        for (int i = 0; i < 10000; ++i) {
+          histogram.record(100 * (t + 1));
+        }
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+
+  const auto first = drained(histogram);
+  EXPECT_EQ(first.count, 40000u);
+  EXPECT_EQ(first.max_ns, 400);
+  for (int t = 0; t < 4; ++t) {
+    EXPECT_EQ(first.buckets[LatencyHistogram::bucket_index(100 * (t + 1))], 10000u);
+  }
+
+  const auto second = drained(histogram);
+  EXPECT_EQ(second.count, 0u);
+  EXPECT_EQ(second.max_ns, 0);
+  histogram.record(7);
+  const auto third = drained(histogram);
+  EXPECT_EQ(third.count, 1u);
+  EXPECT_EQ(third.max_ns, 7);
+}
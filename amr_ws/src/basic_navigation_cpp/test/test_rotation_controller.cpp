@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+
+#include "basic_navigation_cpp/rotation_controller.hpp"
+
+using basic_navigation_cpp::RotationController;
+using basic_navigation_cpp::RotationLimits;
+
+namespace
+{
+
+constexpr double kDeg = M_PI / 180.0;
+
+// The rotation server defaults.
+RotationLimits limits()
+{
+  RotationLimits limits;
+  limits.max_speed = 1.0;
+  limits.max_acceleration = 1.5;
+  limits.min_speed = 0.05;
+  limits.tolerance = 1.0 * kDeg;
+  return limits;
+}
+
+struct Outcome
+{
+  bool done = false;
+  double error_at_done = 0.0;   // true yaw minus target when done() [rad]
+  double error_settled = 0.0;   // after the robot came to rest [rad]
+};
+
+// Rotates by `target` with the controller ticking at 50 Hz while yaw and yaw
+// rate arrive at `sample_hz` and are held in between, as the rotation server
+// sees an IMU or EKF. The base follows the command with a first-order lag.
+Outcome rotate(double target, double sample_hz)
+{
+  constexpr double kControlDt = 0.02;
+  constexpr double kSimDt = 0.001;
+  constexpr double kLag = 0.1;  // base time constant [s]
+  const int steps_per_tick = static_cast<int>(std::lround(kControlDt / kSimDt));
+  const int steps_per_sample = static_cast<int>(std::lround(1.0 / (sample_hz * kSimDt)));
+
+  RotationController controller(limits());
+  controller.start(target);
+  double yaw = 0.0;
+  double rate = 0.0;
+  double held_yaw = 0.0;
+  double held_rate = 0.0;
+  double command = 0.0;
+  Outcome outcome;
+  for (int step = 0; step < 20000; ++step) {
+    if (step % steps_per_sample == 0) {
+      held_yaw = yaw;
+      held_rate = rate;
+    }
+    if (step % steps_per_tick == 0 && !outcome.done) {
+      command = controller.update(held_yaw, held_rate, kControlDt);
+      if (controller.done()) {
+        outcome.done = true;
+        outcome.error_at_done = yaw - target;
+      }
+    }
+    rate += (command - rate) * kSimDt / kLag;
+    yaw += rate * kSimDt;
+  }
+  outcome.error_settled = yaw - target;
+  return outcome;
+}
+
+}  // namespace
+
+TEST(RotationController, DoneNeedsTheMeasuredRateToSettle)
+{
+  RotationController controller(limits());
+  controller.start(10.0 * kDeg);
+  // Inside the tolerance but still turning: not done, and no command.
+  EXPECT_EQ(controller.update(9.5 * kDeg, 0.4, 0.02), 0.0);
+  EXPECT_FALSE(controller.done());
+  // The same held yaw on the next tick says nothing about the rate.
+  EXPECT_EQ(controller.update(9.5 * kDeg, 0.4, 0.02), 0.0);
+  EXPECT_FALSE(controller.done());
+  controller.update(9.8 * kDeg, 0.01, 0.02);
+  EXPECT_TRUE(controller.done());
+  EXPECT_EQ(controller.update(9.8 * kDeg, 0.0, 0.02), 0.0);
+}
+
+TEST(RotationController, RampsUpAndBrakesOnTheProfile)
+{
+  RotationController controller(limits());
+  controller.start(-90.0 * kDeg);
+  // Rate-limited to max_acceleration from rest, towards the target.
+  EXPECT_NEAR(controller.update(0.0, 0.0, 0.02), -0.03, 1e-9);
+  EXPECT_NEAR(controller.update(0.0, 0.0, 0.02), -0.06, 1e-9);
+  // Close to the target the braking speed sqrt(2 a |remaining|) caps the
+  // command, reached at no more than max_acceleration.
+  const double remaining = 2.0 * kDeg;
+  const double braking = std::sqrt(2.0 * 1.5 * remaining);
+  controller.start(-90.0 * kDeg, -1.0);
+  EXPECT_NEAR(controller.update(-88.0 * kDeg, -1.0, 0.02), -0.97, 1e-9);
+  EXPECT_NEAR(controller.remaining(), -remaining, 1e-12);
+  controller.start(-90.0 * kDeg, -braking - 0.01);
+  EXPECT_NEAR(controller.update(-88.0 * kDeg, -braking, 0.02), -braking, 1e-9);
+}
+
+TEST(RotationController, OvershootIsDrivenBack)
+{
+  RotationController controller(limits());
+  controller.start(30.0 * kDeg);
+  EXPECT_LT(controller.update(35.0 * kDeg, 0.0, 0.02), 0.0);
+  EXPECT_FALSE(controller.done());
+}
+
+// Yaw sampled at 10 Hz (IMU) and 30 Hz (EKF) against a 50 Hz control loop:
+// ticks without a new sample must not end the rotation early.
+TEST(RotationController, HeldSamplesDoNotEndTheRotationEarly)
+{
+  for (double sample_hz : {10.0, 30.0, 50.0}) {
+    for (double target : {90.0 * kDeg, -45.0 * kDeg, 10.0 * kDeg, 180.0 * kDeg}) {
+      const Outcome outcome = rotate(target, sample_hz);
+      SCOPED_TRACE(
+        "target " + std::to_string(target / kDeg) + " deg at " + std::to_string(sample_hz) +
+        " Hz");
+      ASSERT_TRUE(outcome.done);
+      EXPECT_LE(std::abs(outcome.error_at_done), 1.5 * kDeg);
+      EXPECT_LE(std::abs(outcome.error_settled), 1.5 * kDeg);
+    }
+  }
+}
@@ -0,0 +1,241 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "basic_navigation_cpp/angles.hpp"
+#include "basic_navigation_cpp/scan_deskew.hpp"
+
+using basic_navigation_cpp::BeamLayout;
+using basic_navigation_cpp::Extrinsic2D;
+using basic_navigation_cpp::OdomHistory;
+using basic_navigation_cpp::Pose2D;
+using basic_navigation_cpp::SweepDeskewer;
+using basic_navigation_cpp::normalize_angle;
+
+namespace
+{
+
+constexpr int64_t kMs = 1000000;
+constexpr int64_t kStamp = 1000 * kMs;
+constexpr uint32_t kBeams = 720;
+constexpr double kScanPeriod = 0.1;
+constexpr double kTimeIncrement = kScanPeriod / kBeams;
+// A 6 x 4 m room around the origin.
+constexpr double kHalfWidth = 3.0;
+constexpr double kHalfHeight = 2.0;
+
+// 2 pi / count apart, and Gazebo's -3.14159 to 3.14159 with both ends
+// included (robot_description/urdf/sensors.xacro).
+const BeamLayout kLayouts[] = {
+  {static_cast<float>(-M_PI), static_cast<float>(2.0 * M_PI / kBeams), kBeams},
+  {-3.14159f, static_cast<float>(2.0 * 3.14159 / (kBeams - 1)), kBeams},
+};
+
+// Pose at time t of a robot that is at `start` at t = 0 and drives at a
+// constant twist.
+Pose2D robot_at(const Pose2D & start, double linear, double angular, double t)
+{
+  Pose2D pose;
+  pose.yaw = start.yaw + angular * t;
+  if (angular == 0.0) {
+    pose.x = start.x + linear * t * std::cos(start.yaw);
+    pose.y = start.y + linear * t * std::sin(start.yaw);
+    return pose;
+  }
+  const double radius = linear / angular;
+  pose.x = start.x + radius * (std::sin(pose.yaw) - std::sin(start.yaw));
+  pose.y = start.y - radius * (std::cos(pose.yaw) - std::cos(start.yaw));
+  return pose;
+}
+
+// Range seen by a lidar at `lidar` on a robot at `pose`, along `angle` in the
+// lidar frame.
+float measure(const Pose2D & pose, const Extrinsic2D & lidar, double angle)
+{
+  const double c = std::cos(pose.yaw);
+  const double s = std::sin(pose.yaw);
+  const double x = pose.x + c * lidar.x - s * lidar.y;
+  const double y = pose.y + s * lidar.x + c * lidar.y;
+  const double dx = std::cos(pose.yaw + lidar.yaw + angle);
+  const double dy = std::sin(pose.yaw + lidar.yaw + angle);
+  double t = std::numeric_limits<double>::infinity();
+  if (dx > 1e-12) {t = std::min(t, (kHalfWidth - x) / dx);}
+  if (dx < -1e-12) {t = std::min(t, (-kHalfWidth - x) / dx);}
+  if (dy > 1e-12) {t = std::min(t, (kHalfHeight - y) / dy);}
+  if (dy < -1e-12) {t = std::min(t, (-kHalfHeight - y) / dy);}
+  return static_cast<float>(t);
+}
+
+struct Sweep
+{
+  std::vector<float> skewed;  // every beam from the pose at its own time
+  std::vector<float> truth;   // every beam from the pose at the stamp
+};
+
+Sweep sweep(
+  const BeamLayout & layout, const Extrinsic2D & lidar, const Pose2D & start, double linear,
+  double angular)
+{
+  Sweep out;
+  for (uint32_t i = 0; i < layout.count; ++i) {
+    const double angle = layout.angle_min + i * static_cast<double>(layout.angle_increment);
+    const Pose2D pose = robot_at(start, linear, angular, i * kTimeIncrement);
+    out.skewed.push_back(measure(pose, lidar, angle));
+    out.truth.push_back(measure(start, lidar, angle));
+  }
+  return out;
+}
+
+// Odometry every `period_ms` from 0.5 s before the stamp to just before the
+// end of the sweep, as the simulated diff drive publishes it.
+OdomHistory odometry(const Pose2D & start, double linear, double angular, int64_t period_ms)
+{
+  OdomHistory odom(1000 * kMs);
+  for (int64_t t = -500; t < 100; t += period_ms) {
+    odom.add(kStamp + t * kMs, robot_at(start, linear, angular, t * 1e-3), linear, angular);
+  }
+  return odom;
+}
+
+// Root mean square and maximum of |ranges - truth| over the non-NaN beams.
+struct Error
+{
+  double rms = 0.0;
+  double max = 0.0;
+  size_t holes = 0;
+};
+
+Error error(const std::vector<float> & ranges, const std::vector<float> & truth)
+{
+  Error e;
+  double sum = 0.0;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    if (std::isnan(ranges[i])) {
+      ++e.holes;
+      continue;
+    }
+    const double d = std::abs(ranges[i] - truth[i]);
+    sum += d * d;
+    e.max = std::max(e.max, d);
+  }
+  e.rms = std::sqrt(sum / (ranges.size() - e.holes));
+  return e;
+}
+
+std::string describe(const BeamLayout & layout)
+{
+  return std::to_string(layout.count) + " beams from " + std::to_string(layout.angle_min) +
+         " every " + std::to_string(layout.angle_increment);
+}
+
+}  // namespace
+
+TEST(Angles, NormalizeAngle)
+{
+  EXPECT_DOUBLE_EQ(normalize_angle(0.5), 0.5);
+  EXPECT_NEAR(normalize_angle(3.0 * M_PI / 2.0), -M_PI / 2.0, 1e-12);
+  EXPECT_NEAR(normalize_angle(-5.0 * M_PI / 2.0), -M_PI / 2.0, 1e-12);
+  EXPECT_DOUBLE_EQ(normalize_angle(M_PI), -M_PI);
+}
+
+TEST(OdomHistory, InterpolatesYawAcrossPi)
+{
+  OdomHistory odom(1000 * kMs);
+  odom.add(0, Pose2D{0.0, 0.0, 3.0}, 0.0, 0.0);
+  odom.add(100 * kMs, Pose2D{1.0, 0.0, -3.0}, 0.0, 0.0);
+  Pose2D pose;
+  ASSERT_TRUE(odom.pose_at(50 * kMs, 0, pose));
+  EXPECT_DOUBLE_EQ(pose.x, 0.5);
+  EXPECT_NEAR(normalize_angle(pose.yaw - M_PI), 0.0, 1e-12);
+}
+
+TEST(OdomHistory, ExtrapolatesOnlyWithinTheLimit)
+{
+  OdomHistory odom(1000 * kMs);
+  odom.add(0, Pose2D{0.0, 0.0, 0.0}, 1.0, 0.0);
+  odom.add(100 * kMs, Pose2D{0.1, 0.0, 0.0}, 1.0, 0.0);
+  Pose2D pose;
+  ASSERT_TRUE(odom.pose_at(150 * kMs, 60 * kMs, pose));
+  EXPECT_NEAR(pose.x, 0.15, 1e-12);
+  EXPECT_FALSE(odom.pose_at(200 * kMs, 60 * kMs, pose));
+  EXPECT_FALSE(odom.pose_at(-100 * kMs, 60 * kMs, pose));
+}
+
+// A robot at rest must get its scan back unchanged, with no hole where the
+// layout wraps around.
+TEST(SweepDeskewer, StaticRobotKeepsTheScan)
+{
+  const Pose2D start{0.4, -0.3, 0.2};
+  for (const BeamLayout & layout : kLayouts) {
+    SCOPED_TRACE(describe(layout));
+    const Sweep scan = sweep(layout, Extrinsic2D(), start, 0.0, 0.0);
+    const OdomHistory odom = odometry(start, 0.0, 0.0, 10);
+    SweepDeskewer deskewer{Extrinsic2D()};
+    std::vector<float> out(layout.count);
+    ASSERT_TRUE(
+      deskewer.deskew(
+        scan.skewed.data(), nullptr, layout, 0.1f, 10.0f, kStamp, kTimeIncrement, odom,
+        150 * kMs, out.data(), nullptr));
+    const Error e = error(out, scan.truth);
+    EXPECT_EQ(e.holes, 0u);
+    EXPECT_LT(e.max, 1e-4);
+  }
+}
+
+// Driving and turning at the nav2 limits (0.26 m/s, 1 rad/s) with the lidar
+// ahead of the base: the deskewed scan is close to one taken entirely from
+// the stamp pose, at both beam spacings, with 100 Hz and 10 Hz odometry.
+TEST(SweepDeskewer, UndoesConstantTwist)
+{
+  const Pose2D start{0.4, -0.3, 0.2};
+  const Extrinsic2D lidar{0.1f, 0.0f, 0.0f};
+  const double linear = 0.26;
+  const double angular = 1.0;
+  for (const BeamLayout & layout : kLayouts) {
+    for (int64_t period_ms : {10, 100}) {
+      SCOPED_TRACE(describe(layout) + ", odometry every " + std::to_string(period_ms) + " ms");
+      const Sweep scan = sweep(layout, lidar, start, linear, angular);
+      const OdomHistory odom = odometry(start, linear, angular, period_ms);
+      SweepDeskewer deskewer(lidar);
+      std::vector<float> out(layout.count);
+      ASSERT_TRUE(
+        deskewer.deskew(
+          scan.skewed.data(), nullptr, layout, 0.1f, 10.0f, kStamp, kTimeIncrement, odom,
+          150 * kMs, out.data(), nullptr));
+
+      const Error before = error(scan.skewed, scan.truth);
+      const Error after = error(out, scan.truth);
+      EXPECT_GT(before.rms, 0.05);
+      EXPECT_LT(after.rms, 0.1 * before.rms);
+      EXPECT_LT(after.max, 0.05);
+      // Beams spread a little while the robot turns, leaving a few bins empty.
+      EXPECT_LE(after.holes, 15u);
+      // Gazebo's first and last beams point the same way.
+      if (&layout == &kLayouts[1]) {
+        EXPECT_FALSE(std::isnan(out.front()));
+        EXPECT_EQ(out.front(), out.back());
+      }
+    }
+  }
+}
+
+TEST(SweepDeskewer, RefusesSweepsTheOdometryDoesNotCover)
+{
+  const Pose2D start{0.0, 0.0, 0.0};
+  OdomHistory odom(1000 * kMs);
+  odom.add(kStamp - 500 * kMs, start, 0.0, 0.0);
+  odom.add(kStamp - 300 * kMs, start, 0.0, 0.0);
+  SweepDeskewer deskewer{Extrinsic2D()};
+  std::vector<float> ranges(kBeams, 1.0f);
+  std::vector<float> out(kBeams, 2.0f);
+  EXPECT_FALSE(
+    deskewer.deskew(
+      ranges.data(), nullptr, kLayouts[0], 0.1f, 10.0f, kStamp, kTimeIncrement, odom,
+      150 * kMs, out.data(), nullptr));
+  EXPECT_EQ(out, std::vector<float>(kBeams, 2.0f));
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "basic_navigation_cpp/scan_filter.hpp"
+
+using basic_navigation_cpp::ScanFilter;
+using basic_navigation_cpp::ScanFilterConfig;
+using basic_navigation_cpp::decimate_scan;
+
+namespace
+{
+
+constexpr float kNaN = std::numeric_limits<float>::quiet_NaN();
+constexpr float kInf = std::numeric_limits<float>::infinity();
+constexpr float kDeg = static_cast<float>(M_PI / 180.0);
+
+// The scan_preprocessor defaults, with shadow removal and the median off.
+ScanFilterConfig config()
+{
+  ScanFilterConfig config;
+  config.range_min = 0.12f;
+  config.range_max = 10.0f;
+  config.shadow_min_angle = 10.0f * kDeg;
+  config.shadow_max_angle = 170.0f * kDeg;
+  return config;
+}
+
+// Filters `ranges` with 0.5 degree beams and returns the number of beams
+// that are not NaN through `kept`.
+std::vector<float> filter(
+  const ScanFilterConfig & config, const std::vector<float> & ranges, size_t & kept)
+{
+  ScanFilter filter(config);
+  std::vector<float> out(ranges.size());
+  kept = filter.filter(ranges.data(), ranges.size(), 0.5f * kDeg, out.data());
+  return out;
+}
+
+// Element-wise equality where NaN equals NaN.
+void expect_ranges(const std::vector<float> & actual, const std::vector<float> & expected)
+{
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    SCOPED_TRACE("beam " + std::to_string(i));
+    if (std::isnan(expected[i])) {
+      EXPECT_TRUE(std::isnan(actual[i])) << actual[i];
+    } else {
+      EXPECT_EQ(actual[i], expected[i]);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(ScanFilter, ClipKeepsNoReturnAsInfinity)
+{
+  size_t kept;
+  const auto out = filter(
+    config(), {5.0f, kInf, kNaN, -kInf, 0.05f, 11.0f, 0.12f, 10.0f}, kept);
+  expect_ranges(out, {5.0f, kInf, kNaN, kNaN, kNaN, kNaN, 0.12f, 10.0f});
+  EXPECT_EQ(kept, 4u);
+}
+
+// A near wall at 1 m ends and a far wall at 3 m starts: the first far beam,
+// which sees the far wall almost along the near beam, is a veil point.
+TEST(ScanFilter, ShadowDropsTheFarSideOfADepthEdge)
+{
+  ScanFilterConfig shadow = config();
+  shadow.shadow_window = 1;
+  size_t kept;
+  const auto out = filter(
+    shadow, {1.0f, 1.0f, 1.0f, 3.0f, 3.0f, 3.0f, kInf, 3.0f, kNaN, 3.0f}, kept);
+  expect_ranges(out, {1.0f, 1.0f, 1.0f, kNaN, 3.0f, 3.0f, kInf, 3.0f, kNaN, 3.0f});
+  EXPECT_EQ(kept, 8u);
+
+  // A wider window also pairs beams two apart, so a veil point between the
+  // walls goes along with the first two far beams.
+  shadow.shadow_window = 2;
+  const auto wide = filter(shadow, {1.0f, 1.0f, 2.0f, 3.0f, 3.0f, 3.0f, 3.0f}, kept);
+  expect_ranges(wide, {1.0f, 1.0f, kNaN, kNaN, kNaN, 3.0f, 3.0f});
+}
+
+TEST(ScanFilter, MedianSkipsInvalidBeams)
+{
+  ScanFilterConfig median = config();
+  median.median_window = 3;
+  size_t kept;
+  const auto out = filter(
+    median, {1.0f, 1.0f, 5.0f, 1.0f, 1.0f, kNaN, 1.0f, kInf, 1.0f, kInf, 3.0f, kInf, kInf},
+    kept);
+  // A single spike and a single dropout are removed, a single return among
+  // no-returns as well; invalid beams stay invalid.
+  EXPECT_EQ(out[2], 1.0f);
+  EXPECT_TRUE(std::isnan(out[5]));
+  EXPECT_EQ(out[7], 1.0f);
+  EXPECT_EQ(out[10], kInf);
+  EXPECT_EQ(kept, 12u);
+}
+
+TEST(ScanFilter, EvenMedianWindowIsWidened)
+{
+  ScanFilterConfig median = config();
+  median.median_window = 4;
+  EXPECT_EQ(ScanFilter(median).config().median_window, 5u);
+  median.median_window = 100;
+  EXPECT_EQ(ScanFilter(median).config().median_window, ScanFilter::kMaxMedianWindow);
+}
+
+TEST(DecimateScan, KeepsTheNearestReturnOfEveryGroup)
+{
+  const std::vector<float> ranges = {
+    3.0f, 1.0f, kNaN, 2.0f,
+    kNaN, kNaN, kNaN, kNaN,
+    kInf, kInf, 4.0f, kInf,
+    kInf, kNaN, kInf, kInf,
+    7.0f};
+  std::vector<float> out(5);
+  ASSERT_EQ(decimate_scan(ranges.data(), ranges.size(), 4, out.data()), 5u);
+  expect_ranges(out, {1.0f, kNaN, 4.0f, kInf, 7.0f});
+
+  // A factor of 0 or 1 copies the scan.
+  std::vector<float> copy(ranges.size());
+  ASSERT_EQ(decimate_scan(ranges.data(), ranges.size(), 0, copy.data()), ranges.size());
+  expect_ranges(copy, ranges);
+}
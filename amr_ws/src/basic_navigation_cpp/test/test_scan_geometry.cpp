@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "basic_navigation_cpp/scan_geometry.hpp"
+
+using basic_navigation_cpp::BeamLayout;
+using basic_navigation_cpp::Extrinsic2D;
+using basic_navigation_cpp::ScanPoints;
+using basic_navigation_cpp::ScanProjector;
+using basic_navigation_cpp::beam_table;
+using basic_navigation_cpp::closest_ahead;
+using basic_navigation_cpp::project_scan;
+using basic_navigation_cpp::project_scan_kernel;
+using basic_navigation_cpp::project_scan_scalar;
+
+namespace
+{
+
+constexpr float kNaN = std::numeric_limits<float>::quiet_NaN();
+constexpr float kInf = std::numeric_limits<float>::infinity();
+constexpr float kRangeMin = 0.12f;
+constexpr float kRangeMax = 3.5f;
+
+// Ranges over the whole valid interval, with every kind of invalid return
+// sprinkled in so both the vector blocks and the tail see them.
+std::vector<float> ranges(uint32_t count)
+{
+  std::vector<float> out(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    switch (i % 11) {
+      case 3: out[i] = kNaN; break;
+      case 5: out[i] = kInf; break;
+      case 7: out[i] = 0.5f * kRangeMin; break;
+      case 9: out[i] = kRangeMax + 1.0f; break;
+      default: out[i] = kRangeMin + (kRangeMax - kRangeMin) * (i % 17) / 16.0f;
+    }
+  }
+  // The interval is closed.
+  if (count > 1) {
+    out[0] = kRangeMin;
+    out[count - 1] = kRangeMax;
+  }
+  return out;
+}
+
+Extrinsic2D extrinsic()
+{
+  Extrinsic2D lidar;
+  lidar.x = 0.1f;
+  lidar.y = -0.05f;
+  lidar.yaw = 0.3f;
+  return lidar;
+}
+
+// The point of beam i computed directly in double.
+void expect_point(
+  const ScanPoints & points, const BeamLayout & layout, const Extrinsic2D & lidar,
+  const std::vector<float> & r, uint32_t i)
+{
+  SCOPED_TRACE("beam " + std::to_string(i));
+  if (!(r[i] >= kRangeMin && r[i] <= kRangeMax)) {
+    EXPECT_TRUE(std::isnan(points.x[i]));
+    EXPECT_TRUE(std::isnan(points.y[i]));
+    return;
+  }
+  const double angle = static_cast<double>(lidar.yaw) + layout.angle_min +
+    static_cast<double>(i) * layout.angle_increment;
+  EXPECT_NEAR(points.x[i], lidar.x + r[i] * std::cos(angle), 1e-5);
+  EXPECT_NEAR(points.y[i], lidar.y + r[i] * std::sin(angle), 1e-5);
+}
+
+}  // namespace
+
+// Counts that leave a tail after whole AVX2 (8) and NEON (4) blocks, and one
+// that does not.
+TEST(ScanGeometry, VectorKernelMatchesScalarWithTails)
+{
+  const Extrinsic2D lidar = extrinsic();
+  for (uint32_t count : {1u, 7u, 13u, 360u, 719u}) {
+    SCOPED_TRACE(std::to_string(count) + " beams on " + project_scan_kernel());
+    const BeamLayout layout{-3.1f, 6.2f / count, count};
+    const auto table = beam_table(layout);
+    const std::vector<float> r = ranges(count);
+    ScanPoints vector;
+    ScanPoints scalar;
+    project_scan(*table, r.data(), kRangeMin, kRangeMax, lidar, vector);
+    project_scan_scalar(*table, r.data(), kRangeMin, kRangeMax, lidar, scalar);
+
+    ASSERT_EQ(vector.x.size(), count);
+    ASSERT_EQ(scalar.x.size(), count);
+    EXPECT_EQ(vector.valid, scalar.valid);
+    size_t valid = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+      expect_point(vector, layout, lidar, r, i);
+      expect_point(scalar, layout, lidar, r, i);
+      valid += std::isnan(scalar.x[i]) ? 0 : 1;
+    }
+    EXPECT_EQ(scalar.valid, valid);
+  }
+}
+
+TEST(ScanGeometry, BeamTableIsSharedPerLayout)
+{
+  const BeamLayout layout{-1.0f, 0.01f, 201};
+  const auto table = beam_table(layout);
+  EXPECT_EQ(beam_table(layout), table);
+
+  // Any change to the layout is a different table.
+  const auto shifted = beam_table(BeamLayout{-0.5f, 0.01f, 201});
+  const auto finer = beam_table(BeamLayout{-1.0f, 0.005f, 201});
+  const auto longer = beam_table(BeamLayout{-1.0f, 0.01f, 202});
+  EXPECT_NE(shifted, table);
+  EXPECT_NE(finer, table);
+  EXPECT_NE(longer, table);
+  EXPECT_FLOAT_EQ(shifted->cos[0], static_cast<float>(std::cos(-0.5)));
+  EXPECT_NEAR(finer->sin[200], 0.0f, 1e-6);
+  EXPECT_EQ(longer->cos.size(), 202u);
+  EXPECT_EQ(beam_table(layout), table);
+}
+
+// A lidar driver that changes angle_min or angle_increment mid-run: the
+// projector must not keep converting with the old table.
+TEST(ScanGeometry, ProjectorFollowsLayoutChanges)
+{
+  ScanProjector projector;
+  const std::vector<float> r(9, 1.0f);
+  BeamLayout layout{0.0f, 0.1f, 9};
+  const ScanPoints & points = projector.project(r.data(), layout, kRangeMin, kRangeMax);
+  EXPECT_FLOAT_EQ(points.x[0], 1.0f);
+  EXPECT_FLOAT_EQ(points.y[4], static_cast<float>(std::sin(0.4)));
+
+  layout.angle_min = static_cast<float>(M_PI / 2);
+  projector.project(r.data(), layout, kRangeMin, kRangeMax);
+  EXPECT_NEAR(points.x[0], 0.0f, 1e-6);
+  EXPECT_FLOAT_EQ(points.y[0], 1.0f);
+
+  layout.angle_increment = 0.2f;
+  projector.project(r.data(), layout, kRangeMin, kRangeMax);
+  EXPECT_FLOAT_EQ(points.x[4], static_cast<float>(std::cos(M_PI / 2 + 0.8)));
+
+  const std::vector<float> longer(13, 2.0f);
+  layout.count = 13;
+  projector.project(longer.data(), layout, kRangeMin, kRangeMax);
+  ASSERT_EQ(points.x.size(), 13u);
+  EXPECT_EQ(points.valid, 13u);
+}
+
+TEST(ScanGeometry, ClosestAheadStaysInTheCorridor)
+{
+  ScanPoints points;
+  points.x = {-0.2f, 0.8f, 0.4f, kNaN, 0.6f, 0.3f};
+  points.y = {0.0f, 0.1f, 0.2f, kNaN, -0.15f, -0.16f};
+  // Behind, outside the corridor and invalid points do not count.
+  EXPECT_FLOAT_EQ(closest_ahead(points, 0.15f), 0.6f);
+  EXPECT_FLOAT_EQ(closest_ahead(points, 0.2f), 0.3f);
+  EXPECT_EQ(closest_ahead(points, 0.05f), kInf);
+  EXPECT_EQ(closest_ahead(ScanPoints(), 0.15f), kInf);
+}
@@ -0,0 +1,241 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "basic_navigation_cpp/twist_arbiter.hpp"
+#include "basic_navigation_cpp/twist_slot.hpp"
+
+using basic_navigation_cpp::TwistArbiter;
+using basic_navigation_cpp::TwistSlot;
+using basic_navigation_cpp::Velocity;
+
+namespace
+{
+
+constexpr int64_t kMs = 1000000;
+
+Velocity uniform(double value)
+{
+  Velocity velocity;
+  velocity.fill(value);
+  return velocity;
+}
+
+bool is_uniform(const Velocity & velocity)
+{
+  for (double value : velocity) {
+    if (value != velocity[0]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST(TwistSlot, EmptyUntilWritten)
+{
+  TwistSlot slot;
+  Velocity velocity;
+  int64_t stamp_ns;
+  uint64_t overwritten;
+  EXPECT_FALSE(slot.read(velocity, stamp_ns));
+  EXPECT_FALSE(slot.consume(velocity, stamp_ns, overwritten));
+  EXPECT_EQ(overwritten, 0u);
+
+  slot.write(uniform(1.0), 5);
+  ASSERT_TRUE(slot.read(velocity, stamp_ns));
+  EXPECT_EQ(velocity, uniform(1.0));
+  EXPECT_EQ(stamp_ns, 5);
+}
+
+TEST(TwistSlot, ConsumeCountsValuesNobodyTook)
+{
+  TwistSlot slot;
+  Velocity velocity;
+  int64_t stamp_ns;
+  uint64_t overwritten;
+
+  slot.write(uniform(1.0), 1);
+  ASSERT_TRUE(slot.consume(velocity, stamp_ns, overwritten));
+  EXPECT_EQ(overwritten, 0u);
+
+  slot.write(uniform(2.0), 2);
+  slot.write(uniform(3.0), 3);
+  slot.write(uniform(4.0), 4);
+  // read() does not consume.
+  ASSERT_TRUE(slot.read(velocity, stamp_ns));
+  ASSERT_TRUE(slot.consume(velocity, stamp_ns, overwritten));
+  EXPECT_EQ(velocity, uniform(4.0));
+  EXPECT_EQ(overwritten, 2u);
+
+  // Consuming the same value again loses nothing.
+  ASSERT_TRUE(slot.consume(velocity, stamp_ns, overwritten));
+  EXPECT_EQ(overwritten, 0u);
+}
+
+// Every write is either consumed or counted as overwritten, exactly once,
+// and a consumer never sees a torn value.
+TEST(TwistSlot, ConcurrentWritesAreAccountedExactly)
+{
+  constexpr int kWrites = 200000;
+  TwistSlot slot;
+  std::atomic<bool> done(false);
+  std::thread writer(
+    [&]() {
+      for (int i = 1; i <= kWrites; ++i) {
+        slot.write(uniform(i), i);
+      }
+      done.store(true);
+    });
+
+  uint64_t consumed = 0;
+  uint64_t overwritten_total = 0;
+  int64_t last_stamp = 0;
+  bool torn = false;
+  bool backwards = false;
+  auto consume = [&]() {
+      Velocity velocity;
+      int64_t stamp_ns;
+      uint64_t overwritten;
+      if (!slot.consume(velocity, stamp_ns, overwritten)) {
+        return;
+      }
+      torn = torn || !is_uniform(velocity) || velocity[0] != static_cast<double>(stamp_ns);
+      backwards = backwards || stamp_ns < last_stamp;
+      if (stamp_ns != last_stamp) {
+        ++consumed;
+        last_stamp = stamp_ns;
+      }
+      overwritten_total += overwritten;
+    };
+  while (!done.load()) {
+    consume();
+  }
+  writer.join();
+  consume();
+
+  EXPECT_FALSE(torn);
+  EXPECT_FALSE(backwards);
+  EXPECT_EQ(last_stamp, kWrites);
+  EXPECT_EQ(consumed + overwritten_total, static_cast<uint64_t>(kWrites));
+}
+
+TEST(TwistArbiter, HighestPriorityFreshInputWins)
+{
+  TwistArbiter arbiter;
+  const size_t nav = arbiter.add_input("nav", 10, 500 * kMs);
+  const size_t teleop = arbiter.add_input("teleop", 100, 500 * kMs);
+  Velocity velocity;
+  EXPECT_EQ(arbiter.select(0, velocity), -1);
+
+  arbiter.write(nav, uniform(1.0), 0);
+  EXPECT_EQ(arbiter.select(10 * kMs, velocity), static_cast<int>(nav));
+  EXPECT_EQ(velocity, uniform(1.0));
+
+  arbiter.write(teleop, uniform(2.0), 20 * kMs);
+  EXPECT_EQ(arbiter.select(30 * kMs, velocity), static_cast<int>(teleop));
+  EXPECT_EQ(velocity, uniform(2.0));
+  EXPECT_EQ(arbiter.counters(nav).preempted, 1u);
+
+  // Once teleop times out, nav is eligible again while its command is fresh.
+  arbiter.write(nav, uniform(3.0), 400 * kMs);
+  EXPECT_EQ(arbiter.select(600 * kMs, velocity), static_cast<int>(nav));
+  EXPECT_EQ(velocity, uniform(3.0));
+  EXPECT_EQ(arbiter.counters(teleop).stale, 1u);
+  EXPECT_EQ(arbiter.counters(teleop).selected, 1u);
+  EXPECT_EQ(arbiter.counters(nav).selected, 2u);
+
+  // Both timed out.
+  EXPECT_EQ(arbiter.select(1000 * kMs, velocity), -1);
+  EXPECT_EQ(arbiter.counters(nav).stale, 1u);
+}
+
+TEST(TwistArbiter, TiesGoToTheFirstInput)
+{
+  TwistArbiter arbiter;
+  const size_t first = arbiter.add_input("first", 10, 500 * kMs);
+  const size_t second = arbiter.add_input("second", 10, 500 * kMs);
+  arbiter.write(second, uniform(2.0), 0);
+  arbiter.write(first, uniform(1.0), 0);
+  Velocity velocity;
+  EXPECT_EQ(arbiter.select(0, velocity), static_cast<int>(first));
+  EXPECT_EQ(arbiter.counters(second).preempted, 1u);
+}
+
+TEST(TwistArbiter, LockedOutInputIsSkipped)
+{
+  TwistArbiter arbiter;
+  const size_t nav = arbiter.add_input("nav", 10, 500 * kMs);
+  const size_t teleop = arbiter.add_input("teleop", 100, 500 * kMs);
+  arbiter.write(nav, uniform(1.0), 0);
+  arbiter.write(teleop, uniform(2.0), 0);
+  arbiter.set_locked_out(teleop, true);
+  Velocity velocity;
+  EXPECT_EQ(arbiter.select(0, velocity), static_cast<int>(nav));
+  EXPECT_EQ(arbiter.counters(teleop).locked_out, 1u);
+
+  arbiter.set_locked_out(teleop, false);
+  EXPECT_EQ(arbiter.select(0, velocity), static_cast<int>(teleop));
+}
+
+TEST(TwistArbiter, CountsOverwrittenCommands)
+{
+  TwistArbiter arbiter;
+  const size_t nav = arbiter.add_input("nav", 10, 500 * kMs);
+  Velocity velocity;
+  arbiter.write(nav, uniform(1.0), 0);
+  arbiter.write(nav, uniform(2.0), 0);
+  arbiter.write(nav, uniform(3.0), 0);
+  arbiter.select(0, velocity);
+  arbiter.select(0, velocity);
+  arbiter.write(nav, uniform(4.0), 0);
+  arbiter.select(0, velocity);
+  EXPECT_EQ(arbiter.counters(nav).received, 4u);
+  EXPECT_EQ(arbiter.counters(nav).overwritten, 2u);
+}
+
+// Inputs written from their own threads while the output tick selects:
+// every selected command is one that was written whole.
+TEST(TwistArbiter, ConcurrentInputs)
+{
+  constexpr int kWrites = 100000;
+  TwistArbiter arbiter;
+  const size_t low = arbiter.add_input("low", 10, 1000 * kMs);
+  const size_t high = arbiter.add_input("high", 100, 1000 * kMs);
+  std::atomic<int> running(2);
+  auto writer = [&](size_t input, double sign) {
+      for (int i = 1; i <= kWrites; ++i) {
+        arbiter.write(input, uniform(sign * i), 0);
+      }
+      running.fetch_sub(1);
+    };
+  std::thread low_writer(writer, low, -1.0);
+  std::thread high_writer(writer, high, 1.0);
+
+  bool torn = false;
+  bool wrong_input = false;
+  Velocity velocity;
+  while (running.load() > 0) {
+    const int winner = arbiter.select(0, velocity);
+    if (winner >= 0) {
+      torn = torn || !is_uniform(velocity);
+      wrong_input = wrong_input ||
+        (winner == static_cast<int>(high)) != (velocity[0] > 0.0);
+    }
+  }
+  low_writer.join();
+  high_writer.join();
+
+  EXPECT_FALSE(torn);
+  EXPECT_FALSE(wrong_input);
+  EXPECT_EQ(arbiter.select(0, velocity), static_cast<int>(high));
+  EXPECT_EQ(velocity, uniform(kWrites));
+  for (size_t input : {low, high}) {
+    const auto counters = arbiter.counters(input);
+    EXPECT_EQ(counters.received, static_cast<uint64_t>(kWrites));
+    EXPECT_LT(counters.overwritten, counters.received);
+  }
+}
@@ -0,0 +1,34 @@
+#ifndef BENCHMARK_UTILS_HPP_
+#define BENCHMARK_UTILS_HPP_
+
+#include <chrono>
+#include <cstddef>
+
+namespace benchmark_utils
+{
+
+// Keeps the optimizer from discarding work whose result is otherwise unused.
+template<typename T>
+inline void do_not_optimize(T const & value)
+{
+  asm volatile ("" : : "g" (&value) : "memory");
+}
+
+// Average wall time of one call to `op`, in nanoseconds.
+template<typename Op>
+double ns_per_op(Op && op, size_t iterations)
+{
+  for (size_t i = 0; i < iterations / 10 + 1; ++i) {
+    op();
+  }
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    op();
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+}  // namespace benchmark_utils
+
+#endif  // BENCHMARK_UTILS_HPP_
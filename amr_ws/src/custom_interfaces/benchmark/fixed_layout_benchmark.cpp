@@ -0,0 +1,123 @@
+// Compares the fixed-layout fast path against the generated fastrtps
+// serializer for every custom_interfaces type, and checks that both produce
+// the same bytes.
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "fastcdr/Cdr.h"
+#include "fastcdr/FastBuffer.h"
+
+#include "custom_interfaces/action/aula9.hpp"
+#include "custom_interfaces/action/rotate.hpp"
+#include "custom_interfaces/fixed_layout_typesupport.hpp"
+#include "custom_interfaces/msg/aula7.hpp"
+#include "custom_interfaces/msg/aula7_fixed.hpp"
+#include "custom_interfaces/srv/aula8.hpp"
+
+#include "benchmark_utils.hpp"
+
+namespace
+{
+
+constexpr size_t kIterations = 1000000;
+
+template<typename MessageT>
+void compare(const char * name, const MessageT & msg)
+{
+  using FastTS = custom_interfaces::FixedLayoutTypeSupport<MessageT>;
+  std::vector<char> stock_bytes(1024);
+  std::vector<char> fast_bytes(1024);
+  eprosima::fastcdr::FastBuffer stock_buffer(stock_bytes.data(), stock_bytes.size());
+  eprosima::fastcdr::FastBuffer fast_buffer(fast_bytes.data(), fast_bytes.size());
+  eprosima::fastcdr::Cdr stock_cdr(
+    stock_buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::Cdr::DDS_CDR);
+  eprosima::fastcdr::Cdr fast_cdr(
+    fast_buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::Cdr::DDS_CDR);
+
+  const double stock_ns = benchmark_utils::ns_per_op(
+    [&]() {
+      stock_cdr.reset();
+      stock_cdr.serialize_encapsulation();
+      FastTS::stock().cdr_serialize(&msg, stock_cdr);
+      benchmark_utils::do_not_optimize(stock_bytes[4]);
+    }, kIterations);
+  const double fast_ns = benchmark_utils::ns_per_op(
+    [&]() {
+      fast_cdr.reset();
+      fast_cdr.serialize_encapsulation();
+      FastTS::cdr_serialize(msg, fast_cdr);
+      benchmark_utils::do_not_optimize(fast_bytes[4]);
+    }, kIterations);
+
+  MessageT decoded;
+  fast_cdr.reset();
+  fast_cdr.read_encapsulation();
+  FastTS::cdr_deserialize(fast_cdr, decoded);
+
+  const size_t length = stock_cdr.getSerializedDataLength();
+  const bool same_bytes = length == fast_cdr.getSerializedDataLength() &&
+    std::memcmp(stock_bytes.data(), fast_bytes.data(), length) == 0;
+
+  std::printf(
+    "%-28s %-6s %6zu %10.1f %10.1f %7.2fx %-5s %-5s\n",
+    name, FastTS::is_fixed_layout() ? "yes" : "no", length - 4,
+    stock_ns, fast_ns, stock_ns / fast_ns,
+    same_bytes ? "ok" : "DIFF", decoded == msg ? "ok" : "DIFF");
+}
+
+}  // namespace
+
+int main()
+{
+  std::printf(
+    "%-28s %-6s %6s %10s %10s %8s %-5s %-5s\n",
+    "type", "fixed", "bytes", "stock ns", "fast ns", "speedup", "bytes", "round");
+
+  custom_interfaces::msg::Aula7 aula7;
+  aula7.count = 42;
+  aula7.message = "The count is: ";
+  compare("msg/Aula7", aula7);
+
+  custom_interfaces::msg::Aula7Fixed aula7_fixed;
+  aula7_fixed.count = 42;
+  aula7_fixed.message_length = 14;
+  std::memcpy(aula7_fixed.message.data(), "The count is: ", 14);
+  compare("msg/Aula7Fixed", aula7_fixed);
+
+  custom_interfaces::srv::Aula8::Request aula8_request;
+  aula8_request.a = 40;
+  aula8_request.b = 2;
+  compare("srv/Aula8_Request", aula8_request);
+
+  custom_interfaces::srv::Aula8::Response aula8_response;
+  aula8_response.sum = 42;
+  compare("srv/Aula8_Response", aula8_response);
+
+  custom_interfaces::action::Aula9::Goal aula9_goal;
+  aula9_goal.count_up_to = 10;
+  compare("action/Aula9_Goal", aula9_goal);
+
+  custom_interfaces::action::Aula9::Result aula9_result;
+  aula9_result.final_count = 10;
+  compare("action/Aula9_Result", aula9_result);
+
+  custom_interfaces::action::Aula9::Feedback aula9_feedback;
+  aula9_feedback.current_number = 3;
+  compare("action/Aula9_Feedback", aula9_feedback);
+
+  custom_interfaces::action::Rotate::Goal rotate_goal;
+  rotate_goal.angle = 90.0f;
+  compare("action/Rotate_Goal", rotate_goal);
+
+  custom_interfaces::action::Rotate::Result rotate_result;
+  rotate_result.success = true;
+  compare("action/Rotate_Result", rotate_result);
+
+  custom_interfaces::action::Rotate::Feedback rotate_feedback;
+  rotate_feedback.remaining_degrees = 45.0f;
+  compare("action/Rotate_Feedback", rotate_feedback);
+
+  return 0;
+}
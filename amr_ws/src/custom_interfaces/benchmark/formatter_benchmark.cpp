@@ -0,0 +1,198 @@
+// Compares the buffer formatter in message_formatter.hpp with the
+// std::ostream / std::string approach of the generated traits to_yaml.
+// The generated to_yaml is used when the installed rosidl provides it
+// (Galactic and newer); otherwise an equivalent ostream writer stands in.
+
+#include <array>
+#include <cstdio>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "custom_interfaces/message_formatter.hpp"
+
+#include "benchmark_utils.hpp"
+
+namespace
+{
+
+constexpr size_t kIterations = 200000;
+
+namespace format = custom_interfaces::format;
+
+// ostream writer with the layout and allocation pattern of the generated code
+template<typename MessageT>
+void ostream_yaml(std::ostream & out, const MessageT & msg, size_t indent);
+
+template<typename T>
+typename std::enable_if<!format::is_formattable_message<T>::value>::type
+ostream_value(std::ostream & out, const T & value, size_t)
+{
+  out << " " << value << "\n";
+}
+
+inline void ostream_value(std::ostream & out, bool value, size_t)
+{
+  out << " " << (value ? "true" : "false") << "\n";
+}
+
+inline void ostream_value(std::ostream & out, uint8_t value, size_t)
+{
+  out << " " << static_cast<unsigned>(value) << "\n";
+}
+
+inline void ostream_value(std::ostream & out, const std::string & value, size_t)
+{
+  out << " \"" << value << "\"\n";
+}
+
+template<typename T>
+typename std::enable_if<format::is_formattable_message<T>::value>::type
+ostream_value(std::ostream & out, const T & value, size_t indent)
+{
+  out << "\n";
+  ostream_yaml(out, value, indent + 2);
+}
+
+template<typename Container>
+void ostream_sequence(std::ostream & out, const Container & values, size_t indent)
+{
+  if (values.size() == 0) {
+    out << " []\n";
+    return;
+  }
+  out << "\n";
+  for (const auto & value : values) {
+    out << std::string(indent, ' ') + "-";
+    ostream_value(out, value, indent);
+  }
+}
+
+template<typename T>
+void ostream_field(std::ostream & out, const T & value, size_t indent)
+{
+  ostream_value(out, value, indent);
+}
+
+template<typename T, size_t N>
+void ostream_field(std::ostream & out, const std::array<T, N> & value, size_t indent)
+{
+  ostream_sequence(out, value, indent);
+}
+
+template<typename T, typename Allocator>
+void ostream_field(std::ostream & out, const std::vector<T, Allocator> & value, size_t indent)
+{
+  ostream_sequence(out, value, indent);
+}
+
+template<typename MessageT>
+struct OstreamVisitor
+{
+  std::ostream & out;
+  const MessageT & msg;
+  size_t indent;
+
+  template<typename FieldT>
+  void operator()(const format::Member<MessageT, FieldT> & field)
+  {
+    out << std::string(indent, ' ') + field.name + ":";
+    ostream_field(out, msg.*(field.pointer), indent);
+  }
+};
+
+template<typename MessageT>
+void ostream_yaml(std::ostream & out, const MessageT & msg, size_t indent)
+{
+  OstreamVisitor<MessageT> visitor{out, msg, indent};
+  format::detail::for_each_member<MessageT>(visitor);
+}
+
+// Prefer the generated to_yaml(msg) when it exists.
+template<typename MessageT>
+auto traits_yaml(const MessageT & msg, int) -> decltype(to_yaml(msg))
+{
+  return to_yaml(msg);
+}
+
+template<typename MessageT>
+std::string traits_yaml(const MessageT & msg, long)  // NOLINT(runtime/int)
+{
+  std::ostringstream out;
+  ostream_yaml(out, msg, 0);
+  return out.str();
+}
+
+template<typename MessageT>
+void run(const char * name, const MessageT & msg)
+{
+  std::array<char, 4096> storage;
+  format::Buffer buffer(storage);
+
+  size_t traits_bytes = 0;
+  const double traits_ns = benchmark_utils::ns_per_op(
+    [&]() {
+      const std::string yaml = traits_yaml(msg, 0);
+      traits_bytes = yaml.size();
+      benchmark_utils::do_not_optimize(yaml);
+    }, kIterations);
+
+  const double yaml_ns = benchmark_utils::ns_per_op(
+    [&]() {
+      buffer.clear();
+      format::write_yaml(buffer, msg);
+      benchmark_utils::do_not_optimize(storage);
+    }, kIterations);
+  const size_t yaml_bytes = buffer.size();
+
+  const double binary_ns = benchmark_utils::ns_per_op(
+    [&]() {
+      buffer.clear();
+      format::write_binary(buffer, msg);
+      benchmark_utils::do_not_optimize(storage);
+    }, kIterations);
+  const size_t binary_bytes = buffer.size();
+
+  std::printf(
+    "%s,%zu,%.1f,%zu,%.1f,%zu,%.1f\n",
+    name, traits_bytes, traits_ns, yaml_bytes, yaml_ns, binary_bytes, binary_ns);
+}
+
+}  // namespace
+
+int main()
+{
+  std::printf("type,traits_bytes,traits_ns,yaml_bytes,yaml_ns,binary_bytes,binary_ns\n");
+
+  custom_interfaces::msg::Aula7 aula7;
+  aula7.count = 42;
+  aula7.message = "The count is: ";
+  run("msg/Aula7", aula7);
+
+  custom_interfaces::msg::ScanSectors scan_sectors;
+  scan_sectors.header.frame_id = "lidar_link";
+  scan_sectors.angle_min = -3.14159f;
+  scan_sectors.sector_width = 2.0944f;
+  scan_sectors.min_range = {0.8f, 0.45f, 1.2f};
+  scan_sectors.mean_range = {2.1f, 1.3f, 2.7f};
+  scan_sectors.argmin = {120, 361, 600};
+  scan_sectors.valid_count = {240, 240, 240};
+  run("msg/ScanSectors", scan_sectors);
+
+  custom_interfaces::srv::Aula8::Request aula8_request;
+  aula8_request.a = 40;
+  aula8_request.b = 2;
+  run("srv/Aula8_Request", aula8_request);
+
+  custom_interfaces::action::Aula9::Feedback aula9_feedback;
+  aula9_feedback.current_number = 3;
+  run("action/Aula9_Feedback", aula9_feedback);
+
+  custom_interfaces::action::Rotate::Feedback rotate_feedback;
+  rotate_feedback.remaining_degrees = 45.0f;
+  run("action/Rotate_Feedback", rotate_feedback);
+
+  return 0;
+}
@@ -0,0 +1,132 @@
+#ifndef INTROSPECTION_CDR_HPP_
+#define INTROSPECTION_CDR_HPP_
+
+#include <cstdint>
+#include <string>
+
+#include "fastcdr/Cdr.h"
+#include "rosidl_typesupport_introspection_cpp/field_types.hpp"
+#include "rosidl_typesupport_introspection_cpp/message_introspection.hpp"
+
+// CDR (de)serialization driven by the introspection typesupport, the way
+// rmw implementations without generated serializers (e.g. Cyclone DDS) walk
+// a message. Used to compare against the generated fastrtps code.
+namespace introspection_cdr
+{
+
+namespace its = rosidl_typesupport_introspection_cpp;
+
+bool serialize(const void * msg, const its::MessageMembers * members, eprosima::fastcdr::Cdr & cdr);
+bool deserialize(eprosima::fastcdr::Cdr & cdr, void * msg, const its::MessageMembers * members);
+
+inline const its::MessageMembers * nested_members(const its::MessageMember & member)
+{
+  return static_cast<const its::MessageMembers *>(member.members_->data);
+}
+
+inline bool serialize_value(
+  const void * value, const its::MessageMember & member, eprosima::fastcdr::Cdr & cdr)
+{
+  switch (member.type_id_) {
+    case its::ROS_TYPE_FLOAT: cdr << *static_cast<const float *>(value); return true;
+    case its::ROS_TYPE_DOUBLE: cdr << *static_cast<const double *>(value); return true;
+    case its::ROS_TYPE_LONG_DOUBLE: cdr << *static_cast<const long double *>(value); return true;
+    case its::ROS_TYPE_BOOLEAN: cdr << *static_cast<const bool *>(value); return true;
+    case its::ROS_TYPE_CHAR:
+    case its::ROS_TYPE_OCTET:
+    case its::ROS_TYPE_UINT8: cdr << *static_cast<const uint8_t *>(value); return true;
+    case its::ROS_TYPE_INT8: cdr << *static_cast<const int8_t *>(value); return true;
+    case its::ROS_TYPE_UINT16: cdr << *static_cast<const uint16_t *>(value); return true;
+    case its::ROS_TYPE_INT16: cdr << *static_cast<const int16_t *>(value); return true;
+    case its::ROS_TYPE_UINT32: cdr << *static_cast<const uint32_t *>(value); return true;
+    case its::ROS_TYPE_INT32: cdr << *static_cast<const int32_t *>(value); return true;
+    case its::ROS_TYPE_UINT64: cdr << *static_cast<const uint64_t *>(value); return true;
+    case its::ROS_TYPE_INT64: cdr << *static_cast<const int64_t *>(value); return true;
+    case its::ROS_TYPE_STRING: cdr << *static_cast<const std::string *>(value); return true;
+    case its::ROS_TYPE_MESSAGE: return serialize(value, nested_members(member), cdr);
+    default: return false;
+  }
+}
+
+inline bool deserialize_value(
+  eprosima::fastcdr::Cdr & cdr, void * value, const its::MessageMember & member)
+{
+  switch (member.type_id_) {
+    case its::ROS_TYPE_FLOAT: cdr >> *static_cast<float *>(value); return true;
+    case its::ROS_TYPE_DOUBLE: cdr >> *static_cast<double *>(value); return true;
+    case its::ROS_TYPE_LONG_DOUBLE: cdr >> *static_cast<long double *>(value); return true;
+    case its::ROS_TYPE_BOOLEAN: cdr >> *static_cast<bool *>(value); return true;
+    case its::ROS_TYPE_CHAR:
+    case its::ROS_TYPE_OCTET:
+    case its::ROS_TYPE_UINT8: cdr >> *static_cast<uint8_t *>(value); return true;
+    case its::ROS_TYPE_INT8: cdr >> *static_cast<int8_t *>(value); return true;
+    case its::ROS_TYPE_UINT16: cdr >> *static_cast<uint16_t *>(value); return true;
+    case its::ROS_TYPE_INT16: cdr >> *static_cast<int16_t *>(value); return true;
+    case its::ROS_TYPE_UINT32: cdr >> *static_cast<uint32_t *>(value); return true;
+    case its::ROS_TYPE_INT32: cdr >> *static_cast<int32_t *>(value); return true;
+    case its::ROS_TYPE_UINT64: cdr >> *static_cast<uint64_t *>(value); return true;
+    case its::ROS_TYPE_INT64: cdr >> *static_cast<int64_t *>(value); return true;
+    case its::ROS_TYPE_STRING: cdr >> *static_cast<std::string *>(value); return true;
+    case its::ROS_TYPE_MESSAGE: return deserialize(cdr, value, nested_members(member));
+    default: return false;
+  }
+}
+
+inline bool serialize(
+  const void * msg, const its::MessageMembers * members, eprosima::fastcdr::Cdr & cdr)
+{
+  const char * base = static_cast<const char *>(msg);
+  for (uint32_t i = 0; i < members->member_count_; ++i) {
+    const its::MessageMember & member = members->members_[i];
+    const void * field = base + member.offset_;
+    if (!member.is_array_) {
+      if (!serialize_value(field, member, cdr)) {
+        return false;
+      }
+      continue;
+    }
+    const size_t count = member.size_function(field);
+    if (member.array_size_ == 0 || member.is_upper_bound_) {
+      cdr << static_cast<uint32_t>(count);
+    }
+    for (size_t j = 0; j < count; ++j) {
+      if (!serialize_value(member.get_const_function(field, j), member, cdr)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+inline bool deserialize(
+  eprosima::fastcdr::Cdr & cdr, void * msg, const its::MessageMembers * members)
+{
+  char * base = static_cast<char *>(msg);
+  for (uint32_t i = 0; i < members->member_count_; ++i) {
+    const its::MessageMember & member = members->members_[i];
+    void * field = base + member.offset_;
+    if (!member.is_array_) {
+      if (!deserialize_value(cdr, field, member)) {
+        return false;
+      }
+      continue;
+    }
+    size_t count = member.array_size_;
+    if (member.array_size_ == 0 || member.is_upper_bound_) {
+      uint32_t length = 0;
+      cdr >> length;
+      count = length;
+      member.resize_function(field, count);
+    }
+    for (size_t j = 0; j < count; ++j) {
+      if (!deserialize_value(cdr, member.get_function(field, j), member)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace introspection_cdr
+
+#endif  // INTROSPECTION_CDR_HPP_
@@ -0,0 +1,192 @@
+// Serialization cost of every custom_interfaces type, through the generated
+// fastrtps typesupport and through an introspection-driven serializer.
+// Prints one CSV row per type; times are ns/op and sizes are bytes/op of CDR
+// payload (without the 4-byte encapsulation header).
+
+#include <cstdio>
+#include <vector>
+
+#include "fastcdr/Cdr.h"
+#include "fastcdr/FastBuffer.h"
+#include "rosidl_typesupport_fastrtps_cpp/message_type_support.h"
+#include "rosidl_typesupport_fastrtps_cpp/message_type_support_decl.hpp"
+#include "rosidl_typesupport_introspection_cpp/message_introspection.hpp"
+#include "rosidl_typesupport_introspection_cpp/message_type_support_decl.hpp"
+
+#include "custom_interfaces/action/aula9.hpp"
+#include "custom_interfaces/action/rotate.hpp"
+#include "custom_interfaces/msg/aula7.hpp"
+#include "custom_interfaces/msg/aula7_fixed.hpp"
+#include "custom_interfaces/msg/scan_sectors.hpp"
+#include "custom_interfaces/msg/temperature.hpp"
+#include "custom_interfaces/srv/add_many.hpp"
+#include "custom_interfaces/srv/aula8.hpp"
+#include "custom_interfaces/srv/celsius_to_fahrenheit.hpp"
+
+#include "benchmark_utils.hpp"
+#include "introspection_cdr.hpp"
+
+namespace
+{
+
+constexpr size_t kIterations = 1000000;
+
+using eprosima::fastcdr::Cdr;
+using eprosima::fastcdr::FastBuffer;
+
+template<typename MessageT>
+void run(const char * name, const MessageT & msg)
+{
+  const auto * fastrtps = static_cast<const message_type_support_callbacks_t *>(
+    rosidl_typesupport_fastrtps_cpp::get_message_type_support_handle<MessageT>()->data);
+  const auto * members = static_cast<const rosidl_typesupport_introspection_cpp::MessageMembers *>(
+    rosidl_typesupport_introspection_cpp::get_message_type_support_handle<MessageT>()->data);
+
+  std::vector<char> bytes(4096);
+  FastBuffer buffer(bytes.data(), bytes.size());
+  Cdr cdr(buffer, Cdr::DEFAULT_ENDIAN, Cdr::DDS_CDR);
+  MessageT decoded;
+
+  const double serialize_ns = benchmark_utils::ns_per_op(
+    [&]() {
+      cdr.reset();
+      cdr.serialize_encapsulation();
+      fastrtps->cdr_serialize(&msg, cdr);
+      benchmark_utils::do_not_optimize(bytes[4]);
+    }, kIterations);
+  const size_t payload = cdr.getSerializedDataLength() - 4;
+
+  const double deserialize_ns = benchmark_utils::ns_per_op(
+    [&]() {
+      cdr.reset();
+      cdr.read_encapsulation();
+      fastrtps->cdr_deserialize(cdr, &decoded);
+      benchmark_utils::do_not_optimize(decoded);
+    }, kIterations);
+
+  const double size_ns = benchmark_utils::ns_per_op(
+    [&]() {
+      uint32_t size = fastrtps->get_serialized_size(&msg);
+      benchmark_utils::do_not_optimize(size);
+    }, kIterations);
+
+  bool full_bounded = true;
+  size_t max_size = 0;
+  const double max_size_ns = benchmark_utils::ns_per_op(
+    [&]() {
+      full_bounded = true;
+      max_size = fastrtps->max_serialized_size(full_bounded);
+      benchmark_utils::do_not_optimize(max_size);
+    }, kIterations);
+
+  const double introspection_serialize_ns = benchmark_utils::ns_per_op(
+    [&]() {
+      cdr.reset();
+      cdr.serialize_encapsulation();
+      introspection_cdr::serialize(&msg, members, cdr);
+      benchmark_utils::do_not_optimize(bytes[4]);
+    }, kIterations);
+  const size_t introspection_payload = cdr.getSerializedDataLength() - 4;
+
+  const double introspection_deserialize_ns = benchmark_utils::ns_per_op(
+    [&]() {
+      cdr.reset();
+      cdr.read_encapsulation();
+      introspection_cdr::deserialize(cdr, &decoded, members);
+      benchmark_utils::do_not_optimize(decoded);
+    }, kIterations);
+
+  std::printf(
+    "%s,%zu,%zu,%s,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%s\n",
+    name, payload, max_size, full_bounded ? "yes" : "no",
+    serialize_ns, deserialize_ns, size_ns, max_size_ns,
+    introspection_serialize_ns, introspection_deserialize_ns,
+    (introspection_payload == payload && decoded == msg) ? "ok" : "MISMATCH");
+}
+
+}  // namespace
+
+int main()
+{
+  std::printf(
+    "type,bytes,max_bytes,bounded,"
+    "fastrtps_serialize_ns,fastrtps_deserialize_ns,"
+    "get_serialized_size_ns,max_serialized_size_ns,"
+    "introspection_serialize_ns,introspection_deserialize_ns,check\n");
+
+  custom_interfaces::msg::Aula7 aula7;
+  aula7.count = 42;
+  aula7.message = "The count is: ";
+  run("msg/Aula7", aula7);
+
+  custom_interfaces::msg::Aula7Fixed aula7_fixed;
+  aula7_fixed.count = 42;
+  aula7_fixed.message_length = 14;
+  run("msg/Aula7Fixed", aula7_fixed);
+
+  custom_interfaces::msg::ScanSectors scan_sectors;
+  scan_sectors.header.frame_id = "lidar_link";
+  scan_sectors.angle_min = -3.14159f;
+  scan_sectors.sector_width = 2.0944f;
+  scan_sectors.min_range = {0.8f, 0.45f, 1.2f};
+  scan_sectors.mean_range = {2.1f, 1.3f, 2.7f};
+  scan_sectors.argmin = {120, 361, 600};
+  scan_sectors.valid_count = {240, 240, 240};
+  run("msg/ScanSectors", scan_sectors);
+
+  custom_interfaces::msg::Temperature temperature;
+  temperature.temperature = 36.5f;
+  run("msg/Temperature", temperature);
+
+  custom_interfaces::srv::Aula8::Request aula8_request;
+  aula8_request.a = 40;
+  aula8_request.b = 2;
+  run("srv/Aula8_Request", aula8_request);
+
+  custom_interfaces::srv::Aula8::Response aula8_response;
+  aula8_response.sum = 42;
+  run("srv/Aula8_Response", aula8_response);
+
+  custom_interfaces::srv::AddMany::Request add_many_request;
+  add_many_request.a.assign(1000, 40);
+  add_many_request.b.assign(1000, 2);
+  run("srv/AddMany_Request", add_many_request);
+
+  custom_interfaces::srv::AddMany::Response add_many_response;
+  add_many_response.sum.assign(1000, 42);
+  run("srv/AddMany_Response", add_many_response);
+
+  custom_interfaces::srv::CelsiusToFahrenheit::Request c2f_request;
+  c2f_request.celsius = 100.0f;
+  run("srv/CelsiusToFahrenheit_Request", c2f_request);
+
+  custom_interfaces::srv::CelsiusToFahrenheit::Response c2f_response;
+  c2f_response.fahrenheit = 212.0f;
+  run("srv/CelsiusToFahrenheit_Response", c2f_response);
+
+  custom_interfaces::action::Aula9::Goal aula9_goal;
+  aula9_goal.count_up_to = 10;
+  run("action/Aula9_Goal", aula9_goal);
+
+  custom_interfaces::action::Aula9::Result aula9_result;
+  aula9_result.final_count = 10;
+  run("action/Aula9_Result", aula9_result);
+
+  custom_interfaces::action::Aula9::Feedback aula9_feedback;
+  aula9_feedback.current_number = 3;
+  run("action/Aula9_Feedback", aula9_feedback);
+
+  custom_interfaces::action::Rotate::Goal rotate_goal;
+  rotate_goal.angle = 90.0f;
+  run("action/Rotate_Goal", rotate_goal);
+
+  custom_interfaces::action::Rotate::Result rotate_result;
+  rotate_result.success = true;
+  run("action/Rotate_Result", rotate_result);
+
+  custom_interfaces::action::Rotate::Feedback rotate_feedback;
+  rotate_feedback.remaining_degrees = 45.0f;
+  run("action/Rotate_Feedback", rotate_feedback);
+
+  return 0;
+}
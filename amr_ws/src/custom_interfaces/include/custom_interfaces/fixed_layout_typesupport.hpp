@@ -0,0 +1,230 @@
+#ifndef CUSTOM_INTERFACES__FIXED_LAYOUT_TYPESUPPORT_HPP_
+#define CUSTOM_INTERFACES__FIXED_LAYOUT_TYPESUPPORT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "fastcdr/Cdr.h"
+#include "rosidl_runtime_c/message_type_support_struct.h"
+#include "rosidl_typesupport_fastrtps_cpp/message_type_support.h"
+#include "rosidl_typesupport_fastrtps_cpp/message_type_support_decl.hpp"
+#include "rosidl_typesupport_introspection_cpp/field_types.hpp"
+#include "rosidl_typesupport_introspection_cpp/message_introspection.hpp"
+#include "rosidl_typesupport_introspection_cpp/message_type_support_decl.hpp"
+
+namespace custom_interfaces
+{
+
+// Where a message's CDR encoding matches its in-memory C++ layout byte for
+// byte, and how many bytes that encoding takes.
+struct FixedLayout
+{
+  bool eligible;
+  size_t cdr_size;
+  size_t alignment;
+};
+
+// Walks the introspection data of a message and decides whether it can be
+// serialized with one memcpy. That holds when every member is a primitive (or
+// a fixed-size array of primitives) whose C++ offset equals its CDR offset.
+// Strings, sequences and nested messages are rejected conservatively.
+inline FixedLayout inspect_fixed_layout(
+  const rosidl_typesupport_introspection_cpp::MessageMembers * members)
+{
+  namespace its = rosidl_typesupport_introspection_cpp;
+  FixedLayout layout{false, 0, 1};
+  if (members == nullptr || members->member_count_ == 0) {
+    return layout;
+  }
+  size_t offset = 0;
+  for (uint32_t i = 0; i < members->member_count_; ++i) {
+    const its::MessageMember & member = members->members_[i];
+    size_t size = 0;
+    switch (member.type_id_) {
+      case its::ROS_TYPE_BOOLEAN:
+      case its::ROS_TYPE_OCTET:
+      case its::ROS_TYPE_CHAR:
+      case its::ROS_TYPE_UINT8:
+      case its::ROS_TYPE_INT8:
+        size = 1;
+        break;
+      case its::ROS_TYPE_UINT16:
+      case its::ROS_TYPE_INT16:
+        size = 2;
+        break;
+      case its::ROS_TYPE_FLOAT:
+      case its::ROS_TYPE_UINT32:
+      case its::ROS_TYPE_INT32:
+        size = 4;
+        break;
+      case its::ROS_TYPE_DOUBLE:
+      case its::ROS_TYPE_UINT64:
+      case its::ROS_TYPE_INT64:
+        size = 8;
+        break;
+      default:
+        return layout;
+    }
+    size_t count = 1;
+    if (member.is_array_) {
+      if (member.is_upper_bound_ || member.array_size_ == 0) {
+        return layout;
+      }
+      count = member.array_size_;
+    }
+    offset = (offset + size - 1) & ~(size - 1);
+    if (offset != member.offset_) {
+      return layout;
+    }
+    offset += size * count;
+    if (size > layout.alignment) {
+      layout.alignment = size;
+    }
+  }
+  layout.eligible = true;
+  layout.cdr_size = offset;
+  return layout;
+}
+
+// Drop-in alternative to the generated rosidl_typesupport_fastrtps_cpp code.
+// Fixed-layout messages are written as one aligned array copy (plus a byte
+// tail when the size is not a multiple of the alignment); every other message,
+// and any stream whose endianness differs from the host, falls back to the
+// generated per-field serializer.
+template<typename MessageT>
+class FixedLayoutTypeSupport
+{
+public:
+  using Callbacks = message_type_support_callbacks_t;
+
+  static const FixedLayout & layout()
+  {
+    static const FixedLayout value = inspect_fixed_layout(
+      static_cast<const rosidl_typesupport_introspection_cpp::MessageMembers *>(
+        rosidl_typesupport_introspection_cpp::get_message_type_support_handle<MessageT>()->data));
+    return value;
+  }
+
+  static bool is_fixed_layout()
+  {
+    return layout().eligible;
+  }
+
+  static bool cdr_serialize(const MessageT & msg, eprosima::fastcdr::Cdr & cdr)
+  {
+    const FixedLayout & fixed = layout();
+    if (!fixed.eligible || cdr.endianness() != eprosima::fastcdr::Cdr::DEFAULT_ENDIAN) {
+      return stock().cdr_serialize(&msg, cdr);
+    }
+    const char * bytes = reinterpret_cast<const char *>(&msg);
+    const size_t words = fixed.cdr_size / fixed.alignment;
+    const size_t head = words * fixed.alignment;
+    switch (fixed.alignment) {
+      case 8:
+        cdr.serializeArray(reinterpret_cast<const uint64_t *>(bytes), words);
+        break;
+      case 4:
+        cdr.serializeArray(reinterpret_cast<const uint32_t *>(bytes), words);
+        break;
+      case 2:
+        cdr.serializeArray(reinterpret_cast<const uint16_t *>(bytes), words);
+        break;
+      default:
+        cdr.serializeArray(bytes, words);
+        break;
+    }
+    if (head < fixed.cdr_size) {
+      cdr.serializeArray(bytes + head, fixed.cdr_size - head);
+    }
+    return true;
+  }
+
+  static bool cdr_deserialize(eprosima::fastcdr::Cdr & cdr, MessageT & msg)
+  {
+    const FixedLayout & fixed = layout();
+    if (!fixed.eligible || cdr.endianness() != eprosima::fastcdr::Cdr::DEFAULT_ENDIAN) {
+      return stock().cdr_deserialize(cdr, &msg);
+    }
+    char * bytes = reinterpret_cast<char *>(&msg);
+    const size_t words = fixed.cdr_size / fixed.alignment;
+    const size_t head = words * fixed.alignment;
+    switch (fixed.alignment) {
+      case 8:
+        cdr.deserializeArray(reinterpret_cast<uint64_t *>(bytes), words);
+        break;
+      case 4:
+        cdr.deserializeArray(reinterpret_cast<uint32_t *>(bytes), words);
+        break;
+      case 2:
+        cdr.deserializeArray(reinterpret_cast<uint16_t *>(bytes), words);
+        break;
+      default:
+        cdr.deserializeArray(bytes, words);
+        break;
+    }
+    if (head < fixed.cdr_size) {
+      cdr.deserializeArray(bytes + head, fixed.cdr_size - head);
+    }
+    return true;
+  }
+
+  static uint32_t get_serialized_size(const MessageT & msg)
+  {
+    const FixedLayout & fixed = layout();
+    if (!fixed.eligible) {
+      return stock().get_serialized_size(&msg);
+    }
+    return static_cast<uint32_t>(fixed.cdr_size);
+  }
+
+  // Type support handle that rmw_fastrtps_cpp accepts in place of the
+  // generated one. Use one or the other for a given type within a process,
+  // since the middleware registers types by name.
+  static const rosidl_message_type_support_t * get_type_support_handle()
+  {
+    static const Callbacks callbacks = {
+      stock().message_namespace_,
+      stock().message_name_,
+      &FixedLayoutTypeSupport::serialize_untyped,
+      &FixedLayoutTypeSupport::deserialize_untyped,
+      &FixedLayoutTypeSupport::get_serialized_size_untyped,
+      stock().max_serialized_size,
+    };
+    static const rosidl_message_type_support_t handle = {
+      stock_handle()->typesupport_identifier,
+      &callbacks,
+      stock_handle()->func,
+    };
+    return &handle;
+  }
+
+  static const Callbacks & stock()
+  {
+    return *static_cast<const Callbacks *>(stock_handle()->data);
+  }
+
+private:
+  static const rosidl_message_type_support_t * stock_handle()
+  {
+    return rosidl_typesupport_fastrtps_cpp::get_message_type_support_handle<MessageT>();
+  }
+
+  static bool serialize_untyped(const void * msg, eprosima::fastcdr::Cdr & cdr)
+  {
+    return cdr_serialize(*static_cast<const MessageT *>(msg), cdr);
+  }
+
+  static bool deserialize_untyped(eprosima::fastcdr::Cdr & cdr, void * msg)
+  {
+    return cdr_deserialize(cdr, *static_cast<MessageT *>(msg));
+  }
+
+  static uint32_t get_serialized_size_untyped(const void * msg)
+  {
+    return get_serialized_size(*static_cast<const MessageT *>(msg));
+  }
+};
+
+}  // namespace custom_interfaces
+
+#endif  // CUSTOM_INTERFACES__FIXED_LAYOUT_TYPESUPPORT_HPP_
@@ -0,0 +1,259 @@
+#ifndef CUSTOM_INTERFACES__MESSAGE_CDR_HPP_
+#define CUSTOM_INTERFACES__MESSAGE_CDR_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "fastcdr/Cdr.h"
+#include "fastcdr/FastBuffer.h"
+#include "fastcdr/exceptions/Exception.h"
+
+#include "custom_interfaces/message_formatter.hpp"
+
+// CDR encoding of the messages that have a Fields<> list, for any
+// ContainerAllocator. The generated typesupport only handles the
+// std::allocator instantiation; these functions produce and accept the same
+// bytes (the serialized form rmw publishes and takes, encapsulation header
+// included), so a message built with another allocator can go through
+// rclcpp's serialized publish and subscription.
+namespace custom_interfaces
+{
+namespace format
+{
+namespace detail
+{
+
+using eprosima::fastcdr::Cdr;
+
+// Primitives
+template<typename T>
+typename std::enable_if<std::is_arithmetic<T>::value>::type
+cdr_write(Cdr & cdr, const T & value) {cdr.serialize(value);}
+
+template<typename T>
+typename std::enable_if<std::is_arithmetic<T>::value>::type
+cdr_read(Cdr & cdr, T & value, size_t) {cdr.deserialize(value);}
+
+// Strings: u32 length including the terminating NUL, then the characters.
+template<typename CharAllocator>
+void cdr_write(
+  Cdr & cdr, const std::basic_string<char, std::char_traits<char>, CharAllocator> & value)
+{
+  cdr.serialize(static_cast<uint32_t>(value.size() + 1));
+  cdr.serializeArray(value.data(), value.size());
+  cdr.serialize('\0');
+}
+
+template<typename CharAllocator>
+void cdr_read(
+  Cdr & cdr, std::basic_string<char, std::char_traits<char>, CharAllocator> & value, size_t limit)
+{
+  uint32_t length;
+  cdr.deserialize(length);
+  if (length > limit) {
+    throw eprosima::fastcdr::exception::NotEnoughMemoryException("string longer than the data");
+  }
+  value.resize(length == 0 ? 0 : length - 1);
+  cdr.deserializeArray(&value[0], value.size());
+  if (length != 0) {
+    char terminator;
+    cdr.deserialize(terminator);
+  }
+}
+
+// Nested messages
+template<typename MessageT>
+typename std::enable_if<is_formattable_message<MessageT>::value>::type
+cdr_write(Cdr & cdr, const MessageT & msg);
+
+template<typename MessageT>
+typename std::enable_if<is_formattable_message<MessageT>::value>::type
+cdr_read(Cdr & cdr, MessageT & msg, size_t limit);
+
+// Fixed arrays have no length; sequences a u32 one. Sequences of numbers go
+// through fastcdr's array calls, which copy in one go when the byte order
+// matches.
+template<typename T>
+struct is_cdr_array_element
+  : std::integral_constant<bool, std::is_arithmetic<T>::value && !std::is_same<T, bool>::value> {};
+
+template<typename T, size_t N>
+void cdr_write(Cdr & cdr, const std::array<T, N> & values)
+{
+  for (const T & value : values) {
+    cdr_write(cdr, value);
+  }
+}
+
+template<typename T, size_t N>
+void cdr_read(Cdr & cdr, std::array<T, N> & values, size_t limit)
+{
+  for (T & value : values) {
+    cdr_read(cdr, value, limit);
+  }
+}
+
+template<typename T, typename Allocator>
+void cdr_write_elements(Cdr & cdr, const std::vector<T, Allocator> & values, std::true_type)
+{
+  cdr.serializeArray(values.data(), values.size());
+}
+
+template<typename T, typename Allocator>
+void cdr_write_elements(Cdr & cdr, const std::vector<T, Allocator> & values, std::false_type)
+{
+  for (const T & value : values) {
+    cdr_write(cdr, value);
+  }
+}
+
+template<typename T, typename Allocator>
+void cdr_read_elements(Cdr & cdr, std::vector<T, Allocator> & values, size_t, std::true_type)
+{
+  cdr.deserializeArray(values.data(), values.size());
+}
+
+template<typename T, typename Allocator>
+void cdr_read_elements(
+  Cdr & cdr, std::vector<T, Allocator> & values, size_t limit, std::false_type)
+{
+  for (T & value : values) {
+    cdr_read(cdr, value, limit);
+  }
+}
+
+template<typename T, typename Allocator>
+void cdr_write(Cdr & cdr, const std::vector<T, Allocator> & values)
+{
+  cdr.serialize(static_cast<uint32_t>(values.size()));
+  cdr_write_elements(cdr, values, is_cdr_array_element<T>{});
+}
+
+template<typename T, typename Allocator>
+void cdr_read(Cdr & cdr, std::vector<T, Allocator> & values, size_t limit)
+{
+  uint32_t count;
+  cdr.deserialize(count);
+  // Every element takes at least one byte, so a longer sequence can only
+  // come from corrupt data; refuse it before resizing.
+  if (count > limit) {
+    throw eprosima::fastcdr::exception::NotEnoughMemoryException("sequence longer than the data");
+  }
+  values.resize(count);
+  cdr_read_elements(cdr, values, limit, is_cdr_array_element<T>{});
+}
+
+template<typename Allocator>
+void cdr_write(Cdr & cdr, const std::vector<bool, Allocator> & values)
+{
+  cdr.serialize(static_cast<uint32_t>(values.size()));
+  for (bool value : values) {
+    cdr.serialize(value);
+  }
+}
+
+template<typename Allocator>
+void cdr_read(Cdr & cdr, std::vector<bool, Allocator> & values, size_t limit)
+{
+  uint32_t count;
+  cdr.deserialize(count);
+  if (count > limit) {
+    throw eprosima::fastcdr::exception::NotEnoughMemoryException("sequence longer than the data");
+  }
+  values.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    bool value;
+    cdr.deserialize(value);
+    values[i] = value;
+  }
+}
+
+template<typename MessageT>
+struct CdrWriteVisitor
+{
+  Cdr & cdr;
+  const MessageT & msg;
+
+  template<typename FieldT>
+  void operator()(const Member<MessageT, FieldT> & field)
+  {
+    cdr_write(cdr, msg.*(field.pointer));
+  }
+};
+
+template<typename MessageT>
+struct CdrReadVisitor
+{
+  Cdr & cdr;
+  MessageT & msg;
+  size_t limit;
+
+  template<typename FieldT>
+  void operator()(const Member<MessageT, FieldT> & field)
+  {
+    cdr_read(cdr, msg.*(field.pointer), limit);
+  }
+};
+
+template<typename MessageT>
+typename std::enable_if<is_formattable_message<MessageT>::value>::type
+cdr_write(Cdr & cdr, const MessageT & msg)
+{
+  CdrWriteVisitor<MessageT> visitor{cdr, msg};
+  for_each_member<MessageT>(visitor);
+}
+
+template<typename MessageT>
+typename std::enable_if<is_formattable_message<MessageT>::value>::type
+cdr_read(Cdr & cdr, MessageT & msg, size_t limit)
+{
+  CdrReadVisitor<MessageT> visitor{cdr, msg, limit};
+  for_each_member<MessageT>(visitor);
+}
+
+}  // namespace detail
+
+// Writes `msg` into `data` as rmw serializes it and returns the number of
+// bytes used, or 0 when `capacity` is too small.
+template<typename MessageT>
+size_t write_cdr(const MessageT & msg, uint8_t * data, size_t capacity)
+{
+  eprosima::fastcdr::FastBuffer buffer(reinterpret_cast<char *>(data), capacity);
+  eprosima::fastcdr::Cdr cdr(
+    buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::Cdr::DDS_CDR);
+  try {
+    cdr.serialize_encapsulation();
+    detail::cdr_write(cdr, msg);
+  } catch (const eprosima::fastcdr::exception::NotEnoughMemoryException &) {
+    return 0;
+  }
+  return cdr.getSerializedDataLength();
+}
+
+// Reads a serialized message of either byte order into `msg`, resizing its
+// strings and sequences with their own allocators. Returns false when the
+// data is truncated or malformed, leaving `msg` partially filled.
+template<typename MessageT>
+bool read_cdr(const uint8_t * data, size_t size, MessageT & msg)
+{
+  eprosima::fastcdr::FastBuffer buffer(
+    reinterpret_cast<char *>(const_cast<uint8_t *>(data)), size);
+  eprosima::fastcdr::Cdr cdr(
+    buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::Cdr::DDS_CDR);
+  try {
+    cdr.read_encapsulation();
+    detail::cdr_read(cdr, msg, size);
+  } catch (const eprosima::fastcdr::exception::Exception &) {
+    return false;
+  }
+  return true;
+}
+
+}  // namespace format
+}  // namespace custom_interfaces
+
+#endif  // CUSTOM_INTERFACES__MESSAGE_CDR_HPP_
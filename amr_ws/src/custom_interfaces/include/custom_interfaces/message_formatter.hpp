@@ -0,0 +1,515 @@
+#ifndef CUSTOM_INTERFACES__MESSAGE_FORMATTER_HPP_
+#define CUSTOM_INTERFACES__MESSAGE_FORMATTER_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "builtin_interfaces/msg/time.hpp"
+#include "geometry_msgs/msg/point.hpp"
+#include "geometry_msgs/msg/pose.hpp"
+#include "geometry_msgs/msg/quaternion.hpp"
+#include "geometry_msgs/msg/twist.hpp"
+#include "geometry_msgs/msg/vector3.hpp"
+#include "nav_msgs/msg/map_meta_data.hpp"
+#include "std_msgs/msg/header.hpp"
+
+#include "custom_interfaces/action/aula9.hpp"
+#include "custom_interfaces/action/rotate.hpp"
+#include "custom_interfaces/msg/aula7.hpp"
+#include "custom_interfaces/msg/aula7_fixed.hpp"
+#include "custom_interfaces/msg/goal_policy_metrics.hpp"
+#include "custom_interfaces/msg/latency_histogram.hpp"
+#include "custom_interfaces/msg/latency_stage.hpp"
+#include "custom_interfaces/msg/packed_occupancy_grid.hpp"
+#include "custom_interfaces/msg/scan_sectors.hpp"
+#include "custom_interfaces/msg/temperature.hpp"
+#include "custom_interfaces/msg/twist_mux_status.hpp"
+#include "custom_interfaces/srv/add_many.hpp"
+#include "custom_interfaces/srv/aula8.hpp"
+#include "custom_interfaces/srv/celsius_to_fahrenheit.hpp"
+
+// Formatting of custom_interfaces messages into a caller-provided buffer,
+// without std::ostream or heap allocation. The field list of every type is
+// declared once in a Fields<> specialization and expanded at compile time
+// into a YAML writer (same layout as the generated to_yaml) and a compact
+// binary dump (packed little-endian values whatever the host byte order, u32
+// length before strings and sequences). test_message_formatter checks every
+// field list against the introspection typesupport.
+namespace custom_interfaces
+{
+namespace format
+{
+
+// Fixed-capacity output. Writes past the capacity are dropped and reported
+// by truncated(); the contents are never NUL-terminated.
+class Buffer
+{
+public:
+  Buffer(char * data, size_t capacity)
+  : data_(data), capacity_(capacity), size_(0), truncated_(false) {}
+
+  template<size_t N>
+  explicit Buffer(std::array<char, N> & storage)
+  : Buffer(storage.data(), N) {}
+
+  void clear()
+  {
+    size_ = 0;
+    truncated_ = false;
+  }
+
+  void append(const char * bytes, size_t count)
+  {
+    if (count > capacity_ - size_) {
+      count = capacity_ - size_;
+      truncated_ = true;
+    }
+    std::memcpy(data_ + size_, bytes, count);
+    size_ += count;
+  }
+
+  void append(char c)
+  {
+    if (size_ == capacity_) {
+      truncated_ = true;
+      return;
+    }
+    data_[size_++] = c;
+  }
+
+  void append(const char * text)
+  {
+    append(text, std::strlen(text));
+  }
+
+  void append_indent(size_t indent)
+  {
+    for (size_t i = 0; i < indent; ++i) {
+      append(' ');
+    }
+  }
+
+  void append_uint(uint64_t value)
+  {
+    char digits[20];
+    size_t n = 0;
+    do {
+      digits[n++] = static_cast<char>('0' + value % 10);
+      value /= 10;
+    } while (value != 0);
+    while (n > 0) {
+      append(digits[--n]);
+    }
+  }
+
+  void append_int(int64_t value)
+  {
+    if (value < 0) {
+      append('-');
+      append_uint(0 - static_cast<uint64_t>(value));
+    } else {
+      append_uint(static_cast<uint64_t>(value));
+    }
+  }
+
+  void append_float(double value, int precision)
+  {
+    char text[32];
+    const int n = std::snprintf(text, sizeof(text), "%.*g", precision, value);
+    append(text, n > 0 ? static_cast<size_t>(n) : 0);
+  }
+
+  const char * data() const {return data_;}
+  size_t size() const {return size_;}
+  bool truncated() const {return truncated_;}
+
+private:
+  char * data_;
+  size_t capacity_;
+  size_t size_;
+  bool truncated_;
+};
+
+template<typename ClassT, typename FieldT>
+struct Member
+{
+  const char * name;
+  FieldT ClassT::* pointer;
+};
+
+template<typename ClassT, typename FieldT>
+constexpr Member<ClassT, FieldT> member(const char * name, FieldT ClassT::* pointer)
+{
+  return Member<ClassT, FieldT>{name, pointer};
+}
+
+// Specialized below for every supported message type.
+template<typename MessageT>
+struct Fields;
+
+template<typename T, typename = void>
+struct is_formattable_message : std::false_type {};
+
+template<typename T>
+struct is_formattable_message<T, decltype(void(Fields<T>::members()))>: std::true_type {};
+
+template<typename MessageT>
+void write_yaml(Buffer & out, const MessageT & msg, size_t indent = 0);
+template<typename MessageT>
+void write_binary(Buffer & out, const MessageT & msg);
+
+namespace detail
+{
+
+template<typename Tuple, typename Visitor, size_t ... I>
+void for_each_member(const Tuple & members, Visitor & visitor, std::index_sequence<I...>)
+{
+  (void)std::initializer_list<int>{(visitor(std::get<I>(members)), 0)...};
+}
+
+template<typename MessageT, typename Visitor>
+void for_each_member(Visitor & visitor)
+{
+  const auto members = Fields<MessageT>::members();
+  for_each_member(
+    members, visitor,
+    std::make_index_sequence<std::tuple_size<decltype(members)>::value>());
+}
+
+// YAML scalars
+inline void yaml_scalar(Buffer & out, bool value) {out.append(value ? "true" : "false");}
+inline void yaml_scalar(Buffer & out, float value) {out.append_float(value, 7);}
+inline void yaml_scalar(Buffer & out, double value) {out.append_float(value, 16);}
+
+template<typename T>
+typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+yaml_scalar(Buffer & out, T value) {out.append_int(value);}
+
+template<typename T>
+typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value &&
+  !std::is_same<T, bool>::value>::type
+yaml_scalar(Buffer & out, T value) {out.append_uint(value);}
+
+template<typename CharAllocator>
+void yaml_scalar(
+  Buffer & out, const std::basic_string<char, std::char_traits<char>, CharAllocator> & value)
+{
+  out.append('"');
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      out.append('\\');
+    }
+    out.append(c);
+  }
+  out.append('"');
+}
+
+// A field value: scalar on the same line, nested message on the next lines.
+template<typename T>
+typename std::enable_if<!is_formattable_message<T>::value>::type
+yaml_value(Buffer & out, const T & value, size_t)
+{
+  out.append(' ');
+  yaml_scalar(out, value);
+  out.append('\n');
+}
+
+template<typename T>
+typename std::enable_if<is_formattable_message<T>::value>::type
+yaml_value(Buffer & out, const T & value, size_t indent)
+{
+  out.append('\n');
+  write_yaml(out, value, indent + 2);
+}
+
+template<typename T>
+void yaml_sequence(Buffer & out, const T * values, size_t count, size_t indent)
+{
+  if (count == 0) {
+    out.append(" []\n");
+    return;
+  }
+  out.append('\n');
+  for (size_t i = 0; i < count; ++i) {
+    out.append_indent(indent);
+    out.append('-');
+    yaml_value(out, values[i], indent);
+  }
+}
+
+template<typename T>
+void yaml_field(Buffer & out, const T & value, size_t indent)
+{
+  yaml_value(out, value, indent);
+}
+
+template<typename T, size_t N>
+void yaml_field(Buffer & out, const std::array<T, N> & value, size_t indent)
+{
+  yaml_sequence(out, value.data(), N, indent);
+}
+
+template<typename T, typename Allocator>
+void yaml_field(Buffer & out, const std::vector<T, Allocator> & value, size_t indent)
+{
+  yaml_sequence(out, value.data(), value.size(), indent);
+}
+
+template<typename Allocator>
+void yaml_field(Buffer & out, const std::vector<bool, Allocator> & value, size_t indent)
+{
+  if (value.empty()) {
+    out.append(" []\n");
+    return;
+  }
+  out.append('\n');
+  for (bool element : value) {
+    out.append_indent(indent);
+    out.append("- ");
+    yaml_scalar(out, element);
+    out.append('\n');
+  }
+}
+
+template<typename MessageT>
+struct YamlVisitor
+{
+  Buffer & out;
+  const MessageT & msg;
+  size_t indent;
+
+  template<typename FieldT>
+  void operator()(const Member<MessageT, FieldT> & field)
+  {
+    out.append_indent(indent);
+    out.append(field.name);
+    out.append(':');
+    yaml_field(out, msg.*(field.pointer), indent);
+  }
+};
+
+// Binary values
+template<typename T>
+typename std::enable_if<std::is_arithmetic<T>::value>::type
+binary_field(Buffer & out, const T & value)
+{
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  std::reverse(bytes, bytes + sizeof(T));
+#endif
+  out.append(bytes, sizeof(T));
+}
+
+template<typename T>
+typename std::enable_if<is_formattable_message<T>::value>::type
+binary_field(Buffer & out, const T & value)
+{
+  write_binary(out, value);
+}
+
+inline void binary_length(Buffer & out, size_t length)
+{
+  binary_field(out, static_cast<uint32_t>(length));
+}
+
+template<typename CharAllocator>
+void binary_field(
+  Buffer & out, const std::basic_string<char, std::char_traits<char>, CharAllocator> & value)
+{
+  binary_length(out, value.size());
+  out.append(value.data(), value.size());
+}
+
+template<typename T, size_t N>
+void binary_field(Buffer & out, const std::array<T, N> & value)
+{
+  for (const T & element : value) {
+    binary_field(out, element);
+  }
+}
+
+template<typename T, typename Allocator>
+void binary_field(Buffer & out, const std::vector<T, Allocator> & value)
+{
+  binary_length(out, value.size());
+  for (const T & element : value) {
+    binary_field(out, element);
+  }
+}
+
+template<typename Allocator>
+void binary_field(Buffer & out, const std::vector<bool, Allocator> & value)
+{
+  binary_length(out, value.size());
+  for (bool element : value) {
+    binary_field(out, element);
+  }
+}
+
+template<typename MessageT>
+struct BinaryVisitor
+{
+  Buffer & out;
+  const MessageT & msg;
+
+  template<typename FieldT>
+  void operator()(const Member<MessageT, FieldT> & field)
+  {
+    binary_field(out, msg.*(field.pointer));
+  }
+};
+
+}  // namespace detail
+
+// Block-style YAML, one "name: value" line per field.
+template<typename MessageT>
+void write_yaml(Buffer & out, const MessageT & msg, size_t indent)
+{
+  detail::YamlVisitor<MessageT> visitor{out, msg, indent};
+  detail::for_each_member<MessageT>(visitor);
+}
+
+// Packed binary dump in declaration order.
+template<typename MessageT>
+void write_binary(Buffer & out, const MessageT & msg)
+{
+  detail::BinaryVisitor<MessageT> visitor{out, msg};
+  detail::for_each_member<MessageT>(visitor);
+}
+
+// Declared on the generated template (Time_, ScanSectors_, ...), so the list
+// also covers messages instantiated with another ContainerAllocator.
+#define CUSTOM_INTERFACES__FORMAT_FIELDS(TEMPLATE, ...) \
+  template<typename ContainerAllocator> \
+  struct Fields<TEMPLATE<ContainerAllocator>> \
+  { \
+    using T = TEMPLATE<ContainerAllocator>; \
+    static constexpr auto members() {return std::make_tuple(__VA_ARGS__);} \
+  }
+
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  builtin_interfaces::msg::Time_,
+  member("sec", &T::sec), member("nanosec", &T::nanosec));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  std_msgs::msg::Header_,
+  member("stamp", &T::stamp), member("frame_id", &T::frame_id));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  geometry_msgs::msg::Point_,
+  member("x", &T::x), member("y", &T::y), member("z", &T::z));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  geometry_msgs::msg::Quaternion_,
+  member("x", &T::x), member("y", &T::y), member("z", &T::z), member("w", &T::w));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  geometry_msgs::msg::Vector3_,
+  member("x", &T::x), member("y", &T::y), member("z", &T::z));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  geometry_msgs::msg::Twist_,
+  member("linear", &T::linear), member("angular", &T::angular));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  geometry_msgs::msg::Pose_,
+  member("position", &T::position), member("orientation", &T::orientation));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  nav_msgs::msg::MapMetaData_,
+  member("map_load_time", &T::map_load_time), member("resolution", &T::resolution),
+  member("width", &T::width), member("height", &T::height), member("origin", &T::origin));
+
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  custom_interfaces::msg::Aula7_,
+  member("count", &T::count), member("message", &T::message));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  custom_interfaces::msg::Aula7Fixed_,
+  member("count", &T::count), member("message_length", &T::message_length),
+  member("message", &T::message));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  custom_interfaces::msg::GoalPolicyMetrics_,
+  member("header", &T::header), member("action", &T::action), member("policy", &T::policy),
+  member("accepted", &T::accepted), member("rejected", &T::rejected),
+  member("preempted", &T::preempted), member("merged", &T::merged),
+  member("started", &T::started), member("queue_depth", &T::queue_depth),
+  member("queue_waits", &T::queue_waits), member("queue_wait_mean_s", &T::queue_wait_mean_s),
+  member("queue_wait_max_s", &T::queue_wait_max_s));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  custom_interfaces::msg::LatencyStage_,
+  member("name", &T::name), member("count", &T::count), member("p50_us", &T::p50_us),
+  member("p99_us", &T::p99_us), member("max_us", &T::max_us),
+  member("bucket_upper_us", &T::bucket_upper_us), member("bucket_count", &T::bucket_count));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  custom_interfaces::msg::LatencyHistogram_,
+  member("header", &T::header), member("node", &T::node), member("window_s", &T::window_s),
+  member("stages", &T::stages));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  custom_interfaces::msg::PackedOccupancyGrid_,
+  member("header", &T::header), member("info", &T::info), member("encoding", &T::encoding),
+  member("data", &T::data));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  custom_interfaces::msg::ScanSectors_,
+  member("header", &T::header), member("angle_min", &T::angle_min),
+  member("sector_width", &T::sector_width), member("min_range", &T::min_range),
+  member("mean_range", &T::mean_range), member("argmin", &T::argmin),
+  member("valid_count", &T::valid_count), member("forward_clearance", &T::forward_clearance));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  custom_interfaces::msg::Temperature_,
+  member("temperature", &T::temperature));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  custom_interfaces::msg::TwistMuxStatus_,
+  member("header", &T::header), member("active_input", &T::active_input),
+  member("input", &T::input), member("received", &T::received),
+  member("overwritten", &T::overwritten), member("stale", &T::stale),
+  member("selected", &T::selected), member("preempted", &T::preempted),
+  member("locked_out", &T::locked_out));
+
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  custom_interfaces::srv::Aula8_Request_,
+  member("a", &T::a), member("b", &T::b));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  custom_interfaces::srv::Aula8_Response_,
+  member("sum", &T::sum));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  custom_interfaces::srv::AddMany_Request_,
+  member("a", &T::a), member("b", &T::b));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  custom_interfaces::srv::AddMany_Response_,
+  member("sum", &T::sum));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  custom_interfaces::srv::CelsiusToFahrenheit_Request_,
+  member("celsius", &T::celsius));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  custom_interfaces::srv::CelsiusToFahrenheit_Response_,
+  member("fahrenheit", &T::fahrenheit));
+
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  custom_interfaces::action::Aula9_Goal_,
+  member("count_up_to", &T::count_up_to));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  custom_interfaces::action::Aula9_Result_,
+  member("final_count", &T::final_count));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  custom_interfaces::action::Aula9_Feedback_,
+  member("current_number", &T::current_number));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  custom_interfaces::action::Rotate_Goal_,
+  member("angle", &T::angle), member("scan_stamp_sec", &T::scan_stamp_sec),
+  member("scan_stamp_nanosec", &T::scan_stamp_nanosec));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  custom_interfaces::action::Rotate_Result_,
+  member("success", &T::success));
+CUSTOM_INTERFACES__FORMAT_FIELDS(
+  custom_interfaces::action::Rotate_Feedback_,
+  member("remaining_degrees", &T::remaining_degrees));
+
+#undef CUSTOM_INTERFACES__FORMAT_FIELDS
+
+}  // namespace format
+}  // namespace custom_interfaces
+
+#endif  // CUSTOM_INTERFACES__MESSAGE_FORMATTER_HPP_
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "fastcdr/Cdr.h"
+#include "fastcdr/FastBuffer.h"
+
+#include "custom_interfaces/action/rotate.hpp"
+#include "custom_interfaces/msg/aula7.hpp"
+#include "custom_interfaces/msg/aula7_fixed.hpp"
+#include "custom_interfaces/fixed_layout_typesupport.hpp"
+
+using custom_interfaces::FixedLayout;
+using custom_interfaces::FixedLayoutTypeSupport;
+
+namespace
+{
+
+using Callbacks = message_type_support_callbacks_t;
+
+template<typename MessageT>
+std::vector<char> serialize(const Callbacks & callbacks, const MessageT & msg)
+{
+  std::vector<char> storage(1024);
+  eprosima::fastcdr::FastBuffer buffer(storage.data(), storage.size());
+  eprosima::fastcdr::Cdr cdr(
+    buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::Cdr::DDS_CDR);
+  cdr.serialize_encapsulation();
+  EXPECT_TRUE(callbacks.cdr_serialize(&msg, cdr));
+  storage.resize(cdr.getSerializedDataLength());
+  return storage;
+}
+
+template<typename MessageT>
+const Callbacks & fast_callbacks()
+{
+  return *static_cast<const Callbacks *>(
+    FixedLayoutTypeSupport<MessageT>::get_type_support_handle()->data);
+}
+
+}  // namespace
+
+// The rotation goal is sent on every wall-follower turn; it must stay on the
+// memcpy path, which a nested message (e.g. builtin_interfaces/Time) would
+// take it off.
+TEST(FixedLayout, RotateGoalTakesTheFastPath)
+{
+  using Goal = custom_interfaces::action::Rotate::Goal;
+  ASSERT_TRUE(FixedLayoutTypeSupport<Goal>::is_fixed_layout());
+  const FixedLayout & layout = FixedLayoutTypeSupport<Goal>::layout();
+  EXPECT_EQ(layout.cdr_size, 12u);
+  EXPECT_EQ(layout.alignment, 4u);
+
+  Goal goal;
+  goal.angle = 90.0f;
+  goal.scan_stamp_sec = 1700000000;
+  goal.scan_stamp_nanosec = 123456789;
+  const std::vector<char> bytes = serialize(fast_callbacks<Goal>(), goal);
+  EXPECT_EQ(bytes, serialize(FixedLayoutTypeSupport<Goal>::stock(), goal));
+
+  eprosima::fastcdr::FastBuffer buffer(const_cast<char *>(bytes.data()), bytes.size());
+  eprosima::fastcdr::Cdr cdr(
+    buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::Cdr::DDS_CDR);
+  cdr.read_encapsulation();
+  Goal read;
+  ASSERT_TRUE(fast_callbacks<Goal>().cdr_deserialize(cdr, &read));
+  EXPECT_TRUE(read == goal);
+}
+
+TEST(FixedLayout, RejectsStringsAndNestedMessages)
+{
+  EXPECT_TRUE(FixedLayoutTypeSupport<custom_interfaces::msg::Aula7Fixed>::is_fixed_layout());
+  EXPECT_FALSE(FixedLayoutTypeSupport<custom_interfaces::msg::Aula7>::is_fixed_layout());
+  EXPECT_FALSE(
+    FixedLayoutTypeSupport<custom_interfaces::action::Rotate::FeedbackMessage>::is_fixed_layout());
+}
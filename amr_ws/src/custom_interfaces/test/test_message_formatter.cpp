@@ -0,0 +1,315 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "fastcdr/Cdr.h"
+#include "fastcdr/FastBuffer.h"
+#include "rosidl_typesupport_fastrtps_cpp/message_type_support.h"
+#include "rosidl_typesupport_fastrtps_cpp/message_type_support_decl.hpp"
+#include "rosidl_typesupport_introspection_cpp/field_types.hpp"
+#include "rosidl_typesupport_introspection_cpp/message_introspection.hpp"
+#include "rosidl_typesupport_introspection_cpp/message_type_support_decl.hpp"
+
+#include "custom_interfaces/message_cdr.hpp"
+#include "custom_interfaces/message_formatter.hpp"
+
+namespace format = custom_interfaces::format;
+namespace its = rosidl_typesupport_introspection_cpp;
+
+namespace
+{
+
+template<typename MessageT>
+std::string yaml(const MessageT & msg)
+{
+  std::array<char, 8192> storage;
+  format::Buffer buffer(storage);
+  format::write_yaml(buffer, msg);
+  EXPECT_FALSE(buffer.truncated());
+  return std::string(buffer.data(), buffer.size());
+}
+
+template<typename MessageT>
+std::vector<uint8_t> binary(const MessageT & msg)
+{
+  std::array<char, 8192> storage;
+  format::Buffer buffer(storage);
+  format::write_binary(buffer, msg);
+  return std::vector<uint8_t>(storage.data(), storage.data() + buffer.size());
+}
+
+// The bytes rmw_fastrtps_cpp publishes for `msg`, from the generated
+// typesupport.
+template<typename MessageT>
+std::vector<uint8_t> generated_cdr(const MessageT & msg)
+{
+  const auto * callbacks = static_cast<const message_type_support_callbacks_t *>(
+    rosidl_typesupport_fastrtps_cpp::get_message_type_support_handle<MessageT>()->data);
+  std::vector<char> storage(8192);
+  eprosima::fastcdr::FastBuffer buffer(storage.data(), storage.size());
+  eprosima::fastcdr::Cdr cdr(
+    buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::Cdr::DDS_CDR);
+  cdr.serialize_encapsulation();
+  EXPECT_TRUE(callbacks->cdr_serialize(&msg, cdr));
+  return std::vector<uint8_t>(storage.data(), storage.data() + cdr.getSerializedDataLength());
+}
+
+// The keys and nesting of a block-style YAML document: every line with its
+// value dropped, so "  sec: 3" becomes "  sec:" and "- 4" becomes "-".
+std::vector<std::string> skeleton(const std::string & text)
+{
+  std::vector<std::string> lines;
+  size_t begin = 0;
+  while (begin < text.size()) {
+    size_t end = text.find('\n', begin);
+    if (end == std::string::npos) {
+      end = text.size();
+    }
+    const std::string line = text.substr(begin, end - begin);
+    const size_t indent = line.find_first_not_of(' ');
+    if (indent != std::string::npos && line[indent] == '-') {
+      lines.push_back(line.substr(0, indent + 1));
+    } else {
+      lines.push_back(line.substr(0, line.find(':') + 1));
+    }
+    begin = end + 1;
+  }
+  return lines;
+}
+
+// The skeleton the generated to_yaml gives for `msg`, derived from the
+// introspection typesupport rather than from Fields<>.
+void introspection_skeleton(
+  const void * msg, const its::MessageMembers * members, size_t indent,
+  std::vector<std::string> & lines)
+{
+  const std::string pad(indent, ' ');
+  const char * base = static_cast<const char *>(msg);
+  for (uint32_t i = 0; i < members->member_count_; ++i) {
+    const its::MessageMember & member = members->members_[i];
+    const void * field = base + member.offset_;
+    lines.push_back(pad + member.name_ + ":");
+    const auto * nested = member.type_id_ == its::ROS_TYPE_MESSAGE ?
+      static_cast<const its::MessageMembers *>(member.members_->data) : nullptr;
+    if (!member.is_array_) {
+      if (nested) {
+        introspection_skeleton(field, nested, indent + 2, lines);
+      }
+      continue;
+    }
+    const size_t count = member.size_function ? member.size_function(field) : member.array_size_;
+    for (size_t j = 0; j < count; ++j) {
+      lines.push_back(pad + "-");
+      if (nested) {
+        introspection_skeleton(member.get_const_function(field, j), nested, indent + 2, lines);
+      }
+    }
+  }
+}
+
+template<typename MessageT>
+std::vector<std::string> introspection_skeleton(const MessageT & msg)
+{
+  const auto * members = static_cast<const its::MessageMembers *>(
+    its::get_message_type_support_handle<MessageT>()->data);
+  std::vector<std::string> lines;
+  introspection_skeleton(&msg, members, 0, lines);
+  return lines;
+}
+
+// The generated to_yaml(msg) when the installed rosidl provides it (Galactic
+// and newer), otherwise nothing to compare with.
+template<typename MessageT>
+auto traits_yaml(const MessageT & msg, int) -> decltype(to_yaml(msg))
+{
+  return to_yaml(msg);
+}
+
+template<typename MessageT>
+std::string traits_yaml(const MessageT &, long)  // NOLINT(runtime/int)
+{
+  return std::string();
+}
+
+// Default messages, with elements in the sequences of messages whose
+// sequences hold nested messages or strings.
+template<typename MessageT>
+MessageT sample()
+{
+  return MessageT();
+}
+
+template<>
+custom_interfaces::msg::LatencyHistogram sample<custom_interfaces::msg::LatencyHistogram>()
+{
+  custom_interfaces::msg::LatencyHistogram msg;
+  msg.stages.resize(2);
+  msg.stages[0].bucket_upper_us = {10.0, 20.0};
+  msg.stages[0].bucket_count = {3, 4};
+  return msg;
+}
+
+template<>
+custom_interfaces::msg::TwistMuxStatus sample<custom_interfaces::msg::TwistMuxStatus>()
+{
+  custom_interfaces::msg::TwistMuxStatus msg;
+  msg.input = {"teleop", "nav"};
+  msg.received = {1, 2};
+  return msg;
+}
+
+template<>
+custom_interfaces::msg::PackedOccupancyGrid
+sample<custom_interfaces::msg::PackedOccupancyGrid>()
+{
+  custom_interfaces::msg::PackedOccupancyGrid msg;
+  msg.info.width = 3;
+  msg.info.height = 1;
+  msg.data = {0x24};
+  return msg;
+}
+
+template<typename MessageT>
+class FieldListTest : public ::testing::Test {};
+
+using AllTypes = ::testing::Types<
+  builtin_interfaces::msg::Time,
+  std_msgs::msg::Header,
+  geometry_msgs::msg::Point,
+  geometry_msgs::msg::Quaternion,
+  geometry_msgs::msg::Vector3,
+  geometry_msgs::msg::Twist,
+  geometry_msgs::msg::Pose,
+  nav_msgs::msg::MapMetaData,
+  custom_interfaces::msg::Aula7,
+  custom_interfaces::msg::Aula7Fixed,
+  custom_interfaces::msg::GoalPolicyMetrics,
+  custom_interfaces::msg::LatencyStage,
+  custom_interfaces::msg::LatencyHistogram,
+  custom_interfaces::msg::PackedOccupancyGrid,
+  custom_interfaces::msg::ScanSectors,
+  custom_interfaces::msg::Temperature,
+  custom_interfaces::msg::TwistMuxStatus,
+  custom_interfaces::srv::Aula8::Request,
+  custom_interfaces::srv::Aula8::Response,
+  custom_interfaces::srv::AddMany::Request,
+  custom_interfaces::srv::AddMany::Response,
+  custom_interfaces::srv::CelsiusToFahrenheit::Request,
+  custom_interfaces::srv::CelsiusToFahrenheit::Response,
+  custom_interfaces::action::Aula9::Goal,
+  custom_interfaces::action::Aula9::Result,
+  custom_interfaces::action::Aula9::Feedback,
+  custom_interfaces::action::Rotate::Goal,
+  custom_interfaces::action::Rotate::Result,
+  custom_interfaces::action::Rotate::Feedback>;
+TYPED_TEST_CASE(FieldListTest, AllTypes);
+
+}  // namespace
+
+// Fields<> is written by hand; a field that is missing, renamed or out of
+// order shows up as a skeleton mismatch.
+TYPED_TEST(FieldListTest, MatchesIntrospection)
+{
+  const TypeParam msg = sample<TypeParam>();
+  EXPECT_EQ(skeleton(yaml(msg)), introspection_skeleton(msg));
+}
+
+TYPED_TEST(FieldListTest, MatchesGeneratedToYaml)
+{
+  const TypeParam msg = sample<TypeParam>();
+  const std::string generated = traits_yaml(msg, 0);
+  if (!generated.empty()) {
+    EXPECT_EQ(skeleton(yaml(msg)), skeleton(generated));
+  }
+}
+
+// write_cdr must produce what the generated typesupport publishes, and
+// read_cdr must take it back, or arena messages would not interoperate with
+// ordinary publishers and subscribers.
+TYPED_TEST(FieldListTest, CdrMatchesGeneratedTypeSupport)
+{
+  const TypeParam msg = sample<TypeParam>();
+  const std::vector<uint8_t> expected = generated_cdr(msg);
+  std::vector<uint8_t> bytes(8192);
+  const size_t size = format::write_cdr(msg, bytes.data(), bytes.size());
+  bytes.resize(size);
+  EXPECT_EQ(bytes, expected);
+  EXPECT_EQ(format::write_cdr(msg, bytes.data(), size - 1), 0u);
+
+  TypeParam read;
+  ASSERT_TRUE(format::read_cdr(expected.data(), expected.size(), read));
+  EXPECT_TRUE(read == msg);
+}
+
+TEST(MessageFormatter, YamlValues)
+{
+  custom_interfaces::msg::Aula7 aula7;
+  aula7.count = -42;
+  aula7.message = "say \"hi\"";
+  EXPECT_EQ(yaml(aula7), "count: -42\nmessage: \"say \\\"hi\\\"\"\n");
+
+  std_msgs::msg::Header header;
+  header.stamp.sec = 3;
+  header.stamp.nanosec = 500;
+  header.frame_id = "map";
+  EXPECT_EQ(yaml(header), "stamp:\n  sec: 3\n  nanosec: 500\nframe_id: \"map\"\n");
+
+  custom_interfaces::srv::AddMany::Request request;
+  request.a = {1, 2};
+  EXPECT_EQ(yaml(request), "a:\n- 1\n- 2\nb: []\n");
+}
+
+TEST(MessageFormatter, BinaryIsLittleEndian)
+{
+  custom_interfaces::srv::AddMany::Request request;
+  request.a = {0x0102030405060708};
+  EXPECT_EQ(
+    binary(request),
+    std::vector<uint8_t>({1, 0, 0, 0, 8, 7, 6, 5, 4, 3, 2, 1, 0, 0, 0, 0}));
+
+  custom_interfaces::msg::Aula7 aula7;
+  aula7.count = 0x01020304;
+  aula7.message = "ab";
+  EXPECT_EQ(
+    binary(aula7), std::vector<uint8_t>({4, 3, 2, 1, 2, 0, 0, 0, 'a', 'b'}));
+}
+
+TEST(MessageFormatter, TruncatesAtCapacity)
+{
+  custom_interfaces::msg::Aula7 aula7;
+  aula7.message = "a long enough message";
+  std::array<char, 8> storage;
+  format::Buffer buffer(storage);
+  format::write_yaml(buffer, aula7);
+  EXPECT_TRUE(buffer.truncated());
+  EXPECT_EQ(std::string(buffer.data(), buffer.size()), "count: 0");
+}
+
+TEST(MessageCdr, RejectsTruncatedAndCorruptData)
+{
+  custom_interfaces::msg::ScanSectors msg;
+  msg.header.frame_id = "laser";
+  msg.min_range = {1.0f, 2.0f, 3.0f};
+  msg.argmin = {4, 5, 6};
+  std::vector<uint8_t> bytes(256);
+  bytes.resize(format::write_cdr(msg, bytes.data(), bytes.size()));
+  ASSERT_FALSE(bytes.empty());
+
+  custom_interfaces::msg::ScanSectors read;
+  for (size_t size = 0; size < bytes.size(); ++size) {
+    EXPECT_FALSE(format::read_cdr(bytes.data(), size, read)) << size;
+  }
+  ASSERT_TRUE(format::read_cdr(bytes.data(), bytes.size(), read));
+  EXPECT_TRUE(read == msg);
+
+  // min_range follows the 4 byte encapsulation, the stamp, the frame_id
+  // (length, "laser\0", 2 bytes of padding) and two floats: a sequence length
+  // larger than the data is refused before anything is resized.
+  std::vector<uint8_t> corrupt = bytes;
+  const size_t length_offset = 4 + 8 + 4 + 8 + 8;
+  corrupt[length_offset + 3] = 0x7f;
+  EXPECT_FALSE(format::read_cdr(corrupt.data(), corrupt.size(), read));
+}
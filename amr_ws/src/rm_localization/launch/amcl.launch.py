@@ -17,8 +17,11 @@ import os
 from ament_index_python.packages import get_package_share_directory
 
 from launch import LaunchDescription
-from launch.actions import DeclareLaunchArgument, SetEnvironmentVariable
-from launch.substitutions import LaunchConfiguration
+from launch.actions import (DeclareLaunchArgument, ExecuteProcess, IncludeLaunchDescription,
+                            SetEnvironmentVariable)
+from launch.conditions import IfCondition
+from launch.launch_description_sources import PythonLaunchDescriptionSource
+from launch.substitutions import LaunchConfiguration, PythonExpression
 from launch_ros.actions import Node
 from nav2_common.launch import RewrittenYaml
 
@@ -32,6 +35,7 @@ def generate_launch_description():
     use_sim_time = LaunchConfiguration('use_sim_time')
     autostart = LaunchConfiguration('autostart')
     params_file = LaunchConfiguration('params_file')
+    preprocess_scan = LaunchConfiguration('preprocess_scan')
     lifecycle_nodes = ['map_server', 'amcl']
 
     # Map fully qualified names to relative ones so the node's namespace can be prepended.
@@ -46,7 +50,9 @@ def generate_launch_description():
     # Create our own temporary YAML files that include substitutions
     param_substitutions = {
         'use_sim_time': use_sim_time,
-        'yaml_filename': map_yaml_file}
+        'yaml_filename': map_yaml_file,
+        'scan_topic': PythonExpression(
+            ["'scan/decimated' if '", preprocess_scan, "'.lower() == 'true' else 'scan'"])}
 
     configured_params = RewrittenYaml(
         source_file=params_file,
@@ -80,6 +86,31 @@ def generate_launch_description():
             default_value=os.path.join(bringup_dir, 'config', 'amcl_params.yaml'),
             description='Full path to the ROS2 parameters file to use'),
 
+        # AMCL does not read the distance field; this only warms the cache
+        # (~/.cache/rm_map_tools) for tools that do.
+        DeclareLaunchArgument(
+            'distance_field', default_value='false',
+            description='Check the cached distance field of the map and '
+                        'rebuild it if the map changed'),
+
+        DeclareLaunchArgument(
+            'preprocess_scan', default_value='false',
+            description='Start scan_preprocessor and localize on scan/decimated '
+                        'instead of the raw scan'),
+
+        IncludeLaunchDescription(
+            PythonLaunchDescriptionSource(os.path.join(
+                get_package_share_directory('basic_navigation_cpp'), 'launch',
+                'scan_preprocessing.launch.py')),
+            launch_arguments={'use_sim_time': use_sim_time}.items(),
+            condition=IfCondition(preprocess_scan)),
+
+        # Cheap when the cache is current: it only fingerprints the PGM.
+        ExecuteProcess(
+            cmd=['ros2', 'run', 'rm_map_tools', 'map_distance_field', map_yaml_file],
+            output='screen',
+            condition=IfCondition(LaunchConfiguration('distance_field'))),
+
         Node(
             package='nav2_map_server',
             executable='map_server',
@@ -0,0 +1,242 @@
+// Cost of the distance-to-obstacle field behind AMCL's likelihood_field
+// model. The input map is tiled into larger copies in a temporary directory.
+// Reports, in milliseconds:
+//   amcl       nav2_amcl's brushfire (map_update_cspace): a priority queue
+//              grown from every obstacle out to max_dist (2.0 m, as
+//              laser_likelihood_max_dist in amcl_params.yaml), inexact
+//   edt_1      distance_transform on one thread
+//   edt_n      distance_transform on every hardware thread
+//   build      write_distance_field: decode, transform and write the cache
+//   load       load_distance_field with an up-to-date cache: fingerprint the
+//              PGM and map the file, what localization pays at startup
+// and whether edt_1 and edt_n agree, and for the untiled map whether they
+// equal the brute-force distances.
+//
+// usage: distance_transform_benchmark <map.yaml> [tiling ...]   (default 1 8 32)
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rm_map_tools/cell_conversion.hpp"
+#include "rm_map_tools/distance_field.hpp"
+#include "rm_map_tools/distance_transform.hpp"
+#include "rm_map_tools/mapped_map.hpp"
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double ms_since(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+template<typename Op>
+double median_ms(Op && op, int runs = 3)
+{
+  std::vector<double> times;
+  for (int i = 0; i < runs; ++i) {
+    const auto start = Clock::now();
+    op();
+    times.push_back(ms_since(start));
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+// Writes `metadata`'s image tiled `tiling` x `tiling` times, and a YAML next
+// to it, into `dir`; returns the YAML path.
+std::string write_tiled(
+  const rm_map_tools::MapMetadata & metadata, const rm_map_tools::MappedMap & map,
+  int tiling, const std::string & dir)
+{
+  const uint32_t width = map.width() * tiling;
+  const uint32_t height = map.height() * tiling;
+  const std::string name = "map_x" + std::to_string(tiling);
+  std::ofstream pgm(dir + "/" + name + ".pgm", std::ios::binary);
+  pgm << "P5\n" << width << " " << height << "\n255\n";
+  std::ifstream source(metadata.image, std::ios::binary);
+  std::vector<char> bytes((std::istreambuf_iterator<char>(source)), {});
+  const size_t cells = static_cast<size_t>(map.width()) * map.height();
+  const char * pixels = bytes.data() + bytes.size() - cells;
+  std::vector<char> row(width);
+  for (uint32_t y = 0; y < height; ++y) {
+    const char * src = pixels + static_cast<size_t>(y % map.height()) * map.width();
+    for (int t = 0; t < tiling; ++t) {
+      std::memcpy(row.data() + static_cast<size_t>(t) * map.width(), src, map.width());
+    }
+    pgm.write(row.data(), width);
+  }
+
+  const std::string yaml = dir + "/" + name + ".yaml";
+  std::ofstream out(yaml);
+  out << "image: " << name << ".pgm\n" <<
+    "mode: " << rm_map_tools::map_mode_name(metadata.mode) << "\n" <<
+    "resolution: " << metadata.resolution << "\n" <<
+    "origin: [" << metadata.origin[0] << ", " << metadata.origin[1] << ", " <<
+    metadata.origin[2] << "]\n" <<
+    "negate: " << (metadata.negate ? 1 : 0) << "\n" <<
+    "occupied_thresh: " << metadata.occupied_thresh << "\n" <<
+    "free_thresh: " << metadata.free_thresh << "\n";
+  return yaml;
+}
+
+// nav2_amcl's map_update_cspace, distances in cells.
+void amcl_brushfire(
+  const int8_t * cells, uint32_t width, uint32_t height, int radius, float * out)
+{
+  struct Cell
+  {
+    float distance;
+    uint32_t x, y, src_x, src_y;
+    bool operator<(const Cell & other) const {return distance > other.distance;}
+  };
+  std::vector<float> table(static_cast<size_t>(radius + 2) * (radius + 2));
+  for (int i = 0; i <= radius + 1; ++i) {
+    for (int j = 0; j <= radius + 1; ++j) {
+      table[static_cast<size_t>(i) * (radius + 2) + j] =
+        std::sqrt(static_cast<float>(i * i + j * j));
+    }
+  }
+  std::vector<uint8_t> marked(static_cast<size_t>(width) * height, 0);
+  std::fill(out, out + marked.size(), static_cast<float>(radius));
+  std::priority_queue<Cell> queue;
+  for (uint32_t y = 0; y < height; ++y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      const size_t i = static_cast<size_t>(y) * width + x;
+      if (cells[i] == rm_map_tools::kOccupied) {
+        out[i] = 0.0f;
+        marked[i] = 1;
+        queue.push({0.0f, x, y, x, y});
+      }
+    }
+  }
+  const auto visit = [&](const Cell & from, uint32_t x, uint32_t y) {
+      const size_t i = static_cast<size_t>(y) * width + x;
+      if (marked[i]) {
+        return;
+      }
+      const int dx = std::abs(static_cast<int>(x) - static_cast<int>(from.src_x));
+      const int dy = std::abs(static_cast<int>(y) - static_cast<int>(from.src_y));
+      if (dx > radius || dy > radius) {
+        return;
+      }
+      const float distance = table[static_cast<size_t>(dx) * (radius + 2) + dy];
+      if (distance > radius) {
+        return;
+      }
+      out[i] = distance;
+      marked[i] = 1;
+      queue.push({distance, x, y, from.src_x, from.src_y});
+    };
+  while (!queue.empty()) {
+    const Cell cell = queue.top();
+    queue.pop();
+    if (cell.x > 0) {
+      visit(cell, cell.x - 1, cell.y);
+    }
+    if (cell.y > 0) {
+      visit(cell, cell.x, cell.y - 1);
+    }
+    if (cell.x + 1 < width) {
+      visit(cell, cell.x + 1, cell.y);
+    }
+    if (cell.y + 1 < height) {
+      visit(cell, cell.x, cell.y + 1);
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  if (argc < 2) {
+    std::fprintf(stderr, "usage: %s <map.yaml> [tiling ...]\n", argv[0]);
+    return 2;
+  }
+  std::vector<int> tilings;
+  for (int i = 2; i < argc; ++i) {
+    tilings.push_back(std::max(1, std::atoi(argv[i])));
+  }
+  if (tilings.empty()) {
+    tilings = {1, 8, 32};
+  }
+
+  const rm_map_tools::MapMetadata metadata = rm_map_tools::load_map_metadata(argv[1]);
+  const rm_map_tools::MappedMap source(metadata);
+  const int radius = static_cast<int>(std::ceil(2.0 / metadata.resolution));
+  char dir_template[] = "/tmp/distance_transform_benchmark_XXXXXX";
+  const char * dir = mkdtemp(dir_template);
+  if (!dir) {
+    std::perror("mkdtemp");
+    return 1;
+  }
+
+  std::printf("threads: %u\n", std::max(1u, std::thread::hardware_concurrency()));
+  std::printf("cells,amcl_ms,edt_1_ms,edt_n_ms,build_ms,load_ms,threads_match,exact\n");
+  std::vector<std::string> files;
+  for (int tiling : tilings) {
+    const std::string yaml = write_tiled(metadata, source, tiling, dir);
+    const std::string stem = yaml.substr(0, yaml.size() - 5);
+    const std::string cache = rm_map_tools::distance_field_path(yaml);
+    files.insert(files.end(), {yaml, stem + ".pgm", cache});
+
+    const rm_map_tools::MappedMap map(yaml);
+    const size_t cells = static_cast<size_t>(map.width()) * map.height();
+    std::vector<int8_t> grid(cells);
+    map.decode(grid.data());
+    std::vector<float> amcl(cells);
+    std::vector<float> single(cells);
+    std::vector<float> parallel(cells);
+
+    const double amcl_ms = median_ms(
+      [&]() {amcl_brushfire(grid.data(), map.width(), map.height(), radius, amcl.data());}, 1);
+    const double single_ms = median_ms(
+      [&]() {
+        rm_map_tools::distance_transform(
+          grid.data(), map.width(), map.height(), single.data(), 1);
+      });
+    const double parallel_ms = median_ms(
+      [&]() {
+        rm_map_tools::distance_transform(grid.data(), map.width(), map.height(), parallel.data());
+      });
+    const bool threads_match = single == parallel;
+    const char * exact = "-";
+    if (tiling == 1) {
+      std::vector<float> brute(cells);
+      rm_map_tools::distance_transform_brute_force(
+        grid.data(), map.width(), map.height(), brute.data());
+      exact = brute == parallel ? "yes" : "no";
+    }
+
+    const double build_ms = median_ms(
+      [&]() {rm_map_tools::write_distance_field(map, cache);});
+    const double load_ms = median_ms(
+      [&]() {rm_map_tools::load_distance_field(yaml);});
+
+    std::printf(
+      "%zu,%.1f,%.1f,%.1f,%.1f,%.2f,%s,%s\n", cells, amcl_ms, single_ms, parallel_ms, build_ms,
+      load_ms, threads_match ? "yes" : "no", exact);
+    std::fflush(stdout);
+  }
+
+  for (const auto & file : files) {
+    unlink(file.c_str());
+  }
+  rmdir(dir);
+  return 0;
+}
@@ -0,0 +1,212 @@
+// Startup cost of loading a map: the map_server path (read the whole image,
+// then convert every pixel with double-precision thresholds) against
+// MappedMap (map the file, decode on demand). The input map is tiled into
+// larger copies in a temporary directory to show how each path scales.
+// Reports, in milliseconds with the file in the page cache:
+//   reference  read + convert the whole map the way nav2_map_server does
+//   nav2       nav2_map_server::loadMapFromYaml itself, when it was found
+//   open       MappedMap construction: YAML, PGM header, mmap
+//   region     open + decode a 256 x 256 cell region around the map centre,
+//              what a consumer needs before it can start working
+//   full       open + decode every cell
+// and whether the full decode matches the reference cell for cell.
+//
+// usage: map_loader_benchmark <map.yaml> [tiling ...]   (default 1 8 32)
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "rm_map_tools/mapped_map.hpp"
+
+#ifdef RM_MAP_TOOLS_HAVE_NAV2_MAP_IO
+#include "nav2_map_server/map_io.hpp"
+#endif
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double ms_since(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+template<typename Op>
+double median_ms(Op && op, int runs = 5)
+{
+  std::vector<double> times;
+  for (int i = 0; i < runs; ++i) {
+    const auto start = Clock::now();
+    op();
+    times.push_back(ms_since(start));
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+// Writes `metadata`'s image tiled `tiling` x `tiling` times, and a YAML next
+// to it, into `dir`; returns the YAML path.
+std::string write_tiled(
+  const rm_map_tools::MapMetadata & metadata, const rm_map_tools::MappedMap & map,
+  int tiling, const std::string & dir)
+{
+  const uint32_t width = map.width() * tiling;
+  const uint32_t height = map.height() * tiling;
+  const std::string name = "map_x" + std::to_string(tiling);
+  std::ofstream pgm(dir + "/" + name + ".pgm", std::ios::binary);
+  pgm << "P5\n" << width << " " << height << "\n255\n";
+  // Re-read the source pixels straight from its file.
+  std::ifstream source(metadata.image, std::ios::binary);
+  std::vector<char> bytes((std::istreambuf_iterator<char>(source)), {});
+  const size_t cells = static_cast<size_t>(map.width()) * map.height();
+  const char * pixels = bytes.data() + bytes.size() - cells;
+  std::vector<char> row(width);
+  for (uint32_t y = 0; y < height; ++y) {
+    const char * src = pixels + static_cast<size_t>(y % map.height()) * map.width();
+    for (int t = 0; t < tiling; ++t) {
+      std::memcpy(row.data() + static_cast<size_t>(t) * map.width(), src, map.width());
+    }
+    pgm.write(row.data(), width);
+  }
+
+  const std::string yaml = dir + "/" + name + ".yaml";
+  std::ofstream out(yaml);
+  out << "image: " << name << ".pgm\n" <<
+    "mode: " << rm_map_tools::map_mode_name(metadata.mode) << "\n" <<
+    "resolution: " << metadata.resolution << "\n" <<
+    "origin: [" << metadata.origin[0] << ", " << metadata.origin[1] << ", " <<
+    metadata.origin[2] << "]\n" <<
+    "negate: " << (metadata.negate ? 1 : 0) << "\n" <<
+    "occupied_thresh: " << metadata.occupied_thresh << "\n" <<
+    "free_thresh: " << metadata.free_thresh << "\n";
+  return yaml;
+}
+
+// nav2_map_server's per-pixel conversion, on a fully read image.
+void reference_load(const std::string & yaml_path, std::vector<int8_t> & grid)
+{
+  const rm_map_tools::MapMetadata metadata = rm_map_tools::load_map_metadata(yaml_path);
+  std::ifstream file(metadata.image, std::ios::binary);
+  std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), {});
+  unsigned width = 0;
+  unsigned height = 0;
+  unsigned maxval = 0;
+  int header = 0;
+  std::sscanf(
+    reinterpret_cast<const char *>(bytes.data()), "P5 %u %u %u%n", &width, &height, &maxval,
+    &header);
+  const unsigned char * pixels = bytes.data() + header + 1;
+  grid.resize(static_cast<size_t>(width) * height);
+  for (unsigned y = 0; y < height; ++y) {
+    for (unsigned x = 0; x < width; ++x) {
+      const double shade =
+        pixels[static_cast<size_t>(y) * width + x] / static_cast<double>(maxval);
+      const double occ = metadata.negate ? shade : 1.0 - shade;
+      int8_t cell;
+      switch (metadata.mode) {
+        case rm_map_tools::MapMode::kTrinary:
+          cell = metadata.occupied_thresh < occ ? 100 : occ < metadata.free_thresh ? 0 : -1;
+          break;
+        case rm_map_tools::MapMode::kScale:
+          cell = metadata.occupied_thresh < occ ? 100 : occ < metadata.free_thresh ? 0 :
+            static_cast<int8_t>(
+            std::rint(
+              (occ - metadata.free_thresh) /
+              (metadata.occupied_thresh - metadata.free_thresh) * 100.0));
+          break;
+        default:
+          {
+            const double value = std::round(shade * 255.0);
+            cell = value >= 0 && value <= 100 ? static_cast<int8_t>(value) : -1;
+          }
+          break;
+      }
+      grid[static_cast<size_t>(height - y - 1) * width + x] = cell;
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  if (argc < 2) {
+    std::fprintf(stderr, "usage: %s <map.yaml> [tiling ...]\n", argv[0]);
+    return 2;
+  }
+  std::vector<int> tilings;
+  for (int i = 2; i < argc; ++i) {
+    tilings.push_back(std::max(1, std::atoi(argv[i])));
+  }
+  if (tilings.empty()) {
+    tilings = {1, 8, 32};
+  }
+
+  const rm_map_tools::MapMetadata metadata = rm_map_tools::load_map_metadata(argv[1]);
+  const rm_map_tools::MappedMap source(metadata);
+  char dir_template[] = "/tmp/map_loader_benchmark_XXXXXX";
+  const char * dir = mkdtemp(dir_template);
+  if (!dir) {
+    std::perror("mkdtemp");
+    return 1;
+  }
+
+  std::printf("kernel: %s\n", rm_map_tools::convert_cells_kernel());
+  std::printf("cells,reference_ms,nav2_ms,open_ms,region_ms,full_ms,speedup,match\n");
+  std::vector<std::string> files;
+  for (int tiling : tilings) {
+    const std::string yaml = write_tiled(metadata, source, tiling, dir);
+    files.push_back(yaml);
+    files.push_back(yaml.substr(0, yaml.size() - 5) + ".pgm");
+
+    std::vector<int8_t> reference;
+    const double reference_ms = median_ms([&]() {reference_load(yaml, reference);});
+    double nav2_ms = std::nan("");
+#ifdef RM_MAP_TOOLS_HAVE_NAV2_MAP_IO
+    nav2_ms = median_ms(
+      [&]() {
+        nav_msgs::msg::OccupancyGrid grid;
+        nav2_map_server::loadMapFromYaml(yaml, grid);
+      });
+#endif
+
+    const double open_ms = median_ms([&]() {rm_map_tools::MappedMap map(yaml);});
+    std::vector<int8_t> region(256 * 256);
+    const double region_ms = median_ms(
+      [&]() {
+        rm_map_tools::MappedMap map(yaml);
+        const uint32_t w = std::min(256u, map.width());
+        const uint32_t h = std::min(256u, map.height());
+        map.decode_region(
+          (map.width() - w) / 2, (map.height() - h) / 2, w, h, region.data(), w);
+      });
+    std::vector<int8_t> full;
+    const double full_ms = median_ms(
+      [&]() {
+        rm_map_tools::MappedMap map(yaml);
+        full.resize(static_cast<size_t>(map.width()) * map.height());
+        map.decode(full.data());
+      });
+
+    std::printf(
+      "%zu,%.3f,%.3f,%.3f,%.3f,%.3f,%.1f,%s\n", reference.size(), reference_ms, nav2_ms,
+      open_ms, region_ms, full_ms, reference_ms / full_ms, full == reference ? "yes" : "no");
+  }
+
+  for (const auto & file : files) {
+    unlink(file.c_str());
+  }
+  rmdir(dir);
+  return 0;
+}
@@ -0,0 +1,201 @@
+// Cost of building the max-pooled map pyramid. The input map is tiled into
+// larger copies in a temporary directory (the default 41 x 41 tiling of
+// my_map is 13079 x 10086 cells). Reports, in milliseconds, for levels
+// 1..n pooled from an already decoded map:
+//   scalar     max_pool_2x2_scalar, one thread
+//   vector_1   max_pool_2x2 (AVX2 / NEON), one thread
+//   vector_n   max_pool_2x2 on every hardware thread
+//   build      write_map_pyramid: decode, pool and write the file
+//   load       load_map_pyramid with an up-to-date file: fingerprint the PGM
+//              and map the file
+// and whether the vector levels equal the scalar ones.
+//
+// usage: map_pyramid_benchmark <map.yaml> [levels [tiling ...]]
+//        (default 6 levels, tilings 1 8 41)
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rm_map_tools/map_pyramid.hpp"
+#include "rm_map_tools/mapped_map.hpp"
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double ms_since(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+template<typename Op>
+double median_ms(Op && op, int runs = 5)
+{
+  std::vector<double> times;
+  for (int i = 0; i < runs; ++i) {
+    const auto start = Clock::now();
+    op();
+    times.push_back(ms_since(start));
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+// Writes `metadata`'s image tiled `tiling` x `tiling` times, and a YAML next
+// to it, into `dir`; returns the YAML path.
+std::string write_tiled(
+  const rm_map_tools::MapMetadata & metadata, const rm_map_tools::MappedMap & map,
+  int tiling, const std::string & dir)
+{
+  const uint32_t width = map.width() * tiling;
+  const uint32_t height = map.height() * tiling;
+  const std::string name = "map_x" + std::to_string(tiling);
+  std::ofstream pgm(dir + "/" + name + ".pgm", std::ios::binary);
+  pgm << "P5\n" << width << " " << height << "\n255\n";
+  std::ifstream source(metadata.image, std::ios::binary);
+  std::vector<char> bytes((std::istreambuf_iterator<char>(source)), {});
+  const size_t cells = static_cast<size_t>(map.width()) * map.height();
+  const char * pixels = bytes.data() + bytes.size() - cells;
+  std::vector<char> row(width);
+  for (uint32_t y = 0; y < height; ++y) {
+    const char * src = pixels + static_cast<size_t>(y % map.height()) * map.width();
+    for (int t = 0; t < tiling; ++t) {
+      std::memcpy(row.data() + static_cast<size_t>(t) * map.width(), src, map.width());
+    }
+    pgm.write(row.data(), width);
+  }
+
+  const std::string yaml = dir + "/" + name + ".yaml";
+  std::ofstream out(yaml);
+  out << "image: " << name << ".pgm\n" <<
+    "mode: " << rm_map_tools::map_mode_name(metadata.mode) << "\n" <<
+    "resolution: " << metadata.resolution << "\n" <<
+    "origin: [" << metadata.origin[0] << ", " << metadata.origin[1] << ", " <<
+    metadata.origin[2] << "]\n" <<
+    "negate: " << (metadata.negate ? 1 : 0) << "\n" <<
+    "occupied_thresh: " << metadata.occupied_thresh << "\n" <<
+    "free_thresh: " << metadata.free_thresh << "\n";
+  return yaml;
+}
+
+// Levels 1..n of `base` in `levels`, each as ceil-halved grids.
+template<typename Pool>
+void pool_levels(
+  const std::vector<int8_t> & base, uint32_t width, uint32_t height,
+  std::vector<std::vector<int8_t>> & levels, Pool && pool)
+{
+  const int8_t * in = base.data();
+  for (auto & level : levels) {
+    pool(in, width, height, level.data());
+    width = (width + 1) / 2;
+    height = (height + 1) / 2;
+    in = level.data();
+  }
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  if (argc < 2) {
+    std::fprintf(stderr, "usage: %s <map.yaml> [levels [tiling ...]]\n", argv[0]);
+    return 2;
+  }
+  const uint32_t requested =
+    argc > 2 ? static_cast<uint32_t>(std::max(1, std::atoi(argv[2]))) : 6;
+  std::vector<int> tilings;
+  for (int i = 3; i < argc; ++i) {
+    tilings.push_back(std::max(1, std::atoi(argv[i])));
+  }
+  if (tilings.empty()) {
+    tilings = {1, 8, 41};
+  }
+
+  const rm_map_tools::MapMetadata metadata = rm_map_tools::load_map_metadata(argv[1]);
+  const rm_map_tools::MappedMap source(metadata);
+  char dir_template[] = "/tmp/map_pyramid_benchmark_XXXXXX";
+  const char * dir = mkdtemp(dir_template);
+  if (!dir) {
+    std::perror("mkdtemp");
+    return 1;
+  }
+
+  std::printf(
+    "kernel: %s, threads: %u\n", rm_map_tools::max_pool_kernel(),
+    std::max(1u, std::thread::hardware_concurrency()));
+  std::printf("width,height,levels,scalar_ms,vector_1_ms,vector_n_ms,build_ms,load_ms,match\n");
+  std::vector<std::string> files;
+  for (int tiling : tilings) {
+    const std::string yaml = write_tiled(metadata, source, tiling, dir);
+    const std::string stem = yaml.substr(0, yaml.size() - 5);
+    files.insert(files.end(), {yaml, stem + ".pgm", stem + ".pyr"});
+
+    const rm_map_tools::MappedMap map(yaml);
+    const uint32_t levels = rm_map_tools::pyramid_levels(map.width(), map.height(), requested);
+    std::vector<int8_t> base(static_cast<size_t>(map.width()) * map.height());
+    map.decode(base.data());
+    std::vector<std::vector<int8_t>> scalar(levels - 1);
+    uint32_t width = map.width();
+    uint32_t height = map.height();
+    for (auto & level : scalar) {
+      width = (width + 1) / 2;
+      height = (height + 1) / 2;
+      level.resize(static_cast<size_t>(width) * height);
+    }
+    auto single = scalar;
+    auto parallel = scalar;
+
+    const double scalar_ms = median_ms(
+      [&]() {
+        pool_levels(
+          base, map.width(), map.height(), scalar,
+          [](const int8_t * in, uint32_t w, uint32_t h, int8_t * out) {
+            rm_map_tools::max_pool_2x2_scalar(in, w, h, out);
+          });
+      });
+    const double single_ms = median_ms(
+      [&]() {
+        pool_levels(
+          base, map.width(), map.height(), single,
+          [](const int8_t * in, uint32_t w, uint32_t h, int8_t * out) {
+            rm_map_tools::max_pool_2x2(in, w, h, out, 1);
+          });
+      });
+    const double parallel_ms = median_ms(
+      [&]() {
+        pool_levels(
+          base, map.width(), map.height(), parallel,
+          [](const int8_t * in, uint32_t w, uint32_t h, int8_t * out) {
+            rm_map_tools::max_pool_2x2(in, w, h, out);
+          });
+      });
+    const bool match = scalar == single && scalar == parallel;
+
+    const double build_ms = median_ms(
+      [&]() {rm_map_tools::write_map_pyramid(map, requested, stem + ".pyr");}, 3);
+    const double load_ms = median_ms(
+      [&]() {rm_map_tools::load_map_pyramid(yaml, requested);});
+
+    std::printf(
+      "%u,%u,%u,%.2f,%.2f,%.2f,%.1f,%.2f,%s\n", map.width(), map.height(), levels, scalar_ms,
+      single_ms, parallel_ms, build_ms, load_ms, match ? "yes" : "no");
+    std::fflush(stdout);
+  }
+
+  for (const auto & file : files) {
+    unlink(file.c_str());
+  }
+  rmdir(dir);
+  return 0;
+}
@@ -0,0 +1,133 @@
+// Cost and payoff of sending a trinary map as a PackedOccupancyGrid instead
+// of a raw OccupancyGrid. The input map is decoded and tiled into larger
+// copies in memory. Reports the payload of each encoding in bytes:
+//   raw        OccupancyGrid data, one byte per cell
+//   2bit       four cells per byte
+//   rle        LEB128 runs
+// the time, in milliseconds, to:
+//   encode     pack into the smaller of the two, as packed_map_server does
+//   scalar     unpack_2bit_scalar
+//   unpack     unpack_2bit (AVX2 / NEON), also as decoded GB/s
+//   rle_dec    decode_rle
+// and the modelled time for a late joiner to receive the map over a link
+// of 100 Mbit/s and 1 Gbit/s: payload / bandwidth, plus the decode for
+// packed (the smaller encoding; the message is encoded once, when latched).
+// Every decode is checked against the input.
+//
+// usage: packed_grid_benchmark <map.yaml> [tiling ...]   (default 1 8 32)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "rm_map_tools/mapped_map.hpp"
+#include "rm_map_tools/packed_grid.hpp"
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double ms_since(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+template<typename Op>
+double median_ms(Op && op, int runs = 5)
+{
+  std::vector<double> times;
+  for (int i = 0; i < runs; ++i) {
+    const auto start = Clock::now();
+    op();
+    times.push_back(ms_since(start));
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+// Milliseconds to move `bytes` over a link of `mbit_per_s`.
+double transfer_ms(size_t bytes, double mbit_per_s)
+{
+  return bytes * 8.0 / (mbit_per_s * 1e3);
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  if (argc < 2) {
+    std::fprintf(stderr, "usage: %s <map.yaml> [tiling ...]\n", argv[0]);
+    return 2;
+  }
+  std::vector<int> tilings;
+  for (int i = 2; i < argc; ++i) {
+    tilings.push_back(std::max(1, std::atoi(argv[i])));
+  }
+  if (tilings.empty()) {
+    tilings = {1, 8, 32};
+  }
+
+  const rm_map_tools::MappedMap source(argv[1]);
+  std::vector<int8_t> source_cells(static_cast<size_t>(source.width()) * source.height());
+  source.decode(source_cells.data());
+  if (!rm_map_tools::is_trinary(source_cells.data(), source_cells.size())) {
+    std::fprintf(stderr, "%s is not a trinary map\n", argv[1]);
+    return 1;
+  }
+
+  std::printf("kernel: %s\n", rm_map_tools::unpack_2bit_kernel());
+  std::printf(
+    "cells,raw_bytes,2bit_bytes,rle_bytes,encode_ms,scalar_ms,unpack_ms,unpack_gbps,"
+    "rle_dec_ms,raw_100m_ms,packed_100m_ms,raw_1g_ms,packed_1g_ms,match\n");
+  for (int tiling : tilings) {
+    const size_t width = static_cast<size_t>(source.width()) * tiling;
+    const size_t height = static_cast<size_t>(source.height()) * tiling;
+    const size_t cells = width * height;
+    std::vector<int8_t> grid(cells);
+    for (size_t y = 0; y < height; ++y) {
+      const int8_t * src = source_cells.data() + (y % source.height()) * source.width();
+      for (int t = 0; t < tiling; ++t) {
+        std::memcpy(grid.data() + y * width + t * source.width(), src, source.width());
+      }
+    }
+
+    std::vector<uint8_t> packed(rm_map_tools::packed_2bit_size(cells));
+    std::vector<uint8_t> rle;
+    const double encode_ms = median_ms(
+      [&]() {
+        rm_map_tools::encode_rle(grid.data(), cells, rle);
+        if (rle.size() > packed.size()) {
+          rm_map_tools::pack_2bit(grid.data(), cells, packed.data());
+        }
+      });
+    rm_map_tools::pack_2bit(grid.data(), cells, packed.data());
+
+    std::vector<int8_t> scalar(cells);
+    std::vector<int8_t> vector(cells);
+    std::vector<int8_t> runs(cells);
+    const double scalar_ms = median_ms(
+      [&]() {rm_map_tools::unpack_2bit_scalar(packed.data(), cells, scalar.data());});
+    const double unpack_ms = median_ms(
+      [&]() {rm_map_tools::unpack_2bit(packed.data(), cells, vector.data());});
+    const double rle_ms = median_ms(
+      [&]() {rm_map_tools::decode_rle(rle.data(), rle.size(), cells, runs.data());});
+    const bool match = scalar == grid && vector == grid && runs == grid;
+
+    const bool use_rle = rle.size() <= packed.size();
+    const size_t packed_bytes = use_rle ? rle.size() : packed.size();
+    const double decode_ms = use_rle ? rle_ms : unpack_ms;
+    std::printf(
+      "%zu,%zu,%zu,%zu,%.2f,%.2f,%.2f,%.1f,%.2f,%.1f,%.1f,%.1f,%.1f,%s\n", cells, cells,
+      packed.size(), rle.size(), encode_ms, scalar_ms, unpack_ms, cells / (unpack_ms * 1e6),
+      rle_ms, transfer_ms(cells, 100.0),
+      transfer_ms(packed_bytes, 100.0) + decode_ms, transfer_ms(cells, 1000.0),
+      transfer_ms(packed_bytes, 1000.0) + decode_ms, match ? "yes" : "no");
+    std::fflush(stdout);
+  }
+  return 0;
+}
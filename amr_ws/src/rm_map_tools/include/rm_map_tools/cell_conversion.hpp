@@ -0,0 +1,51 @@
+#ifndef RM_MAP_TOOLS__CELL_CONVERSION_HPP_
+#define RM_MAP_TOOLS__CELL_CONVERSION_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "rm_map_tools/map_metadata.hpp"
+
+namespace rm_map_tools
+{
+
+// OccupancyGrid values.
+constexpr int8_t kFree = 0;
+constexpr int8_t kOccupied = 100;
+constexpr int8_t kUnknown = -1;
+
+// Occupancy value of every 8-bit pixel value. When the table is at most
+// three runs of equal values, which trinary mode always is, it is also kept
+// as two thresholds so the conversion can run as vector compares:
+// pixel <= low_max -> low, pixel >= high_min -> high, anything else -> mid.
+struct CellTable
+{
+  int8_t value[256];
+  bool three_level;
+  uint8_t low_max;
+  uint8_t high_min;
+  int8_t low;
+  int8_t mid;
+  int8_t high;
+};
+
+// Builds the table with nav2_map_server's formulas for `mode`, `negate` and
+// the thresholds, for pixels scaled by `maxval` (at most 255). Values above
+// maxval are treated as maxval.
+CellTable make_cell_table(const MapMetadata & metadata, unsigned maxval);
+
+// Converts `count` pixels to occupancy values. Uses AVX2 when the CPU has it
+// or NEON on ARM for three-level tables, and a table lookup otherwise.
+void convert_cells(const CellTable & table, const uint8_t * pixels, size_t count, int8_t * out);
+
+// Same conversion by table lookup only; the reference for benchmarks.
+void convert_cells_scalar(
+  const CellTable & table, const uint8_t * pixels, size_t count, int8_t * out);
+
+// Name of the kernel convert_cells uses for three-level tables: "avx2",
+// "neon" or "scalar".
+const char * convert_cells_kernel();
+
+}  // namespace rm_map_tools
+
+#endif  // RM_MAP_TOOLS__CELL_CONVERSION_HPP_
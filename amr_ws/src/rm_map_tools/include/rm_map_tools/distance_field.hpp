@@ -0,0 +1,75 @@
+#ifndef RM_MAP_TOOLS__DISTANCE_FIELD_HPP_
+#define RM_MAP_TOOLS__DISTANCE_FIELD_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "rm_map_tools/mapped_file.hpp"
+#include "rm_map_tools/mapped_map.hpp"
+
+namespace rm_map_tools
+{
+
+// Distance-to-nearest-obstacle cache of a map, kept in the user's cache
+// directory (see distance_field_path) so the transform runs once per map
+// instead of at every localization startup. The file is a 64-byte header ("RMEDT",
+// version, width, height, map fingerprint, resolution, origin) and, from
+// byte 4096, width * height floats in metres in OccupancyGrid row order,
+// +inf where the map has no obstacle. Integers and floats are in host byte
+// order.
+constexpr uint32_t kDistanceFieldVersion = 1;
+
+// Read-only view of a cache file; the distances are memory-mapped.
+class DistanceField
+{
+public:
+  // Throws std::runtime_error when the file is not a cache of this version
+  // or is truncated, and std::system_error when it cannot be mapped.
+  explicit DistanceField(const std::string & path);
+
+  uint32_t width() const {return width_;}
+  uint32_t height() const {return height_;}
+  double resolution() const {return resolution_;}
+  const double * origin() const {return origin_;}
+  uint64_t fingerprint() const {return fingerprint_;}
+
+  // width() * height() distances in metres.
+  const float * data() const {return data_;}
+  float distance(uint32_t x, uint32_t y) const
+  {
+    return data_[static_cast<size_t>(y) * width_ + x];
+  }
+
+private:
+  MappedFile file_;
+  uint32_t width_;
+  uint32_t height_;
+  uint64_t fingerprint_;
+  double resolution_;
+  double origin_[3];
+  const float * data_;
+};
+
+// Path of the cache that belongs to `yaml_path`:
+// $XDG_CACHE_HOME/rm_map_tools/my_map-<hash of the YAML's absolute path>.edt,
+// with ~/.cache in place of $XDG_CACHE_HOME when it is unset. Maps are often
+// installed read-only, so the cache is never written next to them.
+std::string distance_field_path(const std::string & yaml_path);
+
+// Computes the distance field of `map` (see distance_transform) straight
+// into a mapping of `path`, under a temporary name renamed at the end so
+// readers never see a partial file. Missing directories are created.
+// Throws std::system_error on I/O errors.
+void write_distance_field(const MappedMap & map, const std::string & path, unsigned threads = 0);
+
+// Opens the cache of `yaml_path`, first (re)building it when it is missing,
+// of another version, or its fingerprint no longer matches the map.
+// `rebuilt`, when given, tells which happened.
+std::unique_ptr<DistanceField> load_distance_field(
+  const std::string & yaml_path, unsigned threads = 0, bool * rebuilt = nullptr);
+
+}  // namespace rm_map_tools
+
+#endif  // RM_MAP_TOOLS__DISTANCE_FIELD_HPP_
@@ -0,0 +1,27 @@
+#ifndef RM_MAP_TOOLS__DISTANCE_TRANSFORM_HPP_
+#define RM_MAP_TOOLS__DISTANCE_TRANSFORM_HPP_
+
+#include <cstdint>
+
+namespace rm_map_tools
+{
+
+// Exact Euclidean distance, in cells, from every cell to the nearest
+// occupied one (value kOccupied, the cells nav2_amcl's likelihood field
+// treats as obstacles); +inf everywhere when there is none. `cells` and
+// `out` are width * height values in row order. Runs the separable
+// lower-envelope algorithm of Felzenszwalb and Huttenlocher: a pass along
+// the rows, then one along the columns in blocks of 16 so each row read
+// is a whole cache line. Both passes are split over `threads` threads, all
+// hardware threads when 0. The result does not depend on the thread count.
+void distance_transform(
+  const int8_t * cells, uint32_t width, uint32_t height, float * out, unsigned threads = 0);
+
+// Same distances by checking every occupied cell for every cell, in
+// O(cells * obstacles); the reference for benchmarks on small maps.
+void distance_transform_brute_force(
+  const int8_t * cells, uint32_t width, uint32_t height, float * out);
+
+}  // namespace rm_map_tools
+
+#endif  // RM_MAP_TOOLS__DISTANCE_TRANSFORM_HPP_
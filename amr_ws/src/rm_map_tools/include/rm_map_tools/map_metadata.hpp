@@ -0,0 +1,37 @@
+#ifndef RM_MAP_TOOLS__MAP_METADATA_HPP_
+#define RM_MAP_TOOLS__MAP_METADATA_HPP_
+
+#include <string>
+
+namespace rm_map_tools
+{
+
+// How pixel values become occupancy, as in nav2_map_server.
+enum class MapMode
+{
+  kTrinary,  // occupied, free or unknown
+  kScale,    // occupied, free, or a probability in between
+  kRaw,      // the pixel value itself, 0..100, anything else unknown
+};
+
+// Contents of a map YAML file (nav2_map_server format).
+struct MapMetadata
+{
+  std::string image;  // absolute, or relative to the directory of the YAML
+  MapMode mode = MapMode::kTrinary;
+  double resolution = 0.0;
+  double origin[3] = {0.0, 0.0, 0.0};  // x, y, yaw of the lower-left cell
+  bool negate = false;
+  double occupied_thresh = 0.65;
+  double free_thresh = 0.25;
+};
+
+// Parses `yaml_path` and resolves `image` against its directory. Throws
+// std::runtime_error on a missing key or an unknown mode.
+MapMetadata load_map_metadata(const std::string & yaml_path);
+
+const char * map_mode_name(MapMode mode);
+
+}  // namespace rm_map_tools
+
+#endif  // RM_MAP_TOOLS__MAP_METADATA_HPP_
@@ -0,0 +1,96 @@
+#ifndef RM_MAP_TOOLS__MAP_PYRAMID_HPP_
+#define RM_MAP_TOOLS__MAP_PYRAMID_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rm_map_tools/mapped_file.hpp"
+#include "rm_map_tools/mapped_map.hpp"
+
+namespace rm_map_tools
+{
+
+// Halves a grid of OccupancyGrid values: output cell (x, y) is the largest
+// of input cells [2x, 2x + 1] x [2y, 2y + 1] that exist, so the output is
+// ceil(width / 2) x ceil(height / 2). Values compare as signed bytes,
+// occupied > any probability > free > unknown, so a coarse cell is occupied
+// when any of its cells is and unknown only when all are; a coarse score is
+// then an upper bound of the fine ones, as branch-and-bound matching needs.
+// Uses AVX2 when the CPU has it (checked once at runtime) or NEON on ARM,
+// and splits the output rows over `threads` threads, all hardware threads
+// when 0.
+void max_pool_2x2(
+  const int8_t * in, uint32_t width, uint32_t height, int8_t * out, unsigned threads = 0);
+
+// Same pooling in plain C++ on the calling thread; the reference for
+// benchmarks.
+void max_pool_2x2_scalar(const int8_t * in, uint32_t width, uint32_t height, int8_t * out);
+
+// Name of the kernel max_pool_2x2 uses: "avx2", "neon" or "scalar".
+const char * max_pool_kernel();
+
+// One level of a pyramid: level i has resolution * 2^i.
+struct PyramidLevel
+{
+  uint32_t width;
+  uint32_t height;
+  double resolution;
+  const int8_t * cells;  // width * height values in OccupancyGrid row order
+};
+
+// Max-pooled pyramid of a map, stored next to its YAML (my_map.yaml ->
+// my_map.pyr) so scan matching, global localization and planning share one
+// copy. The file is a 64-byte header ("RMPYR", version, level count, base
+// width and height, map fingerprint as in map_fingerprint, base resolution,
+// origin), a table of {width, height, offset} per level, and each level's
+// cells from a page-aligned offset. All levels share the map's origin.
+// Integers and floats are in host byte order.
+constexpr uint32_t kMapPyramidVersion = 1;
+constexpr uint32_t kMaxPyramidLevels = 32;
+
+// Read-only view of a pyramid file; the levels are memory-mapped.
+class MapPyramid
+{
+public:
+  // Throws std::runtime_error when the file is not a pyramid of this
+  // version or is truncated, and std::system_error when it cannot be mapped.
+  explicit MapPyramid(const std::string & path);
+
+  uint32_t levels() const {return static_cast<uint32_t>(levels_.size());}
+  // Level 0 is the map itself.
+  const PyramidLevel & level(uint32_t i) const {return levels_[i];}
+  const double * origin() const {return origin_;}
+  uint64_t fingerprint() const {return fingerprint_;}
+
+private:
+  MappedFile file_;
+  std::vector<PyramidLevel> levels_;
+  uint64_t fingerprint_;
+  double origin_[3];
+};
+
+// Path of the pyramid that belongs to `yaml_path`.
+std::string map_pyramid_path(const std::string & yaml_path);
+
+// Number of levels write_map_pyramid produces for a width x height map when
+// asked for `levels`: at least 1, and no more than needed to reach 1 x 1.
+uint32_t pyramid_levels(uint32_t width, uint32_t height, uint32_t levels);
+
+// Decodes `map` and pools it level by level straight into a mapping of
+// `path`, renamed into place at the end. Throws std::system_error on I/O
+// errors.
+void write_map_pyramid(
+  const MappedMap & map, uint32_t levels, const std::string & path, unsigned threads = 0);
+
+// Opens the pyramid of `yaml_path`, first (re)building it when it is
+// missing, of another version, has another level count, or its fingerprint
+// no longer matches the map. `rebuilt`, when given, tells which happened.
+std::unique_ptr<MapPyramid> load_map_pyramid(
+  const std::string & yaml_path, uint32_t levels, unsigned threads = 0, bool * rebuilt = nullptr);
+
+}  // namespace rm_map_tools
+
+#endif  // RM_MAP_TOOLS__MAP_PYRAMID_HPP_
@@ -0,0 +1,69 @@
+#ifndef RM_MAP_TOOLS__MAPPED_FILE_HPP_
+#define RM_MAP_TOOLS__MAPPED_FILE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace rm_map_tools
+{
+
+// Read-only private mapping of a whole file. Pages are read from disk when
+// first touched, so opening costs the same for a small and a huge map.
+class MappedFile
+{
+public:
+  enum class Access
+  {
+    kSequential,  // read ahead aggressively, e.g. for a full decode
+    kRandom,      // fault in only what is touched, e.g. for region decodes
+  };
+
+  // Throws std::system_error when the file cannot be opened or mapped.
+  explicit MappedFile(const std::string & path, Access access = Access::kRandom);
+  ~MappedFile();
+  MappedFile(const MappedFile &) = delete;
+  MappedFile & operator=(const MappedFile &) = delete;
+
+  // Hints the kernel about the next reads of [offset, offset + size).
+  void advise(Access access, size_t offset = 0, size_t size = 0) const;
+
+  const uint8_t * data() const {return data_;}
+  size_t size() const {return size_;}
+  const std::string & path() const {return path_;}
+
+private:
+  std::string path_;
+  const uint8_t * data_;
+  size_t size_;
+};
+
+// Writable shared mapping of a new file of `size` bytes, created as
+// path + ".tmp" and renamed to `path` by commit(), so readers of `path`
+// never see a partial file. Destroyed without commit(), the temporary file
+// is removed.
+class OutputMappedFile
+{
+public:
+  // Throws std::system_error when the file cannot be created or mapped.
+  OutputMappedFile(const std::string & path, size_t size);
+  ~OutputMappedFile();
+  OutputMappedFile(const OutputMappedFile &) = delete;
+  OutputMappedFile & operator=(const OutputMappedFile &) = delete;
+
+  uint8_t * data() {return data_;}
+  size_t size() const {return size_;}
+
+  // Unmaps and renames the file into place. Throws std::system_error.
+  void commit();
+
+private:
+  std::string path_;
+  std::string temporary_;
+  uint8_t * data_;
+  size_t size_;
+};
+
+}  // namespace rm_map_tools
+
+#endif  // RM_MAP_TOOLS__MAPPED_FILE_HPP_
@@ -0,0 +1,77 @@
+#ifndef RM_MAP_TOOLS__MAPPED_MAP_HPP_
+#define RM_MAP_TOOLS__MAPPED_MAP_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "rm_map_tools/cell_conversion.hpp"
+#include "rm_map_tools/map_metadata.hpp"
+#include "rm_map_tools/mapped_file.hpp"
+
+namespace rm_map_tools
+{
+
+// A map YAML and its binary PGM (P5, 8 bit), with the image memory-mapped
+// and decoded to OccupancyGrid values only when asked for. Opening reads the
+// YAML and the PGM header and nothing else, whatever the map size. Cells use
+// OccupancyGrid coordinates: (0, 0) is the lower-left cell, i.e. the first
+// pixel of the last image row. Results match nav2_map_server cell for cell.
+class MappedMap
+{
+public:
+  // Throws std::runtime_error for a malformed YAML or PGM and
+  // std::system_error when the image cannot be mapped.
+  explicit MappedMap(const std::string & yaml_path);
+  explicit MappedMap(const MapMetadata & metadata);
+
+  uint32_t width() const {return width_;}
+  uint32_t height() const {return height_;}
+  const MapMetadata & metadata() const {return metadata_;}
+  const CellTable & cell_table() const {return table_;}
+  // The whole PGM file, header included.
+  const MappedFile & image() const {return file_;}
+
+  // Decodes every cell into `out`, width() * height() values in row order.
+  void decode(int8_t * out) const;
+
+  // Decodes cells [x, x + w) x [y, y + h) into `out`, `stride` values apart
+  // from one row to the next. Only the image rows of the region are read, so
+  // the cost is that of the region, not of the map. Throws std::out_of_range
+  // when the region does not fit in the map.
+  void decode_region(
+    uint32_t x, uint32_t y, uint32_t w, uint32_t h, int8_t * out, size_t stride) const;
+
+  int8_t cell(uint32_t x, uint32_t y) const;
+
+private:
+  void parse_header();
+  const uint8_t * image_row(uint32_t y) const
+  {
+    return pixels_ + static_cast<size_t>(height_ - 1 - y) * width_;
+  }
+
+  MapMetadata metadata_;
+  MappedFile file_;
+  const uint8_t * pixels_;
+  uint32_t width_;
+  uint32_t height_;
+  unsigned maxval_;
+  CellTable table_;
+};
+
+// Hash of everything the decoded cells depend on: the PGM file's bytes and
+// the YAML's mode, negate, thresholds, resolution and origin. Any edit to
+// the map, or re-saving it with other thresholds, changes it; caches derived
+// from a map store it to notice. A fast 64-bit hash for detecting changes,
+// not a cryptographic one.
+uint64_t map_fingerprint(const MappedMap & map);
+
+// `yaml_path` with its extension replaced by `extension` (".edt" turns
+// maps/my_map.yaml into maps/my_map.edt): where files derived from a map
+// are kept.
+std::string map_companion_path(const std::string & yaml_path, const std::string & extension);
+
+}  // namespace rm_map_tools
+
+#endif  // RM_MAP_TOOLS__MAPPED_MAP_HPP_
@@ -0,0 +1,54 @@
+#ifndef RM_MAP_TOOLS__OCCUPANCY_GRID_HPP_
+#define RM_MAP_TOOLS__OCCUPANCY_GRID_HPP_
+
+#include <cstdint>
+
+#include "custom_interfaces/msg/packed_occupancy_grid.hpp"
+#include "nav_msgs/msg/occupancy_grid.hpp"
+#include "rm_map_tools/mapped_map.hpp"
+#include "rm_map_tools/packed_grid.hpp"
+#include "rm_map_tools/tiled_map.hpp"
+
+namespace rm_map_tools
+{
+
+// Fills `grid` with the whole map, as nav2_map_server publishes it. The
+// header (stamp, frame_id) is left to the caller.
+void to_occupancy_grid(const MappedMap & map, nav_msgs::msg::OccupancyGrid & grid);
+
+// Fills `grid` with cells [x, x + w) x [y, y + h) of the map, its origin
+// moved to the region's lower-left cell.
+void region_to_occupancy_grid(
+  const MappedMap & map, uint32_t x, uint32_t y, uint32_t w, uint32_t h,
+  nav_msgs::msg::OccupancyGrid & grid);
+
+// Same for a tiled map; only the tiles overlapping the region are read.
+void region_to_occupancy_grid(
+  const TiledMap & map, uint32_t x, uint32_t y, uint32_t w, uint32_t h,
+  nav_msgs::msg::OccupancyGrid & grid);
+
+// Fills `grid` with tile (tx, ty), cropped to the map for the last column
+// and row of tiles. Throws std::out_of_range for a missing tile.
+void tile_to_occupancy_grid(
+  const TiledMap & map, uint32_t tx, uint32_t ty, nav_msgs::msg::OccupancyGrid & grid);
+
+// Fills `packed` with `grid`, header and info included, in the given
+// encoding. Throws std::invalid_argument when the grid is not trinary.
+void pack_occupancy_grid(
+  const nav_msgs::msg::OccupancyGrid & grid, PackedEncoding encoding,
+  custom_interfaces::msg::PackedOccupancyGrid & packed);
+
+// Same in whichever encoding is smaller: RLE for maps with long runs, 2-bit
+// otherwise.
+void pack_occupancy_grid(
+  const nav_msgs::msg::OccupancyGrid & grid, custom_interfaces::msg::PackedOccupancyGrid & packed);
+
+// Inverse of pack_occupancy_grid. Throws std::runtime_error when the
+// encoding is unknown or the data does not match info.width * info.height.
+void unpack_occupancy_grid(
+  const custom_interfaces::msg::PackedOccupancyGrid & packed,
+  nav_msgs::msg::OccupancyGrid & grid);
+
+}  // namespace rm_map_tools
+
+#endif  // RM_MAP_TOOLS__OCCUPANCY_GRID_HPP_
@@ -0,0 +1,51 @@
+#ifndef RM_MAP_TOOLS__PACKED_GRID_HPP_
+#define RM_MAP_TOOLS__PACKED_GRID_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rm_map_tools
+{
+
+// Compact encodings of trinary OccupancyGrid cells (free 0, occupied 100,
+// unknown -1), as carried by custom_interfaces/msg/PackedOccupancyGrid.
+// Each cell becomes a 2-bit code: 0 free, 1 occupied, 2 unknown.
+enum class PackedEncoding : uint8_t
+{
+  k2Bit = 0,  // 4 cells per byte, cell i in bits 2 * (i % 4) and up
+  kRle = 1,   // runs of one code, each a LEB128 varint of (length << 2 | code)
+};
+
+// Whether every cell is free, occupied or unknown, i.e. packable.
+bool is_trinary(const int8_t * cells, size_t count);
+
+// Bytes the 2-bit encoding of `count` cells takes.
+inline size_t packed_2bit_size(size_t count) {return (count + 3) / 4;}
+
+// Writes packed_2bit_size(count) bytes to `out`. Throws
+// std::invalid_argument when a cell is not trinary.
+void pack_2bit(const int8_t * cells, size_t count, uint8_t * out);
+
+// Expands `count` cells from `data`, which must hold packed_2bit_size(count)
+// bytes; the unused code 3 reads as unknown. Uses AVX2 when the CPU has it
+// (checked once at runtime) or NEON on ARM, 32 or 16 cells per step.
+void unpack_2bit(const uint8_t * data, size_t count, int8_t * out);
+
+// Same expansion one cell at a time; the reference for benchmarks.
+void unpack_2bit_scalar(const uint8_t * data, size_t count, int8_t * out);
+
+// Name of the kernel unpack_2bit dispatches to: "avx2", "neon" or "scalar".
+const char * unpack_2bit_kernel();
+
+// Replaces `out` with the run-length encoding of the cells. Throws
+// std::invalid_argument when a cell is not trinary.
+void encode_rle(const int8_t * cells, size_t count, std::vector<uint8_t> & out);
+
+// Expands run-length `data` into exactly `count` cells. Throws
+// std::runtime_error when the runs are malformed or do not add up to count.
+void decode_rle(const uint8_t * data, size_t size, size_t count, int8_t * out);
+
+}  // namespace rm_map_tools
+
+#endif  // RM_MAP_TOOLS__PACKED_GRID_HPP_
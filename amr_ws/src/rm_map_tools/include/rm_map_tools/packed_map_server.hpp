@@ -0,0 +1,27 @@
+#ifndef RM_MAP_TOOLS__PACKED_MAP_SERVER_HPP_
+#define RM_MAP_TOOLS__PACKED_MAP_SERVER_HPP_
+
+#include "rclcpp/rclcpp.hpp"
+#include "custom_interfaces/msg/packed_occupancy_grid.hpp"
+
+namespace rm_map_tools
+{
+
+// Latches a trinary map (`yaml_filename`, as nav2_map_server takes it) on
+// map_packed as a PackedOccupancyGrid, a quarter of the raw grid or less,
+// so late joiners such as the costmaps' PackedStaticLayer receive it without
+// the full int8 transfer. `encoding` is "auto" (the smaller of the two),
+// "2bit" or "rle". Throws std::invalid_argument when the map is missing or
+// not trinary.
+class PackedMapServer : public rclcpp::Node
+{
+public:
+  explicit PackedMapServer(const rclcpp::NodeOptions & options = rclcpp::NodeOptions());
+
+private:
+  rclcpp::Publisher<custom_interfaces::msg::PackedOccupancyGrid>::SharedPtr map_pub_;
+};
+
+}  // namespace rm_map_tools
+
+#endif  // RM_MAP_TOOLS__PACKED_MAP_SERVER_HPP_
@@ -0,0 +1,32 @@
+#ifndef RM_MAP_TOOLS__PACKED_STATIC_LAYER_HPP_
+#define RM_MAP_TOOLS__PACKED_STATIC_LAYER_HPP_
+
+#include "custom_interfaces/msg/packed_occupancy_grid.hpp"
+#include "nav2_costmap_2d/static_layer.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+namespace rm_map_tools
+{
+
+// nav2_costmap_2d::StaticLayer that takes its map as a PackedOccupancyGrid
+// (see packed_map_server) on `packed_map_topic`, default map_packed, instead
+// of an OccupancyGrid on map_topic; every other parameter, including
+// map_subscribe_transient_local and subscribe_to_updates, works as in
+// StaticLayer. List it in a costmap's plugins in place of static_layer:
+//   plugins: ["packed_static_layer", ...]
+//   packed_static_layer:
+//     plugin: "rm_map_tools::PackedStaticLayer"
+class PackedStaticLayer : public nav2_costmap_2d::StaticLayer
+{
+public:
+  void onInitialize() override;
+
+private:
+  void incomingPackedMap(const custom_interfaces::msg::PackedOccupancyGrid::SharedPtr msg);
+
+  rclcpp::Subscription<custom_interfaces::msg::PackedOccupancyGrid>::SharedPtr packed_map_sub_;
+};
+
+}  // namespace rm_map_tools
+
+#endif  // RM_MAP_TOOLS__PACKED_STATIC_LAYER_HPP_
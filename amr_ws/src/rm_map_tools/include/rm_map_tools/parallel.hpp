@@ -0,0 +1,41 @@
+#ifndef RM_MAP_TOOLS__PARALLEL_HPP_
+#define RM_MAP_TOOLS__PARALLEL_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace rm_map_tools
+{
+
+// Runs fn(begin, end) on contiguous chunks of [0, count), one chunk per
+// thread with the calling thread taking the first. `threads` 0 means every
+// hardware thread.
+template<typename Fn>
+void parallel_for(uint32_t count, unsigned threads, Fn && fn)
+{
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  const uint32_t chunks = std::max(1u, std::min<uint32_t>(threads, count));
+  if (chunks == 1) {
+    fn(0u, count);
+    return;
+  }
+  std::vector<std::thread> workers;
+  workers.reserve(chunks - 1);
+  for (uint32_t c = 1; c < chunks; ++c) {
+    const uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(count) * c / chunks);
+    const uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(count) * (c + 1) / chunks);
+    workers.emplace_back([&fn, begin, end]() {fn(begin, end);});
+  }
+  fn(0u, static_cast<uint32_t>(static_cast<uint64_t>(count) / chunks));
+  for (auto & worker : workers) {
+    worker.join();
+  }
+}
+
+}  // namespace rm_map_tools
+
+#endif  // RM_MAP_TOOLS__PARALLEL_HPP_
@@ -0,0 +1,49 @@
+#ifndef RM_MAP_TOOLS__TILE_SERVER_HPP_
+#define RM_MAP_TOOLS__TILE_SERVER_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "rclcpp/rclcpp.hpp"
+#include "geometry_msgs/msg/pose_with_covariance_stamped.hpp"
+#include "nav_msgs/msg/occupancy_grid.hpp"
+#include "rm_map_tools/tiled_map.hpp"
+
+namespace rm_map_tools
+{
+
+// Serves a tiled map (see map_tiler) around the robot instead of latching
+// the whole grid. Every pose on `amcl_pose` selects the tiles within
+// `radius` metres; when that set changes, the window they cover is published
+// on map_window (transient local, so late joiners get the current one) and
+// each tile that just entered it on map_tiles. Until the first pose the
+// window is centred on (initial_x, initial_y). Memory and traffic follow the
+// working area: only the tiles read are paged in, and a tile is sent again
+// only after it has left the window.
+class TileServer : public rclcpp::Node
+{
+public:
+  explicit TileServer(const rclcpp::NodeOptions & options = rclcpp::NodeOptions());
+
+private:
+  void pose_callback(const geometry_msgs::msg::PoseWithCovarianceStamped::SharedPtr msg);
+  void serve(double x, double y);
+
+  std::unique_ptr<TiledMap> map_;
+  std::string frame_id_;
+  double radius_;
+  bool has_window_;
+  TileRange window_;
+  uint64_t tiles_sent_;
+
+  rclcpp::Subscription<geometry_msgs::msg::PoseWithCovarianceStamped>::SharedPtr pose_sub_;
+  rclcpp::Publisher<nav_msgs::msg::OccupancyGrid>::SharedPtr window_pub_;
+  rclcpp::Publisher<nav_msgs::msg::OccupancyGrid>::SharedPtr tile_pub_;
+  nav_msgs::msg::OccupancyGrid window_msg_;
+  nav_msgs::msg::OccupancyGrid tile_msg_;
+};
+
+}  // namespace rm_map_tools
+
+#endif  // RM_MAP_TOOLS__TILE_SERVER_HPP_
@@ -0,0 +1,106 @@
+#ifndef RM_MAP_TOOLS__TILED_MAP_HPP_
+#define RM_MAP_TOOLS__TILED_MAP_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "rm_map_tools/mapped_file.hpp"
+#include "rm_map_tools/mapped_map.hpp"
+
+namespace rm_map_tools
+{
+
+// A map cut into square tiles of already converted OccupancyGrid values.
+// On disk it is a directory with two files:
+//
+//   manifest.yaml  format_version, tile_size, width, height, resolution,
+//                  origin, tiles (data file name), plus the source map for
+//                  reference
+//   tiles.bin      64-byte header ("RMTILES", version, tile_size, width,
+//                  height, tiles_x, tiles_y, stored tile count), an index of
+//                  one uint32 per tile (0 for a tile with no known cell,
+//                  else its slot + 1), then page-aligned slots of
+//                  tile_size * tile_size int8 cells
+//
+// Tiles are numbered like cells: tile (0, 0) holds the lower-left cell, and
+// each slot is in row order starting from its lowest row. Cells of the last
+// column and row of tiles that fall outside the map are unknown (-1).
+// Integers are in host byte order.
+struct TiledMapInfo
+{
+  uint32_t tile_size = 0;
+  uint32_t width = 0;   // in cells
+  uint32_t height = 0;
+  uint32_t tiles_x = 0;
+  uint32_t tiles_y = 0;
+  uint32_t stored_tiles = 0;  // tiles with at least one known cell
+  double resolution = 0.0;
+  double origin[3] = {0.0, 0.0, 0.0};  // x, y, yaw of the lower-left cell
+};
+
+constexpr uint32_t kTiledMapVersion = 1;
+
+// Inclusive tile bounds.
+struct TileRange
+{
+  uint32_t x0, y0, x1, y1;
+
+  bool contains(uint32_t tx, uint32_t ty) const
+  {
+    return tx >= x0 && tx <= x1 && ty >= y0 && ty <= y1;
+  }
+  bool operator==(const TileRange & other) const
+  {
+    return x0 == other.x0 && y0 == other.y0 && x1 == other.x1 && y1 == other.y1;
+  }
+};
+
+// Tiles within `radius` metres of (x, y) in the map frame, clamped to the
+// map: a point outside it still gets the nearest tiles.
+TileRange tiles_around(const TiledMapInfo & info, double x, double y, double radius);
+
+// Cuts `map` into tiles of `tile_size` cells and writes `directory`
+// (created when missing). Tiles are decoded one row of tiles at a time, so
+// memory stays at tile_size map rows whatever the map size. tiles.bin is
+// written under a temporary name and renamed, so a server reading the old
+// one is not disturbed. Throws std::invalid_argument for a zero tile_size and
+// std::system_error on I/O errors.
+TiledMapInfo write_tiled_map(
+  const MappedMap & map, const std::string & source_yaml, const std::string & directory,
+  uint32_t tile_size);
+
+// Read side of the format: tiles.bin is memory-mapped and a tile costs
+// nothing until its cells are read.
+class TiledMap
+{
+public:
+  // `path` is the tile directory or its manifest.yaml. Throws
+  // std::runtime_error when the manifest and tiles.bin are malformed or
+  // disagree, and std::system_error when tiles.bin cannot be mapped.
+  explicit TiledMap(const std::string & path);
+
+  const TiledMapInfo & info() const {return info_;}
+  uint32_t width() const {return info_.width;}
+  uint32_t height() const {return info_.height;}
+
+  // Cells of tile (tx, ty), tile_size * tile_size values, or nullptr when no
+  // cell of the tile is known. Throws std::out_of_range for a missing tile.
+  const int8_t * tile(uint32_t tx, uint32_t ty) const;
+
+  // Cells [x, x + w) x [y, y + h) into `out`, `stride` values apart from one
+  // row to the next, touching only the tiles that overlap the region. Throws
+  // std::out_of_range when the region does not fit in the map.
+  void decode_region(
+    uint32_t x, uint32_t y, uint32_t w, uint32_t h, int8_t * out, size_t stride) const;
+
+private:
+  TiledMapInfo info_;
+  MappedFile file_;
+  const uint32_t * index_;
+  const int8_t * slots_;
+};
+
+}  // namespace rm_map_tools
+
+#endif  // RM_MAP_TOOLS__TILED_MAP_HPP_
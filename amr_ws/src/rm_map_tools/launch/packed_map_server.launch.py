@@ -0,0 +1,31 @@
+from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument
+from launch.substitutions import LaunchConfiguration
+from launch_ros.actions import Node
+
+
+# Latches a trinary map on map_packed as a PackedOccupancyGrid. Costmaps
+# read it through the PackedStaticLayer plugin, by setting in their
+# static_layer
+#   plugin: "rm_map_tools::PackedStaticLayer"
+# in place of nav2_costmap_2d::StaticLayer.
+def generate_launch_description():
+    ld = LaunchDescription()
+    ld.add_action(DeclareLaunchArgument('use_sim_time', default_value='true'))
+    ld.add_action(DeclareLaunchArgument(
+        'map',
+        description='YAML of a map saved with mode: trinary'))
+    ld.add_action(DeclareLaunchArgument(
+        'encoding', default_value='auto',
+        description='auto (the smaller), 2bit or rle'))
+    ld.add_action(Node(
+        package='rm_map_tools',
+        executable='packed_map_server',
+        name='packed_map_server',
+        parameters=[{
+            'use_sim_time': LaunchConfiguration('use_sim_time'),
+            'yaml_filename': LaunchConfiguration('map'),
+            'encoding': LaunchConfiguration('encoding'),
+        }],
+        output='screen'))
+    return ld
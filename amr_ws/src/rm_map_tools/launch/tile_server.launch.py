@@ -0,0 +1,32 @@
+from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument
+from launch.substitutions import LaunchConfiguration
+from launch_ros.actions import Node
+
+
+# Serves a map_tiler directory around the AMCL pose on map_window and
+# map_tiles. Make the tiles once with
+#   ros2 run rm_map_tools map_tiler my_map.yaml my_map_tiles
+# then pass tiles:=.../my_map_tiles, and point consumers that only need the
+# surroundings (e.g. a costmap static layer's map_topic) at map_window
+# instead of the latched /map.
+def generate_launch_description():
+    ld = LaunchDescription()
+    ld.add_action(DeclareLaunchArgument('use_sim_time', default_value='true'))
+    ld.add_action(DeclareLaunchArgument(
+        'tiles',
+        description='Directory written by map_tiler'))
+    ld.add_action(DeclareLaunchArgument(
+        'radius', default_value='10.0',
+        description='Metres around the robot whose tiles are served'))
+    ld.add_action(Node(
+        package='rm_map_tools',
+        executable='tile_server',
+        name='tile_server',
+        parameters=[{
+            'use_sim_time': LaunchConfiguration('use_sim_time'),
+            'map': LaunchConfiguration('tiles'),
+            'radius': LaunchConfiguration('radius'),
+        }],
+        output='screen'))
+    return ld
@@ -0,0 +1,176 @@
+#include "rm_map_tools/cell_conversion.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define RM_MAP_TOOLS_HAVE_AVX2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RM_MAP_TOOLS_HAVE_NEON 1
+#endif
+
+namespace rm_map_tools
+{
+
+namespace
+{
+
+// nav2_map_server's map_io for one pixel, `shade` in [0, 1].
+int8_t occupancy_of(const MapMetadata & metadata, double shade)
+{
+  const double occ = metadata.negate ? shade : 1.0 - shade;
+  switch (metadata.mode) {
+    case MapMode::kTrinary:
+      if (metadata.occupied_thresh < occ) {
+        return kOccupied;
+      }
+      return occ < metadata.free_thresh ? kFree : kUnknown;
+    case MapMode::kScale:
+      if (metadata.occupied_thresh < occ) {
+        return kOccupied;
+      }
+      if (occ < metadata.free_thresh) {
+        return kFree;
+      }
+      return static_cast<int8_t>(
+        std::rint(
+          (occ - metadata.free_thresh) /
+          (metadata.occupied_thresh - metadata.free_thresh) * 100.0));
+    case MapMode::kRaw:
+      {
+        const double value = std::round(shade * 255.0);
+        return value >= kFree && value <= kOccupied ? static_cast<int8_t>(value) : kUnknown;
+      }
+  }
+  return kUnknown;
+}
+
+void convert_scalar(const CellTable & table, const uint8_t * pixels, size_t count, int8_t * out)
+{
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = table.value[pixels[i]];
+  }
+}
+
+#if defined(RM_MAP_TOOLS_HAVE_AVX2)
+
+// Converts whole blocks of 32 pixels; returns the first pixel left over.
+__attribute__((target("avx2")))
+size_t convert_avx2(const CellTable & table, const uint8_t * pixels, size_t count, int8_t * out)
+{
+  const __m256i low_max = _mm256_set1_epi8(static_cast<char>(table.low_max));
+  const __m256i high_min = _mm256_set1_epi8(static_cast<char>(table.high_min));
+  const __m256i low = _mm256_set1_epi8(table.low);
+  const __m256i mid = _mm256_set1_epi8(table.mid);
+  const __m256i high = _mm256_set1_epi8(table.high);
+  size_t i = 0;
+  for (; i + 32 <= count; i += 32) {
+    const __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pixels + i));
+    // Unsigned byte compares through min/max, which AVX2 has for epu8.
+    const __m256i is_low = _mm256_cmpeq_epi8(_mm256_max_epu8(p, low_max), low_max);
+    const __m256i is_high = _mm256_cmpeq_epi8(_mm256_min_epu8(p, high_min), high_min);
+    const __m256i cells = _mm256_blendv_epi8(_mm256_blendv_epi8(mid, low, is_low), high, is_high);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), cells);
+  }
+  return i;
+}
+
+bool cpu_has_avx2()
+{
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+}
+
+#elif defined(RM_MAP_TOOLS_HAVE_NEON)
+
+size_t convert_neon(const CellTable & table, const uint8_t * pixels, size_t count, int8_t * out)
+{
+  const uint8x16_t low_max = vdupq_n_u8(table.low_max);
+  const uint8x16_t high_min = vdupq_n_u8(table.high_min);
+  const int8x16_t low = vdupq_n_s8(table.low);
+  const int8x16_t mid = vdupq_n_s8(table.mid);
+  const int8x16_t high = vdupq_n_s8(table.high);
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const uint8x16_t p = vld1q_u8(pixels + i);
+    const int8x16_t cells = vbslq_s8(
+      vcgeq_u8(p, high_min), high, vbslq_s8(vcleq_u8(p, low_max), low, mid));
+    vst1q_s8(out + i, cells);
+  }
+  return i;
+}
+
+#endif
+
+using Kernel = size_t (*)(const CellTable &, const uint8_t *, size_t, int8_t *);
+
+Kernel vector_kernel()
+{
+#if defined(RM_MAP_TOOLS_HAVE_AVX2)
+  return cpu_has_avx2() ? &convert_avx2 : nullptr;
+#elif defined(RM_MAP_TOOLS_HAVE_NEON)
+  return &convert_neon;
+#else
+  return nullptr;
+#endif
+}
+
+}  // namespace
+
+CellTable make_cell_table(const MapMetadata & metadata, unsigned maxval)
+{
+  CellTable table;
+  maxval = std::max(1u, std::min(maxval, 255u));
+  for (unsigned p = 0; p < 256; ++p) {
+    table.value[p] = occupancy_of(metadata, std::min(p, maxval) / static_cast<double>(maxval));
+  }
+
+  // Runs of equal values; three at most make the table vectorizable.
+  unsigned run_starts[4];
+  unsigned runs = 0;
+  for (unsigned p = 0; p < 256 && runs < 4; ++p) {
+    if (p == 0 || table.value[p] != table.value[p - 1]) {
+      run_starts[runs++] = p;
+    }
+  }
+  table.three_level = runs <= 3;
+  if (!table.three_level) {
+    table.low_max = table.high_min = 0;
+    table.low = table.mid = table.high = kUnknown;
+    return table;
+  }
+  table.low = table.value[0];
+  table.high = table.value[255];
+  table.low_max = static_cast<uint8_t>(runs > 1 ? run_starts[1] - 1 : 255);
+  table.high_min = static_cast<uint8_t>(runs > 1 ? run_starts[runs - 1] : 255);
+  table.mid = runs == 3 ? table.value[run_starts[1]] : table.low;
+  return table;
+}
+
+void convert_cells(const CellTable & table, const uint8_t * pixels, size_t count, int8_t * out)
+{
+  static const Kernel kernel = vector_kernel();
+  const size_t done = kernel && table.three_level ? kernel(table, pixels, count, out) : 0;
+  convert_scalar(table, pixels + done, count - done, out + done);
+}
+
+void convert_cells_scalar(
+  const CellTable & table, const uint8_t * pixels, size_t count, int8_t * out)
+{
+  convert_scalar(table, pixels, count, out);
+}
+
+const char * convert_cells_kernel()
+{
+#if defined(RM_MAP_TOOLS_HAVE_AVX2)
+  return cpu_has_avx2() ? "avx2" : "scalar";
+#elif defined(RM_MAP_TOOLS_HAVE_NEON)
+  return "neon";
+#else
+  return "scalar";
+#endif
+}
+
+}  // namespace rm_map_tools
@@ -0,0 +1,168 @@
+#include "rm_map_tools/distance_field.hpp"
+
+#include <limits.h>
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include "rm_map_tools/distance_transform.hpp"
+
+namespace rm_map_tools
+{
+
+namespace
+{
+
+constexpr char kMagic[8] = {'R', 'M', 'E', 'D', 'T', '\0', '\0', '\0'};
+constexpr size_t kDataOffset = 4096;
+
+struct FileHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t width;
+  uint32_t height;
+  uint32_t reserved;
+  uint64_t fingerprint;
+  double resolution;
+  double origin[3];
+};
+static_assert(sizeof(FileHeader) == 64, "distance field header must stay 64 bytes");
+
+// $XDG_CACHE_HOME/rm_map_tools, else ~/.cache/rm_map_tools, else (no home)
+// a directory under /tmp.
+std::string cache_directory()
+{
+  const char * cache = std::getenv("XDG_CACHE_HOME");
+  if (cache && cache[0] == '/') {
+    return std::string(cache) + "/rm_map_tools";
+  }
+  const char * home = std::getenv("HOME");
+  if (home && home[0] == '/') {
+    return std::string(home) + "/.cache/rm_map_tools";
+  }
+  return "/tmp/rm_map_tools";
+}
+
+// mkdir -p of the directory that holds `path`.
+void make_parent_directories(const std::string & path)
+{
+  for (size_t slash = path.find('/', 1); slash != std::string::npos;
+    slash = path.find('/', slash + 1))
+  {
+    const std::string directory = path.substr(0, slash);
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+      throw std::system_error(errno, std::generic_category(), "mkdir " + directory);
+    }
+  }
+}
+
+}  // namespace
+
+DistanceField::DistanceField(const std::string & path)
+: file_(path, MappedFile::Access::kRandom),
+  width_(0), height_(0), fingerprint_(0), resolution_(0.0), origin_{0.0, 0.0, 0.0},
+  data_(nullptr)
+{
+  FileHeader header;
+  if (file_.size() < kDataOffset) {
+    throw std::runtime_error(path + ": truncated distance field");
+  }
+  std::memcpy(&header, file_.data(), sizeof(header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    throw std::runtime_error(path + ": not a distance field");
+  }
+  if (header.version != kDistanceFieldVersion) {
+    throw std::runtime_error(
+      path + ": version " + std::to_string(header.version) + ", expected " +
+      std::to_string(kDistanceFieldVersion));
+  }
+  if (file_.size() < kDataOffset + static_cast<size_t>(header.width) * header.height * 4) {
+    throw std::runtime_error(path + ": truncated distance field");
+  }
+  width_ = header.width;
+  height_ = header.height;
+  fingerprint_ = header.fingerprint;
+  resolution_ = header.resolution;
+  std::memcpy(origin_, header.origin, sizeof(origin_));
+  data_ = reinterpret_cast<const float *>(file_.data() + kDataOffset);
+}
+
+std::string distance_field_path(const std::string & yaml_path)
+{
+  char resolved[PATH_MAX];
+  const std::string absolute = realpath(yaml_path.c_str(), resolved) ? resolved : yaml_path;
+  // FNV-1a of the map's absolute path, so maps that share a name do not
+  // share a cache.
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (unsigned char c : absolute) {
+    hash = (hash ^ c) * 0x100000001b3ULL;
+  }
+  const std::string stem = map_companion_path(absolute.substr(absolute.find_last_of('/') + 1), "");
+  char suffix[32];
+  std::snprintf(suffix, sizeof(suffix), "-%016" PRIx64 ".edt", hash);
+  return cache_directory() + "/" + stem + suffix;
+}
+
+void write_distance_field(const MappedMap & map, const std::string & path, unsigned threads)
+{
+  const size_t cells = static_cast<size_t>(map.width()) * map.height();
+  make_parent_directories(path);
+  OutputMappedFile file(path, kDataOffset + cells * sizeof(float));
+  float * distances = reinterpret_cast<float *>(file.data() + kDataOffset);
+  {
+    std::vector<int8_t> occupancy(cells);
+    map.decode(occupancy.data());
+    distance_transform(occupancy.data(), map.width(), map.height(), distances, threads);
+  }
+  const float resolution = static_cast<float>(map.metadata().resolution);
+  for (size_t i = 0; i < cells; ++i) {
+    distances[i] *= resolution;
+  }
+
+  FileHeader header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kDistanceFieldVersion;
+  header.width = map.width();
+  header.height = map.height();
+  header.fingerprint = map_fingerprint(map);
+  header.resolution = map.metadata().resolution;
+  std::memcpy(header.origin, map.metadata().origin, sizeof(header.origin));
+  std::memcpy(file.data(), &header, sizeof(header));
+  file.commit();
+}
+
+std::unique_ptr<DistanceField> load_distance_field(
+  const std::string & yaml_path, unsigned threads, bool * rebuilt)
+{
+  const MappedMap map(yaml_path);
+  const std::string path = distance_field_path(yaml_path);
+  const uint64_t fingerprint = map_fingerprint(map);
+  try {
+    auto field = std::make_unique<DistanceField>(path);
+    if (field->fingerprint() == fingerprint && field->width() == map.width() &&
+      field->height() == map.height())
+    {
+      if (rebuilt) {
+        *rebuilt = false;
+      }
+      return field;
+    }
+  } catch (const std::exception &) {
+    // Missing, unreadable or of another version: rebuild below.
+  }
+  write_distance_field(map, path, threads);
+  if (rebuilt) {
+    *rebuilt = true;
+  }
+  return std::make_unique<DistanceField>(path);
+}
+
+}  // namespace rm_map_tools
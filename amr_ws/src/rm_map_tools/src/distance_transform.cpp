@@ -0,0 +1,168 @@
+#include "rm_map_tools/distance_transform.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "rm_map_tools/cell_conversion.hpp"
+#include "rm_map_tools/parallel.hpp"
+
+namespace rm_map_tools
+{
+
+namespace
+{
+
+constexpr float kInfinity = std::numeric_limits<float>::infinity();
+// Columns handled together in the column pass: 64 bytes of floats.
+constexpr uint32_t kColumnBlock = 16;
+
+// Distance along the row to the nearest occupied cell of the same row.
+void row_pass(const int8_t * cells, uint32_t width, float * out)
+{
+  float last = kInfinity;
+  for (uint32_t x = 0; x < width; ++x) {
+    last = cells[x] == kOccupied ? 0.0f : last + 1.0f;
+    out[x] = last;
+  }
+  last = kInfinity;
+  for (uint32_t x = width; x-- > 0; ) {
+    last = cells[x] == kOccupied ? 0.0f : last + 1.0f;
+    out[x] = std::min(out[x], last);
+  }
+}
+
+// Lower envelope of the parabolas (y - q)^2 + f[q] over the finite f[q],
+// evaluated at every y; squared distances in `f` are replaced by distances.
+// Integer squares stay exact in double for any map that fits in memory.
+class ColumnPass
+{
+public:
+  explicit ColumnPass(uint32_t height)
+  : f_(height), v_(height), z_(static_cast<size_t>(height) + 1) {}
+
+  // `column` holds row distances on entry and final distances on return.
+  void run(float * column, uint32_t height)
+  {
+    int64_t k = -1;
+    for (uint32_t q = 0; q < height; ++q) {
+      if (column[q] == kInfinity) {
+        continue;
+      }
+      f_[q] = static_cast<double>(column[q]) * column[q];
+      const double fq = f_[q] + static_cast<double>(q) * q;
+      if (k < 0) {
+        k = 0;
+        v_[0] = q;
+        z_[0] = -std::numeric_limits<double>::infinity();
+        z_[1] = std::numeric_limits<double>::infinity();
+        continue;
+      }
+      double s;
+      while (true) {
+        const uint32_t p = v_[k];
+        s = (fq - (f_[p] + static_cast<double>(p) * p)) / (2.0 * (static_cast<double>(q) - p));
+        if (s > z_[k]) {
+          break;
+        }
+        // z_[0] is -inf, so the envelope never empties.
+        --k;
+      }
+      ++k;
+      v_[k] = q;
+      z_[k] = s;
+      z_[k + 1] = std::numeric_limits<double>::infinity();
+    }
+    if (k < 0) {
+      return;  // no obstacle in any row distance of this column: all +inf already
+    }
+    k = 0;
+    for (uint32_t y = 0; y < height; ++y) {
+      while (z_[k + 1] < y) {
+        ++k;
+      }
+      const double dy = static_cast<double>(y) - v_[k];
+      column[y] = static_cast<float>(std::sqrt(dy * dy + f_[v_[k]]));
+    }
+  }
+
+private:
+  std::vector<double> f_;
+  std::vector<uint32_t> v_;
+  std::vector<double> z_;
+};
+
+}  // namespace
+
+void distance_transform(
+  const int8_t * cells, uint32_t width, uint32_t height, float * out, unsigned threads)
+{
+  if (width == 0 || height == 0) {
+    return;
+  }
+
+  parallel_for(
+    height, threads, [&](uint32_t begin, uint32_t end) {
+      for (uint32_t y = begin; y < end; ++y) {
+        const size_t offset = static_cast<size_t>(y) * width;
+        row_pass(cells + offset, width, out + offset);
+      }
+    });
+
+  const uint32_t blocks = (width + kColumnBlock - 1) / kColumnBlock;
+  parallel_for(
+    blocks, threads, [&](uint32_t begin, uint32_t end) {
+      ColumnPass pass(height);
+      // Column-major copy of one block, so each column is contiguous.
+      std::vector<float> block(static_cast<size_t>(kColumnBlock) * height);
+      for (uint32_t b = begin; b < end; ++b) {
+        const uint32_t x0 = b * kColumnBlock;
+        const uint32_t columns = std::min(kColumnBlock, width - x0);
+        for (uint32_t y = 0; y < height; ++y) {
+          const float * row = out + static_cast<size_t>(y) * width + x0;
+          for (uint32_t c = 0; c < columns; ++c) {
+            block[static_cast<size_t>(c) * height + y] = row[c];
+          }
+        }
+        for (uint32_t c = 0; c < columns; ++c) {
+          pass.run(block.data() + static_cast<size_t>(c) * height, height);
+        }
+        for (uint32_t y = 0; y < height; ++y) {
+          float * row = out + static_cast<size_t>(y) * width + x0;
+          for (uint32_t c = 0; c < columns; ++c) {
+            row[c] = block[static_cast<size_t>(c) * height + y];
+          }
+        }
+      }
+    });
+}
+
+void distance_transform_brute_force(
+  const int8_t * cells, uint32_t width, uint32_t height, float * out)
+{
+  std::vector<std::pair<int64_t, int64_t>> obstacles;
+  for (uint32_t y = 0; y < height; ++y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      if (cells[static_cast<size_t>(y) * width + x] == kOccupied) {
+        obstacles.emplace_back(x, y);
+      }
+    }
+  }
+  for (uint32_t y = 0; y < height; ++y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      int64_t best = std::numeric_limits<int64_t>::max();
+      for (const auto & obstacle : obstacles) {
+        const int64_t dx = obstacle.first - x;
+        const int64_t dy = obstacle.second - y;
+        best = std::min(best, dx * dx + dy * dy);
+      }
+      out[static_cast<size_t>(y) * width + x] = obstacles.empty() ?
+        kInfinity : static_cast<float>(std::sqrt(static_cast<double>(best)));
+    }
+  }
+}
+
+}  // namespace rm_map_tools
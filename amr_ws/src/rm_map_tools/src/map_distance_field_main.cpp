@@ -0,0 +1,58 @@
+// Makes sure the distance-field cache of a map (see
+// rm_map_tools/distance_field.hpp) exists and matches the map, rebuilding it
+// when it is missing or stale, so the transform only runs when the map has
+// changed. amcl.launch.py runs it with distance_field:=true.
+//
+//   ros2 run rm_map_tools map_distance_field <map.yaml> [threads] [--force]
+//
+// threads defaults to every hardware thread.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+
+#include "rm_map_tools/distance_field.hpp"
+
+int main(int argc, char ** argv)
+{
+  std::string yaml;
+  unsigned threads = 0;
+  bool force = false;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--ros-args") == 0) {
+      break;
+    } else if (std::strcmp(argv[i], "--force") == 0) {
+      force = true;
+    } else if (yaml.empty()) {
+      yaml = argv[i];
+    } else {
+      threads = static_cast<unsigned>(std::strtoul(argv[i], nullptr, 10));
+    }
+  }
+  if (yaml.empty()) {
+    std::fprintf(stderr, "usage: %s <map.yaml> [threads] [--force]\n", argv[0]);
+    return 2;
+  }
+
+  try {
+    const auto start = std::chrono::steady_clock::now();
+    bool rebuilt = true;
+    if (force) {
+      rm_map_tools::write_distance_field(
+        rm_map_tools::MappedMap(yaml), rm_map_tools::distance_field_path(yaml), threads);
+    }
+    const auto field = rm_map_tools::load_distance_field(yaml, threads, force ? nullptr : &rebuilt);
+    const double elapsed_ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start).count();
+    std::printf(
+      "%s: %ux%u cells, %s (%.1f ms)\n", rm_map_tools::distance_field_path(yaml).c_str(),
+      field->width(), field->height(), rebuilt ? "rebuilt" : "up to date", elapsed_ms);
+  } catch (const std::exception & error) {
+    std::fprintf(stderr, "%s\n", error.what());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,84 @@
+#include "rm_map_tools/map_metadata.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+#include "yaml-cpp/yaml.h"
+
+namespace rm_map_tools
+{
+
+namespace
+{
+
+template<typename T>
+T required(const YAML::Node & node, const char * key, const std::string & path)
+{
+  if (!node[key]) {
+    throw std::runtime_error(path + ": missing '" + key + "'");
+  }
+  return node[key].as<T>();
+}
+
+}  // namespace
+
+MapMetadata load_map_metadata(const std::string & yaml_path)
+{
+  YAML::Node doc;
+  try {
+    doc = YAML::LoadFile(yaml_path);
+  } catch (const YAML::Exception & error) {
+    throw std::runtime_error(yaml_path + ": " + error.what());
+  }
+
+  MapMetadata metadata;
+  metadata.image = required<std::string>(doc, "image", yaml_path);
+  if (metadata.image.empty()) {
+    throw std::runtime_error(yaml_path + ": empty 'image'");
+  }
+  if (metadata.image.front() != '/') {
+    const auto slash = yaml_path.find_last_of('/');
+    if (slash != std::string::npos) {
+      metadata.image = yaml_path.substr(0, slash + 1) + metadata.image;
+    }
+  }
+  metadata.resolution = required<double>(doc, "resolution", yaml_path);
+  const auto origin = required<std::vector<double>>(doc, "origin", yaml_path);
+  if (origin.size() != 3) {
+    throw std::runtime_error(yaml_path + ": 'origin' needs x, y and yaw");
+  }
+  for (size_t i = 0; i < 3; ++i) {
+    metadata.origin[i] = origin[i];
+  }
+  metadata.occupied_thresh = required<double>(doc, "occupied_thresh", yaml_path);
+  metadata.free_thresh = required<double>(doc, "free_thresh", yaml_path);
+  // Optional keys keep nav2_map_server's defaults.
+  if (doc["negate"]) {
+    metadata.negate = doc["negate"].as<int>() != 0;
+  }
+  if (doc["mode"]) {
+    const auto mode = doc["mode"].as<std::string>();
+    if (mode == "trinary") {
+      metadata.mode = MapMode::kTrinary;
+    } else if (mode == "scale") {
+      metadata.mode = MapMode::kScale;
+    } else if (mode == "raw") {
+      metadata.mode = MapMode::kRaw;
+    } else {
+      throw std::runtime_error(yaml_path + ": unknown mode '" + mode + "'");
+    }
+  }
+  return metadata;
+}
+
+const char * map_mode_name(MapMode mode)
+{
+  switch (mode) {
+    case MapMode::kTrinary: return "trinary";
+    case MapMode::kScale: return "scale";
+    case MapMode::kRaw: return "raw";
+  }
+  return "unknown";
+}
+
+}  // namespace rm_map_tools
@@ -0,0 +1,297 @@
+#include "rm_map_tools/map_pyramid.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "rm_map_tools/parallel.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define RM_MAP_TOOLS_HAVE_AVX2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RM_MAP_TOOLS_HAVE_NEON 1
+#endif
+
+namespace rm_map_tools
+{
+
+namespace
+{
+
+constexpr char kMagic[8] = {'R', 'M', 'P', 'Y', 'R', '\0', '\0', '\0'};
+constexpr size_t kPageSize = 4096;
+
+struct FileHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t levels;
+  uint32_t width;
+  uint32_t height;
+  uint64_t fingerprint;
+  double resolution;
+  double origin[3];
+};
+static_assert(sizeof(FileHeader) == 64, "pyramid header must stay 64 bytes");
+
+struct LevelEntry
+{
+  uint32_t width;
+  uint32_t height;
+  uint64_t offset;
+};
+static_assert(sizeof(LevelEntry) == 16, "pyramid level entry must stay 16 bytes");
+
+size_t page_align(size_t offset)
+{
+  return (offset + kPageSize - 1) / kPageSize * kPageSize;
+}
+
+// ceil(n / 2) without the overflow of (n + 1) / 2 at UINT32_MAX.
+uint32_t half_up(uint32_t n)
+{
+  return n / 2 + (n & 1);
+}
+
+// Output cells [begin, out_width) of one output row from input rows a and b
+// (the same row for the last one of an odd height).
+void pool_row_scalar(
+  const int8_t * a, const int8_t * b, uint32_t width, uint32_t begin, int8_t * out)
+{
+  const uint32_t pairs = width / 2;
+  for (uint32_t x = begin; x < pairs; ++x) {
+    out[x] = std::max(std::max(a[2 * x], a[2 * x + 1]), std::max(b[2 * x], b[2 * x + 1]));
+  }
+  if (width % 2 != 0 && begin <= pairs) {
+    out[pairs] = std::max(a[width - 1], b[width - 1]);
+  }
+}
+
+#if defined(RM_MAP_TOOLS_HAVE_AVX2)
+
+// Pools whole blocks of 64 input cells into 32; returns the first output
+// cell left over.
+__attribute__((target("avx2")))
+uint32_t pool_row_avx2(const int8_t * a, const int8_t * b, uint32_t width, int8_t * out)
+{
+  uint32_t x = 0;
+  for (; 2 * x + 64 <= width; x += 32) {
+    const __m256i lo = _mm256_max_epi8(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + 2 * x)),
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + 2 * x)));
+    const __m256i hi = _mm256_max_epi8(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + 2 * x + 32)),
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + 2 * x + 32)));
+    // Each 16-bit lane holds one horizontal pair: sign-extend both bytes,
+    // keep the larger, and pack the lanes back to bytes. The pack works per
+    // 128-bit half, so the 64-bit quarters need reordering afterwards.
+    const __m256i lo_max = _mm256_max_epi16(
+      _mm256_srai_epi16(_mm256_slli_epi16(lo, 8), 8), _mm256_srai_epi16(lo, 8));
+    const __m256i hi_max = _mm256_max_epi16(
+      _mm256_srai_epi16(_mm256_slli_epi16(hi, 8), 8), _mm256_srai_epi16(hi, 8));
+    const __m256i packed = _mm256_permute4x64_epi64(
+      _mm256_packs_epi16(lo_max, hi_max), _MM_SHUFFLE(3, 1, 2, 0));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + x), packed);
+  }
+  return x;
+}
+
+bool cpu_has_avx2()
+{
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+}
+
+#elif defined(RM_MAP_TOOLS_HAVE_NEON)
+
+uint32_t pool_row_neon(const int8_t * a, const int8_t * b, uint32_t width, int8_t * out)
+{
+  uint32_t x = 0;
+  for (; 2 * x + 32 <= width; x += 16) {
+    // vld2q splits even and odd cells into separate registers.
+    const int8x16x2_t pa = vld2q_s8(a + 2 * x);
+    const int8x16x2_t pb = vld2q_s8(b + 2 * x);
+    vst1q_s8(
+      out + x, vmaxq_s8(vmaxq_s8(pa.val[0], pa.val[1]), vmaxq_s8(pb.val[0], pb.val[1])));
+  }
+  return x;
+}
+
+#endif
+
+using Kernel = uint32_t (*)(const int8_t *, const int8_t *, uint32_t, int8_t *);
+
+Kernel vector_kernel()
+{
+#if defined(RM_MAP_TOOLS_HAVE_AVX2)
+  return cpu_has_avx2() ? &pool_row_avx2 : nullptr;
+#elif defined(RM_MAP_TOOLS_HAVE_NEON)
+  return &pool_row_neon;
+#else
+  return nullptr;
+#endif
+}
+
+}  // namespace
+
+void max_pool_2x2(
+  const int8_t * in, uint32_t width, uint32_t height, int8_t * out, unsigned threads)
+{
+  static const Kernel kernel = vector_kernel();
+  const uint32_t out_width = half_up(width);
+  const uint32_t out_height = half_up(height);
+  parallel_for(
+    out_height, threads, [&](uint32_t begin, uint32_t end) {
+      for (uint32_t y = begin; y < end; ++y) {
+        const int8_t * a = in + static_cast<size_t>(2 * y) * width;
+        const int8_t * b = 2 * y + 1 < height ? a + width : a;
+        int8_t * row = out + static_cast<size_t>(y) * out_width;
+        const uint32_t done = kernel ? kernel(a, b, width, row) : 0;
+        pool_row_scalar(a, b, width, done, row);
+      }
+    });
+}
+
+void max_pool_2x2_scalar(const int8_t * in, uint32_t width, uint32_t height, int8_t * out)
+{
+  const uint32_t out_width = half_up(width);
+  for (uint32_t y = 0; y < half_up(height); ++y) {
+    const int8_t * a = in + static_cast<size_t>(2 * y) * width;
+    const int8_t * b = 2 * y + 1 < height ? a + width : a;
+    pool_row_scalar(a, b, width, 0, out + static_cast<size_t>(y) * out_width);
+  }
+}
+
+const char * max_pool_kernel()
+{
+#if defined(RM_MAP_TOOLS_HAVE_AVX2)
+  return cpu_has_avx2() ? "avx2" : "scalar";
+#elif defined(RM_MAP_TOOLS_HAVE_NEON)
+  return "neon";
+#else
+  return "scalar";
+#endif
+}
+
+MapPyramid::MapPyramid(const std::string & path)
+: file_(path, MappedFile::Access::kRandom), fingerprint_(0), origin_{0.0, 0.0, 0.0}
+{
+  FileHeader header;
+  if (file_.size() < sizeof(header)) {
+    throw std::runtime_error(path + ": truncated pyramid");
+  }
+  std::memcpy(&header, file_.data(), sizeof(header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    throw std::runtime_error(path + ": not a map pyramid");
+  }
+  if (header.version != kMapPyramidVersion) {
+    throw std::runtime_error(
+      path + ": version " + std::to_string(header.version) + ", expected " +
+      std::to_string(kMapPyramidVersion));
+  }
+  if (header.levels == 0 || header.levels > kMaxPyramidLevels ||
+    file_.size() < sizeof(header) + header.levels * sizeof(LevelEntry))
+  {
+    throw std::runtime_error(path + ": malformed pyramid");
+  }
+  fingerprint_ = header.fingerprint;
+  std::memcpy(origin_, header.origin, sizeof(origin_));
+  for (uint32_t i = 0; i < header.levels; ++i) {
+    LevelEntry entry;
+    std::memcpy(
+      &entry, file_.data() + sizeof(header) + i * sizeof(LevelEntry), sizeof(entry));
+    if (entry.offset + static_cast<uint64_t>(entry.width) * entry.height > file_.size()) {
+      throw std::runtime_error(path + ": truncated pyramid");
+    }
+    levels_.push_back(
+      {entry.width, entry.height, header.resolution * static_cast<double>(1u << i),
+        reinterpret_cast<const int8_t *>(file_.data() + entry.offset)});
+  }
+}
+
+std::string map_pyramid_path(const std::string & yaml_path)
+{
+  return map_companion_path(yaml_path, ".pyr");
+}
+
+uint32_t pyramid_levels(uint32_t width, uint32_t height, uint32_t levels)
+{
+  uint32_t count = 1;
+  while (count < std::min(levels, kMaxPyramidLevels) && (width > 1 || height > 1)) {
+    width = half_up(width);
+    height = half_up(height);
+    ++count;
+  }
+  return count;
+}
+
+void write_map_pyramid(
+  const MappedMap & map, uint32_t levels, const std::string & path, unsigned threads)
+{
+  levels = pyramid_levels(map.width(), map.height(), levels);
+  std::vector<LevelEntry> entries(levels);
+  size_t offset = page_align(sizeof(FileHeader) + levels * sizeof(LevelEntry));
+  uint32_t width = map.width();
+  uint32_t height = map.height();
+  for (auto & entry : entries) {
+    entry.width = width;
+    entry.height = height;
+    entry.offset = offset;
+    offset = page_align(offset + static_cast<size_t>(width) * height);
+    width = half_up(width);
+    height = half_up(height);
+  }
+
+  OutputMappedFile file(path, offset);
+  int8_t * base = reinterpret_cast<int8_t *>(file.data());
+  map.decode(base + entries[0].offset);
+  for (uint32_t i = 1; i < levels; ++i) {
+    max_pool_2x2(
+      base + entries[i - 1].offset, entries[i - 1].width, entries[i - 1].height,
+      base + entries[i].offset, threads);
+  }
+
+  FileHeader header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kMapPyramidVersion;
+  header.levels = levels;
+  header.width = map.width();
+  header.height = map.height();
+  header.fingerprint = map_fingerprint(map);
+  header.resolution = map.metadata().resolution;
+  std::memcpy(header.origin, map.metadata().origin, sizeof(header.origin));
+  std::memcpy(file.data(), &header, sizeof(header));
+  std::memcpy(file.data() + sizeof(header), entries.data(), levels * sizeof(LevelEntry));
+  file.commit();
+}
+
+std::unique_ptr<MapPyramid> load_map_pyramid(
+  const std::string & yaml_path, uint32_t levels, unsigned threads, bool * rebuilt)
+{
+  const MappedMap map(yaml_path);
+  const std::string path = map_pyramid_path(yaml_path);
+  const uint64_t fingerprint = map_fingerprint(map);
+  try {
+    auto pyramid = std::make_unique<MapPyramid>(path);
+    if (pyramid->fingerprint() == fingerprint &&
+      pyramid->levels() == pyramid_levels(map.width(), map.height(), levels) &&
+      pyramid->level(0).width == map.width() && pyramid->level(0).height == map.height())
+    {
+      if (rebuilt) {
+        *rebuilt = false;
+      }
+      return pyramid;
+    }
+  } catch (const std::exception &) {
+    // Missing, unreadable or of another version: rebuild below.
+  }
+  write_map_pyramid(map, levels, path, threads);
+  if (rebuilt) {
+    *rebuilt = true;
+  }
+  return std::make_unique<MapPyramid>(path);
+}
+
+}  // namespace rm_map_tools
@@ -0,0 +1,49 @@
+// Converts a map YAML and its PGM, as saved by rm_slam, into the tiled
+// format read by tile_server (see rm_map_tools/tiled_map.hpp).
+//
+//   ros2 run rm_map_tools map_tiler <map.yaml> <output_dir> [tile_size]
+//
+// tile_size is in cells and defaults to 256 (12.8 m at 0.05 m/cell).
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <string>
+
+#include "rm_map_tools/mapped_map.hpp"
+#include "rm_map_tools/tiled_map.hpp"
+
+int main(int argc, char ** argv)
+{
+  if (argc < 3) {
+    std::fprintf(stderr, "usage: %s <map.yaml> <output_dir> [tile_size]\n", argv[0]);
+    return 2;
+  }
+  const std::string yaml = argv[1];
+  const std::string directory = argv[2];
+  const int64_t tile_size = argc > 3 ? std::strtoll(argv[3], nullptr, 10) : 256;
+  if (tile_size <= 0 || tile_size > 4096) {
+    std::fprintf(stderr, "tile_size must be in [1, 4096]\n");
+    return 2;
+  }
+
+  try {
+    const auto start = std::chrono::steady_clock::now();
+    const rm_map_tools::MappedMap map(yaml);
+    const auto info = rm_map_tools::write_tiled_map(
+      map, yaml, directory, static_cast<uint32_t>(tile_size));
+    const double elapsed_ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start).count();
+    const size_t tile_count = static_cast<size_t>(info.tiles_x) * info.tiles_y;
+    std::printf(
+      "%s: %ux%u cells -> %ux%u tiles of %u, %u stored, %zu all unknown (%.1f ms)\n",
+      directory.c_str(), info.width, info.height, info.tiles_x, info.tiles_y, info.tile_size,
+      info.stored_tiles, tile_count - info.stored_tiles, elapsed_ms);
+  } catch (const std::exception & error) {
+    std::fprintf(stderr, "%s\n", error.what());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,118 @@
+#include "rm_map_tools/mapped_file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <system_error>
+
+namespace rm_map_tools
+{
+
+MappedFile::MappedFile(const std::string & path, Access access)
+: path_(path), data_(nullptr), size_(0)
+{
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::system_error(errno, std::generic_category(), "open " + path);
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    const int error = errno;
+    close(fd);
+    throw std::system_error(error, std::generic_category(), "fstat " + path);
+  }
+  size_ = static_cast<size_t>(info.st_size);
+  if (size_ == 0) {
+    close(fd);
+    return;
+  }
+  void * base = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  const int error = errno;
+  close(fd);
+  if (base == MAP_FAILED) {
+    throw std::system_error(error, std::generic_category(), "mmap " + path);
+  }
+  data_ = static_cast<const uint8_t *>(base);
+  advise(access);
+}
+
+MappedFile::~MappedFile()
+{
+  if (data_) {
+    munmap(const_cast<uint8_t *>(data_), size_);
+  }
+}
+
+void MappedFile::advise(Access access, size_t offset, size_t size) const
+{
+  if (!data_ || offset >= size_) {
+    return;
+  }
+  // madvise wants a page-aligned start.
+  const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  const size_t begin = offset / page * page;
+  const size_t end = size == 0 || offset + size > size_ ? size_ : offset + size;
+  void * start = const_cast<uint8_t *>(data_ + begin);
+  if (access == Access::kSequential) {
+    madvise(start, end - begin, MADV_SEQUENTIAL);
+    madvise(start, end - begin, MADV_WILLNEED);
+  } else {
+    madvise(start, end - begin, MADV_RANDOM);
+  }
+}
+
+OutputMappedFile::OutputMappedFile(const std::string & path, size_t size)
+: path_(path), temporary_(path + ".tmp"), data_(nullptr), size_(size)
+{
+  const int fd = ::open(temporary_.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    throw std::system_error(errno, std::generic_category(), "open " + temporary_);
+  }
+  if (ftruncate(fd, static_cast<off_t>(size_)) != 0) {
+    const int error = errno;
+    close(fd);
+    unlink(temporary_.c_str());
+    throw std::system_error(error, std::generic_category(), "ftruncate " + temporary_);
+  }
+  if (size_ == 0) {
+    close(fd);
+    return;
+  }
+  void * base = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  const int error = errno;
+  close(fd);
+  if (base == MAP_FAILED) {
+    unlink(temporary_.c_str());
+    throw std::system_error(error, std::generic_category(), "mmap " + temporary_);
+  }
+  data_ = static_cast<uint8_t *>(base);
+}
+
+OutputMappedFile::~OutputMappedFile()
+{
+  if (temporary_.empty()) {
+    return;
+  }
+  if (data_) {
+    munmap(data_, size_);
+  }
+  unlink(temporary_.c_str());
+}
+
+void OutputMappedFile::commit()
+{
+  if (data_) {
+    munmap(data_, size_);
+    data_ = nullptr;
+  }
+  if (std::rename(temporary_.c_str(), path_.c_str()) != 0) {
+    throw std::system_error(errno, std::generic_category(), "rename " + temporary_);
+  }
+  temporary_.clear();
+}
+
+}  // namespace rm_map_tools
@@ -0,0 +1,184 @@
+#include "rm_map_tools/mapped_map.hpp"
+
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+
+namespace rm_map_tools
+{
+
+namespace
+{
+
+// Reads the next unsigned decimal of a PNM header, skipping whitespace and
+// '#' comments.
+uint64_t header_number(const uint8_t * data, size_t size, size_t & pos)
+{
+  while (pos < size) {
+    if (data[pos] == '#') {
+      while (pos < size && data[pos] != '\n') {
+        ++pos;
+      }
+    } else if (std::isspace(data[pos])) {
+      ++pos;
+    } else {
+      break;
+    }
+  }
+  if (pos >= size || !std::isdigit(data[pos])) {
+    throw std::runtime_error("malformed PGM header");
+  }
+  uint64_t value = 0;
+  while (pos < size && std::isdigit(data[pos])) {
+    value = value * 10 + (data[pos++] - '0');
+    if (value > 0xffffffffULL) {
+      throw std::runtime_error("PGM header value out of range");
+    }
+  }
+  return value;
+}
+
+class Hasher
+{
+public:
+  void add(const uint8_t * data, size_t size)
+  {
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+      uint64_t word;
+      std::memcpy(&word, data + i, 8);
+      mix(word);
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, data + i, size - i);
+    mix(tail ^ (static_cast<uint64_t>(size - i) << 56));
+    length_ += size;
+  }
+
+  void add(double value)
+  {
+    add(reinterpret_cast<const uint8_t *>(&value), sizeof(value));
+  }
+
+  uint64_t digest() const
+  {
+    // MurmurHash3's finalizer, so every input bit reaches every output bit.
+    uint64_t h = state_ ^ length_;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+private:
+  void mix(uint64_t word)
+  {
+    state_ ^= word * 0x9e3779b97f4a7c15ULL;
+    state_ = ((state_ << 27) | (state_ >> 37)) * 0xc2b2ae3d27d4eb4fULL;
+  }
+
+  uint64_t state_ = 0x243f6a8885a308d3ULL;
+  uint64_t length_ = 0;
+};
+
+}  // namespace
+
+MappedMap::MappedMap(const std::string & yaml_path)
+: MappedMap(load_map_metadata(yaml_path))
+{
+}
+
+MappedMap::MappedMap(const MapMetadata & metadata)
+: metadata_(metadata),
+  file_(metadata.image, MappedFile::Access::kRandom),
+  pixels_(nullptr), width_(0), height_(0), maxval_(0)
+{
+  parse_header();
+  table_ = make_cell_table(metadata_, maxval_);
+}
+
+void MappedMap::parse_header()
+{
+  const uint8_t * data = file_.data();
+  const size_t size = file_.size();
+  if (size < 2 || data[0] != 'P' || data[1] != '5') {
+    throw std::runtime_error(file_.path() + ": not a binary PGM (P5)");
+  }
+  size_t pos = 2;
+  try {
+    width_ = static_cast<uint32_t>(header_number(data, size, pos));
+    height_ = static_cast<uint32_t>(header_number(data, size, pos));
+    maxval_ = static_cast<unsigned>(header_number(data, size, pos));
+  } catch (const std::runtime_error & error) {
+    throw std::runtime_error(file_.path() + ": " + error.what());
+  }
+  if (maxval_ == 0 || maxval_ > 255) {
+    throw std::runtime_error(file_.path() + ": only 8-bit PGM images are supported");
+  }
+  // Exactly one whitespace byte separates the header from the pixels.
+  ++pos;
+  if (width_ == 0 || height_ == 0 ||
+    pos + static_cast<size_t>(width_) * height_ > size)
+  {
+    throw std::runtime_error(file_.path() + ": truncated PGM");
+  }
+  pixels_ = data + pos;
+}
+
+void MappedMap::decode(int8_t * out) const
+{
+  file_.advise(
+    MappedFile::Access::kSequential, static_cast<size_t>(pixels_ - file_.data()),
+    static_cast<size_t>(width_) * height_);
+  decode_region(0, 0, width_, height_, out, width_);
+}
+
+void MappedMap::decode_region(
+  uint32_t x, uint32_t y, uint32_t w, uint32_t h, int8_t * out, size_t stride) const
+{
+  if (x > width_ || w > width_ - x || y > height_ || h > height_ - y) {
+    throw std::out_of_range("region outside the map");
+  }
+  for (uint32_t row = 0; row < h; ++row) {
+    convert_cells(table_, image_row(y + row) + x, w, out + row * stride);
+  }
+}
+
+int8_t MappedMap::cell(uint32_t x, uint32_t y) const
+{
+  if (x >= width_ || y >= height_) {
+    throw std::out_of_range("cell outside the map");
+  }
+  return table_.value[image_row(y)[x]];
+}
+
+uint64_t map_fingerprint(const MappedMap & map)
+{
+  Hasher hasher;
+  map.image().advise(MappedFile::Access::kSequential);
+  hasher.add(map.image().data(), map.image().size());
+  map.image().advise(MappedFile::Access::kRandom);
+  const MapMetadata & metadata = map.metadata();
+  hasher.add(static_cast<double>(metadata.mode));
+  hasher.add(metadata.negate ? 1.0 : 0.0);
+  hasher.add(metadata.occupied_thresh);
+  hasher.add(metadata.free_thresh);
+  hasher.add(metadata.resolution);
+  for (double value : metadata.origin) {
+    hasher.add(value);
+  }
+  return hasher.digest();
+}
+
+std::string map_companion_path(const std::string & yaml_path, const std::string & extension)
+{
+  const auto slash = yaml_path.find_last_of('/');
+  const auto dot = yaml_path.find_last_of('.');
+  const bool has_extension = dot != std::string::npos &&
+    (slash == std::string::npos || dot > slash);
+  return (has_extension ? yaml_path.substr(0, dot) : yaml_path) + extension;
+}
+
+}  // namespace rm_map_tools
@@ -0,0 +1,125 @@
+#include "rm_map_tools/occupancy_grid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace rm_map_tools
+{
+
+namespace
+{
+
+void set_info(
+  double resolution, const double origin[3], uint32_t x, uint32_t y, uint32_t w, uint32_t h,
+  nav_msgs::msg::MapMetaData & info)
+{
+  const double yaw = origin[2];
+  const double dx = x * resolution;
+  const double dy = y * resolution;
+  info.resolution = static_cast<float>(resolution);
+  info.width = w;
+  info.height = h;
+  info.origin.position.x = origin[0] + std::cos(yaw) * dx - std::sin(yaw) * dy;
+  info.origin.position.y = origin[1] + std::sin(yaw) * dx + std::cos(yaw) * dy;
+  info.origin.position.z = 0.0;
+  info.origin.orientation.x = 0.0;
+  info.origin.orientation.y = 0.0;
+  info.origin.orientation.z = std::sin(0.5 * yaw);
+  info.origin.orientation.w = std::cos(0.5 * yaw);
+}
+
+}  // namespace
+
+void to_occupancy_grid(const MappedMap & map, nav_msgs::msg::OccupancyGrid & grid)
+{
+  const MapMetadata & metadata = map.metadata();
+  set_info(metadata.resolution, metadata.origin, 0, 0, map.width(), map.height(), grid.info);
+  grid.data.resize(static_cast<size_t>(map.width()) * map.height());
+  map.decode(grid.data.data());
+}
+
+void region_to_occupancy_grid(
+  const MappedMap & map, uint32_t x, uint32_t y, uint32_t w, uint32_t h,
+  nav_msgs::msg::OccupancyGrid & grid)
+{
+  set_info(map.metadata().resolution, map.metadata().origin, x, y, w, h, grid.info);
+  grid.data.resize(static_cast<size_t>(w) * h);
+  map.decode_region(x, y, w, h, grid.data.data(), w);
+}
+
+void region_to_occupancy_grid(
+  const TiledMap & map, uint32_t x, uint32_t y, uint32_t w, uint32_t h,
+  nav_msgs::msg::OccupancyGrid & grid)
+{
+  set_info(map.info().resolution, map.info().origin, x, y, w, h, grid.info);
+  grid.data.resize(static_cast<size_t>(w) * h);
+  map.decode_region(x, y, w, h, grid.data.data(), w);
+}
+
+void tile_to_occupancy_grid(
+  const TiledMap & map, uint32_t tx, uint32_t ty, nav_msgs::msg::OccupancyGrid & grid)
+{
+  const uint32_t size = map.info().tile_size;
+  if (tx >= map.info().tiles_x || ty >= map.info().tiles_y) {
+    throw std::out_of_range("tile outside the map");
+  }
+  const uint32_t x = tx * size;
+  const uint32_t y = ty * size;
+  region_to_occupancy_grid(
+    map, x, y, std::min(size, map.width() - x), std::min(size, map.height() - y), grid);
+}
+
+void pack_occupancy_grid(
+  const nav_msgs::msg::OccupancyGrid & grid, PackedEncoding encoding,
+  custom_interfaces::msg::PackedOccupancyGrid & packed)
+{
+  packed.header = grid.header;
+  packed.info = grid.info;
+  packed.encoding = static_cast<uint8_t>(encoding);
+  if (encoding == PackedEncoding::kRle) {
+    encode_rle(grid.data.data(), grid.data.size(), packed.data);
+  } else {
+    packed.data.resize(packed_2bit_size(grid.data.size()));
+    pack_2bit(grid.data.data(), grid.data.size(), packed.data.data());
+  }
+}
+
+void pack_occupancy_grid(
+  const nav_msgs::msg::OccupancyGrid & grid, custom_interfaces::msg::PackedOccupancyGrid & packed)
+{
+  pack_occupancy_grid(grid, PackedEncoding::kRle, packed);
+  if (packed.data.size() > packed_2bit_size(grid.data.size())) {
+    pack_occupancy_grid(grid, PackedEncoding::k2Bit, packed);
+  }
+}
+
+void unpack_occupancy_grid(
+  const custom_interfaces::msg::PackedOccupancyGrid & packed,
+  nav_msgs::msg::OccupancyGrid & grid)
+{
+  const size_t count = static_cast<size_t>(packed.info.width) * packed.info.height;
+  grid.header = packed.header;
+  grid.info = packed.info;
+  grid.data.resize(count);
+  switch (static_cast<PackedEncoding>(packed.encoding)) {
+    case PackedEncoding::k2Bit:
+      if (packed.data.size() != packed_2bit_size(count)) {
+        throw std::runtime_error(
+          "packed grid: " + std::to_string(packed.data.size()) + " bytes for " +
+          std::to_string(count) + " cells");
+      }
+      unpack_2bit(packed.data.data(), count, grid.data.data());
+      break;
+    case PackedEncoding::kRle:
+      decode_rle(packed.data.data(), packed.data.size(), count, grid.data.data());
+      break;
+    default:
+      throw std::runtime_error(
+        "packed grid: unknown encoding " + std::to_string(packed.encoding));
+  }
+}
+
+}  // namespace rm_map_tools
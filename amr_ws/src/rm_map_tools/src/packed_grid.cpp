@@ -0,0 +1,253 @@
+#include "rm_map_tools/packed_grid.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "rm_map_tools/cell_conversion.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define RM_MAP_TOOLS_HAVE_AVX2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RM_MAP_TOOLS_HAVE_NEON 1
+#endif
+
+namespace rm_map_tools
+{
+
+namespace
+{
+
+constexpr uint8_t kCodeFree = 0;
+constexpr uint8_t kCodeOccupied = 1;
+constexpr uint8_t kCodeUnknown = 2;
+
+// Cell value of each 2-bit code; the unused code 3 reads as unknown.
+constexpr int8_t kCodeValue[4] = {kFree, kOccupied, kUnknown, kUnknown};
+
+uint8_t cell_code(int8_t cell, size_t index)
+{
+  switch (cell) {
+    case kFree:
+      return kCodeFree;
+    case kOccupied:
+      return kCodeOccupied;
+    case kUnknown:
+      return kCodeUnknown;
+    default:
+      throw std::invalid_argument(
+        "cell " + std::to_string(index) + " is " + std::to_string(cell) +
+        ", not free, occupied or unknown");
+  }
+}
+
+// Expands bytes [begin, ...) into cells [4 * begin, count).
+void unpack_tail(const uint8_t * data, size_t count, size_t begin, int8_t * out)
+{
+  for (size_t i = 4 * begin; i < count; ++i) {
+    out[i] = kCodeValue[(data[i / 4] >> (2 * (i % 4))) & 3];
+  }
+}
+
+#if defined(RM_MAP_TOOLS_HAVE_AVX2)
+
+// Expands whole blocks of 8 bytes into 32 cells; returns the first byte
+// left over.
+__attribute__((target("avx2")))
+size_t unpack_avx2(const uint8_t * data, size_t count, int8_t * out)
+{
+  // Copies every byte to the four cells it holds (pshufb works per 128-bit
+  // half, so the upper half starts at byte 4), isolates each cell's two bits
+  // in place and compares them against the codes shifted the same way.
+  const __m256i spread = _mm256_setr_epi8(
+    0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+    4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7);
+  const __m256i bits = _mm256_set1_epi32(static_cast<int>(0xc0300c03u));
+  const __m256i occupied_code = _mm256_set1_epi32(0x40100401);
+  const __m256i occupied = _mm256_set1_epi8(kOccupied);
+  const __m256i zero = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; 4 * i + 32 <= count; i += 8) {
+    int64_t block;
+    std::memcpy(&block, data + i, sizeof(block));
+    const __m256i codes = _mm256_and_si256(
+      _mm256_shuffle_epi8(_mm256_set1_epi64x(block), spread), bits);
+    // Free codes give 0, the others all ones (unknown, -1) unless occupied.
+    const __m256i known = _mm256_xor_si256(
+      _mm256_cmpeq_epi8(codes, zero), _mm256_set1_epi8(-1));
+    const __m256i cells = _mm256_blendv_epi8(
+      known, occupied, _mm256_cmpeq_epi8(codes, occupied_code));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 4 * i), cells);
+  }
+  return i;
+}
+
+bool cpu_has_avx2()
+{
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+}
+
+#elif defined(RM_MAP_TOOLS_HAVE_NEON)
+
+// Expands whole blocks of 4 bytes into 16 cells; returns the first byte
+// left over.
+size_t unpack_neon(const uint8_t * data, size_t count, int8_t * out)
+{
+  static const uint8_t kBits[16] = {
+    0x03, 0x0c, 0x30, 0xc0, 0x03, 0x0c, 0x30, 0xc0,
+    0x03, 0x0c, 0x30, 0xc0, 0x03, 0x0c, 0x30, 0xc0};
+  static const uint8_t kOccupiedCode[16] = {
+    0x01, 0x04, 0x10, 0x40, 0x01, 0x04, 0x10, 0x40,
+    0x01, 0x04, 0x10, 0x40, 0x01, 0x04, 0x10, 0x40};
+  const uint8x16_t bits = vld1q_u8(kBits);
+  const uint8x16_t occupied_code = vld1q_u8(kOccupiedCode);
+  const uint8x16_t occupied = vdupq_n_u8(static_cast<uint8_t>(kOccupied));
+  size_t i = 0;
+  for (; 4 * i + 16 <= count; i += 4) {
+    uint32_t block;
+    std::memcpy(&block, data + i, sizeof(block));
+    // Two zips of the bytes with themselves give each byte four times.
+    const uint8x8_t bytes = vreinterpret_u8_u32(vdup_n_u32(block));
+    const uint8x8_t pairs = vzip_u8(bytes, bytes).val[0];
+    const uint8x8x2_t quads = vzip_u8(pairs, pairs);
+    const uint8x16_t codes = vandq_u8(vcombine_u8(quads.val[0], quads.val[1]), bits);
+    const uint8x16_t known = vmvnq_u8(vceqq_u8(codes, vdupq_n_u8(0)));
+    const uint8x16_t cells = vbslq_u8(vceqq_u8(codes, occupied_code), occupied, known);
+    vst1q_s8(out + 4 * i, vreinterpretq_s8_u8(cells));
+  }
+  return i;
+}
+
+#endif
+
+using Kernel = size_t (*)(const uint8_t *, size_t, int8_t *);
+
+Kernel vector_kernel()
+{
+#if defined(RM_MAP_TOOLS_HAVE_AVX2)
+  return cpu_has_avx2() ? &unpack_avx2 : nullptr;
+#elif defined(RM_MAP_TOOLS_HAVE_NEON)
+  return &unpack_neon;
+#else
+  return nullptr;
+#endif
+}
+
+void put_varint(uint64_t value, std::vector<uint8_t> & out)
+{
+  while (value >= 0x80) {
+    out.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+}  // namespace
+
+bool is_trinary(const int8_t * cells, size_t count)
+{
+  for (size_t i = 0; i < count; ++i) {
+    if (cells[i] != kFree && cells[i] != kOccupied && cells[i] != kUnknown) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void pack_2bit(const int8_t * cells, size_t count, uint8_t * out)
+{
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    out[i / 4] = static_cast<uint8_t>(
+      cell_code(cells[i], i) | cell_code(cells[i + 1], i + 1) << 2 |
+      cell_code(cells[i + 2], i + 2) << 4 | cell_code(cells[i + 3], i + 3) << 6);
+  }
+  if (i < count) {
+    uint8_t byte = 0;
+    for (size_t j = i; j < count; ++j) {
+      byte |= static_cast<uint8_t>(cell_code(cells[j], j) << (2 * (j - i)));
+    }
+    out[i / 4] = byte;
+  }
+}
+
+void unpack_2bit(const uint8_t * data, size_t count, int8_t * out)
+{
+  static const Kernel kernel = vector_kernel();
+  unpack_tail(data, count, kernel ? kernel(data, count, out) : 0, out);
+}
+
+void unpack_2bit_scalar(const uint8_t * data, size_t count, int8_t * out)
+{
+  unpack_tail(data, count, 0, out);
+}
+
+const char * unpack_2bit_kernel()
+{
+#if defined(RM_MAP_TOOLS_HAVE_AVX2)
+  return cpu_has_avx2() ? "avx2" : "scalar";
+#elif defined(RM_MAP_TOOLS_HAVE_NEON)
+  return "neon";
+#else
+  return "scalar";
+#endif
+}
+
+void encode_rle(const int8_t * cells, size_t count, std::vector<uint8_t> & out)
+{
+  out.clear();
+  size_t i = 0;
+  while (i < count) {
+    const int8_t value = cells[i];
+    const uint8_t code = cell_code(value, i);
+    size_t end = i + 1;
+    while (end < count && cells[end] == value) {
+      ++end;
+    }
+    put_varint(static_cast<uint64_t>(end - i) << 2 | code, out);
+    i = end;
+  }
+}
+
+void decode_rle(const uint8_t * data, size_t size, size_t count, int8_t * out)
+{
+  size_t pos = 0;
+  size_t cell = 0;
+  while (pos < size) {
+    uint64_t run = 0;
+    for (unsigned shift = 0;; shift += 7) {
+      if (pos == size) {
+        throw std::runtime_error("packed grid: truncated or oversized run");
+      }
+      const uint8_t byte = data[pos++];
+      // The tenth byte only has room for bit 63; anything more would be
+      // shifted out and decode as a shorter run.
+      if (shift == 63 && byte > 1) {
+        throw std::runtime_error("packed grid: truncated or oversized run");
+      }
+      run |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (byte < 0x80) {
+        break;
+      }
+    }
+    const uint64_t length = run >> 2;
+    const uint8_t code = run & 3;
+    if (code > kCodeUnknown || length == 0 || length > count - cell) {
+      throw std::runtime_error(
+        "packed grid: bad run at byte " + std::to_string(pos) + " (code " +
+        std::to_string(code) + ", " + std::to_string(length) + " cells)");
+    }
+    std::memset(out + cell, kCodeValue[code], length);
+    cell += length;
+  }
+  if (cell != count) {
+    throw std::runtime_error(
+      "packed grid: runs cover " + std::to_string(cell) + " of " + std::to_string(count) +
+      " cells");
+  }
+}
+
+}  // namespace rm_map_tools
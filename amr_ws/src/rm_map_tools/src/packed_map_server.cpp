@@ -0,0 +1,60 @@
+#include "rm_map_tools/packed_map_server.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include "nav_msgs/msg/occupancy_grid.hpp"
+#include "rclcpp_components/register_node_macro.hpp"
+#include "rm_map_tools/mapped_map.hpp"
+#include "rm_map_tools/occupancy_grid.hpp"
+
+namespace rm_map_tools
+{
+
+PackedMapServer::PackedMapServer(const rclcpp::NodeOptions & options)
+: Node("packed_map_server", options)
+{
+  const auto path = declare_parameter("yaml_filename", std::string());
+  if (path.empty()) {
+    throw std::invalid_argument("packed_map_server needs the 'yaml_filename' parameter");
+  }
+  const auto frame_id = declare_parameter("frame_id", std::string("map"));
+  const auto encoding = declare_parameter("encoding", std::string("auto"));
+  if (encoding != "auto" && encoding != "2bit" && encoding != "rle") {
+    throw std::invalid_argument(
+      "packed_map_server: encoding '" + encoding + "' is not auto, 2bit or rle");
+  }
+
+  const MappedMap map(path);
+  nav_msgs::msg::OccupancyGrid grid;
+  to_occupancy_grid(map, grid);
+  grid.header.frame_id = frame_id;
+  grid.header.stamp = now();
+  grid.info.map_load_time = grid.header.stamp;
+  if (!is_trinary(grid.data.data(), grid.data.size())) {
+    throw std::invalid_argument(
+      path + ": only trinary maps can be packed (mode is " +
+      map_mode_name(map.metadata().mode) + ")");
+  }
+
+  auto msg = std::make_unique<custom_interfaces::msg::PackedOccupancyGrid>();
+  if (encoding == "auto") {
+    pack_occupancy_grid(grid, *msg);
+  } else {
+    pack_occupancy_grid(
+      grid, encoding == "rle" ? PackedEncoding::kRle : PackedEncoding::k2Bit, *msg);
+  }
+  RCLCPP_INFO(
+    get_logger(), "Latching %ux%u cells from %s as %zu %s bytes (%zu raw)",
+    grid.info.width, grid.info.height, path.c_str(), msg->data.size(),
+    msg->encoding == static_cast<uint8_t>(PackedEncoding::kRle) ? "rle" : "2bit",
+    grid.data.size());
+
+  map_pub_ = create_publisher<custom_interfaces::msg::PackedOccupancyGrid>(
+    "map_packed", rclcpp::QoS(1).reliable().transient_local());
+  map_pub_->publish(std::move(msg));
+}
+
+}  // namespace rm_map_tools
+
+RCLCPP_COMPONENTS_REGISTER_NODE(rm_map_tools::PackedMapServer)
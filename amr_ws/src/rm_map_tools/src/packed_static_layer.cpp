@@ -0,0 +1,52 @@
+#include "rm_map_tools/packed_static_layer.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "nav_msgs/msg/occupancy_grid.hpp"
+#include "pluginlib/class_list_macros.hpp"
+#include "rm_map_tools/occupancy_grid.hpp"
+
+namespace rm_map_tools
+{
+
+void PackedStaticLayer::onInitialize()
+{
+  StaticLayer::onInitialize();
+  // StaticLayer subscribed to the raw map; the packed one replaces it.
+  map_sub_.reset();
+
+  declareParameter("packed_map_topic", rclcpp::ParameterValue(std::string("map_packed")));
+  std::string topic;
+  node_->get_parameter(name_ + "." + "packed_map_topic", topic);
+  // The same QoS StaticLayer gives the raw map.
+  rclcpp::QoS map_qos(10);
+  if (map_subscribe_transient_local_) {
+    map_qos.transient_local();
+    map_qos.reliable();
+    map_qos.keep_last(1);
+  }
+  RCLCPP_INFO(
+    node_->get_logger(), "%s: subscribing to packed map on %s", name_.c_str(), topic.c_str());
+  packed_map_sub_ = node_->create_subscription<custom_interfaces::msg::PackedOccupancyGrid>(
+    topic, map_qos,
+    std::bind(&PackedStaticLayer::incomingPackedMap, this, std::placeholders::_1));
+}
+
+void PackedStaticLayer::incomingPackedMap(
+  const custom_interfaces::msg::PackedOccupancyGrid::SharedPtr msg)
+{
+  auto grid = std::make_shared<nav_msgs::msg::OccupancyGrid>();
+  try {
+    unpack_occupancy_grid(*msg, *grid);
+  } catch (const std::runtime_error & error) {
+    RCLCPP_ERROR(node_->get_logger(), "%s: dropping packed map: %s", name_.c_str(), error.what());
+    return;
+  }
+  incomingMap(grid);
+}
+
+}  // namespace rm_map_tools
+
+PLUGINLIB_EXPORT_CLASS(rm_map_tools::PackedStaticLayer, nav2_costmap_2d::Layer)
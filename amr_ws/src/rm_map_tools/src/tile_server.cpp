@@ -0,0 +1,104 @@
+#include "rm_map_tools/tile_server.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "rclcpp_components/register_node_macro.hpp"
+#include "rm_map_tools/occupancy_grid.hpp"
+
+namespace rm_map_tools
+{
+
+TileServer::TileServer(const rclcpp::NodeOptions & options)
+: Node("tile_server", options),
+  has_window_(false),
+  window_{0, 0, 0, 0},
+  tiles_sent_(0)
+{
+  const auto path = declare_parameter("map", std::string());
+  if (path.empty()) {
+    throw std::invalid_argument("tile_server needs the 'map' parameter (a map_tiler directory)");
+  }
+  map_ = std::make_unique<TiledMap>(path);
+  frame_id_ = declare_parameter("frame_id", std::string("map"));
+  radius_ = std::max(0.0, declare_parameter("radius", 10.0));
+  const double initial_x = declare_parameter("initial_x", 0.0);
+  const double initial_y = declare_parameter("initial_y", 0.0);
+
+  const TiledMapInfo & info = map_->info();
+  // Deep enough for every tile of one window, so a subscriber that keeps up
+  // never misses one.
+  const double tile_m = info.tile_size * info.resolution;
+  const size_t span = 2 * static_cast<size_t>(std::ceil(radius_ / tile_m)) + 1;
+  tile_pub_ = create_publisher<nav_msgs::msg::OccupancyGrid>(
+    "map_tiles", rclcpp::QoS(span * span).reliable());
+  window_pub_ = create_publisher<nav_msgs::msg::OccupancyGrid>(
+    "map_window", rclcpp::QoS(1).reliable().transient_local());
+  pose_sub_ = create_subscription<geometry_msgs::msg::PoseWithCovarianceStamped>(
+    "amcl_pose", 10, std::bind(&TileServer::pose_callback, this, std::placeholders::_1));
+  RCLCPP_INFO(
+    get_logger(), "Serving %ux%u cells as %ux%u tiles of %u (%u stored) from %s",
+    info.width, info.height, info.tiles_x, info.tiles_y, info.tile_size, info.stored_tiles,
+    path.c_str());
+  serve(initial_x, initial_y);
+}
+
+void TileServer::pose_callback(
+  const geometry_msgs::msg::PoseWithCovarianceStamped::SharedPtr msg)
+{
+  if (msg->header.frame_id != frame_id_) {
+    RCLCPP_WARN_THROTTLE(
+      get_logger(), *get_clock(), 5000, "Ignoring poses in '%s', the map frame is '%s'",
+      msg->header.frame_id.c_str(), frame_id_.c_str());
+    return;
+  }
+  serve(msg->pose.pose.position.x, msg->pose.pose.position.y);
+}
+
+void TileServer::serve(double x, double y)
+{
+  const TileRange range = tiles_around(map_->info(), x, y, radius_);
+  if (has_window_ && range == window_) {
+    return;
+  }
+  const TiledMapInfo & info = map_->info();
+  const rclcpp::Time stamp = now();
+
+  size_t fresh = 0;
+  tile_msg_.header.frame_id = frame_id_;
+  tile_msg_.header.stamp = stamp;
+  for (uint32_t ty = range.y0; ty <= range.y1; ++ty) {
+    for (uint32_t tx = range.x0; tx <= range.x1; ++tx) {
+      if (has_window_ && window_.contains(tx, ty)) {
+        continue;
+      }
+      tile_to_occupancy_grid(*map_, tx, ty, tile_msg_);
+      tile_pub_->publish(tile_msg_);
+      ++fresh;
+    }
+  }
+  tiles_sent_ += fresh;
+
+  const uint32_t x0 = range.x0 * info.tile_size;
+  const uint32_t y0 = range.y0 * info.tile_size;
+  const uint32_t x1 = std::min(info.width, (range.x1 + 1) * info.tile_size);
+  const uint32_t y1 = std::min(info.height, (range.y1 + 1) * info.tile_size);
+  window_msg_.header.frame_id = frame_id_;
+  window_msg_.header.stamp = stamp;
+  region_to_occupancy_grid(*map_, x0, y0, x1 - x0, y1 - y0, window_msg_);
+  window_msg_.info.map_load_time = stamp;
+  window_pub_->publish(window_msg_);
+
+  window_ = range;
+  has_window_ = true;
+  RCLCPP_INFO(
+    get_logger(), "Window tiles [%u, %u]x[%u, %u]: %ux%u cells (%.1f%% of the map), "
+    "%zu new tiles, %lu sent so far", range.x0, range.x1, range.y0, range.y1, x1 - x0, y1 - y0,
+    100.0 * (x1 - x0) * (y1 - y0) / (static_cast<double>(info.width) * info.height), fresh,
+    static_cast<unsigned long>(tiles_sent_));
+}
+
+}  // namespace rm_map_tools
+
+RCLCPP_COMPONENTS_REGISTER_NODE(rm_map_tools::TileServer)
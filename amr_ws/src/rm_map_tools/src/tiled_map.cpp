@@ -0,0 +1,342 @@
+#include "rm_map_tools/tiled_map.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include "rm_map_tools/cell_conversion.hpp"
+#include "yaml-cpp/yaml.h"
+
+namespace rm_map_tools
+{
+
+namespace
+{
+
+constexpr char kMagic[8] = {'R', 'M', 'T', 'I', 'L', 'E', 'S', '\0'};
+constexpr size_t kSlotAlignment = 4096;
+constexpr const char * kManifestName = "manifest.yaml";
+constexpr const char * kTilesName = "tiles.bin";
+
+struct FileHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t tile_size;
+  uint32_t width;
+  uint32_t height;
+  uint32_t tiles_x;
+  uint32_t tiles_y;
+  uint32_t stored_tiles;
+  uint32_t reserved[7];
+};
+static_assert(sizeof(FileHeader) == 64, "tiles.bin header must stay 64 bytes");
+
+size_t slots_offset(size_t tile_count)
+{
+  const size_t end = sizeof(FileHeader) + tile_count * sizeof(uint32_t);
+  return (end + kSlotAlignment - 1) / kSlotAlignment * kSlotAlignment;
+}
+
+std::string directory_of(const std::string & path)
+{
+  const auto slash = path.find_last_of('/');
+  return slash == std::string::npos ? std::string(".") : path.substr(0, slash);
+}
+
+void write_at(int fd, const void * data, size_t size, off_t offset, const std::string & path)
+{
+  const char * bytes = static_cast<const char *>(data);
+  while (size > 0) {
+    const ssize_t written = pwrite(fd, bytes, size, offset);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error(errno, std::generic_category(), "write " + path);
+    }
+    bytes += written;
+    size -= static_cast<size_t>(written);
+    offset += written;
+  }
+}
+
+void replace(const std::string & from, const std::string & to)
+{
+  if (std::rename(from.c_str(), to.c_str()) != 0) {
+    throw std::system_error(errno, std::generic_category(), "rename " + from);
+  }
+}
+
+void write_manifest(
+  const TiledMapInfo & info, const MappedMap & map, const std::string & source_yaml,
+  const std::string & path)
+{
+  YAML::Emitter out;
+  out.SetDoublePrecision(15);
+  out << YAML::BeginMap;
+  out << YAML::Key << "format_version" << YAML::Value << kTiledMapVersion;
+  out << YAML::Key << "tiles" << YAML::Value << kTilesName;
+  out << YAML::Key << "tile_size" << YAML::Value << info.tile_size;
+  out << YAML::Key << "width" << YAML::Value << info.width;
+  out << YAML::Key << "height" << YAML::Value << info.height;
+  out << YAML::Key << "resolution" << YAML::Value << info.resolution;
+  out << YAML::Key << "origin" << YAML::Value << YAML::Flow << YAML::BeginSeq <<
+    info.origin[0] << info.origin[1] << info.origin[2] << YAML::EndSeq;
+  out << YAML::Key << "source" << YAML::Value << source_yaml;
+  out << YAML::Key << "mode" << YAML::Value << map_mode_name(map.metadata().mode);
+  out << YAML::EndMap;
+
+  const std::string temporary = path + ".tmp";
+  std::ofstream file(temporary, std::ios::trunc);
+  file << out.c_str() << "\n";
+  file.close();
+  if (!file) {
+    throw std::system_error(errno, std::generic_category(), "write " + temporary);
+  }
+  replace(temporary, path);
+}
+
+template<typename T>
+T required(const YAML::Node & node, const char * key, const std::string & path)
+{
+  if (!node[key]) {
+    throw std::runtime_error(path + ": missing '" + key + "'");
+  }
+  return node[key].as<T>();
+}
+
+std::string load_manifest(const std::string & path, TiledMapInfo & info)
+{
+  struct stat status;
+  const bool is_directory = stat(path.c_str(), &status) == 0 && S_ISDIR(status.st_mode);
+  const std::string manifest = is_directory ? path + "/" + kManifestName : path;
+  YAML::Node doc;
+  try {
+    doc = YAML::LoadFile(manifest);
+  } catch (const YAML::Exception & error) {
+    throw std::runtime_error(manifest + ": " + error.what());
+  }
+  const auto version = required<uint32_t>(doc, "format_version", manifest);
+  if (version != kTiledMapVersion) {
+    throw std::runtime_error(
+      manifest + ": format_version " + std::to_string(version) + ", expected " +
+      std::to_string(kTiledMapVersion));
+  }
+  info.tile_size = required<uint32_t>(doc, "tile_size", manifest);
+  info.width = required<uint32_t>(doc, "width", manifest);
+  info.height = required<uint32_t>(doc, "height", manifest);
+  info.resolution = required<double>(doc, "resolution", manifest);
+  const auto origin = required<std::vector<double>>(doc, "origin", manifest);
+  if (origin.size() != 3) {
+    throw std::runtime_error(manifest + ": 'origin' needs x, y and yaw");
+  }
+  std::copy(origin.begin(), origin.end(), info.origin);
+  if (info.tile_size == 0 || info.width == 0 || info.height == 0) {
+    throw std::runtime_error(manifest + ": empty map or tile size");
+  }
+  info.tiles_x = (info.width + info.tile_size - 1) / info.tile_size;
+  info.tiles_y = (info.height + info.tile_size - 1) / info.tile_size;
+
+  const auto tiles = required<std::string>(doc, "tiles", manifest);
+  return tiles.front() == '/' ? tiles : directory_of(manifest) + "/" + tiles;
+}
+
+}  // namespace
+
+TiledMapInfo write_tiled_map(
+  const MappedMap & map, const std::string & source_yaml, const std::string & directory,
+  uint32_t tile_size)
+{
+  if (tile_size == 0) {
+    throw std::invalid_argument("tile_size must be positive");
+  }
+  if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+    throw std::system_error(errno, std::generic_category(), "mkdir " + directory);
+  }
+
+  TiledMapInfo info;
+  info.tile_size = tile_size;
+  info.width = map.width();
+  info.height = map.height();
+  info.tiles_x = (info.width + tile_size - 1) / tile_size;
+  info.tiles_y = (info.height + tile_size - 1) / tile_size;
+  info.resolution = map.metadata().resolution;
+  std::copy(map.metadata().origin, map.metadata().origin + 3, info.origin);
+
+  const std::string path = directory + "/" + kTilesName;
+  const std::string temporary = path + ".tmp";
+  const int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    throw std::system_error(errno, std::generic_category(), "open " + temporary);
+  }
+  try {
+    const size_t tile_cells = static_cast<size_t>(tile_size) * tile_size;
+    const size_t first_slot = slots_offset(static_cast<size_t>(info.tiles_x) * info.tiles_y);
+    std::vector<uint32_t> index(static_cast<size_t>(info.tiles_x) * info.tiles_y, 0);
+    // One row of tiles, padded to whole tiles with unknown cells.
+    const size_t band_stride = static_cast<size_t>(info.tiles_x) * tile_size;
+    std::vector<int8_t> band(band_stride * tile_size);
+    std::vector<int8_t> tile(tile_cells);
+    for (uint32_t ty = 0; ty < info.tiles_y; ++ty) {
+      const uint32_t y = ty * tile_size;
+      const uint32_t rows = std::min(tile_size, info.height - y);
+      std::fill(band.begin(), band.end(), kUnknown);
+      map.decode_region(0, y, info.width, rows, band.data(), band_stride);
+      for (uint32_t tx = 0; tx < info.tiles_x; ++tx) {
+        bool known = false;
+        const int8_t * column = band.data() + static_cast<size_t>(tx) * tile_size;
+        for (uint32_t row = 0; row < tile_size; ++row) {
+          const int8_t * src = column + row * band_stride;
+          std::memcpy(tile.data() + static_cast<size_t>(row) * tile_size, src, tile_size);
+          known = known || std::any_of(src, src + tile_size, [](int8_t v) {return v != kUnknown;});
+        }
+        if (!known) {
+          continue;
+        }
+        write_at(
+          fd, tile.data(), tile_cells,
+          static_cast<off_t>(first_slot + info.stored_tiles * tile_cells), temporary);
+        index[static_cast<size_t>(ty) * info.tiles_x + tx] = ++info.stored_tiles;
+      }
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kTiledMapVersion;
+    header.tile_size = tile_size;
+    header.width = info.width;
+    header.height = info.height;
+    header.tiles_x = info.tiles_x;
+    header.tiles_y = info.tiles_y;
+    header.stored_tiles = info.stored_tiles;
+    write_at(fd, &header, sizeof(header), 0, temporary);
+    write_at(fd, index.data(), index.size() * sizeof(uint32_t), sizeof(header), temporary);
+    // Even with no stored tile the file must reach the first slot.
+    if (ftruncate(fd, static_cast<off_t>(first_slot + info.stored_tiles * tile_cells)) != 0) {
+      throw std::system_error(errno, std::generic_category(), "truncate " + temporary);
+    }
+  } catch (...) {
+    close(fd);
+    unlink(temporary.c_str());
+    throw;
+  }
+  if (close(fd) != 0) {
+    throw std::system_error(errno, std::generic_category(), "close " + temporary);
+  }
+  replace(temporary, path);
+  write_manifest(info, map, source_yaml, directory + "/" + kManifestName);
+  return info;
+}
+
+TiledMap::TiledMap(const std::string & path)
+: file_(load_manifest(path, info_), MappedFile::Access::kRandom),
+  index_(nullptr), slots_(nullptr)
+{
+  FileHeader header;
+  const size_t tile_count = static_cast<size_t>(info_.tiles_x) * info_.tiles_y;
+  const size_t first_slot = slots_offset(tile_count);
+  if (file_.size() < first_slot) {
+    throw std::runtime_error(file_.path() + ": truncated tile file");
+  }
+  std::memcpy(&header, file_.data(), sizeof(header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    throw std::runtime_error(file_.path() + ": not a tile file");
+  }
+  if (header.version != kTiledMapVersion) {
+    throw std::runtime_error(
+      file_.path() + ": version " + std::to_string(header.version) + ", expected " +
+      std::to_string(kTiledMapVersion));
+  }
+  if (header.tile_size != info_.tile_size || header.width != info_.width ||
+    header.height != info_.height || header.tiles_x != info_.tiles_x ||
+    header.tiles_y != info_.tiles_y)
+  {
+    throw std::runtime_error(file_.path() + ": does not match its manifest");
+  }
+  const size_t tile_cells = static_cast<size_t>(info_.tile_size) * info_.tile_size;
+  if (file_.size() < first_slot + header.stored_tiles * tile_cells) {
+    throw std::runtime_error(file_.path() + ": truncated tile file");
+  }
+  info_.stored_tiles = header.stored_tiles;
+  index_ = reinterpret_cast<const uint32_t *>(file_.data() + sizeof(header));
+  slots_ = reinterpret_cast<const int8_t *>(file_.data() + first_slot);
+  for (size_t i = 0; i < tile_count; ++i) {
+    if (index_[i] > info_.stored_tiles) {
+      throw std::runtime_error(file_.path() + ": tile index out of range");
+    }
+  }
+}
+
+const int8_t * TiledMap::tile(uint32_t tx, uint32_t ty) const
+{
+  if (tx >= info_.tiles_x || ty >= info_.tiles_y) {
+    throw std::out_of_range("tile outside the map");
+  }
+  const uint32_t slot = index_[static_cast<size_t>(ty) * info_.tiles_x + tx];
+  if (slot == 0) {
+    return nullptr;
+  }
+  return slots_ + (slot - 1) * static_cast<size_t>(info_.tile_size) * info_.tile_size;
+}
+
+void TiledMap::decode_region(
+  uint32_t x, uint32_t y, uint32_t w, uint32_t h, int8_t * out, size_t stride) const
+{
+  if (w == 0 || h == 0) {
+    return;
+  }
+  if (x >= info_.width || y >= info_.height || w > info_.width - x || h > info_.height - y) {
+    throw std::out_of_range("region outside the map");
+  }
+  const uint32_t size = info_.tile_size;
+  for (uint32_t ty = y / size; ty <= (y + h - 1) / size; ++ty) {
+    const uint32_t row_begin = std::max(y, ty * size);
+    const uint32_t row_end = std::min(y + h, (ty + 1) * size);
+    for (uint32_t tx = x / size; tx <= (x + w - 1) / size; ++tx) {
+      const uint32_t col_begin = std::max(x, tx * size);
+      const uint32_t col_end = std::min(x + w, (tx + 1) * size);
+      const int8_t * cells = tile(tx, ty);
+      for (uint32_t row = row_begin; row < row_end; ++row) {
+        int8_t * dst = out + (row - y) * stride + (col_begin - x);
+        if (cells) {
+          std::memcpy(
+            dst, cells + static_cast<size_t>(row - ty * size) * size + (col_begin - tx * size),
+            col_end - col_begin);
+        } else {
+          std::memset(dst, kUnknown, col_end - col_begin);
+        }
+      }
+    }
+  }
+}
+
+TileRange tiles_around(const TiledMapInfo & info, double x, double y, double radius)
+{
+  // Into the map's cell frame, which is rotated by the origin's yaw.
+  const double yaw = info.origin[2];
+  const double dx = x - info.origin[0];
+  const double dy = y - info.origin[1];
+  const double u = (std::cos(yaw) * dx + std::sin(yaw) * dy) / info.resolution;
+  const double v = (-std::sin(yaw) * dx + std::cos(yaw) * dy) / info.resolution;
+  const double r = radius / info.resolution;
+  const auto tile = [&info](double cell, uint32_t tiles) {
+      const double t = std::floor(cell / info.tile_size);
+      return static_cast<uint32_t>(std::min(std::max(t, 0.0), tiles - 1.0));
+    };
+  return TileRange{
+    tile(u - r, info.tiles_x), tile(v - r, info.tiles_y),
+    tile(u + r, info.tiles_x), tile(v + r, info.tiles_y)};
+}
+
+}  // namespace rm_map_tools
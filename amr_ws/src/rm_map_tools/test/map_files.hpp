@@ -0,0 +1,66 @@
+#ifndef MAP_FILES_HPP_
+#define MAP_FILES_HPP_
+
+#include <stdlib.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Scratch maps for the tests: a temporary directory removed with everything
+// in it, and writers for map_saver style PGM and YAML files.
+class TempDir
+{
+public:
+  TempDir()
+  {
+    char path[] = "/tmp/rm_map_tools_test_XXXXXX";
+    if (!mkdtemp(path)) {
+      throw std::runtime_error("mkdtemp failed");
+    }
+    path_ = path;
+  }
+  ~TempDir() {std::filesystem::remove_all(path_);}
+  TempDir(const TempDir &) = delete;
+  TempDir & operator=(const TempDir &) = delete;
+
+  const std::string & path() const {return path_;}
+  std::string file(const std::string & name) const {return path_ + "/" + name;}
+
+private:
+  std::string path_;
+};
+
+inline void write_file(const std::string & path, const std::string & contents)
+{
+  std::ofstream out(path, std::ios::binary);
+  out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+}
+
+// A binary PGM as map_saver writes it; `pixels` in image order, top row
+// first.
+inline std::string pgm(
+  uint32_t width, uint32_t height, const std::vector<uint8_t> & pixels, unsigned maxval = 255)
+{
+  return "P5\n" + std::to_string(width) + " " + std::to_string(height) + "\n" +
+         std::to_string(maxval) + "\n" + std::string(pixels.begin(), pixels.end());
+}
+
+// Writes `name`.pgm and `name`.yaml into `dir` and returns the YAML path.
+// `extra` is appended to the YAML, e.g. "negate: 1\n".
+inline std::string write_map(
+  const TempDir & dir, const std::string & name, uint32_t width, uint32_t height,
+  const std::vector<uint8_t> & pixels, const std::string & extra = std::string())
+{
+  write_file(dir.file(name + ".pgm"), pgm(width, height, pixels));
+  const std::string yaml = dir.file(name + ".yaml");
+  write_file(
+    yaml, "image: " + name + ".pgm\nresolution: 0.05\norigin: [-1.0, -2.0, 0.0]\n"
+    "occupied_thresh: 0.65\nfree_thresh: 0.25\n" + extra);
+  return yaml;
+}
+
+#endif  // MAP_FILES_HPP_
@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rm_map_tools/cell_conversion.hpp"
+#include "rm_map_tools/distance_field.hpp"
+#include "rm_map_tools/distance_transform.hpp"
+
+#include "map_files.hpp"
+
+using rm_map_tools::DistanceField;
+using rm_map_tools::distance_field_path;
+using rm_map_tools::distance_transform;
+using rm_map_tools::distance_transform_brute_force;
+using rm_map_tools::kDistanceFieldVersion;
+using rm_map_tools::kFree;
+using rm_map_tools::kOccupied;
+using rm_map_tools::kUnknown;
+using rm_map_tools::load_distance_field;
+
+namespace
+{
+
+// Free, unknown and occupied cells, about `occupied` of them obstacles.
+std::vector<int8_t> random_grid(size_t cells, double occupied, std::mt19937 & rng)
+{
+  std::uniform_real_distribution<double> draw(0.0, 1.0);
+  std::vector<int8_t> grid(cells);
+  for (int8_t & cell : grid) {
+    const double value = draw(rng);
+    cell = value < occupied ? kOccupied : value < 0.5 ? kUnknown : kFree;
+  }
+  return grid;
+}
+
+// Overwrites the cache's version field (after the 8-byte magic).
+void set_cache_version(const std::string & path, uint32_t version)
+{
+  std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+  file.seekp(8);
+  file.write(reinterpret_cast<const char *>(&version), sizeof(version));
+}
+
+// Points $XDG_CACHE_HOME at a scratch directory for the test's duration.
+class DistanceFieldCache : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    const char * previous = getenv("XDG_CACHE_HOME");
+    had_previous_ = previous != nullptr;
+    if (had_previous_) {
+      previous_ = previous;
+    }
+    setenv("XDG_CACHE_HOME", cache_.path().c_str(), 1);
+  }
+
+  void TearDown() override
+  {
+    if (had_previous_) {
+      setenv("XDG_CACHE_HOME", previous_.c_str(), 1);
+    } else {
+      unsetenv("XDG_CACHE_HOME");
+    }
+  }
+
+  TempDir cache_;
+  TempDir maps_;
+
+private:
+  bool had_previous_ = false;
+  std::string previous_;
+};
+
+}  // namespace
+
+// Sizes around the 16-column blocks of the column pass, at thread counts that
+// split the rows and columns unevenly.
+TEST(DistanceTransform, MatchesBruteForceAtEveryThreadCount)
+{
+  std::mt19937 rng(23);
+  const uint32_t sizes[][2] = {{1, 1}, {1, 9}, {9, 1}, {15, 7}, {16, 16}, {17, 33}, {50, 41}};
+  for (const auto & size : sizes) {
+    for (double occupied : {0.0, 0.002, 0.05, 0.4}) {
+      const uint32_t width = size[0];
+      const uint32_t height = size[1];
+      const size_t cells = static_cast<size_t>(width) * height;
+      const std::vector<int8_t> grid = random_grid(cells, occupied, rng);
+      std::vector<float> expected(cells);
+      distance_transform_brute_force(grid.data(), width, height, expected.data());
+      for (unsigned threads : {1u, 2u, 3u, 7u, 0u}) {
+        SCOPED_TRACE(
+          std::to_string(width) + "x" + std::to_string(height) + " occupied " +
+          std::to_string(occupied) + " threads " + std::to_string(threads));
+        std::vector<float> actual(cells, -1.0f);
+        distance_transform(grid.data(), width, height, actual.data(), threads);
+        ASSERT_EQ(actual, expected);
+      }
+    }
+  }
+}
+
+TEST(DistanceTransform, IsInfiniteWithoutObstacles)
+{
+  const std::vector<int8_t> grid(6 * 4, kUnknown);
+  std::vector<float> distances(grid.size());
+  distance_transform(grid.data(), 6, 4, distances.data(), 2);
+  for (float distance : distances) {
+    EXPECT_EQ(distance, std::numeric_limits<float>::infinity());
+  }
+}
+
+TEST_F(DistanceFieldCache, LivesInTheCacheHome)
+{
+  const std::string yaml = write_map(maps_, "room", 2, 1, {0, 254});
+  const std::string path = distance_field_path(yaml);
+  EXPECT_EQ(path.rfind(cache_.path() + "/rm_map_tools/room-", 0), 0u) << path;
+  EXPECT_EQ(path.substr(path.size() - 4), ".edt");
+  // Maps that share a name do not share a cache.
+  TempDir other;
+  EXPECT_NE(distance_field_path(write_map(other, "room", 2, 1, {0, 254})), path);
+}
+
+TEST_F(DistanceFieldCache, RebuildsOnlyWhenTheMapChanges)
+{
+  // Image rows top first: one obstacle in the bottom left corner (205 is
+  // free with free_thresh 0.25), so the field's cell (0, 0) is the obstacle.
+  const std::vector<uint8_t> pixels = {
+    205, 205, 205,
+    205, 205, 205,
+    0, 205, 205};
+  const std::string yaml = write_map(maps_, "room", 3, 3, pixels);
+  const std::string path = distance_field_path(yaml);
+
+  bool rebuilt = false;
+  auto field = load_distance_field(yaml, 2, &rebuilt);
+  EXPECT_TRUE(rebuilt);
+  ASSERT_EQ(field->width(), 3u);
+  ASSERT_EQ(field->height(), 3u);
+  EXPECT_EQ(field->resolution(), 0.05);
+  EXPECT_EQ(field->origin()[0], -1.0);
+  EXPECT_EQ(field->origin()[1], -2.0);
+  EXPECT_EQ(field->distance(0, 0), 0.0f);
+  EXPECT_FLOAT_EQ(field->distance(2, 0), 0.1f);
+  EXPECT_FLOAT_EQ(field->distance(2, 2), static_cast<float>(0.05 * std::sqrt(8.0)));
+
+  field = load_distance_field(yaml, 2, &rebuilt);
+  EXPECT_FALSE(rebuilt);
+
+  // Another PGM with the same size: the obstacle moves to the top right.
+  write_file(maps_.file("room.pgm"), pgm(3, 3, {205, 205, 0, 205, 205, 205, 205, 205, 205}));
+  field = load_distance_field(yaml, 2, &rebuilt);
+  EXPECT_TRUE(rebuilt);
+  EXPECT_EQ(field->distance(2, 2), 0.0f);
+  EXPECT_FLOAT_EQ(field->distance(0, 2), 0.1f);
+  field = load_distance_field(yaml, 2, &rebuilt);
+  EXPECT_FALSE(rebuilt);
+
+  // Same image at another resolution: the distances are in metres.
+  write_file(
+    yaml, "image: room.pgm\nresolution: 0.1\norigin: [-1.0, -2.0, 0.0]\n"
+    "occupied_thresh: 0.65\nfree_thresh: 0.25\n");
+  field = load_distance_field(yaml, 2, &rebuilt);
+  EXPECT_TRUE(rebuilt);
+  EXPECT_EQ(field->resolution(), 0.1);
+  EXPECT_FLOAT_EQ(field->distance(0, 2), 0.2f);
+  field.reset();
+
+  // A cache of another version is replaced, not read.
+  set_cache_version(path, kDistanceFieldVersion + 1);
+  EXPECT_THROW(DistanceField{path}, std::runtime_error);
+  field = load_distance_field(yaml, 2, &rebuilt);
+  EXPECT_TRUE(rebuilt);
+  EXPECT_FLOAT_EQ(field->distance(0, 2), 0.2f);
+  field = load_distance_field(yaml, 2, &rebuilt);
+  EXPECT_FALSE(rebuilt);
+}
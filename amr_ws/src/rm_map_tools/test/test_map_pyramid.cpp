@@ -0,0 +1,259 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rm_map_tools/cell_conversion.hpp"
+#include "rm_map_tools/map_pyramid.hpp"
+
+#include "map_files.hpp"
+
+using rm_map_tools::MapPyramid;
+using rm_map_tools::kOccupied;
+using rm_map_tools::kUnknown;
+using rm_map_tools::load_map_pyramid;
+using rm_map_tools::map_pyramid_path;
+using rm_map_tools::max_pool_2x2;
+using rm_map_tools::max_pool_2x2_scalar;
+using rm_map_tools::max_pool_kernel;
+using rm_map_tools::pyramid_levels;
+
+namespace
+{
+
+// The pooling as documented: the largest of the cells of each 2 x 2 block
+// that exist, compared as signed bytes.
+std::vector<int8_t> pool_by_definition(
+  const std::vector<int8_t> & in, uint32_t width, uint32_t height)
+{
+  const uint32_t out_width = (width + 1) / 2;
+  const uint32_t out_height = (height + 1) / 2;
+  std::vector<int8_t> out(static_cast<size_t>(out_width) * out_height);
+  for (uint32_t y = 0; y < out_height; ++y) {
+    for (uint32_t x = 0; x < out_width; ++x) {
+      int8_t best = in[static_cast<size_t>(2 * y) * width + 2 * x];
+      for (uint32_t dy = 0; dy < 2 && 2 * y + dy < height; ++dy) {
+        for (uint32_t dx = 0; dx < 2 && 2 * x + dx < width; ++dx) {
+          best = std::max(best, in[static_cast<size_t>(2 * y + dy) * width + 2 * x + dx]);
+        }
+      }
+      out[static_cast<size_t>(y) * out_width + x] = best;
+    }
+  }
+  return out;
+}
+
+// Any signed byte, so the kernels' comparisons are checked as signed.
+std::vector<int8_t> random_cells(size_t count, std::mt19937 & rng)
+{
+  std::uniform_int_distribution<int> value(-128, 127);
+  std::vector<int8_t> cells(count);
+  for (int8_t & cell : cells) {
+    cell = static_cast<int8_t>(value(rng));
+  }
+  return cells;
+}
+
+// Rewrites `size` bytes of `path` at `offset`.
+void poke(const std::string & path, size_t offset, const void * bytes, size_t size)
+{
+  std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+  file.seekp(static_cast<std::streamoff>(offset));
+  file.write(static_cast<const char *>(bytes), static_cast<std::streamsize>(size));
+}
+
+// Header layout: char magic[8], u32 version, u32 levels, u32 width,
+// u32 height, u64 fingerprint, then the level table from byte 64.
+constexpr size_t kLevelsOffset = 12;
+constexpr size_t kFingerprintOffset = 24;
+constexpr size_t kLevelTableOffset = 64;
+
+}  // namespace
+
+// The vector kernels pool 64 input cells per step and finish the row in
+// scalar code; widths around one and two blocks, odd and even, cover both.
+TEST(MaxPool, KernelMatchesScalarAndDefinition)
+{
+  SCOPED_TRACE(max_pool_kernel());
+  std::mt19937 rng(24);
+  const uint32_t widths[] = {1, 2, 3, 31, 32, 33, 62, 63, 64, 65, 66, 67, 127, 128, 129, 130, 191};
+  const uint32_t heights[] = {1, 2, 3, 4, 5, 9};
+  for (uint32_t width : widths) {
+    for (uint32_t height : heights) {
+      const std::vector<int8_t> in = random_cells(static_cast<size_t>(width) * height, rng);
+      const std::vector<int8_t> expected = pool_by_definition(in, width, height);
+      std::vector<int8_t> scalar(expected.size(), 0);
+      max_pool_2x2_scalar(in.data(), width, height, scalar.data());
+      {
+        SCOPED_TRACE(std::to_string(width) + "x" + std::to_string(height) + " scalar");
+        ASSERT_EQ(scalar, expected);
+      }
+      for (unsigned threads : {1u, 2u, 3u, 0u}) {
+        SCOPED_TRACE(
+          std::to_string(width) + "x" + std::to_string(height) + " threads " +
+          std::to_string(threads));
+        std::vector<int8_t> pooled(expected.size(), 0);
+        max_pool_2x2(in.data(), width, height, pooled.data(), threads);
+        ASSERT_EQ(pooled, expected);
+      }
+    }
+  }
+}
+
+TEST(MaxPool, OccupiedWinsAndUnknownNeedsAllCells)
+{
+  const int8_t in[] = {
+    kUnknown, kUnknown, 0, kUnknown,
+    kUnknown, kUnknown, kUnknown, kOccupied};
+  int8_t out[2];
+  max_pool_2x2(in, 4, 2, out, 1);
+  EXPECT_EQ(out[0], kUnknown);
+  EXPECT_EQ(out[1], kOccupied);
+}
+
+TEST(MapPyramid, LevelCountStopsAtOneCell)
+{
+  EXPECT_EQ(pyramid_levels(1, 1, 5), 1u);
+  EXPECT_EQ(pyramid_levels(5, 3, 0), 1u);
+  EXPECT_EQ(pyramid_levels(5, 3, 3), 3u);
+  // 5x3 -> 3x2 -> 2x1 -> 1x1
+  EXPECT_EQ(pyramid_levels(5, 3, 10), 4u);
+  EXPECT_EQ(pyramid_levels(UINT32_MAX, UINT32_MAX, 100), rm_map_tools::kMaxPyramidLevels);
+}
+
+TEST(MapPyramid, RoundTripsThroughTheFile)
+{
+  TempDir dir;
+  // 0 is occupied, 254 free and 128 unknown with the thresholds write_map uses.
+  const uint32_t width = 67;
+  const uint32_t height = 5;
+  std::mt19937 rng(5);
+  std::uniform_int_distribution<int> shade(0, 2);
+  std::vector<uint8_t> pixels(static_cast<size_t>(width) * height);
+  for (uint8_t & pixel : pixels) {
+    const int choice = shade(rng);
+    pixel = choice == 0 ? 0 : choice == 1 ? 254 : 128;
+  }
+  const std::string yaml = write_map(dir, "room", width, height, pixels);
+
+  bool rebuilt = false;
+  auto pyramid = load_map_pyramid(yaml, 10, 2, &rebuilt);
+  EXPECT_TRUE(rebuilt);
+  ASSERT_EQ(pyramid->levels(), pyramid_levels(width, height, 10));
+  EXPECT_EQ(pyramid->origin()[0], -1.0);
+  EXPECT_EQ(pyramid->origin()[1], -2.0);
+
+  // Level 0 is the decoded map, rows bottom first; every other level pools
+  // the one below it.
+  const auto & base = pyramid->level(0);
+  ASSERT_EQ(base.width, width);
+  ASSERT_EQ(base.height, height);
+  EXPECT_EQ(base.resolution, 0.05);
+  for (uint32_t y = 0; y < height; ++y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      const uint8_t pixel = pixels[static_cast<size_t>(height - 1 - y) * width + x];
+      const int8_t expected = pixel == 0 ? kOccupied : pixel == 254 ? 0 : kUnknown;
+      ASSERT_EQ(base.cells[static_cast<size_t>(y) * width + x], expected) << x << "," << y;
+    }
+  }
+  for (uint32_t i = 1; i < pyramid->levels(); ++i) {
+    SCOPED_TRACE(i);
+    const auto & fine = pyramid->level(i - 1);
+    const auto & coarse = pyramid->level(i);
+    EXPECT_EQ(coarse.width, (fine.width + 1) / 2);
+    EXPECT_EQ(coarse.height, (fine.height + 1) / 2);
+    EXPECT_EQ(coarse.resolution, 2 * fine.resolution);
+    const std::vector<int8_t> expected = pool_by_definition(
+      std::vector<int8_t>(fine.cells, fine.cells + static_cast<size_t>(fine.width) * fine.height),
+      fine.width, fine.height);
+    EXPECT_EQ(
+      std::vector<int8_t>(
+        coarse.cells, coarse.cells + static_cast<size_t>(coarse.width) * coarse.height),
+      expected);
+  }
+  EXPECT_EQ(pyramid->level(pyramid->levels() - 1).width, 1u);
+  EXPECT_EQ(pyramid->level(pyramid->levels() - 1).height, 1u);
+
+  // Reused as long as the map and the level count stay the same.
+  pyramid = load_map_pyramid(yaml, 10, 2, &rebuilt);
+  EXPECT_FALSE(rebuilt);
+  pyramid = load_map_pyramid(yaml, 2, 2, &rebuilt);
+  EXPECT_TRUE(rebuilt);
+  EXPECT_EQ(pyramid->levels(), 2u);
+}
+
+TEST(MapPyramid, RebuildsOnAStaleFingerprint)
+{
+  TempDir dir;
+  const std::string yaml = write_map(dir, "room", 4, 4, std::vector<uint8_t>(16, 254));
+  const std::string path = map_pyramid_path(yaml);
+  bool rebuilt = false;
+  auto pyramid = load_map_pyramid(yaml, 3, 1, &rebuilt);
+  ASSERT_TRUE(rebuilt);
+  const uint64_t fingerprint = pyramid->fingerprint();
+  pyramid.reset();
+
+  // As if the file had been written for an earlier version of the map.
+  const uint64_t stale = fingerprint ^ 1;
+  poke(path, kFingerprintOffset, &stale, sizeof(stale));
+  EXPECT_EQ(MapPyramid(path).fingerprint(), stale);
+  pyramid = load_map_pyramid(yaml, 3, 1, &rebuilt);
+  EXPECT_TRUE(rebuilt);
+  EXPECT_EQ(pyramid->fingerprint(), fingerprint);
+
+  // A changed PGM changes the fingerprint.
+  std::vector<uint8_t> pixels(16, 254);
+  pixels[5] = 0;
+  write_file(dir.file("room.pgm"), pgm(4, 4, pixels));
+  pyramid = load_map_pyramid(yaml, 3, 1, &rebuilt);
+  EXPECT_TRUE(rebuilt);
+  EXPECT_NE(pyramid->fingerprint(), fingerprint);
+  EXPECT_EQ(pyramid->level(2).cells[0], kOccupied);
+}
+
+TEST(MapPyramid, RejectsATruncatedLevelTable)
+{
+  TempDir dir;
+  const std::string yaml = write_map(dir, "room", 8, 8, std::vector<uint8_t>(64, 254));
+  const std::string path = map_pyramid_path(yaml);
+  const uint32_t levels = pyramid_levels(8, 8, 4);
+  ASSERT_EQ(levels, 4u);
+  load_map_pyramid(yaml, levels, 1);
+
+  // More levels than the table holds before the file ends.
+  const uint32_t too_many = 1000;
+  poke(path, kLevelsOffset, &too_many, sizeof(too_many));
+  EXPECT_THROW(MapPyramid{path}, std::runtime_error);
+  poke(path, kLevelsOffset, &levels, sizeof(levels));
+  ASSERT_NO_THROW(MapPyramid{path});
+
+  // The file cut inside the table.
+  const size_t table_end = kLevelTableOffset + levels * 16;
+  ASSERT_EQ(truncate(path.c_str(), static_cast<off_t>(table_end - 8)), 0);
+  EXPECT_THROW(MapPyramid{path}, std::runtime_error);
+  bool rebuilt = false;
+  auto pyramid = load_map_pyramid(yaml, levels, 1, &rebuilt);
+  EXPECT_TRUE(rebuilt);
+  EXPECT_EQ(pyramid->levels(), levels);
+  pyramid.reset();
+
+  // The file cut where the last level's cells start; levels are padded to
+  // whole pages, so cutting less would only drop padding.
+  uint64_t last_offset = 0;
+  {
+    std::ifstream in(path, std::ios::binary);
+    in.seekg(static_cast<std::streamoff>(kLevelTableOffset + (levels - 1) * 16 + 8));
+    in.read(reinterpret_cast<char *>(&last_offset), sizeof(last_offset));
+  }
+  ASSERT_GT(last_offset, table_end);
+  ASSERT_EQ(truncate(path.c_str(), static_cast<off_t>(last_offset)), 0);
+  EXPECT_THROW(MapPyramid{path}, std::runtime_error);
+  pyramid = load_map_pyramid(yaml, levels, 1, &rebuilt);
+  EXPECT_TRUE(rebuilt);
+}
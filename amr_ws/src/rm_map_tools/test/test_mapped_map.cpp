@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rm_map_tools/cell_conversion.hpp"
+#include "rm_map_tools/mapped_map.hpp"
+
+#include "map_files.hpp"
+
+using rm_map_tools::CellTable;
+using rm_map_tools::MapMetadata;
+using rm_map_tools::MapMode;
+using rm_map_tools::MappedMap;
+using rm_map_tools::convert_cells;
+using rm_map_tools::convert_cells_kernel;
+using rm_map_tools::convert_cells_scalar;
+using rm_map_tools::make_cell_table;
+
+namespace
+{
+
+// nav2_map_server's map_io for one pixel, written out again from its source
+// rather than shared with cell_conversion.cpp.
+int8_t map_io(const MapMetadata & metadata, unsigned pixel, unsigned maxval)
+{
+  const double shade = std::min(pixel, maxval) / static_cast<double>(maxval);
+  const double occ = metadata.negate ? shade : 1.0 - shade;
+  if (metadata.mode == MapMode::kRaw) {
+    const double value = std::round(shade * 255.0);
+    return value <= 100.0 ? static_cast<int8_t>(value) : -1;
+  }
+  if (metadata.occupied_thresh < occ) {
+    return 100;
+  }
+  if (occ < metadata.free_thresh) {
+    return 0;
+  }
+  if (metadata.mode == MapMode::kTrinary) {
+    return -1;
+  }
+  return static_cast<int8_t>(
+    std::rint(
+      (occ - metadata.free_thresh) / (metadata.occupied_thresh - metadata.free_thresh) *
+      100.0));
+}
+
+MapMetadata metadata(MapMode mode, bool negate, double occupied, double free)
+{
+  MapMetadata metadata;
+  metadata.mode = mode;
+  metadata.negate = negate;
+  metadata.occupied_thresh = occupied;
+  metadata.free_thresh = free;
+  return metadata;
+}
+
+}  // namespace
+
+TEST(MappedMap, ParsesHeaderAndFlipsRows)
+{
+  TempDir dir;
+  // Comments and extra whitespace anywhere between the header fields.
+  const std::string header = "P5\n# CREATOR: map_saver\n3  2 # width height\n#\n255\n";
+  write_file(dir.file("map.pgm"), header + std::string("\x00\xfe\xcd\xfe\xfe\x00", 6));
+  write_file(
+    dir.file("map.yaml"),
+    "image: map.pgm\nresolution: 0.05\norigin: [-1.0, -2.0, 0.5]\n"
+    "occupied_thresh: 0.65\nfree_thresh: 0.196\n");
+  const MappedMap map(dir.file("map.yaml"));
+  EXPECT_EQ(map.width(), 3u);
+  EXPECT_EQ(map.height(), 2u);
+  EXPECT_EQ(map.metadata().image, dir.file("map.pgm"));
+  EXPECT_DOUBLE_EQ(map.metadata().origin[2], 0.5);
+  // (0, 0) is the first pixel of the last image row.
+  EXPECT_EQ(map.cell(0, 0), 0);
+  EXPECT_EQ(map.cell(2, 0), 100);
+  EXPECT_EQ(map.cell(0, 1), 100);
+  EXPECT_EQ(map.cell(1, 1), 0);
+  EXPECT_EQ(map.cell(2, 1), -1);
+  std::vector<int8_t> cells(6);
+  map.decode(cells.data());
+  EXPECT_EQ(cells, std::vector<int8_t>({0, 0, 100, 100, 0, -1}));
+  EXPECT_THROW(map.cell(3, 0), std::out_of_range);
+}
+
+TEST(MappedMap, RejectsMalformedImages)
+{
+  TempDir dir;
+  const std::string yaml = write_map(dir, "map", 2, 2, {0, 0, 0, 0});
+  const std::vector<std::string> images = {
+    "P2\n2 2\n255\n0 0 0 0",  // ASCII PGM
+    "P5\n2 2\n255\n" + std::string(3, '\0'),  // truncated
+    "P5\n2 2\n65535\n" + std::string(8, '\0'),  // 16 bit
+    "P5\n0 2\n255\n",  // empty
+    "P5\n2 # height missing\n",
+    "P5\n99999999999 1\n255\n",  // too large
+  };
+  for (const std::string & image : images) {
+    SCOPED_TRACE(image);
+    write_file(dir.file("map.pgm"), image);
+    EXPECT_THROW(MappedMap{yaml}, std::runtime_error);
+  }
+  write_file(dir.file("map.yaml"), "image: map.pgm\nresolution: 0.05\n");
+  EXPECT_THROW(MappedMap{yaml}, std::runtime_error);
+}
+
+// map_saver writes 0 for occupied, 254 for free and 205 for unknown with
+// thresholds 0.65 and 0.196; the comparisons against them are strict.
+TEST(CellTable, TrinaryFollowsMapServer)
+{
+  const CellTable saved = make_cell_table(metadata(MapMode::kTrinary, false, 0.65, 0.196), 255);
+  EXPECT_EQ(saved.value[0], 100);
+  EXPECT_EQ(saved.value[205], -1);
+  EXPECT_EQ(saved.value[254], 0);
+  // occ = 1 - p / 255: above 0.65 up to p = 89, below 0.196 from p = 206.
+  EXPECT_EQ(saved.value[89], 100);
+  EXPECT_EQ(saved.value[90], -1);
+  EXPECT_EQ(saved.value[206], 0);
+  EXPECT_TRUE(saved.three_level);
+
+  // With maxval 4 pixels 1 and 3 land exactly on the thresholds, which are
+  // neither occupied nor free; values above maxval count as maxval.
+  const CellTable exact = make_cell_table(metadata(MapMode::kTrinary, false, 0.75, 0.25), 4);
+  EXPECT_EQ(
+    std::vector<int8_t>(exact.value, exact.value + 6),
+    std::vector<int8_t>({100, -1, -1, -1, 0, 0}));
+  const CellTable negated = make_cell_table(metadata(MapMode::kTrinary, true, 0.75, 0.25), 4);
+  EXPECT_EQ(
+    std::vector<int8_t>(negated.value, negated.value + 6),
+    std::vector<int8_t>({0, -1, -1, -1, 100, 100}));
+}
+
+TEST(CellTable, EveryModeMatchesMapIo)
+{
+  for (MapMode mode : {MapMode::kTrinary, MapMode::kScale, MapMode::kRaw}) {
+    for (bool negate : {false, true}) {
+      for (unsigned maxval : {255u, 100u, 4u}) {
+        const MapMetadata meta = metadata(mode, negate, 0.65, 0.196);
+        SCOPED_TRACE(
+          std::string(rm_map_tools::map_mode_name(mode)) + (negate ? " negated" : "") +
+          ", maxval " + std::to_string(maxval));
+        const CellTable table = make_cell_table(meta, maxval);
+        for (unsigned p = 0; p < 256; ++p) {
+          ASSERT_EQ(table.value[p], map_io(meta, p, maxval)) << "pixel " << p;
+        }
+      }
+    }
+  }
+}
+
+// Lengths around the AVX2 (32) and NEON (16) block sizes, starting at every
+// alignment, against the table lookup.
+TEST(CellTable, VectorConversionMatchesScalar)
+{
+  std::mt19937 random(7);
+  std::vector<uint8_t> pixels(1100);
+  for (uint8_t & p : pixels) {
+    p = static_cast<uint8_t>(random());
+  }
+  const CellTable tables[] = {
+    make_cell_table(metadata(MapMode::kTrinary, false, 0.65, 0.196), 255),
+    make_cell_table(metadata(MapMode::kTrinary, true, 0.65, 0.196), 255),
+    make_cell_table(metadata(MapMode::kTrinary, false, 0.65, 0.196), 100),
+    make_cell_table(metadata(MapMode::kScale, false, 0.65, 0.196), 255),
+  };
+  for (const CellTable & table : tables) {
+    SCOPED_TRACE(std::string(convert_cells_kernel()) + (table.three_level ? "" : ", scale"));
+    for (size_t offset : {0, 1, 7}) {
+      for (size_t count : {0, 1, 15, 16, 17, 31, 32, 33, 63, 1024 + 31}) {
+        std::vector<int8_t> vector(count);
+        std::vector<int8_t> scalar(count);
+        convert_cells(table, pixels.data() + offset, count, vector.data());
+        convert_cells_scalar(table, pixels.data() + offset, count, scalar.data());
+        ASSERT_EQ(vector, scalar) << count << " pixels from " << offset;
+      }
+    }
+  }
+}
+
+TEST(MappedMap, DecodeRegionMatchesCells)
+{
+  TempDir dir;
+  constexpr uint32_t kWidth = 77;
+  constexpr uint32_t kHeight = 41;
+  std::mt19937 random(3);
+  std::vector<uint8_t> pixels(kWidth * kHeight);
+  const uint8_t shades[] = {0, 205, 254, 100, 230};
+  for (uint8_t & p : pixels) {
+    p = shades[random() % 5];
+  }
+  const MappedMap map(write_map(dir, "map", kWidth, kHeight, pixels, "negate: 0\n"));
+
+  constexpr size_t kStride = 50;
+  std::vector<int8_t> region(kStride * 20, 42);
+  map.decode_region(5, 9, 40, 20, region.data(), kStride);
+  for (uint32_t y = 0; y < 20; ++y) {
+    for (uint32_t x = 0; x < kStride; ++x) {
+      const int8_t expected = x < 40 ? map.cell(5 + x, 9 + y) : 42;
+      ASSERT_EQ(region[y * kStride + x], expected) << x << ", " << y;
+    }
+  }
+  EXPECT_THROW(map.decode_region(40, 0, 38, 1, region.data(), kStride), std::out_of_range);
+  EXPECT_THROW(map.decode_region(0, 41, 1, 1, region.data(), kStride), std::out_of_range);
+}
+
+TEST(MappedMap, FingerprintFollowsPixelsAndThresholds)
+{
+  TempDir dir;
+  const std::vector<uint8_t> pixels = {0, 205, 254, 254};
+  const uint64_t base = rm_map_tools::map_fingerprint(
+    MappedMap(write_map(dir, "a", 2, 2, pixels)));
+  EXPECT_EQ(base, rm_map_tools::map_fingerprint(MappedMap(write_map(dir, "b", 2, 2, pixels))));
+  EXPECT_NE(
+    base, rm_map_tools::map_fingerprint(MappedMap(write_map(dir, "c", 2, 2, {0, 205, 254, 0}))));
+  const std::string negated = write_map(dir, "d", 2, 2, pixels, "negate: 1\n");
+  EXPECT_NE(base, rm_map_tools::map_fingerprint(MappedMap(negated)));
+  EXPECT_EQ(
+    rm_map_tools::map_companion_path("maps/my_map.yaml", ".edt"), "maps/my_map.edt");
+  EXPECT_EQ(rm_map_tools::map_companion_path("maps.d/my_map", ".edt"), "maps.d/my_map.edt");
+}
@@ -0,0 +1,255 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rm_map_tools/cell_conversion.hpp"
+#include "rm_map_tools/occupancy_grid.hpp"
+#include "rm_map_tools/packed_grid.hpp"
+
+using rm_map_tools::PackedEncoding;
+using rm_map_tools::decode_rle;
+using rm_map_tools::encode_rle;
+using rm_map_tools::is_trinary;
+using rm_map_tools::kFree;
+using rm_map_tools::kOccupied;
+using rm_map_tools::kUnknown;
+using rm_map_tools::pack_2bit;
+using rm_map_tools::pack_occupancy_grid;
+using rm_map_tools::packed_2bit_size;
+using rm_map_tools::unpack_2bit;
+using rm_map_tools::unpack_2bit_kernel;
+using rm_map_tools::unpack_2bit_scalar;
+using rm_map_tools::unpack_occupancy_grid;
+
+namespace
+{
+
+constexpr int8_t kSentinel = 42;
+
+// Every count up to 40, then counts around the 32-cell (AVX2) and 16-cell
+// (NEON) steps of the vector kernels.
+std::vector<size_t> counts()
+{
+  std::vector<size_t> result;
+  for (size_t count = 0; count <= 40; ++count) {
+    result.push_back(count);
+  }
+  for (size_t count : {47, 48, 49, 63, 64, 65, 95, 96, 97, 127, 128, 129, 1001}) {
+    result.push_back(count);
+  }
+  return result;
+}
+
+// Trinary cells in runs of 1 to `max_run`.
+std::vector<int8_t> random_cells(size_t count, size_t max_run, std::mt19937 & rng)
+{
+  const int8_t values[] = {kFree, kOccupied, kUnknown};
+  std::uniform_int_distribution<int> value(0, 2);
+  std::uniform_int_distribution<size_t> run(1, max_run);
+  std::vector<int8_t> cells;
+  while (cells.size() < count) {
+    cells.insert(cells.end(), std::min(run(rng), count - cells.size()), values[value(rng)]);
+  }
+  return cells;
+}
+
+void expect_rle_error(const std::vector<uint8_t> & data, size_t count)
+{
+  std::vector<int8_t> out(count + 1);
+  EXPECT_THROW(decode_rle(data.data(), data.size(), count, out.data()), std::runtime_error);
+}
+
+nav_msgs::msg::OccupancyGrid make_grid(uint32_t width, uint32_t height, std::mt19937 & rng)
+{
+  nav_msgs::msg::OccupancyGrid grid;
+  grid.header.frame_id = "map";
+  grid.header.stamp.sec = 12;
+  grid.info.resolution = 0.05f;
+  grid.info.width = width;
+  grid.info.height = height;
+  grid.info.origin.position.x = -1.0;
+  grid.data = random_cells(static_cast<size_t>(width) * height, 9, rng);
+  return grid;
+}
+
+}  // namespace
+
+TEST(PackedGrid, TwoBitRoundTrips)
+{
+  std::mt19937 rng(25);
+  for (size_t count : counts()) {
+    SCOPED_TRACE(count);
+    const std::vector<int8_t> cells = random_cells(count, 3, rng);
+    std::vector<uint8_t> packed(packed_2bit_size(count));
+    EXPECT_EQ(packed.size(), (count + 3) / 4);
+    pack_2bit(cells.data(), count, packed.data());
+    // Nothing is written past `count`.
+    std::vector<int8_t> out(count + 40, kSentinel);
+    unpack_2bit(packed.data(), count, out.data());
+    EXPECT_EQ(std::vector<int8_t>(out.begin(), out.begin() + count), cells);
+    EXPECT_EQ(
+      std::vector<int8_t>(out.begin() + count, out.end()), std::vector<int8_t>(40, kSentinel));
+  }
+}
+
+// Random bytes include the unused code 3.
+TEST(PackedGrid, TwoBitKernelMatchesScalar)
+{
+  SCOPED_TRACE(unpack_2bit_kernel());
+  std::mt19937 rng(3);
+  std::uniform_int_distribution<int> byte(0, 255);
+  for (size_t count : counts()) {
+    SCOPED_TRACE(count);
+    std::vector<uint8_t> data(packed_2bit_size(count));
+    for (uint8_t & value : data) {
+      value = static_cast<uint8_t>(byte(rng));
+    }
+    std::vector<int8_t> expected(count + 8, kSentinel);
+    unpack_2bit_scalar(data.data(), count, expected.data());
+    std::vector<int8_t> actual(count + 8, kSentinel);
+    unpack_2bit(data.data(), count, actual.data());
+    ASSERT_EQ(actual, expected);
+  }
+}
+
+TEST(PackedGrid, TwoBitLayout)
+{
+  const int8_t cells[] = {kFree, kOccupied, kUnknown, kFree, kOccupied};
+  uint8_t packed[2];
+  pack_2bit(cells, 5, packed);
+  EXPECT_EQ(packed[0], 0x24);
+  EXPECT_EQ(packed[1], 0x01);
+
+  // Code 3 is unused and reads as unknown.
+  const uint8_t threes[] = {0xff};
+  int8_t out[4];
+  unpack_2bit(threes, 4, out);
+  for (int8_t cell : out) {
+    EXPECT_EQ(cell, kUnknown);
+  }
+}
+
+TEST(PackedGrid, RejectsCellsThatAreNotTrinary)
+{
+  const int8_t cells[] = {kFree, kOccupied, 50, kUnknown};
+  EXPECT_TRUE(is_trinary(cells, 2));
+  EXPECT_FALSE(is_trinary(cells, 4));
+  uint8_t packed[1];
+  EXPECT_THROW(pack_2bit(cells, 4, packed), std::invalid_argument);
+  std::vector<uint8_t> rle;
+  EXPECT_THROW(encode_rle(cells, 4, rle), std::invalid_argument);
+}
+
+TEST(PackedGrid, RleRoundTrips)
+{
+  std::mt19937 rng(7);
+  for (size_t count : counts()) {
+    for (size_t max_run : {1, 5, 200}) {
+      SCOPED_TRACE(std::to_string(count) + " cells, runs up to " + std::to_string(max_run));
+      const std::vector<int8_t> cells = random_cells(count, max_run, rng);
+      std::vector<uint8_t> rle(3, 0xff);
+      encode_rle(cells.data(), count, rle);
+      std::vector<int8_t> out(count + 8, kSentinel);
+      decode_rle(rle.data(), rle.size(), count, out.data());
+      EXPECT_EQ(std::vector<int8_t>(out.begin(), out.begin() + count), cells);
+      EXPECT_EQ(
+        std::vector<int8_t>(out.begin() + count, out.end()), std::vector<int8_t>(8, kSentinel));
+    }
+  }
+}
+
+TEST(PackedGrid, RleRunsAreVarints)
+{
+  // One run of 100000 unknown cells: (100000 << 2 | 2) in three LEB128 bytes.
+  const std::vector<int8_t> cells(100000, kUnknown);
+  std::vector<uint8_t> rle;
+  encode_rle(cells.data(), cells.size(), rle);
+  EXPECT_EQ(rle, (std::vector<uint8_t>{0x82, 0xb5, 0x18}));
+  encode_rle(cells.data(), 0, rle);
+  EXPECT_TRUE(rle.empty());
+}
+
+TEST(PackedGrid, RleRejectsMalformedRuns)
+{
+  // A varint cut short, and one that never ends.
+  expect_rle_error({0x84, 0x80}, 4);
+  expect_rle_error(std::vector<uint8_t>(11, 0x80), 4);
+  // Ten bytes whose last one carries bits past 63: they would shift out and
+  // leave a valid-looking run of one free cell.
+  std::vector<uint8_t> oversized(9, 0x80);
+  oversized[0] = 0x84;
+  oversized.push_back(0x02);
+  expect_rle_error(oversized, 1);
+  // Runs past count, short of it, empty, or of code 3.
+  expect_rle_error({5 << 2 | 1}, 4);
+  expect_rle_error({2 << 2 | 1, 3 << 2 | 0}, 4);
+  expect_rle_error({3 << 2 | 0}, 4);
+  expect_rle_error({}, 4);
+  expect_rle_error({0 << 2 | 1, 4 << 2 | 0}, 4);
+  expect_rle_error({4 << 2 | 3}, 4);
+
+  const std::vector<uint8_t> ok = {4 << 2 | 1};
+  int8_t out[4];
+  decode_rle(ok.data(), ok.size(), 4, out);
+  EXPECT_EQ(out[3], kOccupied);
+}
+
+TEST(PackedOccupancyGrid, RoundTripsInEveryEncoding)
+{
+  std::mt19937 rng(11);
+  for (uint32_t width : {1u, 7u, 33u}) {
+    const nav_msgs::msg::OccupancyGrid grid = make_grid(width, 5, rng);
+    for (int encoding = 0; encoding < 3; ++encoding) {
+      SCOPED_TRACE(std::to_string(width) + " wide, encoding " + std::to_string(encoding));
+      custom_interfaces::msg::PackedOccupancyGrid packed;
+      if (encoding == 2) {
+        // Whichever is smaller.
+        pack_occupancy_grid(grid, packed);
+        EXPECT_LE(packed.data.size(), packed_2bit_size(grid.data.size()));
+      } else {
+        pack_occupancy_grid(grid, static_cast<PackedEncoding>(encoding), packed);
+        EXPECT_EQ(packed.encoding, encoding);
+      }
+      nav_msgs::msg::OccupancyGrid unpacked;
+      unpack_occupancy_grid(packed, unpacked);
+      EXPECT_EQ(unpacked.header.frame_id, "map");
+      EXPECT_EQ(unpacked.header.stamp.sec, 12);
+      EXPECT_EQ(unpacked.info.width, width);
+      EXPECT_EQ(unpacked.info.height, 5u);
+      EXPECT_EQ(unpacked.info.resolution, 0.05f);
+      EXPECT_EQ(unpacked.info.origin.position.x, -1.0);
+      EXPECT_EQ(unpacked.data, grid.data);
+    }
+  }
+}
+
+TEST(PackedOccupancyGrid, RejectsAPayloadOfTheWrongSize)
+{
+  std::mt19937 rng(13);
+  const nav_msgs::msg::OccupancyGrid grid = make_grid(9, 3, rng);
+  custom_interfaces::msg::PackedOccupancyGrid packed;
+  pack_occupancy_grid(grid, PackedEncoding::k2Bit, packed);
+  ASSERT_EQ(packed.data.size(), 7u);
+  nav_msgs::msg::OccupancyGrid unpacked;
+
+  packed.data.push_back(0);
+  EXPECT_THROW(unpack_occupancy_grid(packed, unpacked), std::runtime_error);
+  packed.data.resize(6);
+  EXPECT_THROW(unpack_occupancy_grid(packed, unpacked), std::runtime_error);
+  packed.data.clear();
+  EXPECT_THROW(unpack_occupancy_grid(packed, unpacked), std::runtime_error);
+
+  // The RLE payload must cover width * height too.
+  pack_occupancy_grid(grid, PackedEncoding::kRle, packed);
+  packed.info.height = 4;
+  EXPECT_THROW(unpack_occupancy_grid(packed, unpacked), std::runtime_error);
+
+  pack_occupancy_grid(grid, PackedEncoding::k2Bit, packed);
+  packed.encoding = 7;
+  EXPECT_THROW(unpack_occupancy_grid(packed, unpacked), std::runtime_error);
+}
@@ -0,0 +1,206 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rm_map_tools/mapped_map.hpp"
+#include "rm_map_tools/tiled_map.hpp"
+
+#include "map_files.hpp"
+
+using rm_map_tools::MappedMap;
+using rm_map_tools::TileRange;
+using rm_map_tools::TiledMap;
+using rm_map_tools::TiledMapInfo;
+using rm_map_tools::tiles_around;
+using rm_map_tools::write_tiled_map;
+
+namespace
+{
+
+// 77 x 41 cells cut into 16 cell tiles leaves a 13 cell wide last column and
+// a 9 cell high last row of tiles.
+constexpr uint32_t kWidth = 77;
+constexpr uint32_t kHeight = 41;
+constexpr uint32_t kTileSize = 16;
+
+// Random shades in image order, except for the top-left corner that tile
+// (0, 2) covers, 16 x 9 pixels, which is left mid-grey (unknown with
+// write_map's thresholds) so the tile is not stored.
+std::vector<uint8_t> pixels()
+{
+  std::mt19937 random(5);
+  std::vector<uint8_t> out(kWidth * kHeight);
+  const uint8_t shades[] = {0, 205, 254, 100, 230};
+  for (uint32_t row = 0; row < kHeight; ++row) {
+    for (uint32_t col = 0; col < kWidth; ++col) {
+      const bool blank = row < kHeight - 2 * kTileSize && col < kTileSize;
+      out[row * kWidth + col] = blank ? 128 : shades[random() % 5];
+    }
+  }
+  return out;
+}
+
+TiledMapInfo info(uint32_t tiles_x, uint32_t tiles_y, double yaw)
+{
+  TiledMapInfo info;
+  info.tile_size = 10;
+  info.width = tiles_x * 10;
+  info.height = tiles_y * 10;
+  info.tiles_x = tiles_x;
+  info.tiles_y = tiles_y;
+  info.resolution = 0.1;
+  info.origin[0] = -2.0;
+  info.origin[1] = 3.0;
+  info.origin[2] = yaw;
+  return info;
+}
+
+void expect_range(const TileRange & range, const TileRange & expected)
+{
+  EXPECT_EQ(range.x0, expected.x0);
+  EXPECT_EQ(range.y0, expected.y0);
+  EXPECT_EQ(range.x1, expected.x1);
+  EXPECT_EQ(range.y1, expected.y1);
+}
+
+}  // namespace
+
+TEST(TiledMap, RoundTripMatchesTheMap)
+{
+  TempDir dir;
+  const std::string yaml = write_map(dir, "map", kWidth, kHeight, pixels());
+  const MappedMap map(yaml);
+  const TiledMapInfo written = write_tiled_map(map, yaml, dir.file("tiles"), kTileSize);
+  EXPECT_EQ(written.tiles_x, 5u);
+  EXPECT_EQ(written.tiles_y, 3u);
+
+  // Through the directory and through the manifest.
+  for (const std::string & path : {dir.file("tiles"), dir.file("tiles/manifest.yaml")}) {
+    SCOPED_TRACE(path);
+    const TiledMap tiled(path);
+    const TiledMapInfo & info = tiled.info();
+    EXPECT_EQ(info.tile_size, kTileSize);
+    EXPECT_EQ(info.width, kWidth);
+    EXPECT_EQ(info.height, kHeight);
+    EXPECT_EQ(info.tiles_x, 5u);
+    EXPECT_EQ(info.tiles_y, 3u);
+    EXPECT_EQ(info.stored_tiles, written.stored_tiles);
+    EXPECT_DOUBLE_EQ(info.resolution, 0.05);
+    EXPECT_DOUBLE_EQ(info.origin[0], -1.0);
+    EXPECT_DOUBLE_EQ(info.origin[1], -2.0);
+
+    std::vector<int8_t> expected(kWidth * kHeight);
+    std::vector<int8_t> cells(kWidth * kHeight, 42);
+    map.decode(expected.data());
+    tiled.decode_region(0, 0, kWidth, kHeight, cells.data(), kWidth);
+    ASSERT_EQ(cells, expected);
+  }
+}
+
+// Tiles are found by their index entry: every cell of a stored tile is the
+// map cell it covers, padding beyond the map is unknown, and a tile with no
+// known cell has no slot.
+TEST(TiledMap, TileLookupFollowsTheIndex)
+{
+  TempDir dir;
+  const std::string yaml = write_map(dir, "map", kWidth, kHeight, pixels());
+  const MappedMap map(yaml);
+  write_tiled_map(map, yaml, dir.file("tiles"), kTileSize);
+  const TiledMap tiled(dir.file("tiles"));
+
+  EXPECT_EQ(tiled.tile(0, 2), nullptr);
+  EXPECT_EQ(tiled.info().stored_tiles, 14u);
+  for (uint32_t ty = 0; ty < 3; ++ty) {
+    for (uint32_t tx = 0; tx < 5; ++tx) {
+      SCOPED_TRACE("tile " + std::to_string(tx) + ", " + std::to_string(ty));
+      if (tx == 0 && ty == 2) {
+        continue;
+      }
+      const int8_t * cells = tiled.tile(tx, ty);
+      ASSERT_NE(cells, nullptr);
+      for (uint32_t j = 0; j < kTileSize; ++j) {
+        for (uint32_t i = 0; i < kTileSize; ++i) {
+          const uint32_t x = tx * kTileSize + i;
+          const uint32_t y = ty * kTileSize + j;
+          const int8_t expected = x < kWidth && y < kHeight ? map.cell(x, y) : -1;
+          ASSERT_EQ(cells[j * kTileSize + i], expected) << i << ", " << j;
+        }
+      }
+    }
+  }
+  EXPECT_THROW(tiled.tile(5, 0), std::out_of_range);
+  EXPECT_THROW(tiled.tile(0, 3), std::out_of_range);
+}
+
+// Regions at odd offsets across tile boundaries, including the partial last
+// tiles and the unstored one, into a wider buffer.
+TEST(TiledMap, DecodeRegionAcrossTiles)
+{
+  TempDir dir;
+  const std::string yaml = write_map(dir, "map", kWidth, kHeight, pixels());
+  const MappedMap map(yaml);
+  write_tiled_map(map, yaml, dir.file("tiles"), kTileSize);
+  const TiledMap tiled(dir.file("tiles"));
+
+  constexpr size_t kStride = 70;
+  const uint32_t regions[][4] = {
+    {5, 9, 40, 20}, {15, 15, 2, 2}, {60, 30, 17, 11}, {0, 30, 33, 11}};
+  for (const auto & r : regions) {
+    SCOPED_TRACE(
+      std::to_string(r[2]) + " x " + std::to_string(r[3]) + " from " + std::to_string(r[0]) +
+      ", " + std::to_string(r[1]));
+    std::vector<int8_t> region(kStride * r[3], 42);
+    tiled.decode_region(r[0], r[1], r[2], r[3], region.data(), kStride);
+    for (uint32_t y = 0; y < r[3]; ++y) {
+      for (uint32_t x = 0; x < kStride; ++x) {
+        const int8_t expected = x < r[2] ? map.cell(r[0] + x, r[1] + y) : 42;
+        ASSERT_EQ(region[y * kStride + x], expected) << x << ", " << y;
+      }
+    }
+  }
+  std::vector<int8_t> region(kStride * 2);
+  EXPECT_THROW(tiled.decode_region(40, 0, 38, 1, region.data(), kStride), std::out_of_range);
+  EXPECT_THROW(tiled.decode_region(0, 41, 1, 1, region.data(), kStride), std::out_of_range);
+}
+
+TEST(TiledMap, RejectsZeroTileSize)
+{
+  TempDir dir;
+  const std::string yaml = write_map(dir, "map", 2, 2, {0, 205, 254, 254});
+  EXPECT_THROW(
+    write_tiled_map(MappedMap(yaml), yaml, dir.file("tiles"), 0), std::invalid_argument);
+}
+
+// A 6 x 4 tile map of 1 m tiles with its lower-left corner at (-2, 3).
+TEST(TilesAround, CoversTheRadiusAndClampsToTheMap)
+{
+  const TiledMapInfo map = info(6, 4, 0.0);
+  expect_range(tiles_around(map, 0.5, 4.5, 0.0), {2, 1, 2, 1});
+  expect_range(tiles_around(map, 0.5, 4.5, 0.6), {1, 0, 3, 2});
+  // On a tile boundary the lower tile is the one the point is in.
+  expect_range(tiles_around(map, 1.0, 5.0, 0.0), {3, 2, 3, 2});
+  // Far off the map on both sides: the nearest edge tiles.
+  expect_range(tiles_around(map, -10.0, 20.0, 1.0), {0, 3, 0, 3});
+  expect_range(tiles_around(map, 100.0, -100.0, 1.0), {5, 0, 5, 0});
+  expect_range(tiles_around(map, 1.0, 5.0, 50.0), {0, 0, 5, 3});
+}
+
+TEST(TilesAround, FollowsTheOriginYaw)
+{
+  // Turned a quarter turn, the map's x axis is the world's y axis.
+  const TiledMapInfo map = info(6, 4, M_PI / 2);
+  expect_range(tiles_around(map, -2.5, 4.5, 0.0), {1, 0, 1, 0});
+  expect_range(tiles_around(map, -5.5, 8.5, 0.0), {5, 3, 5, 3});
+
+  const TileRange range{1, 2, 3, 4};
+  EXPECT_TRUE(range.contains(1, 4));
+  EXPECT_FALSE(range.contains(0, 3));
+  EXPECT_FALSE(range.contains(2, 5));
+  EXPECT_TRUE(range == (TileRange{1, 2, 3, 4}));
+  EXPECT_FALSE(range == (TileRange{1, 2, 3, 5}));
+}
@@ -0,0 +1,66 @@
+import os
+
+from ament_index_python.packages import get_package_share_directory
+
+from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument, IncludeLaunchDescription
+from launch.conditions import IfCondition
+from launch.launch_description_sources import PythonLaunchDescriptionSource
+from launch.substitutions import LaunchConfiguration, PythonExpression
+from nav2_common.launch import RewrittenYaml
+
+
+# nav2_bringup's navigation_launch.py with config/nav2_params.yaml. With
+# preprocess_scan:=true it also starts scan_preprocessor and the obstacle
+# sources of both costmaps mark and clear from /scan/filtered, which keeps
+# every beam, instead of /scan.
+def generate_launch_description():
+    bringup_dir = get_package_share_directory('rm_navigation')
+
+    use_sim_time = LaunchConfiguration('use_sim_time')
+    params_file = LaunchConfiguration('params_file')
+    preprocess_scan = LaunchConfiguration('preprocess_scan')
+
+    # `topic` is only used by the costmaps' observation sources.
+    configured_params = RewrittenYaml(
+        source_file=params_file,
+        param_rewrites={
+            'topic': PythonExpression(
+                ["'/scan/filtered' if '", preprocess_scan, "'.lower() == 'true' else '/scan'"])},
+        convert_types=True)
+
+    return LaunchDescription([
+        DeclareLaunchArgument(
+            'use_sim_time', default_value='true',
+            description='Use simulation (Gazebo) clock if true'),
+
+        DeclareLaunchArgument(
+            'autostart', default_value='true',
+            description='Automatically startup the nav2 stack'),
+
+        DeclareLaunchArgument(
+            'params_file',
+            default_value=os.path.join(bringup_dir, 'config', 'nav2_params.yaml'),
+            description='Full path to the ROS2 parameters file to use'),
+
+        DeclareLaunchArgument(
+            'preprocess_scan', default_value='false',
+            description='Start scan_preprocessor and build the costmaps from /scan/filtered '
+                        'instead of /scan'),
+
+        IncludeLaunchDescription(
+            PythonLaunchDescriptionSource(os.path.join(
+                get_package_share_directory('basic_navigation_cpp'), 'launch',
+                'scan_preprocessing.launch.py')),
+            launch_arguments={'use_sim_time': use_sim_time}.items(),
+            condition=IfCondition(preprocess_scan)),
+
+        IncludeLaunchDescription(
+            PythonLaunchDescriptionSource(os.path.join(
+                get_package_share_directory('nav2_bringup'), 'launch',
+                'navigation_launch.py')),
+            launch_arguments={
+                'use_sim_time': use_sim_time,
+                'autostart': LaunchConfiguration('autostart'),
+                'params_file': configured_params}.items()),
+    ])
@@ -1,4 +1,8 @@
 from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument, IncludeLaunchDescription
+from launch.conditions import IfCondition
+from launch.launch_description_sources import PythonLaunchDescriptionSource
+from launch.substitutions import LaunchConfiguration, PythonExpression
 from launch_ros.actions import Node
 from ament_index_python.packages import get_package_share_directory
 import os
@@ -9,15 +13,31 @@ def generate_launch_description():
         'config',
         'slam_config.yaml' 
     )
+    preprocess_scan = LaunchConfiguration('preprocess_scan')
 
     slam_toolbox_node = Node(
        package='slam_toolbox',
        executable='async_slam_toolbox_node',
        name='slam_toolbox',
        output='screen',
-       parameters=[params_file, {'use_sim_time': True}] 
+       parameters=[params_file, {
+           'use_sim_time': True,
+           'scan_topic': PythonExpression(
+               ["'/scan/filtered' if '", preprocess_scan, "'.lower() == 'true' else '/scan'"]),
+       }]
     )
 
+    # Maps from the filtered full-resolution scan when asked to.
+    preprocessing = IncludeLaunchDescription(
+        PythonLaunchDescriptionSource(os.path.join(
+            get_package_share_directory('basic_navigation_cpp'), 'launch',
+            'scan_preprocessing.launch.py')),
+        condition=IfCondition(preprocess_scan))
+
     return LaunchDescription([
+        DeclareLaunchArgument(
+            'preprocess_scan', default_value='false',
+            description='Start scan_preprocessor and map from /scan/filtered instead of /scan'),
+        preprocessing,
         slam_toolbox_node 
     ])
\ No newline at end of file